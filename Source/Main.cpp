@@ -14,6 +14,7 @@
 #include "Teul/Registry/TNodeRegistry.h"
 #include "Teul/Verification/TVerificationParity.h"
 #include "Teul/Verification/TVerificationBenchmark.h"
+#include "Teul/Verification/TVerificationDspKernels.h"
 #include "Teul/Verification/TVerificationGoldenAudio.h"
 #include "Teul/Verification/TVerificationCompiledParity.h"
 #include "Teul/Verification/TVerificationStress.h"
@@ -3053,6 +3054,46 @@ juce::Result runTeulPhase7BenchmarkGate(const juce::StringArray &args) {
   return juce::Result::ok();
 }
 
+juce::Result runTeulPhase7DspKernelGate(const juce::StringArray &args) {
+  const auto iterationArg = argValue(args, "--iteration-count=");
+  int iterationCount = 8;
+  if (iterationArg.isNotEmpty()) {
+    iterationCount = iterationArg.getIntValue();
+    if (iterationCount <= 0) {
+      return juce::Result::fail(
+          "DSP kernel iteration count must be greater than zero.");
+    }
+  }
+
+  Teul::TVerificationDspKernelSuiteReport report;
+  const bool passed = Teul::runDspKernelGate(report, iterationCount);
+  if (report.artifactDirectory.isEmpty()) {
+    return juce::Result::fail(
+        "Teul DSP kernel gate did not produce an artifact directory.");
+  }
+
+  const auto artifactDirectory = juce::File(report.artifactDirectory);
+  const auto summaryFile = artifactDirectory.getChildFile("dsp-kernel-summary.txt");
+  const auto bundleFile = artifactDirectory.getChildFile("artifact-bundle.json");
+  if (!artifactDirectory.isDirectory() || !summaryFile.existsAsFile() ||
+      !bundleFile.existsAsFile()) {
+    return juce::Result::fail(
+        "Teul DSP kernel gate is missing expected suite artifacts.");
+  }
+
+  std::cout << "Teul Phase7 DSP kernel artifact directory: "
+            << artifactDirectory.getFullPathName() << std::endl;
+  std::cout << summaryFile.loadFileAsString() << std::endl;
+
+  if (!passed || report.totalCaseCount <= 0) {
+    return juce::Result::fail(
+        "Teul DSP kernel gate reported one or more failures.");
+  }
+
+  std::cout << "Teul Phase7 DSP kernel gate checks: PASS" << std::endl;
+  return juce::Result::ok();
+}
+
 juce::Result runTeulPhase7RuntimeCompileSmoke(const juce::StringArray &args) {
   const auto outputArg = argValue(args, "--output-dir=");
   const auto runtimeClassName = juce::String("TeulPhase5SmokeRuntime");
@@ -3267,9 +3308,9 @@ juce::Result runTeulPhase5ExportSmoke(const juce::StringArray &args) {
   }
 
   const auto sourceText = report.generatedSourceFile.loadFileAsString();
-  for (const auto &token : {"createParameterLayout()", "embeddedGraphJson()",
-                            "embeddedRuntimeJson()", "setParamById(",
-                            "nodeSchedule() const noexcept"}) {
+  for (const auto &token : {"createParameterLayout()", "makePlan()",
+                            "renderNodes(", "setParamById(",
+                            "setParamByIndex(", "nodeSchedule() const noexcept"}) {
     if (!sourceText.contains(token)) {
       return juce::Result::fail(
           juce::String("Teul generated runtime source missing token: ") + juce::String(token));
@@ -3529,6 +3570,20 @@ public:
       return;
     }
 
+    if (hasArg(args, "--teul-phase7-dsp-kernel-gate")) {
+      const auto smokeResult = runTeulPhase7DspKernelGate(args);
+      if (smokeResult.failed()) {
+        std::cerr << "Teul Phase7 DSP kernel gate failed: "
+                  << smokeResult.getErrorMessage() << std::endl;
+        setApplicationReturnValue(1);
+      } else {
+        setApplicationReturnValue(0);
+      }
+
+      quit();
+      return;
+    }
+
     if (hasArg(args, "--phase6-export-smoke")) {
       const auto smokeResult = runPhase6ExportSmoke(args);
       if (smokeResult.failed()) {
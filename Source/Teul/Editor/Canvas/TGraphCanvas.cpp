@@ -43,6 +43,7 @@ TGraphCanvas::~TGraphCanvas() {
   nodePropertiesRequestHandler = {};
   connectionLevelProvider = {};
   portLevelProvider = {};
+  nodeHeatProvider = {};
   bindingSummaryResolver = {};
   externalEndpointAnchorProvider = {};
   document.meta.canvasOffsetX = viewOriginWorld.x;
@@ -54,6 +55,10 @@ void TGraphCanvas::setConnectionLevelProvider(ConnectionLevelProvider provider)
   connectionLevelProvider = std::move(provider);
 }
 
+void TGraphCanvas::setNodeHeatProvider(NodeHeatProvider provider) {
+  nodeHeatProvider = std::move(provider);
+}
+
 void TGraphCanvas::setPortLevelProvider(PortLevelProvider provider) {
   portLevelProvider = std::move(provider);
 }
@@ -116,6 +121,14 @@ void TGraphCanvas::setDebugOverlayEnabled(bool enabled) {
   pushStatusHint(enabled ? "Overlay on: runtime card visible"
                          : "Overlay off");
 }
+float TGraphCanvas::getNodeHeat(NodeId nodeId) const {
+  if (!nodeHeatProvider)
+    return -1.0f;
+
+  const float heat = nodeHeatProvider(nodeId);
+  return heat < 0.0f ? -1.0f : juce::jmin(1.0f, heat);
+}
+
 float TGraphCanvas::getPortLevel(PortId portId) const {
   if (!portLevelProvider)
     return 0.0f;
@@ -123,6 +136,43 @@ float TGraphCanvas::getPortLevel(PortId portId) const {
   return juce::jlimit(0.0f, 1.0f, portLevelProvider(portId));
 }
 
+std::vector<PortId> TGraphCanvas::collectVisibleMeterPorts() const {
+  std::vector<PortId> ports;
+  if (!portLevelProvider && !connectionLevelProvider)
+    return ports;
+
+  std::set<NodeId> visibleNodes;
+  const auto viewBounds = getLocalBounds();
+  for (const auto &nodeComponent : nodeComponents) {
+    if (nodeComponent == nullptr || !nodeComponent->isVisible() ||
+        !nodeComponent->getBounds().intersects(viewBounds)) {
+      continue;
+    }
+
+    visibleNodes.insert(nodeComponent->getNodeId());
+    if (portLevelProvider) {
+      for (const auto &port : nodeComponent->getOutputPorts())
+        ports.push_back(port->getPortData().portId);
+    }
+  }
+
+  if (connectionLevelProvider) {
+    for (const auto &conn : document.connections) {
+      if (!conn.from.isNodePort())
+        continue;
+
+      if (visibleNodes.count(conn.from.nodeId) != 0 ||
+          (conn.to.isNodePort() && visibleNodes.count(conn.to.nodeId) != 0)) {
+        ports.push_back(conn.from.portId);
+      }
+    }
+  }
+
+  std::sort(ports.begin(), ports.end());
+  ports.erase(std::unique(ports.begin(), ports.end()), ports.end());
+  return ports;
+}
+
 void TGraphCanvas::setNodePropertiesRequestHandler(
     NodePropertiesRequestHandler handler) {
   nodePropertiesRequestHandler = std::move(handler);
@@ -608,7 +658,7 @@ void TGraphCanvas::timerCallback() {
       disconnectAnimation.active = false;
   }
 
-  if (portLevelProvider != nullptr) {
+  if (portLevelProvider != nullptr || nodeHeatProvider != nullptr) {
     for (auto &nodeComponent : nodeComponents) {
       if (nodeComponent != nullptr && nodeComponent->isVisible())
         nodeComponent->repaint();
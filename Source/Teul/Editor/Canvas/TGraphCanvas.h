@@ -110,9 +110,18 @@ public:
   using ConnectionLevelProvider = std::function<float(const TConnection &)>;
   void setConnectionLevelProvider(ConnectionLevelProvider provider);
 
+  // Measured heat in 0..1 for a node, or a negative value when unknown, in
+  // which case the descriptor's estimated cost is shown instead.
+  using NodeHeatProvider = std::function<float(NodeId)>;
+  void setNodeHeatProvider(NodeHeatProvider provider);
+  float getNodeHeat(NodeId nodeId) const;
+
   using PortLevelProvider = std::function<float(PortId)>;
   void setPortLevelProvider(PortLevelProvider provider);
   float getPortLevel(PortId portId) const;
+  // Ports whose level is currently drawn: outputs of on-screen nodes and the
+  // sources of wires touching them. Sorted, without duplicates.
+  std::vector<PortId> collectVisibleMeterPorts() const;
 
   using BindingSummaryResolver =
       std::function<juce::String(const juce::String &paramId)>;
@@ -456,6 +465,7 @@ private:
   float flowPhase = 0.0f;
   ConnectionLevelProvider connectionLevelProvider;
   PortLevelProvider portLevelProvider;
+  NodeHeatProvider nodeHeatProvider;
   BindingSummaryResolver bindingSummaryResolver;
   ExternalDropZoneProvider externalDropZoneProvider;
   ExternalDropZoneProvider externalEndpointAnchorProvider;
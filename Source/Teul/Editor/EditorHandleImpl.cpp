@@ -2929,10 +2929,12 @@ public:
         stats.lastInputChannels,
         stats.lastOutputChannels);
     const juce::String summaryText = juce::String::formatted(
-        "Gen %llu  |  Nodes %d  |  Buffers %d  |  Process %.2f ms",
+        "Gen %llu  |  Nodes %d  |  Buffers %d/%d  |  Workers %d  |  Process %.2f ms",
         static_cast<unsigned long long>(stats.activeGeneration),
         stats.activeNodeCount,
         stats.allocatedPortChannels,
+        stats.naivePortChannels,
+        stats.workerCount,
         stats.lastProcessMilliseconds);
 
     g.setColour(TeulPalette::PanelTextStrong().withAlpha(0.95f));
@@ -2996,6 +2998,16 @@ public:
       drawBadge("XRUN", TeulPalette::AccentRed());
       drewBadge = true;
     }
+    if (stats.shedNodeCount > 0) {
+      drawBadge("Shed " + juce::String(stats.shedNodeCount),
+                TeulPalette::AccentOrange());
+      drewBadge = true;
+    }
+    if (stats.diskUnderrunCount > 0) {
+      drawBadge("Underruns " + juce::String((juce::int64)stats.diskUnderrunCount),
+                TeulPalette::AccentOrange());
+      drewBadge = true;
+    }
     if (stats.clipDetected) {
       drawBadge("Clip", TeulPalette::AccentOrange());
       drewBadge = true;
@@ -3010,6 +3022,9 @@ public:
     }
     if (!drewBadge)
       drawBadge("Stable", TeulPalette::AccentGreen());
+    if (stats.activeVoiceCount > 0)
+      drawBadge("Voices " + juce::String(stats.activeVoiceCount),
+                TeulPalette::AccentSky());
 
     drawBadge(dirty ? "Dirty" : "Saved",
               dirty ? TeulPalette::AccentAmber() : TeulPalette::AccentSlate());
@@ -3173,11 +3188,15 @@ EditorHandle::Impl::Impl(
       bindingRevisionProvider(std::move(bindingRevisionProviderIn)) {
   canvas = std::make_unique<TGraphCanvas>(doc, *registryStore);
   canvas->setConnectionLevelProvider([this](const TConnection &connection) {
-    return connection.from.isNodePort() ? runtime.getPortLevel(connection.from.portId)
+    return connection.from.isNodePort() ? readPortMeterLevel(connection.from.portId)
                                         : 0.0f;
   });
   canvas->setPortLevelProvider(
-      [this](PortId portId) { return runtime.getPortLevel(portId); });
+      [this](PortId portId) { return readPortMeterLevel(portId); });
+  canvas->setNodeHeatProvider([this](NodeId nodeId) {
+    const auto it = nodeHeatById.find(nodeId);
+    return it != nodeHeatById.end() ? it->second : -1.0f;
+  });
   canvas->setBindingSummaryResolver(bindingSummaryResolverIn);
   canvas->setNodePropertiesRequestHandler(
       [this](NodeId nodeId) { openProperties(nodeId); });
@@ -3629,8 +3648,10 @@ EditorHandle::Impl::Impl(
 
   rebuildAll(true);
 
-  if (audioDeviceManager != nullptr)
+  if (audioDeviceManager != nullptr) {
+    runtime.setLoadSheddingEnabled(true);
     audioDeviceManager->addAudioCallback(&runtime);
+  }
 
   if (audioDeviceManager != nullptr)
     controlInputAdapters.push_back(
@@ -3648,8 +3669,10 @@ EditorHandle::Impl::~Impl() {
     canvas->setNodePropertiesRequestHandler({});
     canvas->setConnectionLevelProvider({});
     canvas->setPortLevelProvider({});
+    canvas->setNodeHeatProvider({});
     canvas->setBindingSummaryResolver({});
   }
+  clearPortMeterSubscriptions();
 
   if (propertiesPanel != nullptr) {
     propertiesPanel->setLayoutChangedCallback({});
@@ -4187,6 +4210,53 @@ void EditorHandle::Impl::refreshControlInputAdapters(bool announceChanges) {
     adapter->refresh(announceChanges);
 }
 
+// The runtime meters only subscribed ports, so follow what the canvas shows.
+void EditorHandle::Impl::refreshPortMeterSubscriptions() {
+  auto visiblePorts =
+      canvas != nullptr ? canvas->collectVisibleMeterPorts() : std::vector<PortId>{};
+  if (visiblePorts == meteredPorts)
+    return;
+
+  for (const auto portId : meteredPorts) {
+    if (std::binary_search(visiblePorts.begin(), visiblePorts.end(), portId))
+      continue;
+
+    auto &meterSlot = meterSlotByPort[static_cast<std::size_t>(portId)];
+    runtime.unsubscribePortMeter(meterSlot);
+    meterSlot = -1;
+  }
+
+  for (const auto portId : visiblePorts) {
+    if (std::binary_search(meteredPorts.begin(), meteredPorts.end(), portId))
+      continue;
+
+    if (meterSlotByPort.size() <= static_cast<std::size_t>(portId))
+      meterSlotByPort.resize(static_cast<std::size_t>(portId) + 1, -1);
+    meterSlotByPort[static_cast<std::size_t>(portId)] =
+        runtime.subscribePortMeter(portId);
+  }
+
+  meteredPorts = std::move(visiblePorts);
+}
+
+float EditorHandle::Impl::readPortMeterLevel(PortId portId) const {
+  if (static_cast<std::size_t>(portId) >= meterSlotByPort.size())
+    return 0.0f;
+
+  TPortMeterBank::Reading reading;
+  return runtime.readPortMeter(meterSlotByPort[static_cast<std::size_t>(portId)],
+                               reading)
+             ? reading.peak
+             : 0.0f;
+}
+
+void EditorHandle::Impl::clearPortMeterSubscriptions() {
+  for (const auto portId : meteredPorts)
+    runtime.unsubscribePortMeter(meterSlotByPort[static_cast<std::size_t>(portId)]);
+  meteredPorts.clear();
+  meterSlotByPort.clear();
+}
+
 void EditorHandle::Impl::timerCallback() {
   const auto currentRuntimeRevision = doc.getRuntimeRevision();
   if (currentRuntimeRevision != lastRuntimeRevision) {
@@ -4225,6 +4295,7 @@ void EditorHandle::Impl::timerCallback() {
     refreshControlInputAdapters(true);
   }
 
+  refreshPortMeterSubscriptions();
   refreshRuntimeUi();
   refreshDocumentNoticeUi();
   refreshSessionStatusUi();
@@ -4496,10 +4567,96 @@ void EditorHandle::Impl::refreshRailUi(bool relayout) {
     owner.resized();
 }
 
+// Node timing runs only while something shows it. A node using a quarter
+// of the block budget renders fully hot.
+void EditorHandle::Impl::refreshNodeProfileUi() {
+  const bool drawerOpen =
+      diagnosticsDrawer != nullptr && diagnosticsDrawer->isDrawerOpen();
+  const bool showProfiles =
+      drawerOpen || (canvas != nullptr && canvas->isRuntimeHeatmapEnabled());
+  runtime.setNodeProfilingEnabled(showProfiles);
+  nodeHeatById.clear();
+  if (!showProfiles)
+    return;
+
+  const auto profiles = runtime.getNodeProfiles();
+  for (const auto &profile : profiles) {
+    if (profile.timing.sampleCount > 0) {
+      nodeHeatById[profile.timing.nodeId] =
+          juce::jlimit(0.0f, 1.0f, profile.budgetShare * 4.0f);
+    }
+  }
+
+  if (!drawerOpen || ++nodeCostRefreshCounter < 10)
+    return;
+
+  nodeCostRefreshCounter = 0;
+  std::vector<DiagnosticsNodeCost> costs;
+  for (const auto &profile : profiles) {
+    if (costs.size() >= 12)
+      break;
+    if (profile.timing.sampleCount == 0)
+      continue;
+
+    const auto *node = doc.findNode(profile.timing.nodeId);
+    if (node == nullptr)
+      continue;
+
+    DiagnosticsNodeCost cost;
+    cost.nodeLabel = node->label.isNotEmpty() ? node->label : node->typeKey;
+    cost.meanMicros = profile.timing.meanMicros;
+    cost.p50Micros = profile.timing.p50Micros;
+    cost.p99Micros = profile.timing.p99Micros;
+    cost.budgetShare = profile.budgetShare;
+    costs.push_back(std::move(cost));
+  }
+
+  diagnosticsDrawer->setNodeCosts(costs);
+}
+
+// The drawer only hears about shedding decisions made since it last
+// showed them.
+void EditorHandle::Impl::refreshShedEventUi(
+    const TGraphRuntime::RuntimeStats &stats) {
+  const auto decisionCount = stats.shedEventCount + stats.restoreEventCount;
+  if (diagnosticsDrawer == nullptr || !diagnosticsDrawer->isDrawerOpen() ||
+      decisionCount == shownShedDecisionCount) {
+    return;
+  }
+
+  shownShedDecisionCount = decisionCount;
+  std::vector<DiagnosticsShedEvent> events;
+  for (const auto &event : runtime.getLoadShedEvents()) {
+    DiagnosticsShedEvent row;
+    if (const auto *node = doc.findNode(event.nodeId))
+      row.nodeLabel = node->label.isNotEmpty() ? node->label : node->typeKey;
+    else
+      row.nodeLabel = "Node " + juce::String(event.nodeId);
+    row.time = juce::Time(event.timeMillis);
+    row.restored = event.restored;
+    row.load = event.load;
+    events.push_back(std::move(row));
+  }
+
+  diagnosticsDrawer->setShedEvents(events);
+}
+
 void EditorHandle::Impl::refreshRuntimeUi(bool forceMessage) {
   const auto stats = runtime.getRuntimeStats();
-
-  if ((stats.xrunDetected && !lastRuntimeStats.xrunDetected)) {
+  refreshNodeProfileUi();
+  refreshShedEventUi(stats);
+
+  if (stats.shedNodeCount > lastRuntimeStats.shedNodeCount) {
+    pushRuntimeMessage("Overload: bypassed " + juce::String(stats.shedNodeCount) +
+                           " sheddable node(s)",
+                       TeulPalette::AccentOrange(), 72);
+  } else if (stats.shedNodeCount < lastRuntimeStats.shedNodeCount) {
+    pushRuntimeMessage(stats.shedNodeCount > 0
+                           ? "Headroom back: " + juce::String(stats.shedNodeCount) +
+                                 " node(s) still bypassed"
+                           : juce::String("Headroom back: all shed nodes restored"),
+                       TeulPalette::AccentGreen(), 48);
+  } else if ((stats.xrunDetected && !lastRuntimeStats.xrunDetected)) {
     pushRuntimeMessage("Audio block exceeded budget", TeulPalette::AccentRed(),
                        72);
   } else if (stats.clipDetected && !lastRuntimeStats.clipDetected) {
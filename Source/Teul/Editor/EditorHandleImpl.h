@@ -4,6 +4,7 @@
 #include "Teul/Model/TGraphDocument.h"
 #include "Teul/Runtime/TGraphRuntime.h"
 
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -122,6 +123,8 @@ private:
   bool focusDiagnosticTarget(const juce::String &graphId,
                              const juce::String &query);
   void refreshRuntimeUi(bool forceMessage = false);
+  void refreshNodeProfileUi();
+  void refreshShedEventUi(const TGraphRuntime::RuntimeStats &stats);
   void refreshDocumentNoticeUi(bool force = false);
   void refreshSessionStatusUi(bool force = false);
   void refreshRailUi(bool relayout = false);
@@ -130,6 +133,9 @@ private:
                           juce::Colour accent,
                           int ticks = 50);
   void refreshControlInputAdapters(bool announceChanges);
+  void refreshPortMeterSubscriptions();
+  float readPortMeterLevel(PortId portId) const;
+  void clearPortMeterSubscriptions();
   void drainPendingProfileSyncEvents();
   void drainPendingProfileDeltaEvents();
   void drainPendingLearnBindings();
@@ -179,6 +185,11 @@ private:
   juce::Colour runtimeMessageAccent = juce::Colour(0xff60a5fa);
   int runtimeMessageTicksRemaining = 0;
   int controlInputRefreshCounter = 0;
+  std::vector<PortId> meteredPorts;
+  std::vector<int> meterSlotByPort;
+  std::map<NodeId, float> nodeHeatById;
+  int nodeCostRefreshCounter = 0;
+  std::uint64_t shownShedDecisionCount = 0;
   juce::CriticalSection controlLearnStateLock;
     std::vector<PendingProfileSyncEvent> pendingProfileSyncEvents;
   std::vector<PendingProfileDeltaEvent> pendingProfileDeltaEvents;
@@ -384,10 +384,14 @@ void TNodeComponent::paint(juce::Graphics &g) {
   const float estimatedCpuCost = descriptor != nullptr
                                      ? (float)descriptor->capabilities.estimatedCpuCost
                                      : 0.0f;
-  const float heatLevel = runtimeViewOptions.heatmapEnabled && descriptor != nullptr
-                              ? juce::jlimit(0.0f, 1.0f,
-                                             (estimatedCpuCost - 0.75f) / 4.25f)
-                              : 0.0f;
+  float heatLevel = 0.0f;
+  if (runtimeViewOptions.heatmapEnabled) {
+    const float measuredHeat = ownerCanvas.getNodeHeat(nodeId);
+    if (measuredHeat >= 0.0f)
+      heatLevel = measuredHeat;
+    else if (descriptor != nullptr)
+      heatLevel = juce::jlimit(0.0f, 1.0f, (estimatedCpuCost - 0.75f) / 4.25f);
+  }
   const juce::Colour heatColour = heatColourForLevel(heatLevel);
   const juce::Colour nodeFill = TeulPalette::NodeBackground().interpolatedWith(
       heatColour.darker(0.78f), heatLevel * 0.58f);
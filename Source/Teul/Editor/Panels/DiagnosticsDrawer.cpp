@@ -977,6 +977,10 @@ public:
     addAndMakeVisible(compareScreen);
     addAndMakeVisible(timelineLabel);
     addAndMakeVisible(benchmarkTimeline);
+    addAndMakeVisible(nodeCostLabel);
+    addAndMakeVisible(nodeCostEditor);
+    addAndMakeVisible(shedLabel);
+    addAndMakeVisible(shedEditor);
     addAndMakeVisible(detailEditor);
     addAndMakeVisible(diffEditor);
 
@@ -1066,9 +1070,23 @@ public:
                                  juce::Colours::white.withAlpha(0.72f));
     timelineLabel.setColour(juce::Label::textColourId,
                             juce::Colours::white.withAlpha(0.72f));
+    nodeCostLabel.setText("Node Cost (live)", juce::dontSendNotification);
+    nodeCostLabel.setColour(juce::Label::textColourId,
+                            juce::Colours::white.withAlpha(0.72f));
+    shedLabel.setText("Load Shedding", juce::dontSendNotification);
+    shedLabel.setColour(juce::Label::textColourId,
+                        juce::Colours::white.withAlpha(0.72f));
 
     configureReadOnlyEditor(detailEditor);
     configureReadOnlyEditor(diffEditor);
+    configureReadOnlyEditor(nodeCostEditor);
+    nodeCostEditor.setFont(juce::FontOptions(
+        juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+    configureReadOnlyEditor(shedEditor);
+    shedEditor.setFont(juce::FontOptions(
+        juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+    setNodeCosts({});
+    setShedEvents({});
     updateActionButtons();
     updateShareButtons();
 
@@ -1103,6 +1121,47 @@ public:
       onLayoutChanged();
   }
 
+  void setNodeCosts(const std::vector<DiagnosticsNodeCost> &costs) override {
+    if (costs.empty()) {
+      nodeCostEditor.setText("No node timings yet. Costs appear while audio runs.",
+                             false);
+      return;
+    }
+
+    juce::String text;
+    text << juce::String("Node").paddedRight(' ', 26) << "   mean    p50    p99  block\n";
+    for (const auto &cost : costs) {
+      text << cost.nodeLabel.substring(0, 24).paddedRight(' ', 26)
+           << juce::String(cost.meanMicros, 1).paddedLeft(' ', 7)
+           << juce::String(cost.p50Micros, 1).paddedLeft(' ', 7)
+           << juce::String(cost.p99Micros, 1).paddedLeft(' ', 7)
+           << (juce::String(cost.budgetShare * 100.0f, 1) + "%").paddedLeft(' ', 7)
+           << "\n";
+    }
+
+    nodeCostEditor.setText(text, false);
+  }
+
+  // Newest first.
+  void setShedEvents(const std::vector<DiagnosticsShedEvent> &events) override {
+    if (events.empty()) {
+      shedEditor.setText("No nodes shed. Sheddable nodes are bypassed while "
+                         "the block budget is exceeded.",
+                         false);
+      return;
+    }
+
+    juce::String text;
+    for (auto it = events.rbegin(); it != events.rend(); ++it) {
+      text << it->time.formatted("%H:%M:%S") << "  "
+           << juce::String(it->restored ? "restored" : "shed").paddedRight(' ', 9)
+           << it->nodeLabel.substring(0, 24).paddedRight(' ', 26)
+           << "load " << juce::String(it->load * 100.0f, 1) << "%\n";
+    }
+
+    shedEditor.setText(text, false);
+  }
+
   void refreshArtifacts(bool force = false) override {
     const auto now = juce::Time::getCurrentTime();
     if (!force && lastRefreshTime != juce::Time() &&
@@ -1250,6 +1309,16 @@ public:
     area.removeFromTop(3);
     benchmarkTimeline.setBounds(area.removeFromTop(88));
 
+    area.removeFromTop(6);
+    nodeCostLabel.setBounds(area.removeFromTop(16));
+    area.removeFromTop(3);
+    nodeCostEditor.setBounds(area.removeFromTop(96));
+
+    area.removeFromTop(6);
+    shedLabel.setBounds(area.removeFromTop(16));
+    area.removeFromTop(3);
+    shedEditor.setBounds(area.removeFromTop(52));
+
     area.removeFromTop(6);
     auto listArea = area.removeFromTop(juce::roundToInt(area.getHeight() * 0.22f));
     listViewport.setBounds(listArea);
@@ -1698,8 +1767,12 @@ private:
   juce::Label diffLabel;
   juce::Label compareScreenLabel;
   juce::Label timelineLabel;
+  juce::Label nodeCostLabel;
+  juce::Label shedLabel;
   CompareScreen compareScreen;
   BenchmarkTimeline benchmarkTimeline;
+  juce::TextEditor nodeCostEditor;
+  juce::TextEditor shedEditor;
   juce::TextEditor detailEditor;
   juce::TextEditor diffEditor;
   juce::Colour overallAccent = juce::Colour(0xff22c55e);
@@ -3,9 +3,27 @@
 #include <JuceHeader.h>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace Teul {
 
+// One row of the live node cost table, most expensive first.
+struct DiagnosticsNodeCost {
+  juce::String nodeLabel;
+  double meanMicros = 0.0;
+  double p50Micros = 0.0;
+  double p99Micros = 0.0;
+  float budgetShare = 0.0f;
+};
+
+// A node the runtime bypassed or restored to stay within the block budget.
+struct DiagnosticsShedEvent {
+  juce::String nodeLabel;
+  juce::Time time;
+  bool restored = false;
+  float load = 0.0f;
+};
+
 class DiagnosticsDrawer : public juce::Component {
 public:
   ~DiagnosticsDrawer() override = default;
@@ -16,6 +34,8 @@ public:
   virtual bool isDrawerOpen() const noexcept = 0;
   virtual void setDrawerOpen(bool shouldOpen) = 0;
   virtual void refreshArtifacts(bool force = false) = 0;
+  virtual void setNodeCosts(const std::vector<DiagnosticsNodeCost> &costs) = 0;
+  virtual void setShedEvents(const std::vector<DiagnosticsShedEvent> &events) = 0;
 
   static std::unique_ptr<DiagnosticsDrawer> create();
 };
@@ -1,8 +1,13 @@
 #include "TExport.h"
 
+#include "../Runtime/TGraphBufferPlan.h"
+#include "../Runtime/TGraphRuntime.h"
 #include "../Serialization/TSerializer.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <limits>
 #include <map>
 #include <queue>
 #include <set>
@@ -202,6 +207,19 @@ juce::String sanitizeIdentifier(const juce::String &raw) {
   return sanitized;
 }
 
+// Line breaks would end a generated // comment early and a trailing
+// backslash would splice the next line into it.
+juce::String sanitizeCommentText(const juce::String &raw) {
+  juce::String sanitized;
+  sanitized.preallocateBytes(raw.length() + 8);
+  for (int i = 0; i < raw.length(); ++i) {
+    const auto c = raw[i];
+    sanitized << (c < ' ' || c == 0x7f ? juce::String(" ") : juce::String::charToString(c));
+  }
+
+  return sanitized.trimEnd().trimCharactersAtEnd("\\");
+}
+
 juce::String makeUniqueMemberName(const juce::String &preferredBase,
                                   std::set<juce::String> &usedNames) {
   const auto base = sanitizeIdentifier(preferredBase);
@@ -536,7 +554,7 @@ std::vector<NodeId> collectLiveNodeIds(const TGraphDocument &document,
 
   std::map<NodeId, std::vector<NodeId>> reverseAdjacency;
   for (const auto &connection : document.connections) {
-    if (!connection.isValid())
+    if (!connection.isValid() || !connection.from.isNodePort())
       continue;
     reverseAdjacency[connection.to.nodeId].push_back(connection.from.nodeId);
   }
@@ -550,6 +568,15 @@ std::vector<NodeId> collectLiveNodeIds(const TGraphDocument &document,
     }
   }
 
+  // Nodes wired straight to an output rail reach the device as well.
+  for (const auto &connection : document.connections) {
+    if (connection.isValid() && connection.from.isNodePort() &&
+        connection.to.isRailPort() &&
+        liveNodeIds.insert(connection.from.nodeId).second) {
+      queue.push(connection.from.nodeId);
+    }
+  }
+
   if (queue.empty()) {
     for (const auto &node : document.nodes)
       liveNodeIds.insert(node.nodeId);
@@ -891,6 +918,14 @@ void validateNodes(const TGraphDocument &document,
                           exportSupportToString(descriptor->exportSupport) +
                           ").",
                       location);
+    } else if (options.mode == TExportMode::RuntimeModule && !node.bypassed &&
+               descriptor->instanceFactory != nullptr &&
+               !descriptor->staticInstance.isValid()) {
+      report.addIssue(TExportIssueSeverity::Error,
+                      TExportIssueCode::UnsupportedNodeForMode,
+                      "Node type '" + descriptor->typeKey +
+                          "' has no static instance class for RuntimeModule export.",
+                      location);
     }
 
     validateNodePorts(node, descriptor, report);
@@ -949,6 +984,10 @@ buildGraphIR(const TGraphDocument &document,
   for (const auto &node : document.nodes)
     nodeById[node.nodeId] = &node;
 
+  TGraphBufferPlan bufferPlan;
+  bufferPlan.build(document, order);
+  report.summary.plannedBufferChannelCount = bufferPlan.channelCount;
+
   for (int index = 0; index < (int)order.size(); ++index) {
     const auto *node = nodeById[order[(size_t)index]];
     if (node == nullptr)
@@ -978,7 +1017,7 @@ buildGraphIR(const TGraphDocument &document,
       nodeIR.ports.push_back(std::move(portIR));
 
       TExportBufferPlanEntry bufferEntry;
-      bufferEntry.bufferIndex = report.summary.bufferEntryCount;
+      bufferEntry.bufferIndex = bufferPlan.channelForPort(port.portId);
       bufferEntry.nodeId = node->nodeId;
       bufferEntry.portId = port.portId;
       bufferEntry.dataType = port.dataType;
@@ -1148,6 +1187,8 @@ juce::String buildManifestJsonText(const TExportGraphIR &graph,
   summary->setProperty("prunedNodeCount", report.summary.prunedNodeCount);
   summary->setProperty("scheduleEntryCount", report.summary.scheduleEntryCount);
   summary->setProperty("bufferEntryCount", report.summary.bufferEntryCount);
+  summary->setProperty("plannedBufferChannelCount",
+                       report.summary.plannedBufferChannelCount);
   summary->setProperty("normalizedPortCount", report.summary.normalizedPortCount);
   summary->setProperty("normalizedParamCount", report.summary.normalizedParamCount);
   summary->setProperty("exposedParamCount", report.summary.exposedParamCount);
@@ -1169,168 +1210,550 @@ juce::String buildManifestJsonText(const TExportGraphIR &graph,
   return juce::JSON::toString(juce::var(root), true);
 }
 
+juce::String floatLiteral(float value) {
+  if (std::isnan(value))
+    return "std::numeric_limits<float>::quiet_NaN()";
+  if (std::isinf(value))
+    return value > 0.0f ? "std::numeric_limits<float>::infinity()"
+                        : "-std::numeric_limits<float>::infinity()";
+
+  char text[32] = {};
+  std::snprintf(text, sizeof(text), "%.9g", static_cast<double>(value));
+  juce::String literal(text);
+  if (!literal.containsAnyOf(".e"))
+    literal << ".0";
+  return literal + "f";
+}
+
+juce::String boolLiteral(bool value) { return value ? "true" : "false"; }
+
+juce::String intListLiteral(const std::vector<int> &values) {
+  juce::StringArray items;
+  for (const auto value : values)
+    items.add(juce::String(value));
+  return "{" + items.joinIntoString(", ") + "}";
+}
+
+enum class StaticParamCoercion { None, Boolean, Integer };
+
+// How TGraphRuntime::setParam coerces a value for this parameter: like the
+// value it currently holds.
+StaticParamCoercion staticParamCoercion(const TExportParamIR &param) {
+  const auto &prototype =
+      param.currentValue.isVoid() ? param.defaultValue : param.currentValue;
+  if (prototype.isBool())
+    return StaticParamCoercion::Boolean;
+  if (prototype.isInt() || prototype.isInt64())
+    return StaticParamCoercion::Integer;
+  return StaticParamCoercion::None;
+}
+
+juce::String staticParamCoercionName(StaticParamCoercion coercion) {
+  switch (coercion) {
+  case StaticParamCoercion::Boolean:
+    return "ParamCoercion::Boolean";
+  case StaticParamCoercion::Integer:
+    return "ParamCoercion::Integer";
+  case StaticParamCoercion::None:
+    break;
+  }
+  return "ParamCoercion::None";
+}
+
+// The live part of the document, as the RuntimeModule renders it.
+TGraphDocument makeLiveDocument(const TGraphDocument &document,
+                                const TExportGraphIR &graph) {
+  std::set<NodeId> liveNodeIds;
+  for (const auto &node : graph.nodes)
+    liveNodeIds.insert(node.nodeId);
+
+  auto isLiveEndpoint = [&liveNodeIds](const TEndpoint &endpoint) {
+    return endpoint.isRailPort() || liveNodeIds.count(endpoint.nodeId) != 0;
+  };
+
+  TGraphDocument liveDocument = document;
+  liveDocument.nodes.erase(
+      std::remove_if(liveDocument.nodes.begin(), liveDocument.nodes.end(),
+                     [&liveNodeIds](const TNode &node) {
+                       return liveNodeIds.count(node.nodeId) == 0;
+                     }),
+      liveDocument.nodes.end());
+  liveDocument.connections.erase(
+      std::remove_if(liveDocument.connections.begin(), liveDocument.connections.end(),
+                     [&isLiveEndpoint](const TConnection &connection) {
+                       return !isLiveEndpoint(connection.from) ||
+                              !isLiveEndpoint(connection.to);
+                     }),
+      liveDocument.connections.end());
+  return liveDocument;
+}
+
 juce::String generateHeaderCode(const juce::String &className) {
   juce::StringArray lines;
   lines.add("#pragma once");
   lines.add("");
   lines.add("#include <JuceHeader.h>");
-  lines.add("#include \"Teul/Runtime/TGraphRuntime.h\"");
-  lines.add("#include \"Teul/Registry/TNodeRegistry.h\"");
-  lines.add("#include \"Teul/Serialization/TSerializer.h\"");
-  lines.add("#include <cmath>");
-  lines.add("#include <map>");
+  lines.add("#include <memory>");
+  lines.add("");
+  lines.add("namespace Teul");
+  lines.add("{");
+  lines.add("class TGraphStaticRenderer;");
+  lines.add("}");
   lines.add("");
+  lines.add("// Statically scheduled render of the exported graph. Node instances are");
+  lines.add("// members called in a fixed order over a fixed port buffer layout.");
   lines.add("class " + className);
   lines.add("{");
   lines.add("public:");
   lines.add("    " + className + "();");
-  lines.add("    ~" + className + "() = default;");
+  lines.add("    ~" + className + "();");
   lines.add("");
   lines.add("    void prepare(double sampleRate, int maximumExpectedSamplesPerBlock);");
   lines.add("    void setCurrentChannelLayout(int inputChannels, int outputChannels);");
   lines.add("    void reset();");
   lines.add("    void process(juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiBuffer);");
   lines.add("");
+  lines.add("    // Indices follow createParameterLayout(). The index overloads are");
+  lines.add("    // wait-free and safe to call from the audio thread; sampleOffset");
+  lines.add("    // places the change inside the next processed block.");
   lines.add("    bool setParamById(const juce::String& paramId, const juce::var& value);");
   lines.add("    juce::var getParamById(const juce::String& paramId) const;");
-  lines.add("    bool setParamByIndex(int index, const juce::var& value);");
-  lines.add("    juce::var getParamByIndex(int index) const;");
+  lines.add("    bool setParamByIndex(int index, float value, int sampleOffset = 0) noexcept;");
+  lines.add("    float getParamByIndex(int index) const noexcept;");
   lines.add("    int paramCount() const noexcept;");
   lines.add("    int paramIndexForId(const juce::String& paramId) const noexcept;");
   lines.add("    juce::String paramIdForIndex(int index) const;");
   lines.add("    const juce::StringArray& nodeSchedule() const noexcept;");
   lines.add("");
   lines.add("    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();");
-  lines.add("    static juce::String embeddedGraphJson();");
-  lines.add("    static juce::String embeddedRuntimeJson();");
   lines.add("    static juce::String embeddedManifestJson();");
   lines.add("");
   lines.add("private:");
-  lines.add("    void rebuildRuntime();");
+  lines.add("    struct Nodes;");
   lines.add("");
-  lines.add("    Teul::TGraphDocument document;");
-  lines.add("    std::unique_ptr<Teul::TNodeRegistry> registry;");
-  lines.add("    Teul::TGraphRuntime runtime;");
-  lines.add("    juce::StringArray paramIds;");
+  lines.add("    std::unique_ptr<Teul::TGraphStaticRenderer> renderer;");
+  lines.add("    std::unique_ptr<Nodes> nodes;");
   lines.add("    juce::StringArray scheduleEntries;");
-  lines.add("    std::map<juce::String, int> paramIndexById;");
   lines.add("    double currentSampleRate = 48000.0;");
-  lines.add("    int currentInputChannels = 0;");
-  lines.add("    int currentOutputChannels = 2;");
   lines.add("    int currentBlockSize = 256;");
   lines.add("};");
   lines.add("");
   return lines.joinIntoString("\n");
 }
 
+void addStaticPlanCode(juce::StringArray &lines, const TGraphStaticPlan &plan,
+                       const std::map<NodeId, juce::String> &displayNames) {
+  lines.add("    Teul::TGraphStaticPlan makePlan()");
+  lines.add("    {");
+  lines.add("        Teul::TGraphStaticPlan plan;");
+  lines.add("        plan.channelCount = " + juce::String(plan.channelCount) + ";");
+  lines.add("        plan.silenceChannel = " + juce::String(plan.silenceChannel) + ";");
+  lines.add("        plan.entries.resize(" + juce::String((int)plan.entries.size()) + ");");
+  for (int index = 0; index < (int)plan.entries.size(); ++index) {
+    const auto &entry = plan.entries[(size_t)index];
+    const auto nameIt = displayNames.find(entry.nodeId);
+    lines.add("        {");
+    lines.add("            // " + sanitizeCommentText(entry.typeKey) +
+              (nameIt != displayNames.end()
+                   ? " \"" + sanitizeCommentText(nameIt->second) + "\""
+                   : juce::String()));
+    lines.add("            auto& entry = plan.entries[" + juce::String(index) + "];");
+    lines.add("            entry.nodeId = " + juce::String(entry.nodeId) + ";");
+    lines.add("            entry.runs = " + boolLiteral(entry.runs) + ";");
+
+    juce::StringArray slots;
+    for (const auto &slot : entry.portSlots)
+      slots.add("{" + juce::String(slot.channelIndex) + ", " + boolLiteral(slot.connected) + "}");
+    if (!slots.isEmpty())
+      lines.add("            entry.portSlots = {" + slots.joinIntoString(", ") + "};");
+
+    juce::StringArray sums;
+    for (const auto &sum : entry.inputSums)
+      sums.add("{" + juce::String(sum.dstChannelIndex) + ", " + intListLiteral(sum.srcChannelIndices) + "}");
+    if (!sums.isEmpty())
+      lines.add("            entry.inputSums = {" + sums.joinIntoString(", ") + "};");
+    if (!entry.clearChannels.empty())
+      lines.add("            entry.clearChannels = " + intListLiteral(entry.clearChannels) + ";");
+    if (!entry.aliasedInputChannels.empty())
+      lines.add("            entry.aliasedInputChannels = " + intListLiteral(entry.aliasedInputChannels) + ";");
+
+    juce::StringArray outputs;
+    for (const auto &output : entry.outputs)
+      outputs.add("{" + juce::String(output.channelIndex) + ", " + boolLiteral(output.expandConstant) +
+                  ", " + boolLiteral(output.detectSilence) + "}");
+    if (!outputs.isEmpty())
+      lines.add("            entry.outputs = {" + outputs.joinIntoString(", ") + "};");
+
+    lines.add("            entry.tailLengthMs = " + floatLiteral(entry.tailLengthMs) + ";");
+    if (entry.voiceCount != 1)
+      lines.add("            entry.voiceCount = " + juce::String(entry.voiceCount) + ";");
+    if (entry.voiceLane)
+      lines.add("            entry.voiceLane = true;");
+    if (entry.allocatesVoices)
+      lines.add("            entry.allocatesVoices = true;");
+    if (entry.fusedMember)
+      lines.add("            entry.fusedMember = true;");
+    if (entry.fusionGroup >= 0)
+      lines.add("            entry.fusionGroup = " + juce::String(entry.fusionGroup) + ";");
+    lines.add("        }");
+  }
+
+  if (!plan.fusionGroups.empty()) {
+    lines.add("        plan.fusionGroups.resize(" + juce::String((int)plan.fusionGroups.size()) + ");");
+    for (int index = 0; index < (int)plan.fusionGroups.size(); ++index) {
+      const auto &group = plan.fusionGroups[(size_t)index];
+      juce::StringArray members;
+      for (const auto &operands : group.operands) {
+        juce::StringArray items;
+        for (const auto &operand : operands)
+          items.add("{" + juce::String(operand.member) + ", " + juce::String(operand.slotIndex) + "}");
+        members.add("{" + items.joinIntoString(", ") + "}");
+      }
+      const auto groupRef = "plan.fusionGroups[" + juce::String(index) + "]";
+      lines.add("        " + groupRef + ".memberEntries = " + intListLiteral(group.memberEntries) + ";");
+      lines.add("        " + groupRef + ".operands = {" + members.joinIntoString(", ") + "};");
+      lines.add("        " + groupRef + ".outputSlot = " + juce::String(group.outputSlot) + ";");
+    }
+  }
+
+  for (const auto &param : plan.params) {
+    lines.add("        plan.params.push_back({" + juce::String(param.entryIndex) + ", " +
+              juce::String(param.specIndex) + ", " + juce::String(param.nodeId) + ", {}, " +
+              floatLiteral(param.initialValue) + ", " + boolLiteral(param.smoothing) + "});");
+  }
+  for (const auto &railInput : plan.railInputs) {
+    lines.add("        plan.railInputs.push_back({" + juce::String(railInput.channelIndex) + ", " +
+              juce::String(railInput.deviceChannelIndex) + "});");
+  }
+  for (const auto &railOutput : plan.railOutputs) {
+    lines.add("        plan.railOutputs.push_back({" + juce::String(railOutput.sourceChannelIndex) + ", " +
+              juce::String(railOutput.deviceChannelIndex) + "});");
+  }
+
+  const auto &midi = plan.midi;
+  for (const auto &input : midi.inputs) {
+    lines.add("        plan.midi.inputs.push_back({" + juce::String(input.portId) + ", " +
+              juce::String(input.viewBlock) + ", " + juce::String(input.mergeBlock) + ", " +
+              juce::String(input.sourceBegin) + ", " + juce::String(input.sourceEnd) + "});");
+  }
+  if (!midi.sourceBlocks.empty())
+    lines.add("        plan.midi.sourceBlocks = " + intListLiteral(midi.sourceBlocks) + ";");
+  juce::StringArray midiNodes;
+  for (const auto &node : midi.nodes)
+    midiNodes.add("{" + juce::String(node.inputBegin) + ", " + juce::String(node.inputEnd) + ", " +
+                  juce::String(node.outputBegin) + ", " + juce::String(node.outputEnd) + "}");
+  if (!midiNodes.isEmpty())
+    lines.add("        plan.midi.nodes = {" + midiNodes.joinIntoString(", ") + "};");
+  if (!midi.railOutputBlocks.empty())
+    lines.add("        plan.midi.railOutputBlocks = " + intListLiteral(midi.railOutputBlocks) + ";");
+  lines.add("        plan.midi.deviceInputBlock = " + juce::String(midi.deviceInputBlock) + ";");
+  lines.add("        plan.midi.emptyBlock = " + juce::String(midi.emptyBlock) + ";");
+  lines.add("        plan.midi.blockCount = " + juce::String(midi.blockCount) + ";");
+  lines.add("        return plan;");
+  lines.add("    }");
+}
+
 juce::String generateSourceCode(const juce::String &className,
-                                const juce::String &graphJson,
-                                const juce::String &runtimeJson,
                                 const juce::String &manifestJson,
                                 const TExportGraphIR &graph,
+                                const TGraphStaticPlan &plan,
+                                const TNodeRegistry &registry,
                                 const std::vector<TExportParamIR> &apvtsParams) {
+  std::map<NodeId, juce::String> displayNames;
+  for (const auto &node : graph.nodes)
+    displayNames[node.nodeId] = node.displayName;
+
+  // Only entries that render get an instance; voice lanes are rendered by
+  // their first voice.
+  std::vector<juce::String> memberNames(plan.entries.size());
+  std::vector<const TNodeStaticInstance *> memberClasses(plan.entries.size(), nullptr);
+  std::set<juce::String> usedNames;
+  for (std::size_t index = 0; index < plan.entries.size(); ++index) {
+    const auto &entry = plan.entries[index];
+    const auto *descriptor = registry.descriptorFor(entry.typeKey);
+    if (!entry.runs || entry.voiceLane || descriptor == nullptr ||
+        !descriptor->staticInstance.isValid()) {
+      continue;
+    }
+
+    const auto nameIt = displayNames.find(entry.nodeId);
+    memberNames[index] = makeUniqueMemberName(
+        "node" + (nameIt != displayNames.end() ? nameIt->second : juce::String(entry.nodeId)),
+        usedNames);
+    memberClasses[index] = &descriptor->staticInstance;
+  }
+
+  std::map<std::pair<NodeId, juce::String>, int> planParamIndexByKey;
+  for (int index = 0; index < (int)plan.params.size(); ++index) {
+    const auto &param = plan.params[(size_t)index];
+    planParamIndexByKey[{param.nodeId, param.paramKey}] = index;
+  }
+
   juce::StringArray lines;
   lines.add("#include \"" + className + ".h\"");
   lines.add("");
+  lines.add("#include \"Teul/Registry/Nodes/CoreNodes.h\"");
+  lines.add("#include \"Teul/Runtime/TGraphStaticRenderer.h\"");
+  lines.add("#include <array>");
+  lines.add("#include <limits>");
+  lines.add("");
   lines.add("namespace");
   lines.add("{");
-  lines.add("    Teul::TGraphDocument parseEmbeddedDocument(const juce::String& jsonText)");
+  lines.add("    enum class ParamCoercion");
+  lines.add("    {");
+  lines.add("        None,");
+  lines.add("        Boolean,");
+  lines.add("        Integer");
+  lines.add("    };");
+  lines.add("");
+  lines.add("    struct ParamInfo");
   lines.add("    {");
-  lines.add("        Teul::TGraphDocument document;");
-  lines.add("        auto parsed = juce::JSON::parse(jsonText);");
-  lines.add("        if (!parsed.isVoid())");
-  lines.add("            Teul::TSerializer::fromJson(document, parsed);");
-  lines.add("        return document;");
+  lines.add("        const char* paramId;");
+  lines.add("        int planParamIndex;");
+  lines.add("        ParamCoercion coercion;");
+  lines.add("        float initialValue;");
+  lines.add("    };");
+  lines.add("");
+  lines.add("    const std::array<ParamInfo, " + juce::String((int)apvtsParams.size()) + "> paramInfos{{");
+  for (const auto &param : apvtsParams) {
+    const auto planIt = planParamIndexByKey.find({param.nodeId, param.paramKey});
+    lines.add("        {" + toCppStringLiteral(param.paramId) + ", " +
+              juce::String(planIt != planParamIndexByKey.end() ? planIt->second : -1) + ", " +
+              staticParamCoercionName(staticParamCoercion(param)) + ", " +
+              floatLiteral(varToFloat(param.currentValue.isVoid() ? param.defaultValue
+                                                                  : param.currentValue)) +
+              "},");
+  }
+  lines.add("    }};");
+  lines.add("");
+  lines.add("    float coerceParamValue(ParamCoercion coercion, float value) noexcept");
+  lines.add("    {");
+  lines.add("        switch (coercion)");
+  lines.add("        {");
+  lines.add("            case ParamCoercion::Boolean: return value >= 0.5f ? 1.0f : 0.0f;");
+  lines.add("            case ParamCoercion::Integer: return static_cast<float>(juce::roundToInt(value));");
+  lines.add("            case ParamCoercion::None: break;");
+  lines.add("        }");
+  lines.add("        return value;");
+  lines.add("    }");
+  lines.add("");
+  lines.add("    float paramVarToFloat(const juce::var& value)");
+  lines.add("    {");
+  lines.add("        if (value.isBool())");
+  lines.add("            return static_cast<bool>(value) ? 1.0f : 0.0f;");
+  lines.add("        if (value.isString())");
+  lines.add("            return value.toString().getFloatValue();");
+  lines.add("        return static_cast<float>(static_cast<double>(value));");
   lines.add("    }");
+  lines.add("");
+  addStaticPlanCode(lines, plan, displayNames);
   lines.add("}");
   lines.add("");
-  lines.add(className + "::" + className + "() : registry(Teul::makeDefaultNodeRegistry()), runtime(registry.get())");
+
+  lines.add("struct " + className + "::Nodes");
   lines.add("{");
-  lines.add("    document = parseEmbeddedDocument(embeddedGraphJson());");
-  lines.add("    rebuildRuntime();");
-  for (int index = 0; index < (int)apvtsParams.size(); ++index) {
-    lines.add("    paramIds.add(" + toCppStringLiteral(apvtsParams[(size_t)index].paramId) + ");");
-    lines.add("    paramIndexById[paramIds[" + juce::String(index) + "]] = " + juce::String(index) + ";");
+  lines.add("    Nodes(double sampleRate, int blockSize)");
+  lines.add("    {");
+  for (std::size_t index = 0; index < plan.entries.size(); ++index) {
+    if (memberNames[index].isEmpty())
+      continue;
+
+    const auto &name = memberNames[index];
+    if (plan.entries[index].voiceCount != 1)
+      lines.add("        " + name + ".setVoiceCount(" +
+                juce::String(plan.entries[index].voiceCount) + ");");
+    lines.add("        " + name + ".prepareToPlay(sampleRate, blockSize);");
+    lines.add("        " + name + ".reset();");
+    for (const auto &param : plan.entries[index].initialParams)
+      lines.add("        " + name + ".setParameterValue(" + juce::String(param.specIndex) + ", " +
+                floatLiteral(param.value) + ");");
+    for (const auto &param : plan.entries[index].textParams)
+      lines.add("        " + name + ".setParameterText(" + juce::String(param.specIndex) + ", " +
+                toCppStringLiteral(param.text) + ");");
+  }
+  lines.add("    }");
+  lines.add("");
+  lines.add("    void prepareToPlay(double sampleRate, int blockSize)");
+  lines.add("    {");
+  for (const auto &name : memberNames) {
+    if (name.isNotEmpty())
+      lines.add("        " + name + ".prepareToPlay(sampleRate, blockSize);");
   }
+  lines.add("    }");
+  lines.add("");
+  lines.add("    void bind(Teul::TGraphStaticRenderer& renderer) const");
+  lines.add("    {");
+  for (const auto &group : plan.fusionGroups) {
+    for (const auto entryIndex : group.memberEntries) {
+      const auto &name = memberNames[(size_t)entryIndex];
+      if (name.isNotEmpty())
+        lines.add("        renderer.bindExpression(" + juce::String(entryIndex) + ", " + name + ");");
+    }
+  }
+  if (plan.fusionGroups.empty())
+    lines.add("        juce::ignoreUnused(renderer);");
+  lines.add("    }");
+  lines.add("");
+  lines.add("    void applyParameter(int paramIndex, float value) noexcept");
+  lines.add("    {");
+  lines.add("        switch (paramIndex)");
+  lines.add("        {");
+  for (int index = 0; index < (int)plan.params.size(); ++index) {
+    const auto &param = plan.params[(size_t)index];
+    const auto &name = memberNames[(size_t)param.entryIndex];
+    if (name.isEmpty())
+      continue;
+    lines.add("            case " + juce::String(index) + ": " + name + ".setParameterValue(" +
+              juce::String(param.specIndex) + ", value); break;");
+  }
+  lines.add("            default: juce::ignoreUnused(value); break;");
+  lines.add("        }");
+  lines.add("    }");
+  lines.add("");
+  lines.add("    void renderNodes(Teul::TGraphStaticRenderer& renderer, const Teul::TGraphStaticRenderer::Block& block) noexcept");
+  lines.add("    {");
+  for (std::size_t index = 0; index < plan.entries.size(); ++index) {
+    const auto &entry = plan.entries[index];
+    const auto indexText = juce::String((int)index);
+    if (entry.voiceLane || entry.fusedMember)
+      continue;
+
+    if (memberNames[index].isEmpty()) {
+      lines.add("        renderer.skipNode(" + indexText + ");");
+      continue;
+    }
+
+    juce::String call;
+    if (entry.fusionGroup >= 0)
+      call = "renderer.renderFused(" + indexText + ", contexts[0]);";
+    else if (entry.voiceCount > 1)
+      call = memberNames[index] + ".processVoices(contexts, " + juce::String(entry.voiceCount) + ");";
+    else
+      call = memberNames[index] + ".processSamples(contexts[0]);";
+
+    lines.add("        if (const auto* contexts = renderer.beginNode(" + indexText + ", block))");
+    lines.add("        {");
+    lines.add("            " + call);
+    lines.add("            renderer.endNode(" + indexText + ", block);");
+    lines.add("        }");
+  }
+  lines.add("    }");
+  lines.add("");
+  for (std::size_t index = 0; index < plan.entries.size(); ++index) {
+    if (memberClasses[index] == nullptr)
+      continue;
+
+    const auto &staticInstance = *memberClasses[index];
+    lines.add("    " + staticInstance.className + " " + memberNames[index] +
+              (staticInstance.constructorArguments.isNotEmpty()
+                   ? "{" + staticInstance.constructorArguments + "}"
+                   : juce::String()) +
+              ";");
+  }
+  lines.add("};");
+  lines.add("");
+
+  lines.add(className + "::" + className + "()");
+  lines.add("{");
   for (const auto &schedule : graph.schedule) {
     lines.add("    scheduleEntries.add(" +
               toCppStringLiteral(juce::String(schedule.orderIndex) + ":" + schedule.typeKey + ":" + schedule.displayName) +
               ");");
   }
+  lines.add("    reset();");
   lines.add("}");
   lines.add("");
-  lines.add("void " + className + "::rebuildRuntime()");
-  lines.add("{");
-  lines.add("    runtime.buildGraph(document);");
-  lines.add("    runtime.setCurrentChannelLayout(currentInputChannels, currentOutputChannels);");
-  lines.add("    runtime.prepareToPlay(currentSampleRate, currentBlockSize);");
-  lines.add("}");
+  lines.add(className + "::~" + className + "() = default;");
   lines.add("");
   lines.add("void " + className + "::prepare(double sampleRate, int maximumExpectedSamplesPerBlock)");
   lines.add("{");
   lines.add("    currentSampleRate = sampleRate;");
-  lines.add("    currentBlockSize = maximumExpectedSamplesPerBlock;");
-  lines.add("    runtime.prepareToPlay(sampleRate, maximumExpectedSamplesPerBlock);");
+  lines.add("    currentBlockSize = juce::jmax(1, maximumExpectedSamplesPerBlock);");
+  lines.add("    renderer->prepare(currentSampleRate, currentBlockSize);");
+  lines.add("    nodes->prepareToPlay(currentSampleRate, currentBlockSize);");
   lines.add("}");
   lines.add("");
   lines.add("void " + className + "::setCurrentChannelLayout(int inputChannels, int outputChannels)");
   lines.add("{");
-  lines.add("    currentInputChannels = inputChannels;");
-  lines.add("    currentOutputChannels = outputChannels;");
-  lines.add("    runtime.setCurrentChannelLayout(inputChannels, outputChannels);");
+  lines.add("    renderer->setCurrentChannelLayout(inputChannels, outputChannels);");
   lines.add("}");
   lines.add("");
   lines.add("void " + className + "::reset()");
   lines.add("{");
-  lines.add("    runtime.releaseResources();");
-  lines.add("    rebuildRuntime();");
+  lines.add("    if (renderer == nullptr)");
+  lines.add("        renderer = std::make_unique<Teul::TGraphStaticRenderer>(makePlan());");
+  lines.add("    nodes = std::make_unique<Nodes>(currentSampleRate, currentBlockSize);");
+  lines.add("    nodes->bind(*renderer);");
+  lines.add("    renderer->reset();");
   lines.add("}");
   lines.add("");
   lines.add("void " + className + "::process(juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiBuffer)");
   lines.add("{");
-  lines.add("    runtime.processBlock(audioBuffer, midiBuffer);");
+  lines.add("    renderer->process(*nodes, audioBuffer, midiBuffer);");
   lines.add("}");
   lines.add("");
   lines.add("bool " + className + "::setParamById(const juce::String& paramId, const juce::var& value)");
   lines.add("{");
-  lines.add("    return paramIndexForId(paramId) >= 0 && runtime.setParam(paramId, value);");
+  lines.add("    return setParamByIndex(paramIndexForId(paramId), paramVarToFloat(value));");
   lines.add("}");
   lines.add("");
   lines.add("juce::var " + className + "::getParamById(const juce::String& paramId) const");
   lines.add("{");
-  lines.add("    return paramIndexForId(paramId) >= 0 ? runtime.getParam(paramId) : juce::var();");
+  lines.add("    const int index = paramIndexForId(paramId);");
+  lines.add("    if (index < 0)");
+  lines.add("        return {};");
+  lines.add("");
+  lines.add("    const float value = getParamByIndex(index);");
+  lines.add("    switch (paramInfos[static_cast<size_t>(index)].coercion)");
+  lines.add("    {");
+  lines.add("        case ParamCoercion::Boolean: return value >= 0.5f;");
+  lines.add("        case ParamCoercion::Integer: return juce::roundToInt(value);");
+  lines.add("        case ParamCoercion::None: break;");
+  lines.add("    }");
+  lines.add("    return value;");
   lines.add("}");
   lines.add("");
-  lines.add("bool " + className + "::setParamByIndex(int index, const juce::var& value)");
+  lines.add("bool " + className + "::setParamByIndex(int index, float value, int sampleOffset) noexcept");
   lines.add("{");
-  lines.add("    if (index < 0 || index >= paramIds.size())");
+  lines.add("    if (index < 0 || index >= paramCount())");
   lines.add("        return false;");
-  lines.add("    return setParamById(paramIds[index], value);");
+  lines.add("");
+  lines.add("    const auto& info = paramInfos[static_cast<size_t>(index)];");
+  lines.add("    return info.planParamIndex < 0 ||");
+  lines.add("           renderer->setParameter(info.planParamIndex, coerceParamValue(info.coercion, value),");
+  lines.add("                              sampleOffset);");
   lines.add("}");
   lines.add("");
-  lines.add("juce::var " + className + "::getParamByIndex(int index) const");
+  lines.add("float " + className + "::getParamByIndex(int index) const noexcept");
   lines.add("{");
-  lines.add("    if (index < 0 || index >= paramIds.size())");
-  lines.add("        return {};");
-  lines.add("    return getParamById(paramIds[index]);");
+  lines.add("    if (index < 0 || index >= paramCount())");
+  lines.add("        return 0.0f;");
+  lines.add("");
+  lines.add("    const auto& info = paramInfos[static_cast<size_t>(index)];");
+  lines.add("    return info.planParamIndex >= 0 ? renderer->getParameter(info.planParamIndex)");
+  lines.add("                                    : info.initialValue;");
   lines.add("}");
   lines.add("");
   lines.add("int " + className + "::paramCount() const noexcept");
   lines.add("{");
-  lines.add("    return paramIds.size();");
+  lines.add("    return static_cast<int>(paramInfos.size());");
   lines.add("}");
   lines.add("");
   lines.add("int " + className + "::paramIndexForId(const juce::String& paramId) const noexcept");
   lines.add("{");
-  lines.add("    const auto it = paramIndexById.find(paramId);");
-  lines.add("    return it != paramIndexById.end() ? it->second : -1;");
+  lines.add("    for (size_t index = 0; index < paramInfos.size(); ++index)");
+  lines.add("    {");
+  lines.add("        if (paramId == paramInfos[index].paramId)");
+  lines.add("            return static_cast<int>(index);");
+  lines.add("    }");
+  lines.add("    return -1;");
   lines.add("}");
   lines.add("");
   lines.add("juce::String " + className + "::paramIdForIndex(int index) const");
   lines.add("{");
-  lines.add("    if (index < 0 || index >= paramIds.size())");
+  lines.add("    if (index < 0 || index >= paramCount())");
   lines.add("        return {};");
-  lines.add("    return paramIds[index];");
+  lines.add("    return paramInfos[static_cast<size_t>(index)].paramId;");
   lines.add("}");
   lines.add("");
   lines.add("const juce::StringArray& " + className + "::nodeSchedule() const noexcept");
@@ -1384,16 +1807,6 @@ juce::String generateSourceCode(const juce::String &className,
   lines.add("    return { params.begin(), params.end() };");
   lines.add("}");
   lines.add("");
-  lines.add("juce::String " + className + "::embeddedGraphJson()");
-  lines.add("{");
-  lines.add("    return " + toCppStringLiteral(graphJson) + ";");
-  lines.add("}");
-  lines.add("");
-  lines.add("juce::String " + className + "::embeddedRuntimeJson()");
-  lines.add("{");
-  lines.add("    return " + toCppStringLiteral(runtimeJson) + ";");
-  lines.add("}");
-  lines.add("");
   lines.add("juce::String " + className + "::embeddedManifestJson()");
   lines.add("{");
   lines.add("    return " + toCppStringLiteral(manifestJson) + ";");
@@ -1664,6 +2077,8 @@ juce::var TExportReport::toJson() const {
   summaryData->setProperty("prunedNodeCount", summary.prunedNodeCount);
   summaryData->setProperty("scheduleEntryCount", summary.scheduleEntryCount);
   summaryData->setProperty("bufferEntryCount", summary.bufferEntryCount);
+  summaryData->setProperty("plannedBufferChannelCount",
+                           summary.plannedBufferChannelCount);
   summaryData->setProperty("normalizedPortCount", summary.normalizedPortCount);
   summaryData->setProperty("normalizedParamCount", summary.normalizedParamCount);
   summaryData->setProperty("exposedParamCount", summary.exposedParamCount);
@@ -1960,11 +2375,18 @@ juce::Result TExporter::exportToDirectory(const TGraphDocument &document,
   if (effectiveOptions.mode == TExportMode::RuntimeModule &&
       effectiveOptions.writeRuntimeModuleFiles) {
     const auto apvtsParams = collectAPVTSParams(graph, nullptr);
-    const auto graphJson = buildEditableGraphJsonText(document);
-    const auto runtimeJson = buildRuntimeJsonText(graph);
     const auto manifestJson =
         buildManifestJsonText(graph, effectiveOptions, reportOut);
 
+    // The module replays the plan the runtime builds for the live graph, so
+    // both render the same samples.
+    TGraphStaticPlan plan;
+    TGraphRuntime planRuntime(&registry);
+    if (!planRuntime.buildGraph(makeLiveDocument(document, graph)) ||
+        !planRuntime.describeStaticPlan(plan)) {
+      return writeReportAndFail("RuntimeModule schedule could not be built.");
+    }
+
     const auto headerWriteResult =
         writeTextFile(reportOut.generatedHeaderFile,
                       generateHeaderCode(reportOut.runtimeClassName),
@@ -1974,8 +2396,8 @@ juce::Result TExporter::exportToDirectory(const TGraphDocument &document,
 
     const auto sourceWriteResult = writeTextFile(
         reportOut.generatedSourceFile,
-        generateSourceCode(reportOut.runtimeClassName, graphJson, runtimeJson,
-                           manifestJson, graph, apvtsParams),
+        generateSourceCode(reportOut.runtimeClassName, manifestJson, graph,
+                           plan, registry, apvtsParams),
         effectiveOptions.overwriteExistingFiles);
     if (sourceWriteResult.failed())
       return writeReportAndFail(sourceWriteResult.getErrorMessage());
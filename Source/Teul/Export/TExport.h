@@ -103,6 +103,7 @@ struct TExportSummary {
   int prunedNodeCount = 0;
   int scheduleEntryCount = 0;
   int bufferEntryCount = 0;
+  int plannedBufferChannelCount = 0;
   int normalizedPortCount = 0;
   int normalizedParamCount = 0;
   int exposedParamCount = 0;
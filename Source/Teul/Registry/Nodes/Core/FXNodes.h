@@ -1,8 +1,54 @@
 #pragma once
+#include "../../../Runtime/TDelayEffects.h"
+#include "../../../Runtime/TNodeInstance.h"
 #include "../../TNodeSDK.h"
 
 namespace Teul::Nodes {
 
+class ReverbInstance final : public TNodeInstance {
+public:
+  void prepareToPlay(double newSampleRate,
+                     int maximumExpectedSamplesPerBlock) override {
+    juce::ignoreUnused(maximumExpectedSamplesPerBlock);
+    network.prepare(newSampleRate);
+  }
+
+  void reset() override { network.reset(); }
+
+  void setParameterValue(int paramIndex, float newValue) override {
+    switch (paramIndex) {
+    case 0:
+      network.setRoomSize(newValue);
+      break;
+    case 1:
+      network.setDamping(newValue);
+      break;
+    case 2:
+      network.setWidth(newValue);
+      break;
+    case 3:
+      network.setMix(newValue);
+      break;
+    default:
+      break;
+    }
+  }
+
+  void processSamples(const TProcessContext &ctx) override {
+    if (ctx.globalPortBuffer == nullptr)
+      return;
+
+    TFeedbackDelayNetwork::Block block;
+    block.inputs = {ctx.getInputSamples(0), ctx.getInputSamples(1)};
+    block.outputs = {ctx.getOutputSamples(2), ctx.getOutputSamples(3)};
+    block.numSamples = ctx.numSamples;
+    network.render(block);
+  }
+
+private:
+  TFeedbackDelayNetwork network;
+};
+
 class ReverbNode final : public TNodeClass {
 public:
   TNodeDescriptor makeDescriptor() const override {
@@ -14,6 +60,7 @@ public:
     desc.capabilities.isTimeDependent = true; // 내부 버퍼 꼬임 방지 힌트
     desc.capabilities.canBypass = true;
     desc.capabilities.estimatedCpuCost = 8;
+    desc.capabilities.shedPriority = 0;
 
     desc.paramSpecs = {{"roomSize", "Room Size", 0.5f},
                        {"damping", "Damping", 0.5f},
@@ -21,11 +68,57 @@ public:
                        {"mix", "Mix", 0.3f}};
     desc.portSpecs = {makePortSpec(TPortDirection::Input, TPortDataType::Audio, 2, {"L In", "R In"}),
                       makePortSpec(TPortDirection::Output, TPortDataType::Audio, 2, {"L Out", "R Out"})};
+    desc.staticInstance = {"Teul::Nodes::ReverbInstance", {}};
     return desc;
   }
+
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<ReverbInstance>();
+  }
 };
 TEUL_NODE_AUTOREGISTER(ReverbNode);
 
+class DelayInstance final : public TNodeInstance {
+public:
+  void prepareToPlay(double newSampleRate,
+                     int maximumExpectedSamplesPerBlock) override {
+    juce::ignoreUnused(maximumExpectedSamplesPerBlock);
+    delay.prepare(newSampleRate);
+  }
+
+  void reset() override { delay.reset(); }
+
+  void setParameterValue(int paramIndex, float newValue) override {
+    switch (paramIndex) {
+    case 0:
+      delay.setDelayMs(newValue);
+      break;
+    case 1:
+      delay.setFeedback(newValue);
+      break;
+    case 2:
+      delay.setMix(newValue);
+      break;
+    default:
+      break;
+    }
+  }
+
+  void processSamples(const TProcessContext &ctx) override {
+    if (ctx.globalPortBuffer == nullptr)
+      return;
+
+    TStereoDelay::Block block;
+    block.inputs = {ctx.getInputSamples(0), ctx.getInputSamples(1)};
+    block.outputs = {ctx.getOutputSamples(2), ctx.getOutputSamples(3)};
+    block.numSamples = ctx.numSamples;
+    delay.render(block);
+  }
+
+private:
+  TStereoDelay delay;
+};
+
 class DelayNode final : public TNodeClass {
 public:
   TNodeDescriptor makeDescriptor() const override {
@@ -37,14 +130,23 @@ public:
     desc.capabilities.isTimeDependent = true;
     desc.capabilities.canBypass = true;
     desc.capabilities.estimatedCpuCost = 4;
+    desc.capabilities.shedPriority = 1;
 
-    desc.paramSpecs = {{"time", "Time (ms)", 250.0f},
+    auto time = makeFloatParamSpec("time", "Time (ms)", 250.0f, 1.0f,
+                                   TStereoDelay::kMaxDelayMs, 0.01f, "ms", 2,
+                                   "Time", "Delay time; the line is sized for the maximum.");
+    desc.paramSpecs = {time,
                        {"feedback", "Feedback", 0.3f},
                        {"mix", "Mix", 0.5f}};
     desc.portSpecs = {makePortSpec(TPortDirection::Input, TPortDataType::Audio, 2, {"L In", "R In"}),
                       makePortSpec(TPortDirection::Output, TPortDataType::Audio, 2, {"L Out", "R Out"})};
+    desc.staticInstance = {"Teul::Nodes::DelayInstance", {}};
     return desc;
   }
+
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<DelayInstance>();
+  }
 };
 TEUL_NODE_AUTOREGISTER(DelayNode);
 
@@ -1,7 +1,87 @@
 #pragma once
+#include "../../../Runtime/TNodeInstance.h"
+#include "../../../Runtime/TStateVariableFilter.h"
 #include "../../TNodeSDK.h"
 
 namespace Teul::Nodes {
+namespace FilterNodeHelpers {
+
+// Shared by the three filter nodes: parameter 0 is the cutoff, parameter 1
+// the resonance or Q. Every voice of a region renders in one kernel call.
+class StereoFilterInstance final : public TNodeInstance {
+public:
+  explicit StereoFilterInstance(TStateVariableFilter::Mode modeToUse)
+      : mode(modeToUse) {}
+
+  void prepareToPlay(double newSampleRate,
+                     int maximumExpectedSamplesPerBlock) override {
+    juce::ignoreUnused(maximumExpectedSamplesPerBlock);
+    filter.prepare(newSampleRate);
+  }
+
+  void reset() override { filter.reset(); }
+
+  void setParameterValue(int paramIndex, float newValue) override {
+    if (paramIndex == 0)
+      filter.setCutoff(newValue);
+    else if (paramIndex == 1)
+      filter.setResonance(newValue);
+  }
+
+  void processSamples(const TProcessContext &ctx) override {
+    processVoices(&ctx, 1);
+  }
+
+  void processVoices(const TProcessContext *voiceContexts,
+                     int numVoices) override {
+    TStateVariableFilter::Block block;
+    block.voiceCount =
+        juce::jmin(numVoices, TStateVariableFilter::kMaxVoices);
+    block.numSamples = voiceContexts[0].numSamples;
+    for (int voice = 0; voice < block.voiceCount; ++voice) {
+      const auto index = static_cast<std::size_t>(voice);
+      const auto &ctx = voiceContexts[voice];
+      if (ctx.globalPortBuffer == nullptr)
+        continue;
+
+      block.inputs[2 * index] = ctx.getInputSamples(kLeftInSlot);
+      block.inputs[2 * index + 1] = ctx.getInputSamples(kRightInSlot);
+      block.outputs[2 * index] = ctx.getOutputSamples(kLeftOutSlot);
+      block.outputs[2 * index + 1] = ctx.getOutputSamples(kRightOutSlot);
+      if (ctx.isPortConnected(kFreqCvSlot) &&
+          !ctx.getInputConstant(kFreqCvSlot, block.cvValues[index])) {
+        block.cvInputs[index] = ctx.getInputSamples(kFreqCvSlot);
+        block.audioRateCv =
+            block.audioRateCv || block.cvInputs[index] != nullptr;
+      }
+    }
+
+    filter.render(mode, block);
+  }
+
+private:
+  enum PortSlot : int {
+    kLeftInSlot = 0,
+    kRightInSlot,
+    kFreqCvSlot,
+    kLeftOutSlot,
+    kRightOutSlot
+  };
+
+  TStateVariableFilter::Mode mode;
+  TStateVariableFilter filter;
+};
+
+inline std::vector<TPortSpec> makeStereoFilterPorts() {
+  std::vector<TPortSpec> ports = {
+      makePortSpec(TPortDirection::Input, TPortDataType::Audio, 2, {"L In", "R In"}),
+      makePortSpec(TPortDirection::Input, TPortDataType::CV, "Freq CV"),
+      makePortSpec(TPortDirection::Output, TPortDataType::Audio, 2, {"L Out", "R Out"})};
+  ports[1].acceptsConstant = true;
+  return ports;
+}
+
+} // namespace FilterNodeHelpers
 
 class LowPassFilterNode final : public TNodeClass {
 public:
@@ -10,6 +90,7 @@ public:
     desc.typeKey = "Teul.Filter.LowPass";
     desc.displayName = "LowPass Filter";
     desc.category = "Filter";
+    desc.capabilities.maxPolyphony = TVoiceAllocator::kMaxVoices;
 
     auto cutoff =
         makeFloatParamSpec("cutoff", "Cutoff", 1000.0f, 20.0f, 20000.0f, 0.01f,
@@ -26,11 +107,16 @@ public:
 
     desc.paramSpecs = {cutoff, resonance};
 
-    desc.portSpecs = {makePortSpec(TPortDirection::Input, TPortDataType::Audio, 2, {"L In", "R In"}),
-                      makePortSpec(TPortDirection::Input, TPortDataType::CV, "Freq CV"),
-                      makePortSpec(TPortDirection::Output, TPortDataType::Audio, 2, {"L Out", "R Out"})};
+    desc.portSpecs = FilterNodeHelpers::makeStereoFilterPorts();
+    desc.staticInstance = {"Teul::Nodes::FilterNodeHelpers::StereoFilterInstance",
+                           "Teul::TStateVariableFilter::Mode::LowPass"};
     return desc;
   }
+
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<FilterNodeHelpers::StereoFilterInstance>(
+        TStateVariableFilter::Mode::LowPass);
+  }
 };
 
 TEUL_NODE_AUTOREGISTER(LowPassFilterNode);
@@ -42,14 +128,20 @@ public:
     desc.typeKey = "Teul.Filter.HighPass";
     desc.displayName = "HighPass Filter";
     desc.category = "Filter";
+    desc.capabilities.maxPolyphony = TVoiceAllocator::kMaxVoices;
 
     desc.paramSpecs = {{"cutoff", "Cutoff", 1000.0f},
                        {"resonance", "Resonance", 0.707f}};
-    desc.portSpecs = {makePortSpec(TPortDirection::Input, TPortDataType::Audio, 2, {"L In", "R In"}),
-                      makePortSpec(TPortDirection::Input, TPortDataType::CV, "Freq CV"),
-                      makePortSpec(TPortDirection::Output, TPortDataType::Audio, 2, {"L Out", "R Out"})};
+    desc.portSpecs = FilterNodeHelpers::makeStereoFilterPorts();
+    desc.staticInstance = {"Teul::Nodes::FilterNodeHelpers::StereoFilterInstance",
+                           "Teul::TStateVariableFilter::Mode::HighPass"};
     return desc;
   }
+
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<FilterNodeHelpers::StereoFilterInstance>(
+        TStateVariableFilter::Mode::HighPass);
+  }
 };
 
 TEUL_NODE_AUTOREGISTER(HighPassFilterNode);
@@ -61,15 +153,21 @@ public:
     desc.typeKey = "Teul.Filter.BandPass";
     desc.displayName = "BandPass Filter";
     desc.category = "Filter";
+    desc.capabilities.maxPolyphony = TVoiceAllocator::kMaxVoices;
 
     desc.paramSpecs = {{"cutoff", "Cutoff", 1000.0f}, {"q", "Q Factor", 1.0f}};
-    desc.portSpecs = {makePortSpec(TPortDirection::Input, TPortDataType::Audio, 2, {"L In", "R In"}),
-                      makePortSpec(TPortDirection::Input, TPortDataType::CV, "Freq CV"),
-                      makePortSpec(TPortDirection::Output, TPortDataType::Audio, 2, {"L Out", "R Out"})};
+    desc.portSpecs = FilterNodeHelpers::makeStereoFilterPorts();
+    desc.staticInstance = {"Teul::Nodes::FilterNodeHelpers::StereoFilterInstance",
+                           "Teul::TStateVariableFilter::Mode::BandPass"};
     return desc;
   }
+
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<FilterNodeHelpers::StereoFilterInstance>(
+        TStateVariableFilter::Mode::BandPass);
+  }
 };
 
 TEUL_NODE_AUTOREGISTER(BandPassFilterNode);
 
-} // namespace Teul::Nodes
\ No newline at end of file
+} // namespace Teul::Nodes
@@ -1,4 +1,5 @@
 #pragma once
+#include "../../../Runtime/TExpressionTape.h"
 #include "../../TNodeSDK.h"
 
 namespace Teul::Nodes {
@@ -13,8 +14,16 @@ public:
     desc.portSpecs = {{TPortDirection::Input, TPortDataType::CV, "A"},
                       {TPortDirection::Input, TPortDataType::CV, "B"},
                       {TPortDirection::Output, TPortDataType::CV, "A+B"}};
+    desc.portSpecs[0].acceptsConstant = true;
+    desc.portSpecs[1].acceptsConstant = true;
+    desc.staticInstance = {"Teul::TExpressionNodeInstance",
+                           "Teul::TExpressionOp::Add"};
     return desc;
   }
+
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<TExpressionNodeInstance>(TExpressionOp::Add);
+  }
 };
 TEUL_NODE_AUTOREGISTER(AddNode);
 
@@ -28,8 +37,16 @@ public:
     desc.portSpecs = {{TPortDirection::Input, TPortDataType::CV, "A"},
                       {TPortDirection::Input, TPortDataType::CV, "B"},
                       {TPortDirection::Output, TPortDataType::CV, "A-B"}};
+    desc.portSpecs[0].acceptsConstant = true;
+    desc.portSpecs[1].acceptsConstant = true;
+    desc.staticInstance = {"Teul::TExpressionNodeInstance",
+                           "Teul::TExpressionOp::Subtract"};
     return desc;
   }
+
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<TExpressionNodeInstance>(TExpressionOp::Subtract);
+  }
 };
 TEUL_NODE_AUTOREGISTER(SubtractNode);
 
@@ -43,8 +60,16 @@ public:
     desc.portSpecs = {{TPortDirection::Input, TPortDataType::CV, "A"},
                       {TPortDirection::Input, TPortDataType::CV, "B"},
                       {TPortDirection::Output, TPortDataType::CV, "A*B"}};
+    desc.portSpecs[0].acceptsConstant = true;
+    desc.portSpecs[1].acceptsConstant = true;
+    desc.staticInstance = {"Teul::TExpressionNodeInstance",
+                           "Teul::TExpressionOp::Multiply"};
     return desc;
   }
+
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<TExpressionNodeInstance>(TExpressionOp::Multiply);
+  }
 };
 TEUL_NODE_AUTOREGISTER(MultiplyNode);
 
@@ -58,8 +83,16 @@ public:
     desc.portSpecs = {{TPortDirection::Input, TPortDataType::CV, "A"},
                       {TPortDirection::Input, TPortDataType::CV, "B"},
                       {TPortDirection::Output, TPortDataType::CV, "A/B"}};
+    desc.portSpecs[0].acceptsConstant = true;
+    desc.portSpecs[1].acceptsConstant = true;
+    desc.staticInstance = {"Teul::TExpressionNodeInstance",
+                           "Teul::TExpressionOp::Divide"};
     return desc;
   }
+
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<TExpressionNodeInstance>(TExpressionOp::Divide);
+  }
 };
 TEUL_NODE_AUTOREGISTER(DivideNode);
 
@@ -73,8 +106,17 @@ public:
     desc.paramSpecs = {{"min", "Min", 0.0f}, {"max", "Max", 1.0f}};
     desc.portSpecs = {{TPortDirection::Input, TPortDataType::CV, "In"},
                       {TPortDirection::Output, TPortDataType::CV, "Out"}};
+    desc.portSpecs[0].acceptsConstant = true;
+    desc.staticInstance = {"Teul::TExpressionNodeInstance",
+                           "Teul::TExpressionOp::Clamp, {{0.0f, 1.0f}}"};
     return desc;
   }
+
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<TExpressionNodeInstance>(
+        TExpressionOp::Clamp,
+        std::array<float, TExpressionNodeInstance::kMaxParameters>{{0.0f, 1.0f}});
+  }
 };
 TEUL_NODE_AUTOREGISTER(ClampNode);
 
@@ -91,8 +133,19 @@ public:
                        {"outMax", "Out Max", 1.0f}};
     desc.portSpecs = {{TPortDirection::Input, TPortDataType::CV, "In"},
                       {TPortDirection::Output, TPortDataType::CV, "Out"}};
+    desc.portSpecs[0].acceptsConstant = true;
+    desc.staticInstance = {"Teul::TExpressionNodeInstance",
+                           "Teul::TExpressionOp::ValueMap, "
+                           "{{0.0f, 1.0f, -1.0f, 1.0f}}"};
     return desc;
   }
+
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<TExpressionNodeInstance>(
+        TExpressionOp::ValueMap,
+        std::array<float, TExpressionNodeInstance::kMaxParameters>{
+            {0.0f, 1.0f, -1.0f, 1.0f}});
+  }
 };
 TEUL_NODE_AUTOREGISTER(ValueMapNode);
 
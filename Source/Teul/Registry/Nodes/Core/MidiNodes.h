@@ -2,8 +2,148 @@
 #include "../../../Runtime/TNodeInstance.h"
 #include "../../TNodeSDK.h"
 
+#include <array>
+
 namespace Teul::Nodes {
 
+class PitchToCVInstance final : public TNodeInstance {
+public:
+  void processSamples(const TProcessContext &ctx) override {
+    if (!ctx.midiMessages || !ctx.globalPortBuffer)
+      return;
+
+    // Outputs hold between events. A block without events stays
+    // constant; otherwise each output steps at the event's sample.
+    if (ctx.midiMessages->getNumEvents() == 0) {
+      ctx.setOutputConstant(kGateSlot, lastGate);
+      ctx.setOutputConstant(kPitchSlot, lastPct);
+      ctx.setOutputConstant(kVelocitySlot, lastVel);
+      return;
+    }
+
+    // Reads this node's own MIDI block: the outputs keep their held values
+    // up to each event's sample offset and take the new note from there.
+    int segmentStart = 0;
+    for (const auto meta : *ctx.midiMessages) {
+      const int position = juce::jlimit(segmentStart, ctx.numSamples,
+                                        meta.samplePosition);
+      fillOutputs(ctx, segmentStart, position);
+      segmentStart = position;
+
+      const auto msg = meta.getMessage();
+      if (msg.isNoteOn()) {
+        lastGate = 1.0f;
+        lastPct = msg.getNoteNumber() / 12.0f; // 1V/Oct 방식 근사 (C0 = 0V)
+        lastVel = msg.getFloatVelocity();
+      } else if (msg.isNoteOff() &&
+                 std::abs(lastPct - (msg.getNoteNumber() / 12.0f)) < 0.01f) {
+        lastGate = 0.0f;
+      }
+    }
+
+    fillOutputs(ctx, segmentStart, ctx.numSamples);
+  }
+
+  // Notes arrive on the first voice and are spread over the region by
+  // the allocator. A stolen voice drops its gate for one sample so the
+  // envelopes it drives start again.
+  void processVoices(const TProcessContext *voiceContexts,
+                     int numVoices) override {
+    const auto &ctx = voiceContexts[0];
+    auto *allocator = ctx.voiceAllocator;
+    if (allocator == nullptr || numVoices <= 1) {
+      processSamples(ctx);
+      return;
+    }
+
+    if (ctx.globalPortBuffer == nullptr)
+      return;
+
+    const int voiceCount = juce::jmin(numVoices, allocator->getVoiceCount());
+    if (ctx.midiMessages == nullptr || ctx.midiMessages->getNumEvents() == 0) {
+      for (int voice = 0; voice < voiceCount; ++voice) {
+        const auto &state = allocator->getVoice(voice);
+        const auto &voiceContext = voiceContexts[voice];
+        voiceContext.setOutputConstant(kGateSlot, state.held ? 1.0f : 0.0f);
+        voiceContext.setOutputConstant(kPitchSlot, state.noteNumber / 12.0f);
+        voiceContext.setOutputConstant(kVelocitySlot, state.velocity);
+      }
+      return;
+    }
+
+    std::array<int, TVoiceAllocator::kMaxVoices> retriggerAt;
+    retriggerAt.fill(-1);
+    int segmentStart = 0;
+    for (const auto meta : *ctx.midiMessages) {
+      const int position = juce::jlimit(segmentStart, ctx.numSamples,
+                                        meta.samplePosition);
+      fillVoiceOutputs(voiceContexts, voiceCount, *allocator, segmentStart,
+                       position);
+      segmentStart = position;
+
+      const auto msg = meta.getMessage();
+      if (msg.isNoteOn()) {
+        const auto assignment =
+            allocator->noteOn(msg.getNoteNumber(), msg.getFloatVelocity());
+        if (assignment.stolen)
+          retriggerAt[static_cast<std::size_t>(assignment.voice)] = position;
+      } else if (msg.isNoteOff()) {
+        allocator->noteOff(msg.getNoteNumber());
+      } else if (msg.isAllNotesOff() || msg.isAllSoundOff()) {
+        allocator->releaseAll();
+      }
+    }
+
+    fillVoiceOutputs(voiceContexts, voiceCount, *allocator, segmentStart,
+                     ctx.numSamples);
+
+    for (int voice = 0; voice < voiceCount; ++voice) {
+      const int position = retriggerAt[static_cast<std::size_t>(voice)];
+      auto *gate = voiceContexts[voice].getOutputSamples(kGateSlot);
+      if (gate != nullptr && position >= 0 && position < ctx.numSamples)
+        gate[position] = 0.0f;
+    }
+  }
+
+private:
+  enum PortSlot : int { kMidiInSlot = 0, kPitchSlot, kGateSlot, kVelocitySlot };
+
+  void fillOutputs(const TProcessContext &ctx, int startSample,
+                   int endSample) const noexcept {
+    fillValues(ctx, startSample, endSample, lastGate, lastPct, lastVel);
+  }
+
+  static void fillVoiceOutputs(const TProcessContext *voiceContexts,
+                               int voiceCount, const TVoiceAllocator &allocator,
+                               int startSample, int endSample) noexcept {
+    for (int voice = 0; voice < voiceCount; ++voice) {
+      const auto &state = allocator.getVoice(voice);
+      fillValues(voiceContexts[voice], startSample, endSample,
+                 state.held ? 1.0f : 0.0f, state.noteNumber / 12.0f,
+                 state.velocity);
+    }
+  }
+
+  static void fillValues(const TProcessContext &ctx, int startSample,
+                         int endSample, float gateValue, float pitchValue,
+                         float velocityValue) noexcept {
+    const int count = endSample - startSample;
+    if (count <= 0)
+      return;
+
+    if (auto *gate = ctx.getOutputSamples(kGateSlot))
+      juce::FloatVectorOperations::fill(gate + startSample, gateValue, count);
+    if (auto *pitch = ctx.getOutputSamples(kPitchSlot))
+      juce::FloatVectorOperations::fill(pitch + startSample, pitchValue, count);
+    if (auto *velocity = ctx.getOutputSamples(kVelocitySlot))
+      juce::FloatVectorOperations::fill(velocity + startSample, velocityValue, count);
+  }
+
+  float lastGate = 0.0f;
+  float lastPct = 5.0f; // 60 / 12 (C4)
+  float lastVel = 0.0f;
+};
+
 class PitchToCVNode final : public TNodeClass {
 public:
   TNodeDescriptor makeDescriptor() const override {
@@ -12,90 +152,44 @@ public:
     desc.displayName = "MIDI to CV";
     desc.category = "MIDI";
 
-    desc.capabilities.maxPolyphony = 1;
+    desc.capabilities.maxPolyphony = TVoiceAllocator::kMaxVoices;
+    desc.capabilities.allocatesVoices = true;
+
+    auto voices = makeEnumParamSpec(
+        "voices", "Voices", 1,
+        {makeParamOption("mono", "Mono", 1), makeParamOption("2", "2", 2),
+         makeParamOption("4", "4", 4), makeParamOption("6", "6", 6),
+         makeParamOption("8", "8", 8)},
+        "Polyphony",
+        "Voices of the patch fed by this node. Changing it rebuilds the graph.");
+    voices.isAutomatable = false;
+    voices.isModulatable = false;
+    voices.exposeToIeum = false;
+    voices.categoryPath = "MIDI/Polyphony";
+    desc.paramSpecs = {voices};
 
     desc.portSpecs = {{TPortDirection::Input, TPortDataType::MIDI, "MIDI In"},
                       {TPortDirection::Output, TPortDataType::CV, "V/Oct"},
                       {TPortDirection::Output, TPortDataType::Gate, "Gate"},
                       {TPortDirection::Output, TPortDataType::CV, "Velocity"}};
+    desc.staticInstance = {"Teul::Nodes::PitchToCVInstance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation : public TNodeInstance {
-    public:
-      void processSamples(const TProcessContext &ctx) override {
-        if (!ctx.midiMessages || !ctx.globalPortBuffer || !ctx.portToChannel ||
-            !ctx.nodeData)
-          return;
-
-        auto findChannelByPortName = [&](juce::StringRef portName) -> int {
-          for (const auto &port : ctx.nodeData->ports) {
-            if (port.name == portName) {
-              auto it = ctx.portToChannel->find(port.portId);
-              return (it != ctx.portToChannel->end()) ? it->second : -1;
-            }
-          }
-          return -1;
-        };
-
-        const int gateCh = findChannelByPortName("Gate");
-        const int pctCh = findChannelByPortName("V/Oct");
-        const int velCh = findChannelByPortName("Velocity");
-
-        int numSamples = ctx.globalPortBuffer->getNumSamples();
-
-        float currentGate = lastGate;
-        float currentPct = lastPct;
-        float currentVel = lastVel;
-
-        // 임시: 전역 MIDI 버퍼에서 가장 최근 이벤트를 모노포닉으로 추적
-        for (const auto meta : *ctx.midiMessages) {
-          const auto msg = meta.getMessage();
-          if (msg.isNoteOn()) {
-            currentGate = 1.0f;
-            currentPct =
-                msg.getNoteNumber() / 12.0f; // 1V/Oct 방식 근사 (C0 = 0V)
-            currentVel = msg.getFloatVelocity();
-          } else if (msg.isNoteOff() &&
-                     std::abs(currentPct - (msg.getNoteNumber() / 12.0f)) <
-                         0.01f) {
-            currentGate = 0.0f;
-          }
-        }
-
-        if (gateCh >= 0) {
-          auto *out = ctx.globalPortBuffer->getWritePointer(gateCh);
-          for (int i = 0; i < numSamples; ++i)
-            out[i] = currentGate;
-        }
-        if (pctCh >= 0) {
-          auto *out = ctx.globalPortBuffer->getWritePointer(pctCh);
-          for (int i = 0; i < numSamples; ++i)
-            out[i] = currentPct;
-        }
-        if (velCh >= 0) {
-          auto *out = ctx.globalPortBuffer->getWritePointer(velCh);
-          for (int i = 0; i < numSamples; ++i)
-            out[i] = currentVel;
-        }
-
-        lastGate = currentGate;
-        lastPct = currentPct;
-        lastVel = currentVel;
-      }
-
-    private:
-      float lastGate = 0.0f;
-      float lastPct = 5.0f; // 60 / 12 (C4)
-      float lastVel = 0.0f;
-    };
-    return std::make_unique<Implementation>();
+    return std::make_unique<PitchToCVInstance>();
   }
 };
 
 TEUL_NODE_AUTOREGISTER(PitchToCVNode);
 
+class MidiOutputInstance final : public TNodeInstance {
+public:
+  void processSamples(const TProcessContext &ctx) override {
+    // Output 은 나중에 호스트로 전송할 때 처리
+  }
+};
+
 class MidiOutputNode final : public TNodeClass {
 public:
   TNodeDescriptor makeDescriptor() const override {
@@ -104,22 +198,24 @@ public:
     desc.displayName = "MIDI Output";
     desc.category = "MIDI";
     desc.portSpecs = {{TPortDirection::Input, TPortDataType::MIDI, "MIDI In"}};
+    desc.staticInstance = {"Teul::Nodes::MidiOutputInstance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation : public TNodeInstance {
-    public:
-      void processSamples(const TProcessContext &ctx) override {
-        // Output 은 나중에 호스트로 전송할 때 처리
-      }
-    };
-    return std::make_unique<Implementation>();
+    return std::make_unique<MidiOutputInstance>();
   }
 };
 
 TEUL_NODE_AUTOREGISTER(MidiOutputNode);
 
+class MidiInputInstance final : public TNodeInstance {
+public:
+  void processSamples(const TProcessContext &ctx) override {
+    // Input 은 외부에서 ctx.midiMessages 에 넣어진 상태라고 간주
+  }
+};
+
 class MidiInputNode final : public TNodeClass {
 public:
   TNodeDescriptor makeDescriptor() const override {
@@ -129,17 +225,12 @@ public:
     desc.category = "MIDI";
     desc.portSpecs = {
         {TPortDirection::Output, TPortDataType::MIDI, "MIDI Out"}};
+    desc.staticInstance = {"Teul::Nodes::MidiInputInstance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation : public TNodeInstance {
-    public:
-      void processSamples(const TProcessContext &ctx) override {
-        // Input 은 외부에서 ctx.midiMessages 에 넣어진 상태라고 간주
-      }
-    };
-    return std::make_unique<Implementation>();
+    return std::make_unique<MidiInputInstance>();
   }
 };
 
@@ -6,46 +6,60 @@
 #include <cmath>
 
 namespace Teul::Nodes {
-namespace MixerNodeHelpers {
 
-static int findPortChannel(const TProcessContext &ctx,
-                           juce::StringRef portName) {
-  if (ctx.nodeData == nullptr || ctx.portToChannel == nullptr)
-    return -1;
-
-  for (const auto &port : ctx.nodeData->ports) {
-    if (port.name == portName) {
-      const auto it = ctx.portToChannel->find(port.portId);
-      return it != ctx.portToChannel->end() ? it->second : -1;
-    }
+class VCAInstance final : public TNodeInstance {
+public:
+  void setParameterValue(int paramIndex, float newValue) override {
+    if (paramIndex == 0)
+      gain = juce::jlimit(0.0f, 2.0f, newValue);
   }
 
-  return -1;
-}
-
-static int findNthAudioInputChannel(const TProcessContext &ctx, int inputIndex) {
-  if (ctx.nodeData == nullptr || ctx.portToChannel == nullptr)
-    return -1;
-
-  int currentIndex = 0;
-  for (const auto &port : ctx.nodeData->ports) {
-    if (port.direction != TPortDirection::Input ||
-        port.dataType != TPortDataType::Audio) {
-      continue;
+  void processSamples(const TProcessContext &ctx) override {
+    if (ctx.globalPortBuffer == nullptr)
+      return;
+
+    auto *leftOutput = ctx.getOutputSamples(kLeftOutSlot);
+    auto *rightOutput = ctx.getOutputSamples(kRightOutSlot);
+    if (leftOutput == nullptr && rightOutput == nullptr)
+      return;
+
+    const int numSamples = ctx.numSamples;
+    const float *leftInput = ctx.getInputSamples(kLeftInSlot);
+    const float *rightInput = ctx.getInputSamples(kRightInSlot);
+    if (rightInput == nullptr)
+      rightInput = leftInput;
+    const float *cv = ctx.getInputSamples(kCVSlot);
+    float constantModulation = 1.0f;
+    if (ctx.getInputConstant(kCVSlot, constantModulation)) {
+      constantModulation = juce::jmax(0.0f, constantModulation);
+      cv = nullptr;
     }
 
-    if (currentIndex == inputIndex) {
-      const auto it = ctx.portToChannel->find(port.portId);
-      return it != ctx.portToChannel->end() ? it->second : -1;
+    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
+      const float modulation =
+          cv != nullptr ? juce::jmax(0.0f, cv[sampleIndex]) : constantModulation;
+      const float leftSource =
+          leftInput != nullptr ? leftInput[sampleIndex] : 0.0f;
+      const float rightSource =
+          rightInput != nullptr ? rightInput[sampleIndex] : leftSource;
+      if (leftOutput != nullptr)
+        leftOutput[sampleIndex] = leftSource * gain * modulation;
+      if (rightOutput != nullptr)
+        rightOutput[sampleIndex] = rightSource * gain * modulation;
     }
-
-    ++currentIndex;
   }
 
-  return -1;
-}
+private:
+  enum PortSlot : int {
+    kLeftInSlot = 0,
+    kRightInSlot,
+    kCVSlot,
+    kLeftOutSlot,
+    kRightOutSlot
+  };
 
-} // namespace MixerNodeHelpers
+  float gain = 1.0f;
+};
 
 class VCANode final : public TNodeClass {
 public:
@@ -55,6 +69,8 @@ public:
     desc.displayName = "VCA";
     desc.category = "Mixer";
     desc.capabilities.canMute = true;
+    desc.capabilities.tailLengthMs = 0.0f;
+    desc.capabilities.maxPolyphony = TVoiceAllocator::kMaxVoices;
 
     auto gain = makeFloatParamSpec("gain", "Gain", 1.0f, 0.0f, 2.0f, 0.001f,
                                    {}, 3, "Level",
@@ -69,74 +85,68 @@ public:
                       {TPortDirection::Input, TPortDataType::CV, "CV"},
                       {TPortDirection::Output, TPortDataType::Audio, "L Out"},
                       {TPortDirection::Output, TPortDataType::Audio, "R Out"}};
+    desc.portSpecs[2].acceptsConstant = true;
+    desc.staticInstance = {"Teul::Nodes::VCAInstance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation final : public TNodeInstance {
-    public:
-      void setParameterValue(const juce::String &paramKey,
-                             float newValue) override {
-        if (paramKey == "gain")
-          gain = juce::jlimit(0.0f, 2.0f, newValue);
-      }
+    return std::make_unique<VCAInstance>();
+  }
+};
+TEUL_NODE_AUTOREGISTER(VCANode);
 
-      void processSamples(const TProcessContext &ctx) override {
-        if (ctx.globalPortBuffer == nullptr)
-          return;
-
-        int leftInputChannel = MixerNodeHelpers::findPortChannel(ctx, "L In");
-        int rightInputChannel = MixerNodeHelpers::findPortChannel(ctx, "R In");
-        const int cvChannel = MixerNodeHelpers::findPortChannel(ctx, "CV");
-        const int leftOutputChannel = MixerNodeHelpers::findPortChannel(ctx, "L Out");
-        const int rightOutputChannel = MixerNodeHelpers::findPortChannel(ctx, "R Out");
-        if (leftOutputChannel < 0 && rightOutputChannel < 0)
-          return;
-
-        if (leftInputChannel < 0)
-          leftInputChannel = MixerNodeHelpers::findNthAudioInputChannel(ctx, 0);
-        if (rightInputChannel < 0)
-          rightInputChannel = MixerNodeHelpers::findNthAudioInputChannel(ctx, 1);
-
-        const int numSamples = ctx.globalPortBuffer->getNumSamples();
-        auto *leftOutput = leftOutputChannel >= 0
-                               ? ctx.globalPortBuffer->getWritePointer(leftOutputChannel)
-                               : nullptr;
-        auto *rightOutput = rightOutputChannel >= 0
-                                ? ctx.globalPortBuffer->getWritePointer(rightOutputChannel)
-                                : nullptr;
-        const float *leftInput =
-            leftInputChannel >= 0 ? ctx.globalPortBuffer->getReadPointer(leftInputChannel)
-                                  : nullptr;
-        const float *rightInput = rightInputChannel >= 0
-                                      ? ctx.globalPortBuffer->getReadPointer(rightInputChannel)
-                                      : leftInput;
-        const float *cv =
-            cvChannel >= 0 ? ctx.globalPortBuffer->getReadPointer(cvChannel)
-                           : nullptr;
-
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
-          const float modulation =
-              cv != nullptr ? juce::jmax(0.0f, cv[sampleIndex]) : 1.0f;
-          const float leftSource =
-              leftInput != nullptr ? leftInput[sampleIndex] : 0.0f;
-          const float rightSource =
-              rightInput != nullptr ? rightInput[sampleIndex] : leftSource;
-          if (leftOutput != nullptr)
-            leftOutput[sampleIndex] = leftSource * gain * modulation;
-          if (rightOutput != nullptr)
-            rightOutput[sampleIndex] = rightSource * gain * modulation;
-        }
-      }
+class StereoPannerInstance final : public TNodeInstance {
+public:
+  void setParameterValue(int paramIndex, float newValue) override {
+    if (paramIndex == 0)
+      pan = juce::jlimit(-1.0f, 1.0f, newValue);
+  }
 
-    private:
-      float gain = 1.0f;
-    };
+  void processSamples(const TProcessContext &ctx) override {
+    if (ctx.globalPortBuffer == nullptr)
+      return;
+
+    auto *left = ctx.getOutputSamples(kLeftOutSlot);
+    auto *right = ctx.getOutputSamples(kRightOutSlot);
+    if (left == nullptr || right == nullptr)
+      return;
+
+    const int numSamples = ctx.numSamples;
+    const float *input = ctx.getInputSamples(kInSlot);
+    const float *cv = ctx.getInputSamples(kPanCVSlot);
+
+    float constantCV = 0.0f;
+    if (ctx.getInputConstant(kPanCVSlot, constantCV)) {
+      const float currentPan = juce::jlimit(-1.0f, 1.0f, pan + constantCV);
+      const float angle =
+          (currentPan * 0.5f + 0.5f) * juce::MathConstants<float>::halfPi;
+      const float leftGain = std::cos(angle);
+      const float rightGain = std::sin(angle);
+      for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
+        const float source = input != nullptr ? input[sampleIndex] : 0.0f;
+        left[sampleIndex] = source * leftGain;
+        right[sampleIndex] = source * rightGain;
+      }
+      return;
+    }
 
-    return std::make_unique<Implementation>();
+    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
+      const float source = input != nullptr ? input[sampleIndex] : 0.0f;
+      const float currentPan = juce::jlimit(
+          -1.0f, 1.0f, pan + (cv != nullptr ? cv[sampleIndex] : 0.0f));
+      const float angle =
+          (currentPan * 0.5f + 0.5f) * juce::MathConstants<float>::halfPi;
+      left[sampleIndex] = source * std::cos(angle);
+      right[sampleIndex] = source * std::sin(angle);
+    }
   }
+
+private:
+  enum PortSlot : int { kInSlot = 0, kPanCVSlot, kLeftOutSlot, kRightOutSlot };
+
+  float pan = 0.0f;
 };
-TEUL_NODE_AUTOREGISTER(VCANode);
 
 class StereoPannerNode final : public TNodeClass {
 public:
@@ -146,6 +156,7 @@ public:
     desc.displayName = "Stereo Panner";
     desc.category = "Mixer";
     desc.capabilities.canMute = true;
+    desc.capabilities.tailLengthMs = 0.0f;
 
     auto pan = makeFloatParamSpec("pan", "Pan", 0.0f, -1.0f, 1.0f, 0.001f,
                                   {}, 3, "Placement",
@@ -159,58 +170,57 @@ public:
                       {TPortDirection::Input, TPortDataType::CV, "Pan CV"},
                       {TPortDirection::Output, TPortDataType::Audio, "L Out"},
                       {TPortDirection::Output, TPortDataType::Audio, "R Out"}};
+    desc.portSpecs[1].acceptsConstant = true;
+    desc.staticInstance = {"Teul::Nodes::StereoPannerInstance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation final : public TNodeInstance {
-    public:
-      void setParameterValue(const juce::String &paramKey,
-                             float newValue) override {
-        if (paramKey == "pan")
-          pan = juce::jlimit(-1.0f, 1.0f, newValue);
-      }
+    return std::make_unique<StereoPannerInstance>();
+  }
+};
+TEUL_NODE_AUTOREGISTER(StereoPannerNode);
 
-      void processSamples(const TProcessContext &ctx) override {
-        if (ctx.globalPortBuffer == nullptr)
-          return;
-
-        const int inputChannel = MixerNodeHelpers::findPortChannel(ctx, "In");
-        const int cvChannel = MixerNodeHelpers::findPortChannel(ctx, "Pan CV");
-        const int leftChannel = MixerNodeHelpers::findPortChannel(ctx, "L Out");
-        const int rightChannel = MixerNodeHelpers::findPortChannel(ctx, "R Out");
-        if (leftChannel < 0 || rightChannel < 0)
-          return;
-
-        const int numSamples = ctx.globalPortBuffer->getNumSamples();
-        const float *input =
-            inputChannel >= 0 ? ctx.globalPortBuffer->getReadPointer(inputChannel)
-                              : nullptr;
-        const float *cv =
-            cvChannel >= 0 ? ctx.globalPortBuffer->getReadPointer(cvChannel)
-                           : nullptr;
-        auto *left = ctx.globalPortBuffer->getWritePointer(leftChannel);
-        auto *right = ctx.globalPortBuffer->getWritePointer(rightChannel);
-
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
-          const float source = input != nullptr ? input[sampleIndex] : 0.0f;
-          const float currentPan = juce::jlimit(
-              -1.0f, 1.0f, pan + (cv != nullptr ? cv[sampleIndex] : 0.0f));
-          const float angle =
-              (currentPan * 0.5f + 0.5f) * juce::MathConstants<float>::halfPi;
-          left[sampleIndex] = source * std::cos(angle);
-          right[sampleIndex] = source * std::sin(angle);
-        }
-      }
+class Mixer2Instance final : public TNodeInstance {
+public:
+  void setParameterValue(int paramIndex, float newValue) override {
+    switch (paramIndex) {
+    case 0:
+      gain1 = juce::jlimit(0.0f, 2.0f, newValue);
+      break;
+    case 1:
+      gain2 = juce::jlimit(0.0f, 2.0f, newValue);
+      break;
+    default:
+      break;
+    }
+  }
+
+  void processSamples(const TProcessContext &ctx) override {
+    if (ctx.globalPortBuffer == nullptr)
+      return;
+
+    auto *output = ctx.getOutputSamples(kOutSlot);
+    if (output == nullptr)
+      return;
 
-    private:
-      float pan = 0.0f;
-    };
+    const int numSamples = ctx.numSamples;
+    const float *input1 = ctx.getInputSamples(kIn1Slot);
+    const float *input2 = ctx.getInputSamples(kIn2Slot);
 
-    return std::make_unique<Implementation>();
+    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
+      const float a = input1 != nullptr ? input1[sampleIndex] : 0.0f;
+      const float b = input2 != nullptr ? input2[sampleIndex] : 0.0f;
+      output[sampleIndex] = a * gain1 + b * gain2;
+    }
   }
+
+private:
+  enum PortSlot : int { kIn1Slot = 0, kIn2Slot, kOutSlot };
+
+  float gain1 = 1.0f;
+  float gain2 = 1.0f;
 };
-TEUL_NODE_AUTOREGISTER(StereoPannerNode);
 
 class Mixer2Node final : public TNodeClass {
 public:
@@ -220,60 +230,57 @@ public:
     desc.displayName = "Mixer (2-Ch)";
     desc.category = "Mixer";
     desc.capabilities.canMute = true;
+    desc.capabilities.tailLengthMs = 0.0f;
 
     desc.paramSpecs = {{"gain1", "Gain 1", 1.0f}, {"gain2", "Gain 2", 1.0f}};
     desc.portSpecs = {{TPortDirection::Input, TPortDataType::Audio, "In 1"},
                       {TPortDirection::Input, TPortDataType::Audio, "In 2"},
                       {TPortDirection::Output, TPortDataType::Audio, "Out"}};
+    desc.staticInstance = {"Teul::Nodes::Mixer2Instance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation final : public TNodeInstance {
-    public:
-      void setParameterValue(const juce::String &paramKey,
-                             float newValue) override {
-        if (paramKey == "gain1")
-          gain1 = juce::jlimit(0.0f, 2.0f, newValue);
-        else if (paramKey == "gain2")
-          gain2 = juce::jlimit(0.0f, 2.0f, newValue);
-      }
+    return std::make_unique<Mixer2Instance>();
+  }
+};
+TEUL_NODE_AUTOREGISTER(Mixer2Node);
 
-      void processSamples(const TProcessContext &ctx) override {
-        if (ctx.globalPortBuffer == nullptr)
-          return;
-
-        const int input1Channel = MixerNodeHelpers::findPortChannel(ctx, "In 1");
-        const int input2Channel = MixerNodeHelpers::findPortChannel(ctx, "In 2");
-        const int outputChannel = MixerNodeHelpers::findPortChannel(ctx, "Out");
-        if (outputChannel < 0)
-          return;
-
-        const int numSamples = ctx.globalPortBuffer->getNumSamples();
-        const float *input1 = input1Channel >= 0
-                                  ? ctx.globalPortBuffer->getReadPointer(input1Channel)
-                                  : nullptr;
-        const float *input2 = input2Channel >= 0
-                                  ? ctx.globalPortBuffer->getReadPointer(input2Channel)
-                                  : nullptr;
-        auto *output = ctx.globalPortBuffer->getWritePointer(outputChannel);
-
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
-          const float a = input1 != nullptr ? input1[sampleIndex] : 0.0f;
-          const float b = input2 != nullptr ? input2[sampleIndex] : 0.0f;
-          output[sampleIndex] = a * gain1 + b * gain2;
-        }
-      }
+class MonoMixer4Instance final : public TNodeInstance {
+public:
+  void setParameterValue(int paramIndex, float newValue) override {
+    if (paramIndex >= 0 && paramIndex < 4)
+      gains[(size_t)paramIndex] = juce::jlimit(0.0f, 2.0f, newValue);
+  }
+
+  void processSamples(const TProcessContext &ctx) override {
+    if (ctx.globalPortBuffer == nullptr)
+      return;
 
-    private:
-      float gain1 = 1.0f;
-      float gain2 = 1.0f;
-    };
+    auto *output = ctx.getOutputSamples(kOutSlot);
+    if (output == nullptr)
+      return;
 
-    return std::make_unique<Implementation>();
+    std::array<const float *, 4> inputs{};
+    for (int inputIndex = 0; inputIndex < 4; ++inputIndex)
+      inputs[(size_t)inputIndex] = ctx.getInputSamples(inputIndex);
+
+    const int numSamples = ctx.numSamples;
+    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
+      float mix = 0.0f;
+      for (size_t inputIndex = 0; inputIndex < gains.size(); ++inputIndex) {
+        if (inputs[inputIndex] != nullptr)
+          mix += inputs[inputIndex][sampleIndex] * gains[inputIndex];
+      }
+      output[sampleIndex] = mix;
+    }
   }
+
+private:
+  enum PortSlot : int { kOutSlot = 4 };
+
+  std::array<float, 4> gains{{1.0f, 1.0f, 1.0f, 1.0f}};
 };
-TEUL_NODE_AUTOREGISTER(Mixer2Node);
 
 class MonoMixer4Node final : public TNodeClass {
 public:
@@ -283,6 +290,7 @@ public:
     desc.displayName = "Mono Mixer (4-In)";
     desc.category = "Mixer";
     desc.capabilities.canMute = true;
+    desc.capabilities.tailLengthMs = 0.0f;
 
     std::vector<TParamSpec> params;
     params.reserve(4);
@@ -301,60 +309,65 @@ public:
                       {TPortDirection::Input, TPortDataType::Audio, "In 3"},
                       {TPortDirection::Input, TPortDataType::Audio, "In 4"},
                       {TPortDirection::Output, TPortDataType::Audio, "Out"}};
+    desc.staticInstance = {"Teul::Nodes::MonoMixer4Instance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation final : public TNodeInstance {
-    public:
-      void setParameterValue(const juce::String &paramKey,
-                             float newValue) override {
-        for (int inputIndex = 0; inputIndex < 4; ++inputIndex) {
-          if (paramKey == "gain" + juce::String(inputIndex + 1)) {
-            gains[(size_t)inputIndex] = juce::jlimit(0.0f, 2.0f, newValue);
-            return;
-          }
-        }
-      }
+    return std::make_unique<MonoMixer4Instance>();
+  }
+};
+TEUL_NODE_AUTOREGISTER(MonoMixer4Node);
 
-      void processSamples(const TProcessContext &ctx) override {
-        if (ctx.globalPortBuffer == nullptr)
-          return;
-
-        const int outputChannel = MixerNodeHelpers::findPortChannel(ctx, "Out");
-        if (outputChannel < 0)
-          return;
-
-        std::array<const float *, 4> inputs{};
-        for (int inputIndex = 0; inputIndex < 4; ++inputIndex) {
-          const int inputChannel = MixerNodeHelpers::findPortChannel(
-              ctx, "In " + juce::String(inputIndex + 1));
-          inputs[(size_t)inputIndex] =
-              inputChannel >= 0
-                  ? ctx.globalPortBuffer->getReadPointer(inputChannel)
-                  : nullptr;
-        }
-
-        auto *output = ctx.globalPortBuffer->getWritePointer(outputChannel);
-        const int numSamples = ctx.globalPortBuffer->getNumSamples();
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
-          float mix = 0.0f;
-          for (size_t inputIndex = 0; inputIndex < gains.size(); ++inputIndex) {
-            if (inputs[inputIndex] != nullptr)
-              mix += inputs[inputIndex][sampleIndex] * gains[inputIndex];
-          }
-          output[sampleIndex] = mix;
-        }
-      }
+class StereoMixer4Instance final : public TNodeInstance {
+public:
+  void setParameterValue(int paramIndex, float newValue) override {
+    if (paramIndex >= 0 && paramIndex < 4)
+      gains[(size_t)paramIndex] = juce::jlimit(0.0f, 2.0f, newValue);
+  }
+
+  void processSamples(const TProcessContext &ctx) override {
+    if (ctx.globalPortBuffer == nullptr)
+      return;
+
+    auto *leftOutput = ctx.getOutputSamples(kLeftOutSlot);
+    auto *rightOutput = ctx.getOutputSamples(kRightOutSlot);
+    if (leftOutput == nullptr && rightOutput == nullptr)
+      return;
+
+    // Input slots alternate L/R per bus: L In 1, R In 1, L In 2, ...
+    std::array<const float *, 4> leftInputs{};
+    std::array<const float *, 4> rightInputs{};
+    for (int busIndex = 0; busIndex < 4; ++busIndex) {
+      leftInputs[(size_t)busIndex] = ctx.getInputSamples(busIndex * 2);
+      rightInputs[(size_t)busIndex] = ctx.getInputSamples(busIndex * 2 + 1);
+    }
 
-    private:
-      std::array<float, 4> gains{{1.0f, 1.0f, 1.0f, 1.0f}};
-    };
+    const int numSamples = ctx.numSamples;
 
-    return std::make_unique<Implementation>();
+    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
+      float leftMix = 0.0f;
+      float rightMix = 0.0f;
+
+      for (size_t busIndex = 0; busIndex < gains.size(); ++busIndex) {
+        if (leftInputs[busIndex] != nullptr)
+          leftMix += leftInputs[busIndex][sampleIndex] * gains[busIndex];
+        if (rightInputs[busIndex] != nullptr)
+          rightMix += rightInputs[busIndex][sampleIndex] * gains[busIndex];
+      }
+
+      if (leftOutput != nullptr)
+        leftOutput[sampleIndex] = leftMix;
+      if (rightOutput != nullptr)
+        rightOutput[sampleIndex] = rightMix;
+    }
   }
+
+private:
+  enum PortSlot : int { kLeftOutSlot = 8, kRightOutSlot };
+
+  std::array<float, 4> gains{{1.0f, 1.0f, 1.0f, 1.0f}};
 };
-TEUL_NODE_AUTOREGISTER(MonoMixer4Node);
 
 class StereoMixer4Node final : public TNodeClass {
 public:
@@ -364,6 +377,7 @@ public:
     desc.displayName = "Stereo Mixer (4-Bus)";
     desc.category = "Mixer";
     desc.capabilities.canMute = true;
+    desc.capabilities.tailLengthMs = 0.0f;
 
     std::vector<TParamSpec> params;
     params.reserve(4);
@@ -387,84 +401,55 @@ public:
                       {TPortDirection::Input, TPortDataType::Audio, "R In 4"},
                       {TPortDirection::Output, TPortDataType::Audio, "L Out"},
                       {TPortDirection::Output, TPortDataType::Audio, "R Out"}};
+    desc.staticInstance = {"Teul::Nodes::StereoMixer4Instance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation final : public TNodeInstance {
-    public:
-      void setParameterValue(const juce::String &paramKey,
-                             float newValue) override {
-        for (int busIndex = 0; busIndex < 4; ++busIndex) {
-          if (paramKey == "gain" + juce::String(busIndex + 1)) {
-            gains[(size_t)busIndex] = juce::jlimit(0.0f, 2.0f, newValue);
-            return;
-          }
-        }
-      }
-
-      void processSamples(const TProcessContext &ctx) override {
-        if (ctx.globalPortBuffer == nullptr)
-          return;
-
-        const int leftOutputChannel = MixerNodeHelpers::findPortChannel(ctx, "L Out");
-        const int rightOutputChannel = MixerNodeHelpers::findPortChannel(ctx, "R Out");
-        if (leftOutputChannel < 0 && rightOutputChannel < 0)
-          return;
-
-        std::array<const float *, 4> leftInputs{};
-        std::array<const float *, 4> rightInputs{};
-        for (int busIndex = 0; busIndex < 4; ++busIndex) {
-          const juce::String suffix(busIndex + 1);
-          const int leftInputChannel =
-              MixerNodeHelpers::findPortChannel(ctx, "L In " + suffix);
-          const int rightInputChannel =
-              MixerNodeHelpers::findPortChannel(ctx, "R In " + suffix);
-
-          leftInputs[(size_t)busIndex] =
-              leftInputChannel >= 0
-                  ? ctx.globalPortBuffer->getReadPointer(leftInputChannel)
-                  : nullptr;
-          rightInputs[(size_t)busIndex] =
-              rightInputChannel >= 0
-                  ? ctx.globalPortBuffer->getReadPointer(rightInputChannel)
-                  : nullptr;
-        }
-
-        const int numSamples = ctx.globalPortBuffer->getNumSamples();
-        auto *leftOutput = leftOutputChannel >= 0
-                               ? ctx.globalPortBuffer->getWritePointer(leftOutputChannel)
-                               : nullptr;
-        auto *rightOutput = rightOutputChannel >= 0
-                                ? ctx.globalPortBuffer->getWritePointer(rightOutputChannel)
-                                : nullptr;
-
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
-          float leftMix = 0.0f;
-          float rightMix = 0.0f;
-
-          for (size_t busIndex = 0; busIndex < gains.size(); ++busIndex) {
-            if (leftInputs[busIndex] != nullptr)
-              leftMix += leftInputs[busIndex][sampleIndex] * gains[busIndex];
-            if (rightInputs[busIndex] != nullptr)
-              rightMix += rightInputs[busIndex][sampleIndex] * gains[busIndex];
-          }
-
-          if (leftOutput != nullptr)
-            leftOutput[sampleIndex] = leftMix;
-          if (rightOutput != nullptr)
-            rightOutput[sampleIndex] = rightMix;
-        }
-      }
+    return std::make_unique<StereoMixer4Instance>();
+  }
+};
+TEUL_NODE_AUTOREGISTER(StereoMixer4Node);
 
-    private:
-      std::array<float, 4> gains{{1.0f, 1.0f, 1.0f, 1.0f}};
-    };
+class AudioInputInstance final : public TNodeInstance {
+public:
+  void processSamples(const TProcessContext &ctx) override {
+    if (ctx.globalPortBuffer == nullptr || ctx.inputAudioBuffer == nullptr)
+      return;
+
+    auto *leftOutput = ctx.getOutputSamples(0);
+    auto *rightOutput = ctx.getOutputSamples(1);
+    if (leftOutput == nullptr && rightOutput == nullptr)
+      return;
+
+    const int availableInputChannels = ctx.inputAudioBuffer->getNumChannels();
+    const int numSamples =
+        juce::jmin(ctx.numSamples, ctx.inputAudioBuffer->getNumSamples());
+    if (numSamples <= 0 || availableInputChannels <= 0)
+      return;
+
+    const float *leftInput = availableInputChannels > 0
+                                 ? ctx.inputAudioBuffer->getReadPointer(0)
+                                 : nullptr;
+    const float *rightInput = availableInputChannels > 1
+                                  ? ctx.inputAudioBuffer->getReadPointer(1)
+                                  : leftInput;
+
+    if (leftOutput != nullptr) {
+      if (leftInput != nullptr)
+        juce::FloatVectorOperations::copy(leftOutput, leftInput, numSamples);
+      else
+        juce::FloatVectorOperations::clear(leftOutput, numSamples);
+    }
 
-    return std::make_unique<Implementation>();
+    if (rightOutput != nullptr) {
+      if (rightInput != nullptr)
+        juce::FloatVectorOperations::copy(rightOutput, rightInput, numSamples);
+      else
+        juce::FloatVectorOperations::clear(rightOutput, numSamples);
+    }
   }
 };
-TEUL_NODE_AUTOREGISTER(StereoMixer4Node);
 
 class AudioInputNode final : public TNodeClass {
 public:
@@ -479,59 +464,58 @@ public:
 
     desc.portSpecs = {{TPortDirection::Output, TPortDataType::Audio, "L Out"},
                       {TPortDirection::Output, TPortDataType::Audio, "R Out"}};
+    desc.staticInstance = {"Teul::Nodes::AudioInputInstance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation final : public TNodeInstance {
-    public:
-      void processSamples(const TProcessContext &ctx) override {
-        if (ctx.globalPortBuffer == nullptr || ctx.inputAudioBuffer == nullptr ||
-            ctx.nodeData == nullptr || ctx.portToChannel == nullptr) {
-          return;
-        }
-
-        const int leftChannel = MixerNodeHelpers::findPortChannel(ctx, "L Out");
-        const int rightChannel = MixerNodeHelpers::findPortChannel(ctx, "R Out");
-        if (leftChannel < 0 && rightChannel < 0)
-          return;
-
-        const int availableInputChannels = ctx.inputAudioBuffer->getNumChannels();
-        const int numSamples = juce::jmin(ctx.globalPortBuffer->getNumSamples(),
-                                          ctx.inputAudioBuffer->getNumSamples());
-        if (numSamples <= 0 || availableInputChannels <= 0)
-          return;
-
-        const float *leftInput = availableInputChannels > 0
-                                     ? ctx.inputAudioBuffer->getReadPointer(0)
-                                     : nullptr;
-        const float *rightInput = availableInputChannels > 1
-                                      ? ctx.inputAudioBuffer->getReadPointer(1)
-                                      : leftInput;
-
-        if (leftChannel >= 0) {
-          auto *leftOutput = ctx.globalPortBuffer->getWritePointer(leftChannel);
-          if (leftInput != nullptr)
-            juce::FloatVectorOperations::copy(leftOutput, leftInput, numSamples);
-          else
-            juce::FloatVectorOperations::clear(leftOutput, numSamples);
-        }
-
-        if (rightChannel >= 0) {
-          auto *rightOutput = ctx.globalPortBuffer->getWritePointer(rightChannel);
-          if (rightInput != nullptr)
-            juce::FloatVectorOperations::copy(rightOutput, rightInput, numSamples);
-          else
-            juce::FloatVectorOperations::clear(rightOutput, numSamples);
-        }
-      }
-    };
-
-    return std::make_unique<Implementation>();
+    return std::make_unique<AudioInputInstance>();
   }
 };
 TEUL_NODE_AUTOREGISTER(AudioInputNode);
 
+class AudioOutputInstance final : public TNodeInstance {
+public:
+  void setParameterValue(int paramIndex, float newValue) override {
+    if (paramIndex == 0)
+      volume = juce::jlimit(0.0f, 2.0f, newValue);
+  }
+
+  void processSamples(const TProcessContext &ctx) override {
+    if (ctx.globalPortBuffer == nullptr || ctx.deviceAudioBuffer == nullptr)
+      return;
+
+    const int numSamples =
+        juce::jmin(ctx.numSamples, ctx.deviceAudioBuffer->getNumSamples());
+    if (numSamples <= 0 || ctx.deviceAudioBuffer->getNumChannels() <= 0)
+      return;
+
+    const float *leftInput = ctx.getInputSamples(0);
+    const float *rightInput = ctx.getInputSamples(1);
+    if (rightInput == nullptr)
+      rightInput = leftInput;
+
+    auto *leftOutput = ctx.deviceAudioBuffer->getWritePointer(0);
+    float *rightOutput = ctx.deviceAudioBuffer->getNumChannels() > 1
+                             ? ctx.deviceAudioBuffer->getWritePointer(1)
+                             : nullptr;
+
+    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
+      const float leftSample =
+          (leftInput != nullptr ? leftInput[sampleIndex] : 0.0f) * volume;
+      const float rightSample =
+          (rightInput != nullptr ? rightInput[sampleIndex] : leftSample) * volume;
+
+      leftOutput[sampleIndex] += leftSample;
+      if (rightOutput != nullptr)
+        rightOutput[sampleIndex] += rightSample;
+    }
+  }
+
+private:
+  float volume = 1.0f;
+};
+
 class AudioOutputNode final : public TNodeClass {
 public:
   TNodeDescriptor makeDescriptor() const override {
@@ -544,67 +528,17 @@ public:
     desc.capabilities.canBypass = false;
     desc.capabilities.minInstances = 1;
     desc.capabilities.maxInstances = 1;
+    desc.capabilities.tailLengthMs = 0.0f;
 
     desc.paramSpecs = {{"volume", "Volume", 1.0f}};
     desc.portSpecs = {{TPortDirection::Input, TPortDataType::Audio, "L In"},
                       {TPortDirection::Input, TPortDataType::Audio, "R In"}};
+    desc.staticInstance = {"Teul::Nodes::AudioOutputInstance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation final : public TNodeInstance {
-    public:
-      void setParameterValue(const juce::String &paramKey,
-                             float newValue) override {
-        if (paramKey == "volume")
-          volume = juce::jlimit(0.0f, 2.0f, newValue);
-      }
-
-      void processSamples(const TProcessContext &ctx) override {
-        if (ctx.globalPortBuffer == nullptr || ctx.deviceAudioBuffer == nullptr)
-          return;
-
-        int leftInputChannel = MixerNodeHelpers::findPortChannel(ctx, "L In");
-        int rightInputChannel = MixerNodeHelpers::findPortChannel(ctx, "R In");
-        if (leftInputChannel < 0)
-          leftInputChannel = MixerNodeHelpers::findNthAudioInputChannel(ctx, 0);
-        if (rightInputChannel < 0)
-          rightInputChannel = MixerNodeHelpers::findNthAudioInputChannel(ctx, 1);
-
-        const int numSamples = juce::jmin(ctx.globalPortBuffer->getNumSamples(),
-                                          ctx.deviceAudioBuffer->getNumSamples());
-        if (numSamples <= 0 || ctx.deviceAudioBuffer->getNumChannels() <= 0)
-          return;
-
-        const float *leftInput = leftInputChannel >= 0
-                                     ? ctx.globalPortBuffer->getReadPointer(leftInputChannel)
-                                     : nullptr;
-        const float *rightInput = rightInputChannel >= 0
-                                      ? ctx.globalPortBuffer->getReadPointer(rightInputChannel)
-                                      : leftInput;
-
-        auto *leftOutput = ctx.deviceAudioBuffer->getWritePointer(0);
-        float *rightOutput = ctx.deviceAudioBuffer->getNumChannels() > 1
-                                 ? ctx.deviceAudioBuffer->getWritePointer(1)
-                                 : nullptr;
-
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
-          const float leftSample =
-              (leftInput != nullptr ? leftInput[sampleIndex] : 0.0f) * volume;
-          const float rightSample =
-              (rightInput != nullptr ? rightInput[sampleIndex] : leftSample) * volume;
-
-          leftOutput[sampleIndex] += leftSample;
-          if (rightOutput != nullptr)
-            rightOutput[sampleIndex] += rightSample;
-        }
-      }
-
-    private:
-      float volume = 1.0f;
-    };
-
-    return std::make_unique<Implementation>();
+    return std::make_unique<AudioOutputInstance>();
   }
 };
 TEUL_NODE_AUTOREGISTER(AudioOutputNode);
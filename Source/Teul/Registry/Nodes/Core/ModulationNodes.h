@@ -1,7 +1,167 @@
 #pragma once
+#include "../../../Runtime/TNodeInstance.h"
 #include "../../TNodeSDK.h"
 
+#include <array>
+#include <cmath>
+
 namespace Teul::Nodes {
+namespace ModulationNodeHelpers {
+
+// Envelope state of every voice, one lane per voice. Gate edges pick the
+// stage; the level update computes all three stage results and selects
+// one, so the lane loop stays branch free. Lanes are padded to a fixed
+// width; padding lanes read a closed gate and stay idle.
+struct EnvelopeLanes {
+  static constexpr int kMaxLanes = TVoiceAllocator::kMaxVoices;
+  static constexpr float kSilenceLevel = 1.0e-5f;
+  enum Stage : int { kIdle = 0, kAttack, kDecay, kRelease };
+
+  float attackStep = 0.0f;
+  float decayCoefficient = 0.0f;
+  float sustain = 0.5f;
+  float releaseCoefficient = 0.0f;
+
+  std::array<float, kMaxLanes> levels{};
+  std::array<float, kMaxLanes> gates{};
+  std::array<int, kMaxLanes> stages{};
+
+  void reset() noexcept {
+    levels.fill(0.0f);
+    gates.fill(0.0f);
+    stages.fill(kIdle);
+  }
+
+  // A lane with gate stride 0 reads one value for the whole block.
+  template <int LaneWidth>
+  void render(const float *const *gateInputs, const int *gateStrides,
+              float *const *outputs, int laneCount, int numSamples) noexcept {
+    std::array<float, LaneWidth> frame{};
+    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
+      for (std::size_t lane = 0; lane < LaneWidth; ++lane) {
+        const float gate =
+            gateInputs[lane][sampleIndex * gateStrides[lane]] > 0.5f ? 1.0f : 0.0f;
+        const bool opened = gate > gates[lane];
+        const bool closed = gate < gates[lane];
+        gates[lane] = gate;
+        stages[lane] = opened ? kAttack : (closed ? kRelease : stages[lane]);
+
+        const float level = levels[lane];
+        const float attacked = juce::jmin(1.0f, level + attackStep);
+        const float decayed = sustain + (level - sustain) * decayCoefficient;
+        const float released = level * releaseCoefficient;
+        const float next = stages[lane] == kAttack
+                               ? attacked
+                               : (stages[lane] == kDecay ? decayed : released);
+        stages[lane] = (stages[lane] == kAttack && next >= 1.0f) ? kDecay : stages[lane];
+        levels[lane] = next < kSilenceLevel && stages[lane] != kAttack ? 0.0f : next;
+        frame[lane] = levels[lane];
+      }
+
+      for (int lane = 0; lane < laneCount; ++lane) {
+        if (auto *output = outputs[lane])
+          output[sampleIndex] = frame[static_cast<std::size_t>(lane)];
+      }
+    }
+  }
+};
+
+} // namespace ModulationNodeHelpers
+
+class ADSRInstance final : public TNodeInstance {
+public:
+  ADSRInstance() { updateRates(); }
+
+  void prepareToPlay(double newSampleRate,
+                     int maximumExpectedSamplesPerBlock) override {
+    juce::ignoreUnused(maximumExpectedSamplesPerBlock);
+    sampleRate = juce::jmax(1.0, newSampleRate);
+    updateRates();
+  }
+
+  void reset() override { envelopes.reset(); }
+
+  void setParameterValue(int paramIndex, float newValue) override {
+    switch (paramIndex) {
+    case 0:
+      attackMs = juce::jlimit(0.0f, 5000.0f, newValue);
+      break;
+    case 1:
+      decayMs = juce::jlimit(0.0f, 5000.0f, newValue);
+      break;
+    case 2:
+      envelopes.sustain = juce::jlimit(0.0f, 1.0f, newValue);
+      return;
+    case 3:
+      releaseMs = juce::jlimit(0.0f, 5000.0f, newValue);
+      break;
+    default:
+      return;
+    }
+    updateRates();
+  }
+
+  void processSamples(const TProcessContext &ctx) override {
+    processVoices(&ctx, 1);
+  }
+
+  void processVoices(const TProcessContext *voiceContexts,
+                     int numVoices) override {
+    constexpr int kMaxLanes = ModulationNodeHelpers::EnvelopeLanes::kMaxLanes;
+    const int laneCount = juce::jmin(numVoices, kMaxLanes);
+    std::array<const float *, kMaxLanes> gateInputs{};
+    std::array<int, kMaxLanes> gateStrides{};
+    std::array<float, kMaxLanes> constantGates{};
+    std::array<float *, kMaxLanes> outputs{};
+    for (int lane = 0; lane < kMaxLanes; ++lane) {
+      const auto index = static_cast<std::size_t>(lane);
+      gateInputs[index] = &constantGates[index];
+      if (lane >= laneCount || voiceContexts[lane].globalPortBuffer == nullptr)
+        continue;
+
+      const auto &ctx = voiceContexts[lane];
+      outputs[index] = ctx.getOutputSamples(kEnvSlot);
+      const float *gate = ctx.getInputSamples(kGateSlot);
+      if (gate != nullptr && !ctx.getInputConstant(kGateSlot, constantGates[index])) {
+        gateInputs[index] = gate;
+        gateStrides[index] = 1;
+      }
+    }
+
+    const int numSamples = voiceContexts[0].numSamples;
+    if (laneCount <= 1) {
+      envelopes.render<1>(gateInputs.data(), gateStrides.data(), outputs.data(),
+                          laneCount, numSamples);
+    } else if (laneCount <= 4) {
+      envelopes.render<4>(gateInputs.data(), gateStrides.data(), outputs.data(),
+                          laneCount, numSamples);
+    } else {
+      envelopes.render<kMaxLanes>(gateInputs.data(), gateStrides.data(),
+                                  outputs.data(), laneCount, numSamples);
+    }
+  }
+
+private:
+  enum PortSlot : int { kGateSlot = 0, kEnvSlot };
+
+  // Decay and release cover 99% of their distance in the set time.
+  void updateRates() noexcept {
+    const auto samplesFor = [this](float milliseconds) {
+      return juce::jmax(1.0, (double)milliseconds * 0.001 * sampleRate);
+    };
+    envelopes.attackStep = static_cast<float>(1.0 / samplesFor(attackMs));
+    envelopes.decayCoefficient =
+        static_cast<float>(std::exp(std::log(0.01) / samplesFor(decayMs)));
+    envelopes.releaseCoefficient =
+        static_cast<float>(std::exp(std::log(0.01) / samplesFor(releaseMs)));
+  }
+
+  double sampleRate = 48000.0;
+  float attackMs = 10.0f;
+  float decayMs = 100.0f;
+  float releaseMs = 300.0f;
+  ModulationNodeHelpers::EnvelopeLanes envelopes;
+};
 
 class ADSRNode final : public TNodeClass {
 public:
@@ -33,10 +193,19 @@ public:
 
     desc.paramSpecs = {attack, decay, sustain, release};
 
+    desc.capabilities.maxPolyphony = TVoiceAllocator::kMaxVoices;
+
     desc.portSpecs = {{TPortDirection::Input, TPortDataType::Gate, "Gate"},
                       {TPortDirection::Output, TPortDataType::CV, "Env"}};
+    desc.portSpecs[0].acceptsConstant = true;
+    desc.staticInstance = {"Teul::Nodes::ADSRInstance", {}};
     return desc;
   }
+
+
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<ADSRInstance>();
+  }
 };
 
 TEUL_NODE_AUTOREGISTER(ADSRNode);
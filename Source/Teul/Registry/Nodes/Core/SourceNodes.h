@@ -1,42 +1,91 @@
 #pragma once
 #include "../../../Runtime/TNodeInstance.h"
+#include "../../../Runtime/TOscillatorBank.h"
+#include "../../../Runtime/TSampleStreamer.h"
 #include "../TNodeSDK.h"
 
 #include <cmath>
 
 namespace Teul::Nodes {
-namespace SourceNodeHelpers {
 
-static int findPortChannel(const TProcessContext &ctx,
-                           juce::StringRef portName) {
-  if (ctx.nodeData == nullptr || ctx.portToChannel == nullptr)
-    return -1;
+class OscillatorInstance final : public TNodeInstance {
+public:
+  void prepareToPlay(double newSampleRate,
+                     int maximumExpectedSamplesPerBlock) override {
+    juce::ignoreUnused(maximumExpectedSamplesPerBlock);
+    sampleRate = juce::jmax(1.0, newSampleRate);
+    TOscillatorTables::get();
+  }
 
-  for (const auto &port : ctx.nodeData->ports) {
-    if (port.name == portName) {
-      const auto it = ctx.portToChannel->find(port.portId);
-      return it != ctx.portToChannel->end() ? it->second : -1;
+  void reset() override { bank.reset(); }
+
+  void setParameterValue(int paramIndex, float newValue) override {
+    switch (paramIndex) {
+    case 0:
+      waveform = static_cast<TOscillatorWaveform>(
+          juce::jlimit(0, 3, juce::roundToInt(newValue)));
+      break;
+    case 1:
+      frequency = juce::jlimit(20.0f, 20000.0f, newValue);
+      break;
+    case 2:
+      gain = juce::jlimit(0.0f, 1.0f, newValue);
+      break;
+    default:
+      break;
     }
   }
 
-  return -1;
-}
-
-static float sampleWaveform(int waveform, float phase) {
-  switch (waveform) {
-  case 1:
-    return 1.0f - 4.0f * std::abs(phase - 0.5f);
-  case 2:
-    return phase < 0.5f ? 1.0f : -1.0f;
-  case 3:
-    return 1.0f - 2.0f * phase;
-  case 0:
-  default:
-    return std::sin(phase * juce::MathConstants<float>::twoPi);
+  void processSamples(const TProcessContext &ctx) override {
+    processVoices(&ctx, 1);
   }
-}
 
-} // namespace SourceNodeHelpers
+  // A block-constant pitch costs one exp2 per voice and block; only
+  // voices with audio-rate pitch pay for it per sample.
+  void processVoices(const TProcessContext *voiceContexts,
+                     int numVoices) override {
+    TOscillatorBank::Block block;
+    block.laneCount = juce::jmin(numVoices, TOscillatorBank::kLanes);
+    block.numSamples = voiceContexts[0].numSamples;
+    block.frequency = frequency;
+    block.maxFrequency = (float)(sampleRate * 0.45);
+    block.inverseSampleRate = 1.0f / (float)sampleRate;
+    block.gain = gain;
+    for (int lane = 0; lane < block.laneCount; ++lane) {
+      const auto index = static_cast<std::size_t>(lane);
+      const auto &ctx = voiceContexts[lane];
+      if (ctx.globalPortBuffer == nullptr)
+        continue;
+
+      block.outputs[index] = ctx.getOutputSamples(kOutSlot);
+      float laneFrequency = frequency;
+      float constantPitch = 0.0f;
+      if (ctx.isPortConnected(kPitchSlot)) {
+        if (ctx.getInputConstant(kPitchSlot, constantPitch)) {
+          laneFrequency *= fastExp2(constantPitch);
+        } else {
+          block.pitches[index] = ctx.getInputSamples(kPitchSlot);
+          block.audioRatePitch =
+              block.audioRatePitch || block.pitches[index] != nullptr;
+        }
+      }
+      block.increments[index] =
+          juce::jlimit(0.0f, block.maxFrequency, laneFrequency) *
+          block.inverseSampleRate;
+    }
+
+    bank.render(waveform, block);
+  }
+
+private:
+  enum PortSlot : int { kPitchSlot = 0, kSyncSlot, kOutSlot };
+
+  double sampleRate = 48000.0;
+  TOscillatorWaveform waveform = TOscillatorWaveform::Sine;
+  float frequency = 440.0f;
+  float gain = 0.707f;
+  TOscillatorBank bank;
+};
 
 class OscillatorNode final : public TNodeClass {
 public:
@@ -81,75 +130,61 @@ public:
     desc.portSpecs = {{TPortDirection::Input, TPortDataType::CV, "V/Oct"},
                       {TPortDirection::Input, TPortDataType::CV, "Sync"},
                       {TPortDirection::Output, TPortDataType::Audio, "Out"}};
+    desc.portSpecs[0].acceptsConstant = true;
+    desc.staticInstance = {"Teul::Nodes::OscillatorInstance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation final : public TNodeInstance {
-    public:
-      void prepareToPlay(double newSampleRate,
-                         int maximumExpectedSamplesPerBlock) override {
-        juce::ignoreUnused(maximumExpectedSamplesPerBlock);
-        sampleRate = juce::jmax(1.0, newSampleRate);
-      }
+    return std::make_unique<OscillatorInstance>();
+  }
+};
 
-      void reset() override { phase = 0.0f; }
+TEUL_NODE_AUTOREGISTER(OscillatorNode);
 
-      void setParameterValue(const juce::String &paramKey,
-                             float newValue) override {
-        if (paramKey == "waveform")
-          waveform = juce::jlimit(0, 3, juce::roundToInt(newValue));
-        else if (paramKey == "frequency")
-          frequency = juce::jlimit(20.0f, 20000.0f, newValue);
-        else if (paramKey == "gain")
-          gain = juce::jlimit(0.0f, 1.0f, newValue);
-      }
+class LFOInstance final : public TNodeInstance {
+public:
+  void prepareToPlay(double newSampleRate,
+                     int maximumExpectedSamplesPerBlock) override {
+    juce::ignoreUnused(maximumExpectedSamplesPerBlock);
+    sampleRate = juce::jmax(1.0, newSampleRate);
+    TOscillatorTables::get();
+  }
 
-      void processSamples(const TProcessContext &ctx) override {
-        if (ctx.globalPortBuffer == nullptr)
-          return;
-
-        const int outputChannel =
-            SourceNodeHelpers::findPortChannel(ctx, "Out");
-        if (outputChannel < 0)
-          return;
-
-        const int pitchChannel =
-            SourceNodeHelpers::findPortChannel(ctx, "V/Oct");
-        const int numSamples = ctx.globalPortBuffer->getNumSamples();
-        auto *output = ctx.globalPortBuffer->getWritePointer(outputChannel);
-        const float *pitch =
-            pitchChannel >= 0 ? ctx.globalPortBuffer->getReadPointer(pitchChannel)
-                              : nullptr;
-
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
-          float currentFrequency = frequency;
-          if (pitch != nullptr)
-            currentFrequency *= std::pow(2.0f, pitch[sampleIndex]);
-
-          currentFrequency = juce::jlimit(
-              0.0f, (float)(sampleRate * 0.45), currentFrequency);
-          output[sampleIndex] =
-              SourceNodeHelpers::sampleWaveform(waveform, phase) * gain;
-
-          phase += currentFrequency / (float)sampleRate;
-          phase -= std::floor(phase);
-        }
-      }
+  void reset() override { bank.reset(); }
+
+  void setParameterValue(int paramIndex, float newValue) override {
+    switch (paramIndex) {
+    case 0:
+      waveform = static_cast<TOscillatorWaveform>(
+          juce::jlimit(0, 3, juce::roundToInt(newValue)));
+      break;
+    case 1:
+      rate = juce::jlimit(0.01f, 20.0f, newValue);
+      break;
+    default:
+      break;
+    }
+  }
+
+  void processSamples(const TProcessContext &ctx) override {
+    if (ctx.globalPortBuffer == nullptr)
+      return;
 
-    private:
-      double sampleRate = 48000.0;
-      int waveform = 0;
-      float frequency = 440.0f;
-      float gain = 0.707f;
-      float phase = 0.0f;
-    };
+    auto *output = ctx.getOutputSamples(0);
+    if (output == nullptr)
+      return;
 
-    return std::make_unique<Implementation>();
+    bank.renderControl(waveform, rate / (float)sampleRate, output,
+                       ctx.numSamples);
   }
-};
 
-TEUL_NODE_AUTOREGISTER(OscillatorNode);
+private:
+  double sampleRate = 48000.0;
+  TOscillatorWaveform waveform = TOscillatorWaveform::Sine;
+  float rate = 1.0f;
+  TOscillatorBank bank;
+};
 
 class LFONode final : public TNodeClass {
 public:
@@ -178,60 +213,286 @@ public:
 
     desc.paramSpecs = {waveform, rate};
     desc.portSpecs = {{TPortDirection::Output, TPortDataType::CV, "Out"}};
+    desc.staticInstance = {"Teul::Nodes::LFOInstance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation final : public TNodeInstance {
-    public:
-      void prepareToPlay(double newSampleRate,
-                         int maximumExpectedSamplesPerBlock) override {
-        juce::ignoreUnused(maximumExpectedSamplesPerBlock);
-        sampleRate = juce::jmax(1.0, newSampleRate);
-      }
+    return std::make_unique<LFOInstance>();
+  }
+};
+
+TEUL_NODE_AUTOREGISTER(LFONode);
+
+class SamplerInstance final : public TNodeInstance {
+public:
+  ~SamplerInstance() override {
+    for (auto &voice : voices) {
+      if (voice.stream != nullptr)
+        TSampleStreamer::get().unregisterStream(*voice.stream);
+    }
+  }
+
+  void prepareToPlay(double newSampleRate,
+                     int maximumExpectedSamplesPerBlock) override {
+    juce::ignoreUnused(maximumExpectedSamplesPerBlock);
+    sampleRate = juce::jmax(1.0, newSampleRate);
+  }
+
+  void reset() override {
+    for (auto &voice : voices) {
+      stopVoice(voice);
+      voice.gateHigh = false;
+    }
+    freeRunStarted = false;
+  }
+
+  void setParameterValue(int paramIndex, float newValue) override {
+    if (paramIndex == 1)
+      gain = juce::jlimit(0.0f, 1.0f, newValue);
+  }
+
+  void setVoiceCount(int numVoices) override {
+    voiceCount = juce::jlimit(1, TVoiceAllocator::kMaxVoices, numVoices);
+  }
 
-      void reset() override { phase = 0.0f; }
+  // Called once, before the instance runs; one stream per voice is
+  // registered here so the audio thread only ever starts and stops them.
+  void setParameterText(int paramIndex, const juce::String &text) override {
+    const auto path = text.trim();
+    if (paramIndex != 0 || path.isEmpty() || source != nullptr)
+      return;
+
+    source = TSampleStreamer::get().openSource(
+        juce::File::isAbsolutePath(path)
+            ? juce::File(path)
+            : juce::File::getCurrentWorkingDirectory().getChildFile(path));
+    if (source == nullptr ||
+        source->getStorage() != TSampleSource::Storage::Streamed) {
+      return;
+    }
+
+    for (int voiceIndex = 0; voiceIndex < voiceCount; ++voiceIndex) {
+      auto &voice = voices[static_cast<std::size_t>(voiceIndex)];
+      voice.stream = std::make_unique<TSampleStream>();
+      TSampleStreamer::get().registerStream(*voice.stream, *source);
+    }
+  }
+
+  void processSamples(const TProcessContext &ctx) override {
+    processVoices(&ctx, 1);
+  }
 
-      void setParameterValue(const juce::String &paramKey,
-                             float newValue) override {
-        if (paramKey == "waveform")
-          waveform = juce::jlimit(0, 3, juce::roundToInt(newValue));
-        else if (paramKey == "rate")
-          rate = juce::jlimit(0.01f, 20.0f, newValue);
+  void processVoices(const TProcessContext *voiceContexts,
+                     int numVoices) override {
+    const int renderedVoices = juce::jmin(numVoices, voiceCount);
+    for (int voiceIndex = 0; voiceIndex < renderedVoices; ++voiceIndex) {
+      const auto &ctx = voiceContexts[voiceIndex];
+      if (ctx.globalPortBuffer == nullptr)
+        continue;
+
+      auto &voice = voices[static_cast<std::size_t>(voiceIndex)];
+      if (voiceIndex == 0 && !freeRunStarted && !ctx.isPortConnected(kGateSlot)) {
+        freeRunStarted = true;
+        startVoice(voice);
       }
+      renderVoice(voice, ctx);
+    }
+  }
+
+private:
+  enum PortSlot : int { kGateSlot = 0, kLeftOutSlot, kRightOutSlot };
+  enum : int { kWindowFrames = 256 };
+
+  // Frames around the playhead; refilled from the resident part of the
+  // source or from the voice's stream as the playhead moves on.
+  struct Voice {
+    std::array<float, kWindowFrames> left{};
+    std::array<float, kWindowFrames> right{};
+    std::unique_ptr<TSampleStream> stream;
+    juce::int64 windowStart = 0;
+    int windowCount = 0;
+    double position = 0.0;
+    bool playing = false;
+    bool gateHigh = false;
+  };
+
+  void startVoice(Voice &voice) noexcept {
+    if (source == nullptr)
+      return;
+
+    voice.position = 0.0;
+    voice.windowStart = 0;
+    voice.windowCount = 0;
+    voice.playing = true;
+    if (voice.stream != nullptr)
+      voice.stream->start(source->getResidentFrames());
+  }
+
+  void stopVoice(Voice &voice) noexcept {
+    voice.playing = false;
+    if (voice.stream != nullptr)
+      voice.stream->stop();
+  }
 
-      void processSamples(const TProcessContext &ctx) override {
-        if (ctx.globalPortBuffer == nullptr)
-          return;
+  int fetchFrames(Voice &voice, juce::int64 startFrame, float *left,
+                  float *right, int numFrames) noexcept {
+    int fetched = source->readResident(startFrame, left, right, numFrames);
+    if (fetched < numFrames && voice.stream != nullptr) {
+      fetched += voice.stream->read(startFrame + fetched, left + fetched,
+                                    right + fetched, numFrames - fetched);
+    }
+    return fetched;
+  }
 
-        const int outputChannel =
-            SourceNodeHelpers::findPortChannel(ctx, "Out");
-        if (outputChannel < 0)
-          return;
+  // Slides the window so it holds frame and frame + 1. Frames past the
+  // end of the file read as silence; frames the stream has not read
+  // yet also do, and count as an underrun.
+  void ensureWindow(Voice &voice, juce::int64 frame) noexcept {
+    const juce::int64 windowEnd = voice.windowStart + voice.windowCount;
+    if (frame >= voice.windowStart && frame + 1 < windowEnd)
+      return;
+
+    int kept = 0;
+    if (frame >= voice.windowStart && frame < windowEnd) {
+      kept = static_cast<int>(windowEnd - frame);
+      const auto offset = static_cast<std::size_t>(frame - voice.windowStart);
+      std::copy_n(voice.left.begin() + offset, kept, voice.left.begin());
+      std::copy_n(voice.right.begin() + offset, kept, voice.right.begin());
+    }
 
-        const int numSamples = ctx.globalPortBuffer->getNumSamples();
-        auto *output = ctx.globalPortBuffer->getWritePointer(outputChannel);
+    const juce::int64 fetchStart = frame + kept;
+    const int wanted = kWindowFrames - kept;
+    const int fetched = fetchFrames(voice, fetchStart, voice.left.data() + kept,
+                                    voice.right.data() + kept, wanted);
+    std::fill(voice.left.begin() + kept + fetched, voice.left.end(), 0.0f);
+    std::fill(voice.right.begin() + kept + fetched, voice.right.end(), 0.0f);
+    if (fetchStart + fetched < juce::jmin(source->getLengthInFrames(),
+                                          fetchStart + wanted)) {
+      TSampleStreamer::get().noteUnderrun();
+    }
 
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
-          output[sampleIndex] =
-              SourceNodeHelpers::sampleWaveform(waveform, phase);
-          phase += rate / (float)sampleRate;
-          phase -= std::floor(phase);
-        }
+    voice.windowStart = frame;
+    voice.windowCount = kWindowFrames;
+  }
+
+  void renderVoice(Voice &voice, const TProcessContext &ctx) noexcept {
+    auto *left = ctx.getOutputSamples(kLeftOutSlot);
+    auto *right = ctx.getOutputSamples(kRightOutSlot);
+    if (left != nullptr)
+      juce::FloatVectorOperations::clear(left, ctx.numSamples);
+    if (right != nullptr)
+      juce::FloatVectorOperations::clear(right, ctx.numSamples);
+    if (source == nullptr)
+      return;
+
+    const float *gate =
+        ctx.isPortConnected(kGateSlot) ? ctx.getInputSamples(kGateSlot) : nullptr;
+    const double step = source->getSampleRate() / sampleRate;
+    const juce::int64 length = source->getLengthInFrames();
+    for (int sampleIndex = 0; sampleIndex < ctx.numSamples; ++sampleIndex) {
+      if (gate != nullptr) {
+        const bool high = gate[sampleIndex] > 0.5f;
+        if (high && !voice.gateHigh)
+          startVoice(voice);
+        voice.gateHigh = high;
       }
+      if (!voice.playing)
+        continue;
 
-    private:
-      double sampleRate = 48000.0;
-      int waveform = 0;
-      float rate = 1.0f;
-      float phase = 0.0f;
-    };
+      const auto frame = static_cast<juce::int64>(voice.position);
+      if (frame >= length) {
+        stopVoice(voice);
+        continue;
+      }
 
-    return std::make_unique<Implementation>();
+      ensureWindow(voice, frame);
+      const auto index = static_cast<std::size_t>(frame - voice.windowStart);
+      const float fraction = static_cast<float>(voice.position - (double)frame);
+      if (left != nullptr) {
+        left[sampleIndex] =
+            gain * (voice.left[index] +
+                    (voice.left[index + 1] - voice.left[index]) * fraction);
+      }
+      if (right != nullptr) {
+        right[sampleIndex] =
+            gain * (voice.right[index] +
+                    (voice.right[index + 1] - voice.right[index]) * fraction);
+      }
+      voice.position += step;
+    }
   }
+
+  double sampleRate = 48000.0;
+  float gain = 1.0f;
+  int voiceCount = 1;
+  bool freeRunStarted = false;
+  std::shared_ptr<const TSampleSource> source;
+  std::array<Voice, TVoiceAllocator::kMaxVoices> voices;
 };
 
-TEUL_NODE_AUTOREGISTER(LFONode);
+class SamplerNode final : public TNodeClass {
+public:
+  TNodeDescriptor makeDescriptor() const override {
+    TNodeDescriptor desc;
+    desc.typeKey = "Teul.Source.Sampler";
+    desc.displayName = "Sampler";
+    desc.category = "Source";
+
+    desc.capabilities.canMute = true;
+    desc.capabilities.maxPolyphony = TVoiceAllocator::kMaxVoices;
+
+    TParamSpec file;
+    file.key = "file";
+    file.label = "File";
+    file.defaultValue = juce::String();
+    file.valueType = TParamValueType::String;
+    file.preferredWidget = TParamWidgetHint::Text;
+    file.isAutomatable = false;
+    file.isModulatable = false;
+    file.isDiscrete = true;
+    file.group = "Source";
+    file.description = "Audio file to play; anything juce_audio_formats decodes.";
+    file.exportSymbol = "samplerFile";
+    file.categoryPath = "Sampler/Source";
+
+    auto gain = makeFloatParamSpec("gain", "Gain", 1.0f, 0.0f, 1.0f, 0.001f,
+                                   {}, 3, "Output", "Linear output gain.");
+    gain.showInNodeBody = true;
+    gain.categoryPath = "Sampler/Output";
+
+    desc.paramSpecs = {file, gain};
+    desc.portSpecs = {makePortSpec(TPortDirection::Input, TPortDataType::Gate, "Gate"),
+                      makePortSpec(TPortDirection::Output, TPortDataType::Audio, 2,
+                                   {"L Out", "R Out"})};
+    desc.staticInstance = {"Teul::Nodes::SamplerInstance", {}};
+    return desc;
+  }
+
+  // A rising gate plays the file from the start; with the gate unconnected
+  // the first voice plays it once after a reset. Playback follows the
+  // file's sample rate through linear interpolation.
+  std::unique_ptr<TNodeInstance> createInstance() const override {
+    return std::make_unique<SamplerInstance>();
+  }
+};
+
+TEUL_NODE_AUTOREGISTER(SamplerNode);
+
+class ConstantInstance final : public TNodeInstance {
+public:
+  void setParameterValue(int paramIndex, float newValue) override {
+    if (paramIndex == 0)
+      value = newValue;
+  }
+
+  void processSamples(const TProcessContext &ctx) override {
+    ctx.setOutputConstant(0, value);
+  }
+
+private:
+  float value = 1.0f;
+};
 
 class ConstantNode final : public TNodeClass {
 public:
@@ -243,38 +504,12 @@ public:
     desc.capabilities.canMute = true;
     desc.paramSpecs = {{"value", "Value", 1.0f}};
     desc.portSpecs = {{TPortDirection::Output, TPortDataType::CV, "Value"}};
+    desc.staticInstance = {"Teul::Nodes::ConstantInstance", {}};
     return desc;
   }
 
   std::unique_ptr<TNodeInstance> createInstance() const override {
-    class Implementation final : public TNodeInstance {
-    public:
-      void setParameterValue(const juce::String &paramKey,
-                             float newValue) override {
-        if (paramKey == "value")
-          value = newValue;
-      }
-
-      void processSamples(const TProcessContext &ctx) override {
-        if (ctx.globalPortBuffer == nullptr)
-          return;
-
-        const int outputChannel =
-            SourceNodeHelpers::findPortChannel(ctx, "Value");
-        if (outputChannel < 0)
-          return;
-
-        const int numSamples = ctx.globalPortBuffer->getNumSamples();
-        auto *output = ctx.globalPortBuffer->getWritePointer(outputChannel);
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
-          output[sampleIndex] = value;
-      }
-
-    private:
-      float value = 1.0f;
-    };
-
-    return std::make_unique<Implementation>();
+    return std::make_unique<ConstantInstance>();
   }
 };
 
@@ -100,6 +100,10 @@ struct TPortSpec {
 
   int maxIncomingConnections = 1;
   int maxOutgoingConnections = -1;
+
+  // Input only: the node checks getInputConstant before reading samples,
+  // so block constants feeding this port are not expanded.
+  bool acceptsConstant = false;
 };
 
 // 1) 기본 Mono 포트 생성
@@ -156,6 +160,22 @@ struct TNodeCapabilities {
   int maxPolyphony = 1;
   float processingLatencyMs = 0.0f;
   int estimatedCpuCost = 1;
+
+  // Silence contract. A value >= 0 promises that once every input has been
+  // silent for this long the outputs are silent too, so the runtime may skip
+  // processSamples. -1 (unknown) keeps the node running every block, which
+  // generators and time-dependent nodes without a bounded tail need.
+  float tailLengthMs = -1.0f;
+
+  // Load shedding. -1 keeps the node running under any load; otherwise the
+  // runtime may bypass it while the graph overruns its budget, lowest
+  // priority first and the costliest first within a priority.
+  int shedPriority = -1;
+
+  // Polyphony. A node that allocates voices starts a region with as many
+  // voices as its "voices" parameter asks for; nodes it feeds join the
+  // region while their maxPolyphony covers that count.
+  bool allocatesVoices = false;
 };
 
 enum class TNodeExportSupport {
@@ -167,6 +187,17 @@ enum class TNodeExportSupport {
 
 class TNodeInstance;
 
+// Instance class a compiled RuntimeModule declares for the node, and the
+// arguments it is constructed with. The class must be a final
+// TNodeInstance reachable from CoreNodes.h; nodes without one only run
+// under TGraphRuntime.
+struct TNodeStaticInstance {
+  juce::String className;
+  juce::String constructorArguments;
+
+  bool isValid() const noexcept { return className.isNotEmpty(); }
+};
+
 struct TNodeDescriptor {
   juce::String typeKey;
   juce::String displayName;
@@ -174,6 +205,7 @@ struct TNodeDescriptor {
 
   TNodeCapabilities capabilities;
   TNodeExportSupport exportSupport = TNodeExportSupport::Both;
+  TNodeStaticInstance staticInstance;
 
   std::vector<TParamSpec> paramSpecs;
   std::vector<TPortSpec> portSpecs;
@@ -0,0 +1,116 @@
+#include "TBlockLatencyMonitor.h"
+
+#include <cmath>
+
+namespace Teul {
+namespace {
+
+constexpr float kMinLoad = 1.0f / 128.0f;
+constexpr int kStepsPerOctave = 8;
+
+} // namespace
+
+TBlockLatencyMonitor::TBlockLatencyMonitor() = default;
+
+void TBlockLatencyMonitor::recordBlock(float load) noexcept {
+  if (!(load >= 0.0f))
+    return;
+
+  buckets[static_cast<std::size_t>(bucketForLoad(load))].fetch_add(
+      1, std::memory_order_relaxed);
+  if (load > 1.0f)
+    overBudgetCount.fetch_add(1, std::memory_order_relaxed);
+  if (load > maxLoad.load(std::memory_order_relaxed))
+    maxLoad.store(load, std::memory_order_relaxed);
+}
+
+void TBlockLatencyMonitor::recordXrun(const XrunRecord &record) noexcept {
+  xruns.push(record);
+}
+
+void TBlockLatencyMonitor::reset() noexcept {
+  for (auto &bucket : buckets)
+    bucket.store(0, std::memory_order_relaxed);
+  overBudgetCount.store(0, std::memory_order_relaxed);
+  maxLoad.store(0.0f, std::memory_order_relaxed);
+  firstVisibleXrun.store(xruns.getCount(), std::memory_order_relaxed);
+}
+
+TBlockLatencyMonitor::LoadSummary
+TBlockLatencyMonitor::summarize() const noexcept {
+  std::array<std::uint64_t, kBucketCount> counts{};
+  LoadSummary summary;
+  for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+    counts[static_cast<std::size_t>(bucket)] =
+        buckets[static_cast<std::size_t>(bucket)].load(std::memory_order_relaxed);
+    summary.blockCount += counts[static_cast<std::size_t>(bucket)];
+  }
+
+  summary.overBudgetCount = overBudgetCount.load(std::memory_order_relaxed);
+  summary.maxLoad = maxLoad.load(std::memory_order_relaxed);
+  if (summary.blockCount == 0)
+    return summary;
+
+  const auto percentile = [&](double fraction) {
+    const auto rank = juce::jmax<std::uint64_t>(
+        1, static_cast<std::uint64_t>(
+               std::ceil(fraction * static_cast<double>(summary.blockCount))));
+    std::uint64_t cumulative = 0;
+    for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+      cumulative += counts[static_cast<std::size_t>(bucket)];
+      if (cumulative >= rank)
+        return juce::jmin(bucketUpperLoad(bucket), summary.maxLoad);
+    }
+    return summary.maxLoad;
+  };
+
+  summary.p50Load = percentile(0.50);
+  summary.p99Load = percentile(0.99);
+  summary.p999Load = percentile(0.999);
+  return summary;
+}
+
+std::vector<TBlockLatencyMonitor::Bucket> TBlockLatencyMonitor::getHistogram() const {
+  std::vector<Bucket> histogram;
+  for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+    const auto count =
+        buckets[static_cast<std::size_t>(bucket)].load(std::memory_order_relaxed);
+    if (count > 0)
+      histogram.push_back({bucketUpperLoad(bucket), count});
+  }
+
+  return histogram;
+}
+
+std::vector<TBlockLatencyMonitor::XrunRecord>
+TBlockLatencyMonitor::getRecentXruns() const {
+  return xruns.readRecent(firstVisibleXrun.load(std::memory_order_relaxed));
+}
+
+// Bucket 0 holds everything under 1/128 of the budget; after that each
+// octave is split into eight linear steps. The last bucket also takes
+// every block beyond 32 budgets.
+int TBlockLatencyMonitor::bucketForLoad(float load) noexcept {
+  if (load < kMinLoad)
+    return 0;
+
+  int exponent = 0;
+  const float mantissa = std::frexp(load / kMinLoad, &exponent);
+  const int octave = exponent - 1;
+  const int step = juce::jlimit(
+      0, kStepsPerOctave - 1,
+      static_cast<int>((mantissa * 2.0f - 1.0f) * static_cast<float>(kStepsPerOctave)));
+  return juce::jmin(kBucketCount - 1, 1 + octave * kStepsPerOctave + step);
+}
+
+float TBlockLatencyMonitor::bucketUpperLoad(int bucket) noexcept {
+  if (bucket <= 0)
+    return kMinLoad;
+
+  const int octave = (bucket - 1) / kStepsPerOctave;
+  const int step = (bucket - 1) % kStepsPerOctave;
+  return kMinLoad * std::ldexp(1.0f, octave) *
+         (1.0f + static_cast<float>(step + 1) / static_cast<float>(kStepsPerOctave));
+}
+
+} // namespace Teul
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../Model/TTypes.h"
+#include "TSeqlockRing.h"
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace Teul {
+
+// Long-running record of block processing time. Every block's load (time
+// spent over the block's real-time budget) lands in a log-scale histogram
+// with eight steps per octave from 1/128 of the budget, so percentiles stay
+// accurate to about 6% across a whole show. Blocks that overrun the budget
+// are also kept in a ring of the most recent kMaxXruns records. The audio
+// thread is the only writer; readers may call from any thread.
+class TBlockLatencyMonitor {
+public:
+  static constexpr int kBucketCount = 97;
+  static constexpr int kMaxXruns = 64;
+  static constexpr int kTopNodeCount = 3;
+  static constexpr int kParamBurstThreshold = 32;
+
+  struct NodeCost {
+    NodeId nodeId = kInvalidNodeId;
+    float micros = 0.0f;
+  };
+
+  struct XrunRecord {
+    std::uint64_t blockIndex = 0;
+    juce::int64 timeMillis = 0;
+    std::uint64_t generation = 0;
+    float elapsedMicros = 0.0f;
+    float budgetMicros = 0.0f;
+    int numSamples = 0;
+    int paramChanges = 0;
+    bool rebuildCommitted = false;
+    bool paramBurst = false;
+    std::array<NodeCost, kTopNodeCount> topNodes{};
+  };
+
+  struct LoadSummary {
+    std::uint64_t blockCount = 0;
+    std::uint64_t overBudgetCount = 0;
+    float p50Load = 0.0f;
+    float p99Load = 0.0f;
+    float p999Load = 0.0f;
+    float maxLoad = 0.0f;
+  };
+
+  struct Bucket {
+    float upperLoad = 0.0f;
+    std::uint64_t count = 0;
+  };
+
+  TBlockLatencyMonitor();
+
+  // Audio thread. load is elapsed time divided by the block budget.
+  void recordBlock(float load) noexcept;
+  void recordXrun(const XrunRecord &record) noexcept;
+
+  // Clears the histogram and hides earlier xruns. Safe to call while the
+  // audio thread records; a block racing the reset may land on either side.
+  void reset() noexcept;
+
+  LoadSummary summarize() const noexcept;
+  std::vector<Bucket> getHistogram() const;
+  std::vector<XrunRecord> getRecentXruns() const;
+
+private:
+  static int bucketForLoad(float load) noexcept;
+  static float bucketUpperLoad(int bucket) noexcept;
+
+  std::array<std::atomic<std::uint64_t>, kBucketCount> buckets{};
+  std::atomic<std::uint64_t> overBudgetCount{0};
+  std::atomic<float> maxLoad{0.0f};
+  TSeqlockRing<XrunRecord, kMaxXruns> xruns;
+  std::atomic<std::uint64_t> firstVisibleXrun{0};
+};
+
+} // namespace Teul
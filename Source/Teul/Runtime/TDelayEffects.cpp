@@ -0,0 +1,209 @@
+#include "TDelayEffects.h"
+
+#include <cmath>
+
+namespace Teul {
+namespace {
+
+// Mutually prime line lengths, spread so the echo density builds quickly.
+constexpr std::array<float, TFeedbackDelayNetwork::kLines> kLineLengthsMs = {
+    31.3f, 37.7f, 41.9f, 45.1f, 52.7f, 56.9f, 62.3f, 68.3f};
+constexpr float kReverbInputGain = 0.35f;
+constexpr float kReverbOutputGain = 0.35f;
+
+} // namespace
+
+void TStereoDelay::prepare(double newSampleRate) {
+  const bool rateChanged = newSampleRate != sampleRate;
+  sampleRate = juce::jmax(1.0, newSampleRate);
+  const int required = static_cast<int>(
+                           std::ceil(kMaxDelayMs * 0.001 * sampleRate)) + 2;
+  if (!lines.isValid() || capacity < TDelayLinePool::capacityFor(required)) {
+    lines = TDelayLinePool::get().acquire(2 * TDelayLinePool::capacityFor(required));
+    capacity = lines.size() / 2;
+    writeIndex = 0;
+  } else if (rateChanged) {
+    reset();
+  }
+  delaySamples = -1.0;
+}
+
+void TStereoDelay::reset() noexcept {
+  if (lines.isValid())
+    std::fill_n(lines.data(), lines.size(), 0.0f);
+  writeIndex = 0;
+  delaySamples = -1.0;
+}
+
+void TStereoDelay::setDelayMs(float newDelayMs) noexcept {
+  delayMs = juce::jlimit(1.0f, kMaxDelayMs, newDelayMs);
+}
+
+void TStereoDelay::setFeedback(float newFeedback) noexcept {
+  feedback = juce::jlimit(0.0f, 0.98f, newFeedback);
+}
+
+void TStereoDelay::setMix(float newMix) noexcept {
+  mix = juce::jlimit(0.0f, 1.0f, newMix);
+}
+
+void TStereoDelay::render(const Block &block) noexcept {
+  if (!lines.isValid() || block.numSamples <= 0)
+    return;
+
+  const int mask = capacity - 1;
+  const double targetDelay =
+      juce::jlimit(1.0, (double)(capacity - 2), delayMs * 0.001 * sampleRate);
+  if (delaySamples < 0.0)
+    delaySamples = targetDelay;
+  const double delayStep = (targetDelay - delaySamples) / block.numSamples;
+
+  const float silence = 0.0f;
+  std::array<const float *, 2> inputs{};
+  std::array<int, 2> strides{};
+  std::array<float *, 2> bases{};
+  for (std::size_t channel = 0; channel < 2; ++channel) {
+    inputs[channel] = block.inputs[channel] != nullptr ? block.inputs[channel] : &silence;
+    strides[channel] = block.inputs[channel] != nullptr ? 1 : 0;
+    bases[channel] = lines.data() + channel * static_cast<std::size_t>(capacity);
+  }
+
+  std::array<float, 2> frame{};
+  for (int sampleIndex = 0; sampleIndex < block.numSamples; ++sampleIndex) {
+    delaySamples += delayStep;
+    const double readPosition = writeIndex - delaySamples + capacity;
+    const int readIndex = static_cast<int>(readPosition);
+    const float fraction = static_cast<float>(readPosition - readIndex);
+    for (std::size_t channel = 0; channel < 2; ++channel) {
+      const float *line = bases[channel];
+      const float older = line[readIndex & mask];
+      const float newer = line[(readIndex + 1) & mask];
+      const float delayed = older + (newer - older) * fraction;
+      const float dry = inputs[channel][sampleIndex * strides[channel]];
+      bases[channel][writeIndex] = dry + feedback * delayed;
+      frame[channel] = dry + mix * (delayed - dry);
+    }
+
+    for (std::size_t channel = 0; channel < 2; ++channel) {
+      if (auto *output = block.outputs[channel])
+        output[sampleIndex] = frame[channel];
+    }
+    writeIndex = (writeIndex + 1) & mask;
+  }
+  delaySamples = targetDelay;
+}
+
+void TFeedbackDelayNetwork::prepare(double newSampleRate) {
+  const bool rateChanged = newSampleRate != sampleRate;
+  sampleRate = juce::jmax(1.0, newSampleRate);
+  for (std::size_t line = 0; line < kLines; ++line) {
+    lengths[line] = juce::jmax(
+        1, static_cast<int>(std::round(kLineLengthsMs[line] * 0.001 * sampleRate)));
+  }
+
+  const int required = TDelayLinePool::capacityFor(lengths[kLines - 1] + 1);
+  if (!memory.isValid() || capacity != required) {
+    memory = TDelayLinePool::get().acquire(kLines * required);
+    capacity = required;
+    writeIndex = 0;
+    lowpassStates.fill(0.0f);
+  } else if (rateChanged) {
+    reset();
+  }
+  updateLineGains();
+}
+
+void TFeedbackDelayNetwork::reset() noexcept {
+  if (memory.isValid())
+    std::fill_n(memory.data(), memory.size(), 0.0f);
+  lowpassStates.fill(0.0f);
+  writeIndex = 0;
+}
+
+void TFeedbackDelayNetwork::setRoomSize(float newRoomSize) noexcept {
+  newRoomSize = juce::jlimit(0.0f, 1.0f, newRoomSize);
+  if (newRoomSize != roomSize) {
+    roomSize = newRoomSize;
+    updateLineGains();
+  }
+}
+
+void TFeedbackDelayNetwork::setDamping(float newDamping) noexcept {
+  dampingCoefficient = 0.7f * juce::jlimit(0.0f, 1.0f, newDamping);
+}
+
+void TFeedbackDelayNetwork::setWidth(float newWidth) noexcept {
+  width = juce::jlimit(0.0f, 1.0f, newWidth);
+}
+
+void TFeedbackDelayNetwork::setMix(float newMix) noexcept {
+  mix = juce::jlimit(0.0f, 1.0f, newMix);
+}
+
+// A line of length n loses 60 dB over the decay time when it is scaled by
+// 10^(-3n / (decay * sampleRate)) on every pass.
+void TFeedbackDelayNetwork::updateLineGains() noexcept {
+  const double decaySeconds = 0.3 + 4.7 * roomSize;
+  for (std::size_t line = 0; line < kLines; ++line) {
+    lineGains[line] = static_cast<float>(
+        std::pow(10.0, -3.0 * lengths[line] / (decaySeconds * sampleRate)));
+  }
+}
+
+void TFeedbackDelayNetwork::render(const Block &block) noexcept {
+  if (!memory.isValid() || block.numSamples <= 0)
+    return;
+
+  const int mask = capacity - 1;
+  const float silence = 0.0f;
+  std::array<const float *, 2> inputs{};
+  std::array<int, 2> strides{};
+  for (std::size_t channel = 0; channel < 2; ++channel) {
+    inputs[channel] = block.inputs[channel] != nullptr ? block.inputs[channel] : &silence;
+    strides[channel] = block.inputs[channel] != nullptr ? 1 : 0;
+  }
+
+  std::array<float *, kLines> lines{};
+  for (std::size_t line = 0; line < kLines; ++line)
+    lines[line] = memory.data() + line * static_cast<std::size_t>(capacity);
+
+  const float direct = 0.5f + 0.5f * width;
+  const float cross = 0.5f - 0.5f * width;
+  std::array<float, kLines> outputs{};
+  for (int sampleIndex = 0; sampleIndex < block.numSamples; ++sampleIndex) {
+    const float dryLeft = inputs[0][sampleIndex * strides[0]];
+    const float dryRight = inputs[1][sampleIndex * strides[1]];
+
+    float sum = 0.0f;
+    for (std::size_t line = 0; line < kLines; ++line) {
+      outputs[line] = lines[line][(writeIndex - lengths[line]) & mask];
+      lowpassStates[line] =
+          outputs[line] + dampingCoefficient * (lowpassStates[line] - outputs[line]);
+      sum += lowpassStates[line];
+    }
+
+    const float reflection = sum * (2.0f / kLines);
+    float wetLeft = 0.0f;
+    float wetRight = 0.0f;
+    for (std::size_t line = 0; line < kLines; ++line) {
+      const bool left = (line & 1u) == 0;
+      const float feed = kReverbInputGain * (left ? dryLeft : dryRight);
+      lines[line][writeIndex] =
+          feed + lineGains[line] * (lowpassStates[line] - reflection);
+      wetLeft += left ? outputs[line] : 0.0f;
+      wetRight += left ? 0.0f : outputs[line];
+    }
+
+    wetLeft *= kReverbOutputGain;
+    wetRight *= kReverbOutputGain;
+    const float left = dryLeft + mix * (direct * wetLeft + cross * wetRight - dryLeft);
+    const float right = dryRight + mix * (direct * wetRight + cross * wetLeft - dryRight);
+    if (block.outputs[0] != nullptr)
+      block.outputs[0][sampleIndex] = left;
+    if (block.outputs[1] != nullptr)
+      block.outputs[1][sampleIndex] = right;
+    writeIndex = (writeIndex + 1) & mask;
+  }
+}
+
+} // namespace Teul
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "TDelayLinePool.h"
+#include <JuceHeader.h>
+#include <array>
+
+namespace Teul {
+
+// Stereo feedback delay on pooled memory sized for kMaxDelayMs. Delay time
+// changes ramp across the block and are read with linear interpolation,
+// so sweeping the time bends pitch instead of clicking.
+class TStereoDelay {
+public:
+  static constexpr float kMaxDelayMs = 2000.0f;
+
+  struct Block {
+    std::array<const float *, 2> inputs{};
+    std::array<float *, 2> outputs{};
+    int numSamples = 0;
+  };
+
+  // Keeps the current lines when they still fit. A new sample rate clears
+  // them, since the tail was recorded at the old rate.
+  void prepare(double newSampleRate);
+  void reset() noexcept;
+
+  void setDelayMs(float newDelayMs) noexcept;
+  void setFeedback(float newFeedback) noexcept;
+  void setMix(float newMix) noexcept;
+
+  void render(const Block &block) noexcept;
+
+private:
+  double sampleRate = 48000.0;
+  TDelayLinePool::Lease lines;
+  int capacity = 0;
+  int writeIndex = 0;
+  float delayMs = 250.0f;
+  double delaySamples = -1.0;
+  float feedback = 0.3f;
+  float mix = 0.5f;
+};
+
+// Eight-line feedback delay network reverb. The lines are lanes of one
+// loop: a one-pole damping filter and a Householder reflection mix them,
+// and per-line gains give every line the decay time the room size asks
+// for. Even lines take and feed the left channel, odd lines the right.
+class TFeedbackDelayNetwork {
+public:
+  static constexpr int kLines = 8;
+
+  using Block = TStereoDelay::Block;
+
+  void prepare(double newSampleRate);
+  void reset() noexcept;
+
+  void setRoomSize(float newRoomSize) noexcept;
+  void setDamping(float newDamping) noexcept;
+  void setWidth(float newWidth) noexcept;
+  void setMix(float newMix) noexcept;
+
+  void render(const Block &block) noexcept;
+
+private:
+  void updateLineGains() noexcept;
+
+  double sampleRate = 48000.0;
+  TDelayLinePool::Lease memory;
+  int capacity = 0;
+  int writeIndex = 0;
+  std::array<int, kLines> lengths{};
+  std::array<float, kLines> lineGains{};
+  std::array<float, kLines> lowpassStates{};
+  float roomSize = 0.5f;
+  float dampingCoefficient = 0.35f;
+  float width = 1.0f;
+  float mix = 0.3f;
+};
+
+} // namespace Teul
@@ -0,0 +1,99 @@
+#include "TDelayLinePool.h"
+
+#include <algorithm>
+
+namespace Teul {
+
+TDelayLinePool::Lease::~Lease() {
+  if (pool != nullptr && samples != nullptr)
+    pool->release(samples, capacity);
+}
+
+TDelayLinePool &TDelayLinePool::get() {
+  static TDelayLinePool pool;
+  return pool;
+}
+
+int TDelayLinePool::capacityFor(int minimumSamples) noexcept {
+  int capacity = 1;
+  while (capacity < minimumSamples && capacity < (1 << 30))
+    capacity <<= 1;
+  return capacity;
+}
+
+TDelayLinePool::Lease TDelayLinePool::acquire(int minimumSamples) {
+  const int capacity = capacityFor(juce::jmax(1, minimumSamples));
+  std::unique_ptr<float[]> block;
+
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    auto &blocks = freeBlocks[capacity];
+    if (!blocks.empty()) {
+      block = std::move(blocks.back().samples);
+      blocks.pop_back();
+      stats.pooledSampleCount -= static_cast<std::size_t>(capacity);
+      ++stats.reuseCount;
+    } else {
+      ++stats.allocationCount;
+    }
+  }
+
+  if (block == nullptr)
+    block = std::make_unique<float[]>(static_cast<std::size_t>(capacity));
+  std::fill_n(block.get(), capacity, 0.0f);
+
+  Lease lease;
+  lease.samples = block.get();
+  lease.capacity = capacity;
+  lease.pool = this;
+
+  const std::lock_guard<std::mutex> lock(mutex);
+  leasedBlocks.push_back(std::move(block));
+  return lease;
+}
+
+void TDelayLinePool::release(float *samples, int capacity) {
+  const std::lock_guard<std::mutex> lock(mutex);
+  const auto leased =
+      std::find_if(leasedBlocks.begin(), leasedBlocks.end(),
+                   [samples](const auto &block) { return block.get() == samples; });
+  if (leased == leasedBlocks.end())
+    return;
+
+  freeBlocks[capacity].push_back({std::move(*leased), nextReleaseOrder++});
+  leasedBlocks.erase(leased);
+  stats.pooledSampleCount += static_cast<std::size_t>(capacity);
+
+  while (stats.pooledSampleCount > kMaxPooledSamples) {
+    if (!evictOldestFreeBlock())
+      break;
+  }
+}
+
+// Blocks of one size are released in order, so the oldest of each size
+// sits at the front of its list.
+bool TDelayLinePool::evictOldestFreeBlock() {
+  auto oldest = freeBlocks.end();
+  for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it) {
+    if (!it->second.empty() &&
+        (oldest == freeBlocks.end() ||
+         it->second.front().releaseOrder < oldest->second.front().releaseOrder))
+      oldest = it;
+  }
+  if (oldest == freeBlocks.end())
+    return false;
+
+  oldest->second.erase(oldest->second.begin());
+  stats.pooledSampleCount -= static_cast<std::size_t>(oldest->first);
+  ++stats.evictionCount;
+  if (oldest->second.empty())
+    freeBlocks.erase(oldest);
+  return true;
+}
+
+TDelayLinePool::Stats TDelayLinePool::getStats() const {
+  const std::lock_guard<std::mutex> lock(mutex);
+  return stats;
+}
+
+} // namespace Teul
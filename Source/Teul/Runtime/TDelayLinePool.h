@@ -0,0 +1,93 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Teul {
+
+// Shared store of delay memory. Blocks are power-of-two sized so readers
+// can wrap with a mask, and a released block is kept for the next node
+// that asks for the same size, so deleting and re-adding an effect or
+// re-preparing at the same rate does not go back to the heap. Free memory is
+// capped at kMaxPooledSamples; past that the longest-unused blocks go back
+// to the heap, so resizing through many sizes does not keep them all.
+// Acquire and release on the message thread only: from prepareToPlay and
+// instance destructors, which the runtime never runs on the audio thread.
+class TDelayLinePool {
+public:
+  // Owns one block until destroyed or reassigned.
+  class Lease {
+  public:
+    Lease() = default;
+    Lease(Lease &&other) noexcept { swap(other); }
+    Lease &operator=(Lease &&other) noexcept {
+      Lease released;
+      released.swap(other);
+      swap(released);
+      return *this;
+    }
+    Lease(const Lease &) = delete;
+    Lease &operator=(const Lease &) = delete;
+    ~Lease();
+
+    float *data() const noexcept { return samples; }
+    int size() const noexcept { return capacity; }
+    bool isValid() const noexcept { return samples != nullptr; }
+
+  private:
+    friend class TDelayLinePool;
+
+    void swap(Lease &other) noexcept {
+      std::swap(samples, other.samples);
+      std::swap(capacity, other.capacity);
+      std::swap(pool, other.pool);
+    }
+
+    float *samples = nullptr;
+    int capacity = 0;
+    TDelayLinePool *pool = nullptr;
+  };
+
+  struct Stats {
+    std::uint64_t allocationCount = 0;
+    std::uint64_t reuseCount = 0;
+    std::uint64_t evictionCount = 0;
+    std::size_t pooledSampleCount = 0;
+  };
+
+  // 8 MB of floats: two stereo delays at 192 kHz.
+  static constexpr std::size_t kMaxPooledSamples = std::size_t{1} << 21;
+
+  static TDelayLinePool &get();
+
+  // A cleared block of at least minimumSamples, rounded up to a power of
+  // two.
+  Lease acquire(int minimumSamples);
+
+  Stats getStats() const;
+
+  static int capacityFor(int minimumSamples) noexcept;
+
+private:
+  TDelayLinePool() = default;
+
+  struct FreeBlock {
+    std::unique_ptr<float[]> samples;
+    std::uint64_t releaseOrder = 0;
+  };
+
+  void release(float *samples, int capacity);
+  bool evictOldestFreeBlock();
+
+  mutable std::mutex mutex;
+  std::map<int, std::vector<FreeBlock>> freeBlocks;
+  std::uint64_t nextReleaseOrder = 0;
+  std::vector<std::unique_ptr<float[]>> leasedBlocks;
+  Stats stats;
+};
+
+} // namespace Teul
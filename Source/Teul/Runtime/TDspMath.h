@@ -0,0 +1,28 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstdint>
+#include <cstring>
+
+namespace Teul {
+
+// 2^x within about 2e-7 relative error, well under a thousandth of a cent
+// for V/Oct pitch. x is clamped to the normal float exponent range.
+inline float fastExp2(float x) noexcept {
+  x = juce::jlimit(-126.0f, 126.0f, x);
+  // Truncating a positive value floors it.
+  const int whole = static_cast<int>(x + 128.0f) - 128;
+  const float fraction = x - static_cast<float>(whole);
+  const float mantissa =
+      1.0f + fraction * (0.693151249f +
+                         fraction * (0.240157735f +
+                                     fraction * (0.0558360204f +
+                                                 fraction * (0.00895988811f +
+                                                             fraction * 0.00189510729f))));
+  const std::uint32_t bits = static_cast<std::uint32_t>(whole + 127) << 23;
+  float scale = 0.0f;
+  std::memcpy(&scale, &bits, sizeof(scale));
+  return mantissa * scale;
+}
+
+} // namespace Teul
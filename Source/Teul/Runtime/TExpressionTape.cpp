@@ -0,0 +1,232 @@
+#include "TExpressionTape.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Teul {
+
+int TExpressionTape::operandCount(TExpressionOp op) noexcept {
+  switch (op) {
+  case TExpressionOp::Clamp:
+  case TExpressionOp::ValueMap:
+    return 1;
+  default:
+    return 2;
+  }
+}
+
+int TExpressionTape::addInput() {
+  registerInputs.push_back(numInputs++);
+  const int reg = static_cast<int>(registerInputs.size()) - 1;
+  chunks.resize(registerInputs.size() * kChunkSize);
+  constantRegisters.resize(registerInputs.size());
+  constantValues.resize(registerInputs.size());
+  return reg;
+}
+
+int TExpressionTape::addInstruction(TExpressionOp op,
+                                    std::array<int, kMaxOperands> operands,
+                                    const float *parameters) {
+  registerInputs.push_back(-1);
+  const int reg = static_cast<int>(registerInputs.size()) - 1;
+  instructions.push_back({op, operands, parameters, reg});
+  chunks.resize(registerInputs.size() * kChunkSize);
+  constantRegisters.resize(registerInputs.size());
+  constantValues.resize(registerInputs.size());
+  coefficients.resize(instructions.size());
+  sumsOfSquares.resize(instructions.size());
+  return reg;
+}
+
+bool TExpressionTape::run(const Input *inputs, float *output, int numSamples,
+                          Level *levels) noexcept {
+  if (instructions.empty() || output == nullptr || numSamples <= 0)
+    return false;
+
+  for (std::size_t reg = 0; reg < registerInputs.size(); ++reg) {
+    const int input = registerInputs[reg];
+    if (input < 0)
+      continue;
+    constantRegisters[reg] = inputs[input].samples == nullptr;
+    constantValues[reg] = inputs[input].constant;
+  }
+  if (levels != nullptr)
+    std::fill_n(levels, instructions.size(), Level{});
+
+  for (std::size_t index = 0; index < instructions.size(); ++index) {
+    const auto &instruction = instructions[index];
+    coefficients[index] = coefficientsFor(instruction.op, instruction.parameters);
+    sumsOfSquares[index] = 0.0;
+
+    const int numOperands = operandCount(instruction.op);
+    bool constant = true;
+    std::array<float, kMaxOperands> values{};
+    for (int operand = 0; operand < numOperands; ++operand) {
+      const auto reg = static_cast<std::size_t>(instruction.operands[(std::size_t)operand]);
+      constant = constant && constantRegisters[reg] != 0;
+      values[(std::size_t)operand] = constantValues[reg];
+    }
+
+    const auto destination = static_cast<std::size_t>(instruction.destination);
+    constantRegisters[destination] = constant;
+    if (constant) {
+      renderChunk(instruction.op, &values[0], &values[1], coefficients[index],
+                  &constantValues[destination], 1);
+    }
+  }
+
+  const auto &result = instructions.back();
+  const bool constantResult =
+      constantRegisters[static_cast<std::size_t>(result.destination)] != 0;
+  if (constantResult) {
+    output[0] = constantValues[static_cast<std::size_t>(result.destination)];
+  } else {
+    // Constants feeding sample-rate instructions are read as full chunks.
+    for (std::size_t reg = 0; reg < registerInputs.size(); ++reg) {
+      if (constantRegisters[reg] != 0)
+        juce::FloatVectorOperations::fill(chunkOf(static_cast<int>(reg)),
+                                          constantValues[reg], kChunkSize);
+    }
+
+    const std::size_t lastIndex = instructions.size() - 1;
+    for (int offset = 0; offset < numSamples; offset += kChunkSize) {
+      const int count = juce::jmin(kChunkSize, numSamples - offset);
+      for (std::size_t index = 0; index < instructions.size(); ++index) {
+        const auto &instruction = instructions[index];
+        if (constantRegisters[static_cast<std::size_t>(instruction.destination)] != 0)
+          continue;
+
+        std::array<const float *, kMaxOperands> operands{};
+        for (int operand = 0; operand < operandCount(instruction.op); ++operand) {
+          const int reg = instruction.operands[(std::size_t)operand];
+          const int input = registerInputs[static_cast<std::size_t>(reg)];
+          operands[(std::size_t)operand] =
+              (input >= 0 && inputs[input].samples != nullptr)
+                  ? inputs[input].samples + offset
+                  : chunkOf(reg);
+        }
+        if (operands[1] == nullptr)
+          operands[1] = operands[0];
+
+        float *destination =
+            index == lastIndex ? output + offset : chunkOf(instruction.destination);
+        renderChunk(instruction.op, operands[0], operands[1], coefficients[index],
+                    destination, count);
+
+        if (levels != nullptr) {
+          auto &level = levels[index];
+          const auto range =
+              juce::FloatVectorOperations::findMinAndMax(destination, count);
+          level.peak = juce::jmax(level.peak, std::abs(range.getStart()),
+                                  std::abs(range.getEnd()));
+          double sum = 0.0;
+          for (int sampleIndex = 0; sampleIndex < count; ++sampleIndex)
+            sum += destination[sampleIndex] * destination[sampleIndex];
+          sumsOfSquares[index] += sum;
+        }
+      }
+    }
+  }
+
+  if (levels != nullptr) {
+    for (std::size_t index = 0; index < instructions.size(); ++index) {
+      const auto destination = static_cast<std::size_t>(instructions[index].destination);
+      auto &level = levels[index];
+      if (constantRegisters[destination] != 0) {
+        const float magnitude = std::abs(constantValues[destination]);
+        level.peak = juce::jmin(1.0f, magnitude);
+        level.rms = magnitude;
+      } else {
+        level.peak = juce::jmin(1.0f, level.peak);
+        level.rms = static_cast<float>(
+            std::sqrt(sumsOfSquares[index] / static_cast<double>(numSamples)));
+      }
+    }
+  }
+
+  return constantResult;
+}
+
+TExpressionTape::Coefficients
+TExpressionTape::coefficientsFor(TExpressionOp op, const float *parameters) noexcept {
+  if (parameters == nullptr)
+    return {};
+
+  switch (op) {
+  case TExpressionOp::Clamp:
+    return {parameters[0], juce::jmax(parameters[0], parameters[1])};
+  case TExpressionOp::ValueMap: {
+    // out = in * scale + offset; an empty input range maps to outMin.
+    const float inRange = parameters[1] - parameters[0];
+    const float scale =
+        inRange != 0.0f ? (parameters[3] - parameters[2]) / inRange : 0.0f;
+    return {scale, parameters[2] - parameters[0] * scale};
+  }
+  default:
+    return {};
+  }
+}
+
+void TExpressionTape::renderChunk(TExpressionOp op, const float *a, const float *b,
+                                  Coefficients coefficients, float *output,
+                                  int numSamples) noexcept {
+  switch (op) {
+  case TExpressionOp::Add:
+    juce::FloatVectorOperations::add(output, a, b, numSamples);
+    break;
+  case TExpressionOp::Subtract:
+    juce::FloatVectorOperations::subtract(output, a, b, numSamples);
+    break;
+  case TExpressionOp::Multiply:
+    juce::FloatVectorOperations::multiply(output, a, b, numSamples);
+    break;
+  case TExpressionOp::Divide:
+    // Division by zero gives zero rather than inf, which downstream
+    // multiplies would spread.
+    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
+      output[sampleIndex] =
+          b[sampleIndex] != 0.0f ? a[sampleIndex] / b[sampleIndex] : 0.0f;
+    }
+    break;
+  case TExpressionOp::Clamp:
+    juce::FloatVectorOperations::clip(output, a, coefficients.first,
+                                      coefficients.second, numSamples);
+    break;
+  case TExpressionOp::ValueMap:
+    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+      output[sampleIndex] = a[sampleIndex] * coefficients.first + coefficients.second;
+    break;
+  }
+}
+
+TExpressionNodeInstance::TExpressionNodeInstance(
+    TExpressionOp expressionOp, std::array<float, kMaxParameters> defaultParameters)
+    : op(expressionOp), parameters(defaultParameters) {
+  std::array<int, TExpressionTape::kMaxOperands> operands{{-1, -1}};
+  for (int operand = 0; operand < getNumOperands(); ++operand)
+    operands[(std::size_t)operand] = tape.addInput();
+  tape.addInstruction(op, operands, parameters.data());
+}
+
+void TExpressionNodeInstance::setParameterValue(int paramIndex, float newValue) {
+  if (paramIndex >= 0 && paramIndex < kMaxParameters)
+    parameters[(std::size_t)paramIndex] = newValue;
+}
+
+void TExpressionNodeInstance::processSamples(const TProcessContext &ctx) {
+  auto *output = ctx.getOutputSamples(getOutputSlot());
+  if (output == nullptr)
+    return;
+
+  std::array<TExpressionTape::Input, TExpressionTape::kMaxOperands> inputs{};
+  for (int operand = 0; operand < getNumOperands(); ++operand) {
+    auto &input = inputs[(std::size_t)operand];
+    if (!ctx.getInputConstant(operand, input.constant))
+      input.samples = ctx.getInputSamples(operand);
+  }
+
+  if (tape.run(inputs.data(), output, ctx.numSamples))
+    ctx.setOutputConstant(getOutputSlot(), output[0]);
+}
+
+} // namespace Teul
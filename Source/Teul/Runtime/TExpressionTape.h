@@ -0,0 +1,125 @@
+#pragma once
+
+#include "TNodeInstance.h"
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Teul {
+
+enum class TExpressionOp : std::uint8_t {
+  Add,
+  Subtract,
+  Multiply,
+  Divide,
+  Clamp,
+  ValueMap
+};
+
+// Straight-line program over per-sample math ops. Every input and every
+// instruction result is a register; the last instruction is the result.
+// run() evaluates the block in kChunkSize slices with vector operations, so
+// inputs are read in place and only the result is written out. Registers
+// that depend on constant inputs alone are folded to a scalar once per run.
+class TExpressionTape {
+public:
+  static constexpr int kChunkSize = 64;
+  static constexpr int kMaxOperands = 2;
+
+  // Samples of one input, or a value for the whole block when samples is
+  // nullptr.
+  struct Input {
+    const float *samples = nullptr;
+    float constant = 0.0f;
+  };
+
+  // Peak, clipped to 1 like port meters, and RMS of a register over a run.
+  struct Level {
+    float peak = 0.0f;
+    float rms = 0.0f;
+  };
+
+  static int operandCount(TExpressionOp op) noexcept;
+
+  // Building happens off the audio thread. Both return the new register.
+  int addInput();
+  // parameters are read live on every run and must outlive the tape.
+  int addInstruction(TExpressionOp op, std::array<int, kMaxOperands> operands,
+                     const float *parameters);
+
+  int getNumInputs() const noexcept { return numInputs; }
+  int getNumInstructions() const noexcept {
+    return static_cast<int>(instructions.size());
+  }
+
+  // Renders numSamples of the result to output and returns false; when the
+  // result is constant only output[0] is written and it returns true.
+  // levels, if given, receives one entry per instruction.
+  bool run(const Input *inputs, float *output, int numSamples,
+           Level *levels = nullptr) noexcept;
+
+private:
+  // Block constants of an op, taken from its parameters once per run.
+  struct Coefficients {
+    float first = 0.0f;
+    float second = 0.0f;
+  };
+
+  struct Instruction {
+    TExpressionOp op = TExpressionOp::Add;
+    std::array<int, kMaxOperands> operands{{-1, -1}};
+    const float *parameters = nullptr;
+    int destination = -1;
+  };
+
+  static Coefficients coefficientsFor(TExpressionOp op,
+                                      const float *parameters) noexcept;
+  static void renderChunk(TExpressionOp op, const float *a, const float *b,
+                          Coefficients coefficients, float *output,
+                          int numSamples) noexcept;
+
+  float *chunkOf(int reg) noexcept {
+    return chunks.data() + static_cast<std::size_t>(reg) * kChunkSize;
+  }
+
+  std::vector<Instruction> instructions;
+  int numInputs = 0;
+  // Per register: its input index, or -1 for an instruction result.
+  std::vector<int> registerInputs;
+
+  // Run state, sized while building.
+  std::vector<float> chunks;
+  std::vector<std::uint8_t> constantRegisters;
+  std::vector<float> constantValues;
+  std::vector<Coefficients> coefficients;
+  std::vector<double> sumsOfSquares;
+};
+
+// Instance of a per-sample math node. Operands are port slots 0 .. n-1 and
+// the result is the slot after them. Alone it runs a one-instruction tape
+// over its own ports; buildGraph fuses connected nodes into a shared tape
+// that reads getParameters() of every member instead.
+class TExpressionNodeInstance final : public TNodeInstance {
+public:
+  static constexpr int kMaxParameters = 4;
+
+  explicit TExpressionNodeInstance(
+      TExpressionOp expressionOp,
+      std::array<float, kMaxParameters> defaultParameters = {});
+
+  TExpressionOp getOp() const noexcept { return op; }
+  int getNumOperands() const noexcept { return TExpressionTape::operandCount(op); }
+  int getOutputSlot() const noexcept { return getNumOperands(); }
+  const float *getParameters() const noexcept { return parameters.data(); }
+
+  void setParameterValue(int paramIndex, float newValue) override;
+  void processSamples(const TProcessContext &context) override;
+
+private:
+  TExpressionOp op;
+  std::array<float, kMaxParameters> parameters;
+  TExpressionTape tape;
+};
+
+} // namespace Teul
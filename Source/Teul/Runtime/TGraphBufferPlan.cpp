@@ -0,0 +1,332 @@
+#include "TGraphBufferPlan.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+
+namespace Teul {
+namespace {
+
+struct InputSource {
+  bool fromRail = false;
+  PortId portId = kInvalidPortId;
+  juce::String railKey;
+};
+
+struct FreeChannel {
+  int channelIndex = -1;
+  std::vector<std::size_t> releasedBy;
+};
+
+struct LiveChannel {
+  int channelIndex = -1;
+  int remainingConsumers = 0;
+  std::vector<std::size_t> releasedBy;
+};
+
+bool isSignalPort(const TPort *port) noexcept {
+  return port != nullptr && port->dataType != TPortDataType::MIDI;
+}
+
+bool isSignalRailInput(const TGraphDocument &doc, const juce::String &endpointId,
+                       const juce::String &portId) {
+  for (const auto &endpoint : doc.controlState.inputEndpoints) {
+    if (endpoint.endpointId != endpointId)
+      continue;
+
+    for (const auto &port : endpoint.ports) {
+      if (port.portId == portId)
+        return port.dataType != TPortDataType::MIDI;
+    }
+  }
+
+  return false;
+}
+
+} // namespace
+
+void TGraphBufferPlan::build(const TGraphDocument &doc,
+                             const std::vector<NodeId> &order) {
+  nodes.clear();
+  channelByPort.clear();
+  railInputChannels.clear();
+  silenceChannel = -1;
+  channelCount = 0;
+  naiveChannelCount = 0;
+  aliasedInputCount = 0;
+  summedInputCount = 0;
+
+  std::vector<const TNode *> plannedNodes;
+  std::map<NodeId, std::size_t> indexByNodeId;
+  for (const auto nodeId : order) {
+    const auto *node = doc.findNode(nodeId);
+    if (node == nullptr || indexByNodeId.count(nodeId) != 0)
+      continue;
+
+    indexByNodeId[nodeId] = plannedNodes.size();
+    plannedNodes.push_back(node);
+    naiveChannelCount += static_cast<int>(node->ports.size());
+  }
+
+  const std::size_t nodeCount = plannedNodes.size();
+  std::vector<std::set<std::size_t>> predecessors(nodeCount);
+  std::map<PortId, std::vector<InputSource>> sourcesByInput;
+  std::map<PortId, std::set<std::size_t>> consumersByOutput;
+  std::map<juce::String, std::set<std::size_t>> consumersByRailInput;
+  std::set<PortId> pinnedOutputs;
+
+  for (const auto &conn : doc.connections) {
+    if (!conn.isValid())
+      continue;
+
+    if (conn.to.isNodePort()) {
+      const auto dstIt = indexByNodeId.find(conn.to.nodeId);
+      if (dstIt == indexByNodeId.end())
+        continue;
+
+      const auto *targetPort = plannedNodes[dstIt->second]->findPort(conn.to.portId);
+      if (conn.from.isNodePort()) {
+        const auto srcIt = indexByNodeId.find(conn.from.nodeId);
+        if (srcIt == indexByNodeId.end())
+          continue;
+
+        predecessors[dstIt->second].insert(srcIt->second);
+        const auto *sourcePort = plannedNodes[srcIt->second]->findPort(conn.from.portId);
+        if (!isSignalPort(sourcePort) || !isSignalPort(targetPort))
+          continue;
+
+        sourcesByInput[conn.to.portId].push_back({false, conn.from.portId, {}});
+        consumersByOutput[conn.from.portId].insert(dstIt->second);
+      } else if (conn.from.isRailPort()) {
+        if (!isSignalPort(targetPort) ||
+            !isSignalRailInput(doc, conn.from.railEndpointId, conn.from.railPortId)) {
+          continue;
+        }
+
+        const auto key = makeRailPortKey(conn.from.railEndpointId, conn.from.railPortId);
+        sourcesByInput[conn.to.portId].push_back({true, kInvalidPortId, key});
+        consumersByRailInput[key].insert(dstIt->second);
+      }
+      continue;
+    }
+
+    if (conn.from.isNodePort() && conn.to.isRailPort()) {
+      const auto srcIt = indexByNodeId.find(conn.from.nodeId);
+      const auto *endpoint = doc.controlState.findEndpoint(conn.to.railEndpointId);
+      if (srcIt == indexByNodeId.end() || endpoint == nullptr ||
+          endpoint->kind != TSystemRailEndpointKind::audioOutput) {
+        continue;
+      }
+
+      if (isSignalPort(plannedNodes[srcIt->second]->findPort(conn.from.portId)))
+        pinnedOutputs.insert(conn.from.portId);
+    }
+  }
+
+  const std::size_t wordCount = (nodeCount + 63) / 64;
+  std::vector<std::vector<std::uint64_t>> ancestors(
+      nodeCount, std::vector<std::uint64_t>(wordCount, 0));
+  for (std::size_t index = 0; index < nodeCount; ++index) {
+    for (const auto predecessor : predecessors[index]) {
+      if (predecessor >= index)
+        continue;
+
+      auto &bits = ancestors[index];
+      const auto &inherited = ancestors[predecessor];
+      for (std::size_t word = 0; word < wordCount; ++word)
+        bits[word] |= inherited[word];
+      bits[predecessor / 64] |= std::uint64_t{1} << (predecessor % 64);
+    }
+  }
+
+  std::map<juce::String, LiveChannel> liveRailInputs;
+  for (const auto &endpoint : doc.controlState.inputEndpoints) {
+    for (const auto &port : endpoint.ports) {
+      const auto key = makeRailPortKey(endpoint.endpointId, port.portId);
+      const auto consumersIt = consumersByRailInput.find(key);
+      if (consumersIt == consumersByRailInput.end() ||
+          railInputChannels.count(key) != 0) {
+        continue;
+      }
+
+      LiveChannel live;
+      live.channelIndex = channelCount++;
+      live.remainingConsumers = static_cast<int>(consumersIt->second.size());
+      live.releasedBy.assign(consumersIt->second.begin(), consumersIt->second.end());
+      railInputChannels[key] = live.channelIndex;
+      liveRailInputs[key] = std::move(live);
+    }
+  }
+  naiveChannelCount += static_cast<int>(railInputChannels.size());
+
+  for (const auto *node : plannedNodes) {
+    for (const auto &port : node->ports) {
+      if (port.direction == TPortDirection::Input && isSignalPort(&port)) {
+        silenceChannel = channelCount++;
+        break;
+      }
+    }
+
+    if (silenceChannel >= 0)
+      break;
+  }
+
+  std::vector<FreeChannel> freeChannels;
+  std::map<PortId, LiveChannel> liveOutputs;
+
+  // Takes the most recently released channel whose previous users all finish
+  // before nodeIndex can start; otherwise grows the buffer by one channel.
+  auto acquireChannel = [&](std::size_t nodeIndex) {
+    const auto &bits = ancestors[nodeIndex];
+    for (auto it = freeChannels.rbegin(); it != freeChannels.rend(); ++it) {
+      const bool reusable =
+          std::all_of(it->releasedBy.begin(), it->releasedBy.end(),
+                      [&bits](std::size_t user) {
+                        return ((bits[user / 64] >> (user % 64)) & 1u) != 0;
+                      });
+      if (!reusable)
+        continue;
+
+      const int channelIndex = it->channelIndex;
+      freeChannels.erase(std::next(it).base());
+      return channelIndex;
+    }
+
+    return channelCount++;
+  };
+
+  nodes.reserve(nodeCount);
+  for (std::size_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex) {
+    const auto &node = *plannedNodes[nodeIndex];
+    NodePlan plan;
+    plan.nodeId = node.nodeId;
+
+    std::vector<int> transientChannels;
+    std::set<PortId> consumedOutputs;
+    std::set<juce::String> consumedRailInputs;
+
+    for (const auto &port : node.ports) {
+      if (port.direction != TPortDirection::Input || !isSignalPort(&port))
+        continue;
+
+      const auto sourcesIt = sourcesByInput.find(port.portId);
+      if (sourcesIt == sourcesByInput.end()) {
+        plan.portChannels[port.portId] = silenceChannel;
+        channelByPort[port.portId] = silenceChannel;
+        continue;
+      }
+
+      std::vector<int> sourceChannels;
+      for (const auto &source : sourcesIt->second) {
+        int sourceChannel = -1;
+        if (source.fromRail) {
+          const auto railIt = railInputChannels.find(source.railKey);
+          sourceChannel = railIt != railInputChannels.end() ? railIt->second : -1;
+          consumedRailInputs.insert(source.railKey);
+        } else {
+          const auto liveIt = liveOutputs.find(source.portId);
+          const auto channelIt = channelByPort.find(source.portId);
+          sourceChannel = channelIt != channelByPort.end() ? channelIt->second : -1;
+          if (liveIt != liveOutputs.end())
+            consumedOutputs.insert(source.portId);
+        }
+
+        if (sourceChannel >= 0)
+          sourceChannels.push_back(sourceChannel);
+      }
+
+      // The source channel stays live until this node has run, so the input
+      // can read it in place.
+      if (sourceChannels.size() == 1) {
+        plan.portChannels[port.portId] = sourceChannels.front();
+        channelByPort[port.portId] = sourceChannels.front();
+        ++aliasedInputCount;
+        continue;
+      }
+
+      const int channelIndex = acquireChannel(nodeIndex);
+      plan.portChannels[port.portId] = channelIndex;
+      channelByPort[port.portId] = channelIndex;
+      transientChannels.push_back(channelIndex);
+
+      if (sourceChannels.empty()) {
+        plan.clearChannels.push_back(channelIndex);
+      } else {
+        plan.sums.push_back({channelIndex, std::move(sourceChannels)});
+        ++summedInputCount;
+      }
+    }
+
+    for (const auto &port : node.ports) {
+      if (port.direction != TPortDirection::Output || !isSignalPort(&port))
+        continue;
+
+      const int channelIndex = acquireChannel(nodeIndex);
+      plan.portChannels[port.portId] = channelIndex;
+      plan.clearChannels.push_back(channelIndex);
+      channelByPort[port.portId] = channelIndex;
+
+      if (pinnedOutputs.count(port.portId) != 0)
+        continue;
+
+      const auto consumersIt = consumersByOutput.find(port.portId);
+      if (consumersIt == consumersByOutput.end()) {
+        transientChannels.push_back(channelIndex);
+        continue;
+      }
+
+      LiveChannel live;
+      live.channelIndex = channelIndex;
+      live.remainingConsumers = static_cast<int>(consumersIt->second.size());
+      live.releasedBy.push_back(nodeIndex);
+      live.releasedBy.insert(live.releasedBy.end(), consumersIt->second.begin(),
+                             consumersIt->second.end());
+      liveOutputs[port.portId] = std::move(live);
+    }
+
+    for (const int channelIndex : transientChannels)
+      freeChannels.push_back({channelIndex, {nodeIndex}});
+
+    for (const auto &portId : consumedOutputs) {
+      auto liveIt = liveOutputs.find(portId);
+      if (--liveIt->second.remainingConsumers > 0)
+        continue;
+
+      freeChannels.push_back(
+          {liveIt->second.channelIndex, std::move(liveIt->second.releasedBy)});
+      liveOutputs.erase(liveIt);
+    }
+
+    for (const auto &key : consumedRailInputs) {
+      auto liveIt = liveRailInputs.find(key);
+      if (liveIt == liveRailInputs.end() ||
+          --liveIt->second.remainingConsumers > 0) {
+        continue;
+      }
+
+      freeChannels.push_back(
+          {liveIt->second.channelIndex, std::move(liveIt->second.releasedBy)});
+      liveRailInputs.erase(liveIt);
+    }
+
+    nodes.push_back(std::move(plan));
+  }
+}
+
+int TGraphBufferPlan::channelForPort(PortId portId) const noexcept {
+  const auto it = channelByPort.find(portId);
+  return it != channelByPort.end() ? it->second : -1;
+}
+
+int TGraphBufferPlan::channelForRailInput(
+    const juce::String &endpointId, const juce::String &portId) const noexcept {
+  const auto it = railInputChannels.find(makeRailPortKey(endpointId, portId));
+  return it != railInputChannels.end() ? it->second : -1;
+}
+
+juce::String TGraphBufferPlan::makeRailPortKey(const juce::String &endpointId,
+                                               const juce::String &portId) {
+  return endpointId + "::" + portId;
+}
+
+} // namespace Teul
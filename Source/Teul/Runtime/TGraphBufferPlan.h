@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../Model/TGraphDocument.h"
+#include <JuceHeader.h>
+#include <map>
+#include <vector>
+
+namespace Teul {
+
+// Liveness-based assignment of signal ports to physical channels of the
+// runtime port buffer. MIDI ports never get a channel. Unconnected inputs
+// share one read-only silence channel; it is reserved whenever the graph has
+// a signal input, so the runtime can also point inputs fed by skipped nodes
+// at it. A channel is only handed to a later node once every node that
+// touched it is an ancestor of that node, so the plan stays valid when
+// independent nodes run concurrently.
+// An input with a single source aliases that source's channel; only fan-in
+// gets a channel of its own, filled by one SumOp before the node runs.
+struct TGraphBufferPlan {
+  struct SumOp {
+    int dstChannelIndex = -1;
+    std::vector<int> srcChannelIndices;
+  };
+
+  struct NodePlan {
+    NodeId nodeId = kInvalidNodeId;
+    std::map<PortId, int> portChannels;
+    std::vector<int> clearChannels;
+    std::vector<SumOp> sums;
+  };
+
+  std::vector<NodePlan> nodes;
+  std::map<PortId, int> channelByPort;
+  std::map<juce::String, int> railInputChannels;
+  int silenceChannel = -1;
+  int channelCount = 0;
+  int naiveChannelCount = 0;
+  int aliasedInputCount = 0;
+  int summedInputCount = 0;
+
+  void build(const TGraphDocument &doc, const std::vector<NodeId> &order);
+
+  int channelForPort(PortId portId) const noexcept;
+  int channelForRailInput(const juce::String &endpointId,
+                          const juce::String &portId) const noexcept;
+
+  static juce::String makeRailPortKey(const juce::String &endpointId,
+                                      const juce::String &portId);
+};
+
+} // namespace Teul
@@ -0,0 +1,114 @@
+#include "TGraphFusionPlan.h"
+
+#include <algorithm>
+#include <set>
+
+namespace Teul {
+
+void TGraphFusionPlan::build(const TGraphDocument &doc,
+                             const std::vector<NodeId> &order,
+                             const std::map<NodeId, Candidate> &candidates) {
+  groups.clear();
+  fusedNodeCount = 0;
+  if (candidates.size() < 2)
+    return;
+
+  auto operandIndexOf = [&candidates](NodeId nodeId, PortId portId) {
+    const auto it = candidates.find(nodeId);
+    if (it == candidates.end())
+      return -1;
+
+    const auto &ports = it->second.operandPorts;
+    const auto portIt = std::find(ports.begin(), ports.end(), portId);
+    return portIt != ports.end() ? static_cast<int>(portIt - ports.begin()) : -1;
+  };
+
+  std::map<NodeId, std::vector<NodeId>> consumers;
+  std::set<NodeId> escaping;
+  std::map<PortId, std::vector<NodeId>> sourcesByOperand;
+  for (const auto &conn : doc.connections) {
+    if (!conn.isValid())
+      continue;
+
+    if (conn.to.isNodePort() && operandIndexOf(conn.to.nodeId, conn.to.portId) >= 0) {
+      sourcesByOperand[conn.to.portId].push_back(
+          conn.from.isNodePort() ? conn.from.nodeId : kInvalidNodeId);
+    }
+
+    if (!conn.from.isNodePort())
+      continue;
+    const auto sourceIt = candidates.find(conn.from.nodeId);
+    if (sourceIt == candidates.end() || sourceIt->second.outputPort != conn.from.portId)
+      continue;
+
+    if (conn.to.isNodePort() && operandIndexOf(conn.to.nodeId, conn.to.portId) >= 0)
+      consumers[conn.from.nodeId].push_back(conn.to.nodeId);
+    else
+      escaping.insert(conn.from.nodeId);
+  }
+
+  // Consumers come later in the order, so walking it backwards places every
+  // node after the group of each of its consumers is known.
+  std::map<NodeId, std::size_t> groupOf;
+  std::vector<std::vector<NodeId>> groupNodes;
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    const NodeId nodeId = *it;
+    if (candidates.count(nodeId) == 0)
+      continue;
+
+    std::size_t group = groupNodes.size();
+    const auto consumersIt = consumers.find(nodeId);
+    if (escaping.count(nodeId) == 0 && consumersIt != consumers.end()) {
+      const auto &users = consumersIt->second;
+      const auto first = groupOf.find(users.front());
+      const bool oneGroup =
+          first != groupOf.end() &&
+          std::all_of(users.begin(), users.end(), [&](NodeId user) {
+            const auto userIt = groupOf.find(user);
+            return userIt != groupOf.end() && userIt->second == first->second;
+          });
+      if (oneGroup &&
+          static_cast<int>(groupNodes[first->second].size()) < kMaxGroupSize) {
+        group = first->second;
+      }
+    }
+
+    if (group == groupNodes.size())
+      groupNodes.emplace_back();
+    groupOf[nodeId] = group;
+    groupNodes[group].push_back(nodeId);
+  }
+
+  for (auto &nodes : groupNodes) {
+    if (nodes.size() < 2)
+      continue;
+
+    std::reverse(nodes.begin(), nodes.end());
+    Group group;
+    std::map<NodeId, int> memberIndex;
+    for (const auto nodeId : nodes) {
+      Member member;
+      member.nodeId = nodeId;
+      const auto &operandPorts = candidates.at(nodeId).operandPorts;
+      for (std::size_t slot = 0; slot < operandPorts.size(); ++slot) {
+        Operand operand;
+        operand.slotIndex = static_cast<int>(slot);
+        const auto sourcesIt = sourcesByOperand.find(operandPorts[slot]);
+        if (sourcesIt != sourcesByOperand.end() && sourcesIt->second.size() == 1) {
+          const auto sourceIt = memberIndex.find(sourcesIt->second.front());
+          if (sourceIt != memberIndex.end())
+            operand.member = sourceIt->second;
+        }
+        member.operands.push_back(operand);
+      }
+
+      memberIndex[nodeId] = static_cast<int>(group.members.size());
+      group.members.push_back(std::move(member));
+    }
+
+    fusedNodeCount += static_cast<int>(group.members.size());
+    groups.push_back(std::move(group));
+  }
+}
+
+} // namespace Teul
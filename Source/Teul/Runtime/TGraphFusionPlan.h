@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../Model/TGraphDocument.h"
+#include <JuceHeader.h>
+#include <map>
+#include <vector>
+
+namespace Teul {
+
+// Chains and trees of per-sample math nodes fused into one expression tape
+// each. A candidate joins the group of its consumers when every connection
+// from its output goes to operand ports of candidates in that one group;
+// the root, whose output leaves the group, comes last and runs the tape for
+// all members. Operands fed from inside the group read the source's
+// register; every other operand is a tape input read from the member's own
+// input channel. Those channels stay intact until the root runs because
+// only the group's members and its root's descendants may reuse them.
+// Groups of one node are left out.
+struct TGraphFusionPlan {
+  static constexpr int kMaxGroupSize = 16;
+
+  struct Candidate {
+    // Operand k is the node's port slot k.
+    std::vector<PortId> operandPorts;
+    PortId outputPort = kInvalidPortId;
+  };
+
+  // Another member's result when member >= 0, else the operand's own slot.
+  struct Operand {
+    int member = -1;
+    int slotIndex = -1;
+  };
+
+  struct Member {
+    NodeId nodeId = kInvalidNodeId;
+    std::vector<Operand> operands;
+  };
+
+  struct Group {
+    // In build order, the root last.
+    std::vector<Member> members;
+  };
+
+  std::vector<Group> groups;
+  int fusedNodeCount = 0;
+
+  void build(const TGraphDocument &doc, const std::vector<NodeId> &order,
+             const std::map<NodeId, Candidate> &candidates);
+};
+
+} // namespace Teul
@@ -0,0 +1,315 @@
+#include "TGraphMidiFabric.h"
+
+#include <algorithm>
+#include <map>
+
+namespace Teul {
+namespace {
+
+struct PendingSource {
+  // Zero for the device input, otherwise the source node index plus one,
+  // so merged inputs see device events first and then upstream nodes.
+  std::size_t order = 0;
+  int blockIndex = -1;
+};
+
+bool isMidiPort(const TPort *port) noexcept {
+  return port != nullptr && port->dataType == TPortDataType::MIDI;
+}
+
+} // namespace
+
+void TGraphMidiFabric::build(const TGraphDocument &doc,
+                             const std::vector<NodeId> &order,
+                             int maxEventsPerBlock, int maxBytesPerBlock) {
+  blocks.clear();
+  inputs.clear();
+  sourceBlocks.clear();
+  sourceCursors.clear();
+  nodes.clear();
+  railOutputBlocks.clear();
+  deviceInputBlock = -1;
+  emptyBlock = -1;
+
+  std::vector<const TNode *> plannedNodes;
+  std::map<NodeId, std::size_t> indexByNodeId;
+  for (const auto nodeId : order) {
+    const auto *node = doc.findNode(nodeId);
+    if (node == nullptr || indexByNodeId.count(nodeId) != 0)
+      continue;
+
+    indexByNodeId[nodeId] = plannedNodes.size();
+    plannedNodes.push_back(node);
+  }
+
+  int blockCount = 0;
+  std::map<PortId, int> outputBlockByPort;
+  nodes.resize(plannedNodes.size());
+  for (std::size_t nodeIndex = 0; nodeIndex < plannedNodes.size(); ++nodeIndex) {
+    auto &nodeMidi = nodes[nodeIndex];
+    nodeMidi.outputBegin = blockCount;
+    for (const auto &port : plannedNodes[nodeIndex]->ports) {
+      if (port.direction == TPortDirection::Output && isMidiPort(&port))
+        outputBlockByPort[port.portId] = blockCount++;
+    }
+    nodeMidi.outputEnd = blockCount;
+  }
+
+  std::map<PortId, std::vector<PendingSource>> sourcesByInput;
+  std::vector<std::pair<std::size_t, int>> railOutputs;
+
+  for (const auto &conn : doc.connections) {
+    if (!conn.isValid())
+      continue;
+
+    if (conn.from.isNodePort() && conn.to.isNodePort()) {
+      const auto srcIt = indexByNodeId.find(conn.from.nodeId);
+      const auto dstIt = indexByNodeId.find(conn.to.nodeId);
+      if (srcIt == indexByNodeId.end() || dstIt == indexByNodeId.end())
+        continue;
+
+      const auto blockIt = outputBlockByPort.find(conn.from.portId);
+      if (blockIt == outputBlockByPort.end() ||
+          !isMidiPort(plannedNodes[dstIt->second]->findPort(conn.to.portId))) {
+        continue;
+      }
+
+      sourcesByInput[conn.to.portId].push_back({srcIt->second + 1, blockIt->second});
+      continue;
+    }
+
+    if (conn.from.isRailPort() && conn.to.isNodePort()) {
+      const auto *endpoint = doc.controlState.findEndpoint(conn.from.railEndpointId);
+      const auto dstIt = indexByNodeId.find(conn.to.nodeId);
+      if (endpoint == nullptr || dstIt == indexByNodeId.end() ||
+          endpoint->kind != TSystemRailEndpointKind::midiInput ||
+          !isMidiPort(plannedNodes[dstIt->second]->findPort(conn.to.portId))) {
+        continue;
+      }
+
+      if (deviceInputBlock < 0)
+        deviceInputBlock = blockCount++;
+      sourcesByInput[conn.to.portId].push_back({0, deviceInputBlock});
+      continue;
+    }
+
+    if (conn.from.isNodePort() && conn.to.isRailPort()) {
+      const auto *endpoint = doc.controlState.findEndpoint(conn.to.railEndpointId);
+      const auto srcIt = indexByNodeId.find(conn.from.nodeId);
+      const auto blockIt = outputBlockByPort.find(conn.from.portId);
+      if (endpoint == nullptr || srcIt == indexByNodeId.end() ||
+          blockIt == outputBlockByPort.end() ||
+          endpoint->kind != TSystemRailEndpointKind::midiOutput) {
+        continue;
+      }
+
+      railOutputs.emplace_back(srcIt->second, blockIt->second);
+    }
+  }
+
+  std::stable_sort(railOutputs.begin(), railOutputs.end(),
+                   [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+  for (const auto &railOutput : railOutputs)
+    railOutputBlocks.push_back(railOutput.second);
+
+  for (std::size_t nodeIndex = 0; nodeIndex < plannedNodes.size(); ++nodeIndex) {
+    auto &nodeMidi = nodes[nodeIndex];
+    nodeMidi.inputBegin = static_cast<int>(inputs.size());
+
+    for (const auto &port : plannedNodes[nodeIndex]->ports) {
+      if (port.direction != TPortDirection::Input || !isMidiPort(&port))
+        continue;
+
+      Input input;
+      input.portId = port.portId;
+      input.sourceBegin = static_cast<int>(sourceBlocks.size());
+
+      auto sourcesIt = sourcesByInput.find(port.portId);
+      if (sourcesIt != sourcesByInput.end()) {
+        auto &sources = sourcesIt->second;
+        std::stable_sort(sources.begin(), sources.end(),
+                         [](const PendingSource &lhs, const PendingSource &rhs) {
+                           return lhs.order < rhs.order;
+                         });
+        for (const auto &source : sources)
+          sourceBlocks.push_back(source.blockIndex);
+      }
+      input.sourceEnd = static_cast<int>(sourceBlocks.size());
+
+      const int sourceCount = input.sourceEnd - input.sourceBegin;
+      if (sourceCount == 0) {
+        if (emptyBlock < 0)
+          emptyBlock = blockCount++;
+        input.viewBlock = emptyBlock;
+      } else if (sourceCount == 1) {
+        input.viewBlock = sourceBlocks[static_cast<std::size_t>(input.sourceBegin)];
+      } else {
+        input.mergeBlock = blockCount++;
+        input.viewBlock = input.mergeBlock;
+      }
+
+      inputs.push_back(input);
+    }
+
+    nodeMidi.inputEnd = static_cast<int>(inputs.size());
+  }
+
+  allocate(blockCount, maxEventsPerBlock, maxBytesPerBlock);
+}
+
+void TGraphMidiFabric::allocate(int blockCount, int maxEventsPerBlock,
+                                int maxBytesPerBlock) {
+  sourceCursors.assign(sourceBlocks.size(), 0);
+  blocks.clear();
+  blocks.resize(static_cast<std::size_t>(juce::jmax(0, blockCount)));
+  for (auto &block : blocks)
+    block.allocate(maxEventsPerBlock, maxBytesPerBlock);
+}
+
+int TGraphMidiFabric::captureDeviceInput(const juce::MidiBuffer &deviceMidi,
+                                         int startSample,
+                                         int numSamples) noexcept {
+  if (deviceInputBlock < 0)
+    return 0;
+
+  auto &block = blocks[static_cast<std::size_t>(deviceInputBlock)];
+  block.clear();
+  const int endSample = startSample + numSamples;
+  for (auto it = deviceMidi.findNextSamplePosition(startSample); it != deviceMidi.cend();
+       ++it) {
+    const auto metadata = *it;
+    if (metadata.samplePosition >= endSample)
+      break;
+    block.addEvent(metadata.data, metadata.numBytes,
+                   metadata.samplePosition - startSample);
+  }
+
+  return block.getNumDroppedEvents();
+}
+
+int TGraphMidiFabric::prepareNode(std::size_t nodeIndex) noexcept {
+  if (nodeIndex >= nodes.size())
+    return 0;
+
+  const auto &nodeMidi = nodes[nodeIndex];
+  for (int blockIndex = nodeMidi.outputBegin; blockIndex < nodeMidi.outputEnd;
+       ++blockIndex) {
+    blocks[static_cast<std::size_t>(blockIndex)].clear();
+  }
+
+  int dropped = 0;
+  for (int inputIndex = nodeMidi.inputBegin; inputIndex < nodeMidi.inputEnd;
+       ++inputIndex) {
+    const auto &input = inputs[static_cast<std::size_t>(inputIndex)];
+    if (input.mergeBlock >= 0)
+      dropped += mergeInput(input);
+  }
+
+  return dropped;
+}
+
+int TGraphMidiFabric::countOutputDrops(std::size_t nodeIndex) const noexcept {
+  if (nodeIndex >= nodes.size())
+    return 0;
+
+  int dropped = 0;
+  const auto &nodeMidi = nodes[nodeIndex];
+  for (int blockIndex = nodeMidi.outputBegin; blockIndex < nodeMidi.outputEnd;
+       ++blockIndex) {
+    dropped += blocks[static_cast<std::size_t>(blockIndex)].getNumDroppedEvents();
+  }
+
+  return dropped;
+}
+
+bool TGraphMidiFabric::hasInputEvents(std::size_t nodeIndex) const noexcept {
+  if (nodeIndex >= nodes.size())
+    return false;
+
+  const auto &nodeMidi = nodes[nodeIndex];
+  for (int inputIndex = nodeMidi.inputBegin; inputIndex < nodeMidi.inputEnd;
+       ++inputIndex) {
+    const auto &input = inputs[static_cast<std::size_t>(inputIndex)];
+    if (blocks[static_cast<std::size_t>(input.viewBlock)].getNumEvents() > 0)
+      return true;
+  }
+
+  return false;
+}
+
+const TMidiEventBlock *
+TGraphMidiFabric::getFirstInput(std::size_t nodeIndex) const noexcept {
+  if (nodeIndex >= nodes.size())
+    return nullptr;
+
+  const auto &nodeMidi = nodes[nodeIndex];
+  if (nodeMidi.inputBegin == nodeMidi.inputEnd)
+    return nullptr;
+
+  const auto &input = inputs[static_cast<std::size_t>(nodeMidi.inputBegin)];
+  return &blocks[static_cast<std::size_t>(input.viewBlock)];
+}
+
+TMidiEventBlock *TGraphMidiFabric::getFirstOutput(std::size_t nodeIndex) noexcept {
+  if (nodeIndex >= nodes.size())
+    return nullptr;
+
+  const auto &nodeMidi = nodes[nodeIndex];
+  if (nodeMidi.outputBegin == nodeMidi.outputEnd)
+    return nullptr;
+
+  return &blocks[static_cast<std::size_t>(nodeMidi.outputBegin)];
+}
+
+void TGraphMidiFabric::renderRailOutputs(juce::MidiBuffer &destination,
+                                         int startSample, int numSamples) const {
+  for (const int blockIndex : railOutputBlocks) {
+    for (const auto metadata : blocks[static_cast<std::size_t>(blockIndex)]) {
+      if (metadata.samplePosition >= 0 && metadata.samplePosition < numSamples)
+        destination.addEvent(metadata.data, metadata.numBytes,
+                             startSample + metadata.samplePosition);
+    }
+  }
+}
+
+// Sources are already time ordered, so a k-way merge keeps every append at
+// the end of the destination block. Ties go to the earlier source.
+int TGraphMidiFabric::mergeInput(const Input &input) noexcept {
+  auto &destination = blocks[static_cast<std::size_t>(input.mergeBlock)];
+  destination.clear();
+
+  for (int sourceIndex = input.sourceBegin; sourceIndex < input.sourceEnd; ++sourceIndex)
+    sourceCursors[static_cast<std::size_t>(sourceIndex)] = 0;
+
+  for (;;) {
+    int bestSource = -1;
+    int bestPosition = 0;
+    for (int sourceIndex = input.sourceBegin; sourceIndex < input.sourceEnd;
+         ++sourceIndex) {
+      const auto &source =
+          blocks[static_cast<std::size_t>(sourceBlocks[static_cast<std::size_t>(sourceIndex)])];
+      const int cursor = sourceCursors[static_cast<std::size_t>(sourceIndex)];
+      if (cursor >= source.getNumEvents())
+        continue;
+
+      const int position = source.getSamplePosition(cursor);
+      if (bestSource < 0 || position < bestPosition) {
+        bestSource = sourceIndex;
+        bestPosition = position;
+      }
+    }
+
+    if (bestSource < 0)
+      break;
+
+    auto &cursor = sourceCursors[static_cast<std::size_t>(bestSource)];
+    const auto &source =
+        blocks[static_cast<std::size_t>(sourceBlocks[static_cast<std::size_t>(bestSource)])];
+    const auto metadata = source.getEvent(cursor++);
+    destination.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
+  }
+
+  return destination.getNumDroppedEvents();
+}
+
+} // namespace Teul
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../Model/TGraphDocument.h"
+#include "TMidiEventBlock.h"
+#include <JuceHeader.h>
+#include <vector>
+
+namespace Teul {
+
+// MIDI routing resolved at build time. Every MIDI output port and every
+// merged input owns one event block. An input fed by a single source reads
+// that source's block directly, so fan-out shares events instead of copying
+// them; only inputs with several sources merge into their own block. Nodes
+// are indexed in the order passed to build().
+struct TGraphMidiFabric {
+  struct Input {
+    PortId portId = kInvalidPortId;
+    int viewBlock = -1;
+    int mergeBlock = -1;
+    int sourceBegin = 0;
+    int sourceEnd = 0;
+  };
+
+  struct NodeMidi {
+    int inputBegin = 0;
+    int inputEnd = 0;
+    int outputBegin = 0;
+    int outputEnd = 0;
+  };
+
+  std::vector<TMidiEventBlock> blocks;
+  std::vector<Input> inputs;
+  std::vector<int> sourceBlocks;
+  std::vector<int> sourceCursors;
+  std::vector<NodeMidi> nodes;
+  std::vector<int> railOutputBlocks;
+  int deviceInputBlock = -1;
+  int emptyBlock = -1;
+
+  void build(const TGraphDocument &doc, const std::vector<NodeId> &order,
+             int maxEventsPerBlock = TMidiEventBlock::kDefaultMaxEvents,
+             int maxBytesPerBlock = TMidiEventBlock::kDefaultMaxBytes);
+
+  // Creates the event blocks for routing tables that are already filled
+  // in. build() ends with it; tables restored from a static plan call it
+  // themselves.
+  void allocate(int blockCount,
+                int maxEventsPerBlock = TMidiEventBlock::kDefaultMaxEvents,
+                int maxBytesPerBlock = TMidiEventBlock::kDefaultMaxBytes);
+
+  // Both work on the part of the device block starting at startSample;
+  // node blocks hold positions relative to that start.
+  int captureDeviceInput(const juce::MidiBuffer &deviceMidi, int startSample,
+                         int numSamples) noexcept;
+
+  // Clears the node's outputs and merges its multi-source inputs. Must run
+  // after every upstream node finished; returns the events dropped.
+  int prepareNode(std::size_t nodeIndex) noexcept;
+  int countOutputDrops(std::size_t nodeIndex) const noexcept;
+  bool hasInputEvents(std::size_t nodeIndex) const noexcept;
+
+  const TMidiEventBlock *getFirstInput(std::size_t nodeIndex) const noexcept;
+  TMidiEventBlock *getFirstOutput(std::size_t nodeIndex) noexcept;
+
+  void renderRailOutputs(juce::MidiBuffer &destination, int startSample,
+                         int numSamples) const;
+
+private:
+  int mergeInput(const Input &input) noexcept;
+};
+
+} // namespace Teul
@@ -0,0 +1,323 @@
+#include "TGraphNodeRender.h"
+
+#include "TPortMeterBank.h"
+#include <cmath>
+
+namespace Teul {
+
+TGraphNodeRender::TGraphNodeRender(juce::AudioBuffer<float> &portBufferToUse,
+                                   ChannelSignal *channelSignalsToUse,
+                                   int *channelStridesToUse, int silenceChannelToUse,
+                                   TGraphMidiFabric &midiFabricToUse,
+                                   const juce::MidiBuffer &deviceMidiToUse) noexcept
+    : portBuffer(portBufferToUse), channelSignals(channelSignalsToUse),
+      channelStrides(channelStridesToUse), silenceChannel(silenceChannelToUse),
+      midiFabric(midiFabricToUse), deviceMidi(deviceMidiToUse) {}
+
+void TGraphNodeRender::readRailInput(int channelIndex, int deviceChannelIndex,
+                                     const Block &block) noexcept {
+  if (channelIndex < 0 || channelIndex >= portBuffer.getNumChannels())
+    return;
+
+  auto *destination = portBuffer.getWritePointer(channelIndex);
+  auto &signal = channelSignals[static_cast<std::size_t>(channelIndex)];
+  const auto *inputBuffer = block.inputBuffer;
+  if (inputBuffer != nullptr && deviceChannelIndex >= 0 &&
+      deviceChannelIndex < inputBuffer->getNumChannels()) {
+    juce::FloatVectorOperations::copy(
+        destination, inputBuffer->getReadPointer(deviceChannelIndex), block.numSamples);
+    signal = ChannelSignal::Active;
+  } else {
+    juce::FloatVectorOperations::clear(destination, block.numSamples);
+    signal = ChannelSignal::Zeroed;
+  }
+}
+
+void TGraphNodeRender::writeRailOutput(int sourceChannelIndex, int deviceChannelIndex,
+                                       const Block &block) noexcept {
+  auto &deviceBuffer = *block.deviceBuffer;
+  if (sourceChannelIndex < 0 || sourceChannelIndex >= portBuffer.getNumChannels() ||
+      deviceChannelIndex < 0 || deviceChannelIndex >= deviceBuffer.getNumChannels() ||
+      channelSignals[static_cast<std::size_t>(sourceChannelIndex)] !=
+          ChannelSignal::Active) {
+    return;
+  }
+
+  deviceBuffer.addFrom(deviceChannelIndex, 0, portBuffer, sourceChannelIndex, 0,
+                       block.numSamples);
+}
+
+bool TGraphNodeRender::skipsSilentNode(const NodePorts &ports, std::size_t entryIndex,
+                                       int tailSamples, int &silentSamples,
+                                       int numSamples) const noexcept {
+  if (tailSamples < 0)
+    return false;
+
+  if (!inputsAreSilent(ports, entryIndex)) {
+    silentSamples = 0;
+    return false;
+  }
+
+  if (silentSamples >= tailSamples)
+    return true;
+
+  silentSamples = juce::jmin(tailSamples, silentSamples + numSamples);
+  return false;
+}
+
+bool TGraphNodeRender::inputsAreSilent(const NodePorts &ports,
+                                       std::size_t entryIndex) const noexcept {
+  auto isSilent = [this](int channelIndex) {
+    return channelSignals[static_cast<std::size_t>(channelIndex)] !=
+           ChannelSignal::Active;
+  };
+
+  if (!std::all_of(ports.aliasedInputChannels.begin(),
+                   ports.aliasedInputChannels.end(), isSilent)) {
+    return false;
+  }
+
+  for (const auto &sum : ports.inputSums) {
+    if (!std::all_of(sum.srcChannelIndices.begin(), sum.srcChannelIndices.end(),
+                     isSilent)) {
+      return false;
+    }
+  }
+
+  return !midiFabric.hasInputEvents(entryIndex);
+}
+
+void TGraphNodeRender::prepareContext(const NodePorts &ports,
+                                      std::vector<TPortSlot> &blockSlots,
+                                      std::size_t entryIndex, const Block &block,
+                                      TProcessContext &ctx) noexcept {
+  for (const auto &sum : ports.inputSums) {
+    const bool summed = sumChannels(sum, block.numSamples);
+    if (!summed)
+      portBuffer.clear(sum.dstChannelIndex, 0, block.numSamples);
+    channelSignals[static_cast<std::size_t>(sum.dstChannelIndex)] =
+        summed ? ChannelSignal::Active : ChannelSignal::Zeroed;
+    channelStrides[static_cast<std::size_t>(sum.dstChannelIndex)] = 1;
+  }
+
+  // Planned channels are recycled between nodes, so outputs start from
+  // silence for nodes that skip or only partially write them.
+  for (const int channelIndex : ports.clearChannels) {
+    portBuffer.clear(channelIndex, 0, block.numSamples);
+    channelSignals[static_cast<std::size_t>(channelIndex)] = ChannelSignal::Zeroed;
+    channelStrides[static_cast<std::size_t>(channelIndex)] = 1;
+  }
+
+  const TPortSlot *slots = ports.portSlots.data();
+  const bool readsStaleInput = std::any_of(
+      ports.aliasedInputChannels.begin(), ports.aliasedInputChannels.end(),
+      [this](int channelIndex) {
+        return channelSignals[static_cast<std::size_t>(channelIndex)] ==
+               ChannelSignal::Stale;
+      });
+  if (readsStaleInput) {
+    for (std::size_t slotIndex = 0; slotIndex < ports.portSlots.size(); ++slotIndex) {
+      auto slot = ports.portSlots[slotIndex];
+      if (slot.channelIndex >= 0 &&
+          channelSignals[static_cast<std::size_t>(slot.channelIndex)] ==
+              ChannelSignal::Stale) {
+        slot.channelIndex = silenceChannel;
+      }
+      blockSlots[slotIndex] = slot;
+    }
+    slots = blockSlots.data();
+  }
+
+  ctx = {};
+  ctx.globalPortBuffer = &portBuffer;
+  ctx.inputAudioBuffer = block.inputBuffer;
+  ctx.deviceAudioBuffer = block.deviceBuffer;
+  ctx.midiMessages = midiFabric.getFirstInput(entryIndex);
+  ctx.deviceMidiMessages = &deviceMidi;
+  ctx.midiOutputMessages = midiFabric.getFirstOutput(entryIndex);
+  ctx.portSlots = slots;
+  ctx.numPortSlots = static_cast<int>(ports.portSlots.size());
+  ctx.numSamples = block.numSamples;
+  ctx.blockSampleOffset = block.startSample;
+  ctx.channelStrides = channelStrides;
+}
+
+void TGraphNodeRender::renderFused(FusedExpression &fused, const TProcessContext &ctx,
+                                   Level *levels) noexcept {
+  auto *output = ctx.getOutputSamples(fused.outputSlot);
+  if (output == nullptr || fused.tape.getNumInstructions() == 0)
+    return;
+
+  for (std::size_t index = 0; index < fused.inputChannels.size(); ++index) {
+    const int channelIndex = fused.inputChannels[index];
+    auto &input = fused.inputs[index];
+    input = {};
+    if (channelIndex < 0 ||
+        channelSignals[static_cast<std::size_t>(channelIndex)] == ChannelSignal::Stale) {
+      continue;
+    }
+
+    const float *samples = portBuffer.getReadPointer(channelIndex);
+    if (channelStrides[static_cast<std::size_t>(channelIndex)] ==
+        TProcessContext::kConstantStride) {
+      input.constant = samples[0];
+    } else {
+      input.samples = samples;
+    }
+  }
+
+  if (fused.tape.run(fused.inputs.data(), output, ctx.numSamples, levels))
+    ctx.setOutputConstant(fused.outputSlot, output[0]);
+  else
+    channelStrides[static_cast<std::size_t>(ctx.getPortChannel(fused.outputSlot))] = 1;
+}
+
+void TGraphNodeRender::publishOutput(int channelIndex, bool expandConstant,
+                                     bool detectSilence, int numSamples,
+                                     Level *level) noexcept {
+  auto &stride = channelStrides[static_cast<std::size_t>(channelIndex)];
+  auto &signal = channelSignals[static_cast<std::size_t>(channelIndex)];
+  auto *samples = portBuffer.getWritePointer(channelIndex);
+  if (stride != 1 && (stride != TProcessContext::kConstantStride || expandConstant)) {
+    TProcessContext::expandControlRate(samples, stride, numSamples);
+    stride = 1;
+  }
+
+  if (stride == TProcessContext::kConstantStride) {
+    const float magnitude = std::abs(samples[0]);
+    signal = magnitude > 0.0f ? ChannelSignal::Active : ChannelSignal::Zeroed;
+    if (level != nullptr)
+      *level = {juce::jmin(1.0f, magnitude), magnitude};
+    return;
+  }
+
+  if (level != nullptr) {
+    TPortMeterBank::measure(samples, numSamples, level->peak, level->rms);
+    signal = level->peak > 0.0f ? ChannelSignal::Active : ChannelSignal::Zeroed;
+  } else if (detectSilence) {
+    const auto range = juce::FloatVectorOperations::findMinAndMax(samples, numSamples);
+    signal = range.getStart() == 0.0f && range.getEnd() == 0.0f ? ChannelSignal::Zeroed
+                                                                : ChannelSignal::Active;
+  } else {
+    signal = ChannelSignal::Active;
+  }
+}
+
+bool TGraphNodeRender::sumChannels(const TGraphBufferPlan::SumOp &sum,
+                                   int numSamples) noexcept {
+  const auto &sources = sum.srcChannelIndices;
+  const std::size_t numSources = sources.size();
+  if (numSamples <= 0)
+    return false;
+
+  std::size_t cursor = 0;
+  auto nextSource = [&]() -> const float * {
+    while (cursor < numSources) {
+      const int channelIndex = sources[cursor++];
+      if (channelSignals[static_cast<std::size_t>(channelIndex)] == ChannelSignal::Active)
+        return portBuffer.getReadPointer(channelIndex);
+    }
+    return nullptr;
+  };
+
+  const float *a = nextSource();
+  if (a == nullptr)
+    return false;
+
+  float *const destination = portBuffer.getWritePointer(sum.dstChannelIndex);
+  const float *b = nextSource();
+  const float *c = b != nullptr ? nextSource() : nullptr;
+  const float *d = c != nullptr ? nextSource() : nullptr;
+
+  if (b == nullptr) {
+    juce::FloatVectorOperations::copy(destination, a, numSamples);
+  } else if (c == nullptr) {
+    for (int i = 0; i < numSamples; ++i)
+      destination[i] = a[i] + b[i];
+  } else if (d == nullptr) {
+    for (int i = 0; i < numSamples; ++i)
+      destination[i] = a[i] + b[i] + c[i];
+  } else {
+    for (int i = 0; i < numSamples; ++i)
+      destination[i] = a[i] + b[i] + c[i] + d[i];
+  }
+
+  if (d == nullptr)
+    return true;
+
+  while ((a = nextSource()) != nullptr) {
+    b = nextSource();
+    c = b != nullptr ? nextSource() : nullptr;
+    if (c != nullptr) {
+      for (int i = 0; i < numSamples; ++i)
+        destination[i] = destination[i] + a[i] + b[i] + c[i];
+    } else if (b != nullptr) {
+      for (int i = 0; i < numSamples; ++i)
+        destination[i] = destination[i] + a[i] + b[i];
+    } else {
+      for (int i = 0; i < numSamples; ++i)
+        destination[i] += a[i];
+    }
+  }
+
+  return true;
+}
+
+TGraphNodeRender::Block TGraphNodeRender::makeSubBlock(
+    const juce::AudioBuffer<float> *inputBuffer, juce::AudioBuffer<float> &deviceBuffer,
+    int subBlockStart, int subBlockEnd, juce::AudioBuffer<float> &inputView,
+    juce::AudioBuffer<float> &deviceView) noexcept {
+  Block block{subBlockEnd - subBlockStart, inputBuffer, &deviceBuffer, subBlockStart};
+  if (subBlockStart == 0 && subBlockEnd >= deviceBuffer.getNumSamples())
+    return block;
+
+  // JUCE only takes non-const channel pointers.
+  if (inputBuffer != nullptr) {
+    inputView.setDataToReferTo(
+        const_cast<float *const *>(inputBuffer->getArrayOfReadPointers()),
+        inputBuffer->getNumChannels(), subBlockStart, block.numSamples);
+    block.inputBuffer = &inputView;
+  }
+  deviceView.setDataToReferTo(deviceBuffer.getArrayOfWritePointers(),
+                              deviceBuffer.getNumChannels(), subBlockStart,
+                              block.numSamples);
+  block.deviceBuffer = &deviceView;
+  return block;
+}
+
+float TGraphNodeRender::smoothingAlpha(int numSamples, double sampleRate) noexcept {
+  if (sampleRate <= 0.0)
+    return 1.0f;
+
+  return juce::jlimit(0.0f, 1.0f,
+                      static_cast<float>((double)numSamples / sampleRate) / 0.03f);
+}
+
+bool TGraphNodeRender::smoothTowards(float &current, float target,
+                                     float alpha) noexcept {
+  const float delta = target - current;
+  if (std::abs(delta) <= 0.0001f) {
+    current = target;
+    return false;
+  }
+
+  current += delta * alpha;
+  if (!isSmoothing(current, target))
+    current = target;
+  return true;
+}
+
+bool TGraphNodeRender::isSmoothing(float current, float target) noexcept {
+  return std::abs(target - current) > 0.0005f;
+}
+
+int TGraphNodeRender::tailLengthToSamples(float tailLengthMs,
+                                          double sampleRate) noexcept {
+  if (tailLengthMs < 0.0f)
+    return -1;
+
+  return static_cast<int>(std::ceil(static_cast<double>(tailLengthMs) *
+                                    juce::jmax(0.0, sampleRate) / 1000.0));
+}
+
+} // namespace Teul
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "TExpressionTape.h"
+#include "TGraphBufferPlan.h"
+#include "TGraphFusionPlan.h"
+#include "TGraphMidiFabric.h"
+#include "TNodeInstance.h"
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Teul {
+
+// The render steps of one graph entry, shared by TGraphRuntime and the
+// TGraphStaticRenderer of an exported RuntimeModule so that both render the
+// same samples. It is a view of a render state: the port buffer, the signal
+// and stride of each of its channels and the MIDI fabric, all owned by the
+// caller. Views are cheap and are made where they are needed.
+class TGraphNodeRender {
+public:
+  // Per-block state of a port buffer channel. Stale channels are logically
+  // silent but were left untouched by a skipped node, so readers that still
+  // run are pointed at the silence channel instead.
+  enum class ChannelSignal : std::uint8_t { Active, Zeroed, Stale };
+
+  using Level = TExpressionTape::Level;
+
+  // What the buffer plan decided for the ports of one entry.
+  struct NodePorts {
+    std::vector<TPortSlot> portSlots;
+    std::vector<TGraphBufferPlan::SumOp> inputSums;
+    std::vector<int> clearChannels;
+    std::vector<int> aliasedInputChannels;
+  };
+
+  // One sub-block of the device block. The device buffers are views that
+  // start at startSample; the port buffer always starts at zero.
+  struct Block {
+    int numSamples = 0;
+    const juce::AudioBuffer<float> *inputBuffer = nullptr;
+    juce::AudioBuffer<float> *deviceBuffer = nullptr;
+    int startSample = 0;
+  };
+
+  // Math nodes run as one tape per group. Instruction i is the node of
+  // memberEntries[i], the root last; tape input i reads inputChannels[i].
+  struct FusedExpression {
+    TExpressionTape tape;
+    std::vector<int> inputChannels;
+    std::vector<std::size_t> memberEntries;
+    std::vector<std::vector<TGraphFusionPlan::Operand>> memberOperands;
+    int outputSlot = -1;
+    std::vector<TExpressionTape::Input> inputs;
+    std::vector<Level> levels;
+  };
+
+  TGraphNodeRender(juce::AudioBuffer<float> &portBuffer, ChannelSignal *channelSignals,
+                   int *channelStrides, int silenceChannel,
+                   TGraphMidiFabric &midiFabric,
+                   const juce::MidiBuffer &deviceMidi) noexcept;
+
+  // Rail channels are refreshed at the start of every sub-block. A rail
+  // without a device channel, deviceChannelIndex -1, reads as silence.
+  void readRailInput(int channelIndex, int deviceChannelIndex,
+                     const Block &block) noexcept;
+  void writeRailOutput(int sourceChannelIndex, int deviceChannelIndex,
+                       const Block &block) noexcept;
+
+  // Nodes that honour the silence contract stop running once their inputs
+  // have been silent for the declared tail; silentSamples carries the count
+  // between sub-blocks. True when the node skips this sub-block.
+  bool skipsSilentNode(const NodePorts &ports, std::size_t entryIndex,
+                       int tailSamples, int &silentSamples,
+                       int numSamples) const noexcept;
+  bool inputsAreSilent(const NodePorts &ports, std::size_t entryIndex) const noexcept;
+
+  // Fills the entry's fan-in sums and clears its owned outputs, then points
+  // the context at its port slots, with inputs left stale by skipped nodes
+  // redirected to the silence channel through blockSlots.
+  void prepareContext(const NodePorts &ports, std::vector<TPortSlot> &blockSlots,
+                      std::size_t entryIndex, const Block &block,
+                      TProcessContext &ctx) noexcept;
+
+  // Runs a fused group's tape over its input channels, with inputs left
+  // stale by skipped nodes read as silence. levels, when given, receives
+  // every member's result.
+  void renderFused(FusedExpression &fused, const TProcessContext &ctx,
+                   Level *levels) noexcept;
+
+  // Expands a control-rate output unless it is a constant its readers take
+  // as is, and records whether it carries signal. A metered output is
+  // measured into level and the peak doubles as the silence test, which
+  // otherwise runs only for outputs that feed a skippable node.
+  void publishOutput(int channelIndex, bool expandConstant, bool detectSilence,
+                     int numSamples, Level *level) noexcept;
+
+  // Silent sources are left out rather than read. The additions always run
+  // in source order, so every caller gets the same bits.
+  bool sumChannels(const TGraphBufferPlan::SumOp &sum, int numSamples) noexcept;
+
+  // Builds the tape of a group whose memberEntries and memberOperands are
+  // set. entries[i] is an entry with NodePorts, expressionOf(i) the
+  // instance of member entry i.
+  template <typename Entries, typename ExpressionOf>
+  static void assembleFused(FusedExpression &fused, const Entries &entries,
+                            ExpressionOf &&expressionOf) {
+    std::vector<int> resultRegisters;
+    for (std::size_t member = 0; member < fused.memberEntries.size(); ++member) {
+      const auto entryIndex = fused.memberEntries[member];
+      const auto &slots = entries[entryIndex].portSlots;
+      const TExpressionNodeInstance &expression = expressionOf(entryIndex);
+
+      std::array<int, TExpressionTape::kMaxOperands> operands{{-1, -1}};
+      const auto &memberOperands = fused.memberOperands[member];
+      for (std::size_t operand = 0; operand < memberOperands.size(); ++operand) {
+        const auto &source = memberOperands[operand];
+        if (source.member >= 0) {
+          operands[operand] = resultRegisters[static_cast<std::size_t>(source.member)];
+          continue;
+        }
+
+        operands[operand] = fused.tape.addInput();
+        fused.inputChannels.push_back(
+            source.slotIndex >= 0 && source.slotIndex < static_cast<int>(slots.size())
+                ? slots[static_cast<std::size_t>(source.slotIndex)].channelIndex
+                : TPortSlot::kNoChannel);
+      }
+
+      resultRegisters.push_back(fused.tape.addInstruction(
+          expression.getOp(), operands, expression.getParameters()));
+    }
+
+    fused.outputSlot = fused.memberEntries.empty()
+                           ? -1
+                           : expressionOf(fused.memberEntries.back()).getOutputSlot();
+    fused.inputs.resize(fused.inputChannels.size());
+    fused.levels.resize(fused.memberEntries.size());
+  }
+
+  // Splits a device block at the parameter events, at device MIDI and at
+  // maxSamples, with sub-blocks never shorter than minSamples. Events are
+  // sorted here and applied right before the sub-block they fall in;
+  // renderSubBlock(start, end, index) renders one. Returns the count.
+  template <typename Event, typename ApplyEvent, typename RenderSubBlock>
+  static int renderSubBlocks(int numSamples, int minSamples, int maxSamples,
+                             std::vector<Event> &events,
+                             const juce::MidiBuffer &deviceMidi,
+                             ApplyEvent &&applyEvent,
+                             RenderSubBlock &&renderSubBlock) {
+    std::sort(events.begin(), events.end(), [](const Event &lhs, const Event &rhs) {
+      return lhs.sampleOffset < rhs.sampleOffset;
+    });
+
+    std::size_t eventIndex = 0;
+    int subBlockCount = 0;
+    for (int subBlockStart = 0; subBlockStart < numSamples;) {
+      const int earliestSplit = subBlockStart + minSamples;
+      int subBlockEnd = juce::jmin(numSamples, subBlockStart + maxSamples);
+      for (auto index = eventIndex; index < events.size(); ++index) {
+        if (events[index].sampleOffset >= earliestSplit) {
+          subBlockEnd = juce::jmin(subBlockEnd, events[index].sampleOffset);
+          break;
+        }
+      }
+      if (earliestSplit < subBlockEnd) {
+        const auto midiIt = deviceMidi.findNextSamplePosition(earliestSplit);
+        if (midiIt != deviceMidi.cend())
+          subBlockEnd = juce::jmin(subBlockEnd, (*midiIt).samplePosition);
+      }
+
+      for (; eventIndex < events.size() && events[eventIndex].sampleOffset < subBlockEnd;
+           ++eventIndex) {
+        applyEvent(events[eventIndex]);
+      }
+
+      renderSubBlock(subBlockStart, subBlockEnd, subBlockCount++);
+      subBlockStart = subBlockEnd;
+    }
+
+    return subBlockCount;
+  }
+
+  // A sub-block that does not cover the whole device block gets views of
+  // its range; they never write through the input.
+  static Block makeSubBlock(const juce::AudioBuffer<float> *inputBuffer,
+                            juce::AudioBuffer<float> &deviceBuffer, int subBlockStart,
+                            int subBlockEnd, juce::AudioBuffer<float> &inputView,
+                            juce::AudioBuffer<float> &deviceView) noexcept;
+
+  // Smoothed parameters cover about 30 ms whatever the sub-block size.
+  // smoothTowards returns true when current moved and must be applied.
+  static float smoothingAlpha(int numSamples, double sampleRate) noexcept;
+  static bool smoothTowards(float &current, float target, float alpha) noexcept;
+  static bool isSmoothing(float current, float target) noexcept;
+
+  static int tailLengthToSamples(float tailLengthMs, double sampleRate) noexcept;
+
+private:
+  juce::AudioBuffer<float> &portBuffer;
+  ChannelSignal *channelSignals = nullptr;
+  int *channelStrides = nullptr;
+  int silenceChannel = -1;
+  TGraphMidiFabric &midiFabric;
+  const juce::MidiBuffer &deviceMidi;
+};
+
+} // namespace Teul
@@ -1,7 +1,8 @@
 #include "TGraphRuntime.h"
+#include "TSampleStreamer.h"
 
+#include <algorithm>
 #include <cmath>
-#include <cstring>
 #include <map>
 #include <queue>
 #include <set>
@@ -21,9 +22,115 @@ juce::var coerceNumericValue(const juce::var &prototype, float value) {
   return value;
 }
 
-juce::String makeRailPortKey(const juce::String &endpointId,
-                             const juce::String &portId) {
-  return endpointId + "::" + portId;
+int findParamSpecIndex(const TNodeDescriptor *desc, const juce::String &key) {
+  if (desc == nullptr)
+    return -1;
+
+  for (int index = 0; index < static_cast<int>(desc->paramSpecs.size()); ++index) {
+    if (desc->paramSpecs[static_cast<std::size_t>(index)].key == key)
+      return index;
+  }
+
+  return -1;
+}
+
+// Maps each descriptor port spec onto the node's port with the same
+// direction and name; a multi-channel spec gets one slot per channel, named
+// by its channelNames. Ports renamed since the document was saved fall back
+// to the port of the same direction and type at the same ordinal. Inputs
+// whose spec accepts block constants are added to constantPorts.
+std::vector<TPortSlot> resolvePortSlots(const TNode &node,
+                                        const TNodeDescriptor *desc,
+                                        const std::map<PortId, int> &portChannels,
+                                        const std::set<PortId> &connectedPorts,
+                                        std::set<PortId> &constantPorts) {
+  auto makeSlot = [&](const TPort *port) {
+    TPortSlot slot;
+    if (port == nullptr)
+      return slot;
+
+    const auto channelIt = portChannels.find(port->portId);
+    if (channelIt != portChannels.end())
+      slot.channelIndex = channelIt->second;
+    slot.connected = connectedPorts.count(port->portId) != 0;
+    return slot;
+  };
+
+  std::vector<TPortSlot> slots;
+  if (desc == nullptr) {
+    for (const auto &port : node.ports)
+      slots.push_back(makeSlot(&port));
+    return slots;
+  }
+
+  slots.reserve(desc->portSpecs.size());
+  for (std::size_t specIndex = 0; specIndex < desc->portSpecs.size(); ++specIndex) {
+    const auto &spec = desc->portSpecs[specIndex];
+    int ordinal = 0;
+    for (std::size_t previous = 0; previous < specIndex; ++previous) {
+      const auto &other = desc->portSpecs[previous];
+      if (other.direction == spec.direction && other.dataType == spec.dataType)
+        ordinal += juce::jmax(1, other.channelCount);
+    }
+
+    for (int channel = 0; channel < juce::jmax(1, spec.channelCount); ++channel) {
+      const auto &name =
+          spec.channelCount > 1 && channel < static_cast<int>(spec.channelNames.size())
+              ? spec.channelNames[static_cast<std::size_t>(channel)]
+              : spec.name;
+      const TPort *match = nullptr;
+      for (const auto &port : node.ports) {
+        if (port.direction == spec.direction && port.name == name) {
+          match = &port;
+          break;
+        }
+      }
+
+      if (match == nullptr) {
+        int remaining = ordinal + channel;
+        for (const auto &port : node.ports) {
+          if (port.direction != spec.direction || port.dataType != spec.dataType)
+            continue;
+          if (remaining-- == 0) {
+            match = &port;
+            break;
+          }
+        }
+      }
+
+      if (match != nullptr && spec.direction == TPortDirection::Input &&
+          spec.acceptsConstant) {
+        constantPorts.insert(match->portId);
+      }
+
+      slots.push_back(makeSlot(match));
+    }
+  }
+
+  return slots;
+}
+
+juce::var paramValueOrDefault(const TNode &node, const TParamSpec &spec) {
+  const auto it = node.params.find(spec.key);
+  return it != node.params.end() ? it->second : spec.defaultValue;
+}
+
+// Text parameters never reach a running instance, so a node whose text
+// changed gets a new instance instead of the previous one.
+bool textParamsChanged(const TNodeDescriptor *desc, const TNode &previous,
+                       const TNode &current) {
+  if (desc == nullptr)
+    return false;
+
+  for (const auto &spec : desc->paramSpecs) {
+    if (spec.valueType == TParamValueType::String &&
+        paramValueOrDefault(previous, spec).toString() !=
+            paramValueOrDefault(current, spec).toString()) {
+      return true;
+    }
+  }
+
+  return false;
 }
 
 int findRailPortIndex(const TSystemRailEndpoint &endpoint,
@@ -38,24 +145,44 @@ int findRailPortIndex(const TSystemRailEndpoint &endpoint,
 
 } // namespace
 
+class TGraphRuntime::NodeTaskRunner final : public TGraphWorkerPool::TaskRunner {
+public:
+  NodeTaskRunner(TGraphRuntime &runtimeIn, RenderState &stateIn,
+                 const NodeBlockContext &blockIn) noexcept
+      : runtime(runtimeIn), state(stateIn), block(blockIn) {}
+
+  void runTask(int taskIndex) noexcept override {
+    runtime.processNodeEntry(state, static_cast<std::size_t>(taskIndex), block);
+  }
+
+private:
+  TGraphRuntime &runtime;
+  RenderState &state;
+  const NodeBlockContext &block;
+};
+
 TGraphRuntime::TGraphRuntime(const TNodeRegistry *registry)
     : nodeRegistry(registry) {}
 
 TGraphRuntime::~TGraphRuntime() {
+  stopTimer();
   cancelPendingUpdate();
+  workerPool.stop();
   releaseResources();
   pendingState.set(nullptr);
   activeState.set(nullptr);
+  collectRetiredStates();
 }
 
 bool TGraphRuntime::buildGraph(const TGraphDocument &doc) {
   rebuildRequestCount.fetch_add(1, std::memory_order_relaxed);
   const auto buildStartTicks = juce::Time::getHighResolutionTicks();
+  collectRetiredStates();
 
   std::map<NodeId, int> inDegree;
   std::map<NodeId, std::vector<NodeId>> adj;
-  std::set<juce::String> usedRailInputKeys;
   std::set<juce::String> usedRailOutputKeys;
+  std::set<PortId> connectedPorts;
 
   for (const auto &node : doc.nodes)
     inDegree[node.nodeId] = 0;
@@ -64,21 +191,20 @@ bool TGraphRuntime::buildGraph(const TGraphDocument &doc) {
     if (!conn.isValid())
       continue;
 
+    if (conn.from.isNodePort())
+      connectedPorts.insert(conn.from.portId);
+    if (conn.to.isNodePort())
+      connectedPorts.insert(conn.to.portId);
+
     if (conn.from.isNodePort() && conn.to.isNodePort()) {
       adj[conn.from.nodeId].push_back(conn.to.nodeId);
       inDegree[conn.to.nodeId]++;
       continue;
     }
 
-    if (conn.from.isRailPort() && conn.to.isNodePort()) {
-      usedRailInputKeys.insert(
-          makeRailPortKey(conn.from.railEndpointId, conn.from.railPortId));
-      continue;
-    }
-
     if (conn.from.isNodePort() && conn.to.isRailPort()) {
       usedRailOutputKeys.insert(
-          makeRailPortKey(conn.to.railEndpointId, conn.to.railPortId));
+          TGraphBufferPlan::makeRailPortKey(conn.to.railEndpointId, conn.to.railPortId));
     }
   }
 
@@ -103,79 +229,193 @@ bool TGraphRuntime::buildGraph(const TGraphDocument &doc) {
   if (sortedIds.size() != doc.nodes.size())
     return false;
 
+  // Polyphonic regions are planned on a copy of the document with one node
+  // per voice; everything below works on that copy.
+  TGraphVoicePlan voicePlan;
+  const bool expandedVoices = voicePlan.build(doc, sortedIds, nodeRegistry);
+  const TGraphDocument &planDoc = expandedVoices ? voicePlan.expandedDoc : doc;
+  if (expandedVoices) {
+    sortedIds = voicePlan.order;
+    adj.clear();
+    connectedPorts.clear();
+    for (const auto &conn : planDoc.connections) {
+      if (!conn.isValid())
+        continue;
+
+      if (conn.from.isNodePort())
+        connectedPorts.insert(conn.from.portId);
+      if (conn.to.isNodePort())
+        connectedPorts.insert(conn.to.portId);
+      if (conn.from.isNodePort() && conn.to.isNodePort())
+        adj[conn.from.nodeId].push_back(conn.to.nodeId);
+    }
+  }
+
+  std::map<NodeId, const TGraphVoicePlan::VoiceGroup *> voiceGroupByLeader;
+  std::set<NodeId> voiceLaneIds;
+  for (const auto &group : voicePlan.groups) {
+    voiceGroupByLeader[group.nodeId] = &group;
+    voiceLaneIds.insert(std::next(group.voiceNodeIds.begin()), group.voiceNodeIds.end());
+  }
+
+  TGraphBufferPlan bufferPlan;
+  bufferPlan.build(planDoc, sortedIds);
+
   std::vector<NodeEntry> newSortedNodes;
-  newSortedNodes.reserve(sortedIds.size());
+  newSortedNodes.reserve(bufferPlan.nodes.size());
 
-  int portChannelCounter = 0;
-  std::map<PortId, int> globalPortIndexMap;
-  std::map<juce::String, int> railInputChannelMap;
   std::vector<RailInputSource> railInputSources;
   std::vector<RailOutputTarget> railOutputTargets;
-  std::vector<RailMidiInputTarget> railMidiInputTargets;
-  std::vector<RailMidiOutputTarget> railMidiOutputTargets;
-  std::vector<MidiRoute> midiRoutes;
   const double sampleRate = currentSampleRate.load(std::memory_order_relaxed);
   const int blockSize = currentBlockSize.load(std::memory_order_relaxed);
 
-  for (const auto &id : sortedIds) {
-    const TNode *node = doc.findNode(id);
+  // Instances are carried over from the newest state, so unchanged nodes
+  // keep their phase, tails and parameter values across edits.
+  RenderState::Ptr previousState = pendingState.get();
+  if (previousState == nullptr)
+    previousState = activeState.get();
+
+  std::map<NodeId, const NodeEntry *> previousEntries;
+  if (previousState != nullptr) {
+    for (const auto &entry : previousState->sortedNodes)
+      previousEntries[entry.nodeId] = &entry;
+  }
+
+  std::map<NodeId, const NodeEntry *> reusedEntries;
+  std::set<PortId> constantInputPorts;
+
+  for (auto &nodePlan : bufferPlan.nodes) {
+    const TNode *node = planDoc.findNode(nodePlan.nodeId);
     if (node == nullptr)
       continue;
 
     NodeEntry entry;
     entry.nodeId = node->nodeId;
     entry.nodeSnapshot = *node;
+    entry.portChannels = std::move(nodePlan.portChannels);
+    entry.clearChannels = std::move(nodePlan.clearChannels);
+    entry.inputSums = std::move(nodePlan.sums);
 
+    const TNodeDescriptor *desc = nullptr;
+    if (nodeRegistry != nullptr)
+      desc = nodeRegistry->descriptorFor(entry.nodeSnapshot.typeKey);
+
+    entry.portSlots = resolvePortSlots(entry.nodeSnapshot, desc,
+                                       entry.portChannels, connectedPorts,
+                                       constantInputPorts);
+    entry.blockSlots = entry.portSlots;
+    entry.voiceLane = voiceLaneIds.count(entry.nodeId) != 0;
+    const auto groupIt = voiceGroupByLeader.find(entry.nodeId);
+    if (groupIt != voiceGroupByLeader.end())
+      entry.voiceCount = static_cast<int>(groupIt->second->voiceNodeIds.size());
+
+    // Voices render together, so none of them can skip on silence alone.
+    const bool polyphonic = entry.voiceLane || entry.voiceCount > 1;
+    entry.tailLengthMs = desc != nullptr && !polyphonic ? desc->capabilities.tailLengthMs
+                                                        : -1.0f;
+    entry.tailSamples =
+        TGraphNodeRender::tailLengthToSamples(entry.tailLengthMs, sampleRate);
+
+    // Inputs that read another node's channel in place; summed and cleared
+    // inputs own their channel and are handled by inputSums/clearChannels.
     for (const auto &port : entry.nodeSnapshot.ports) {
-      entry.portChannels[port.portId] = portChannelCounter;
-      globalPortIndexMap[port.portId] = portChannelCounter;
-      ++portChannelCounter;
-
-      if (port.dataType == TPortDataType::MIDI) {
-        if (port.direction == TPortDirection::Input)
-          entry.midiInputBuffers.emplace(port.portId, juce::MidiBuffer{});
-        else
-          entry.midiOutputBuffers.emplace(port.portId, juce::MidiBuffer{});
+      if (port.direction != TPortDirection::Input ||
+          port.dataType == TPortDataType::MIDI) {
+        continue;
       }
+
+      const auto channelIt = entry.portChannels.find(port.portId);
+      if (channelIt == entry.portChannels.end() ||
+          channelIt->second == bufferPlan.silenceChannel) {
+        continue;
+      }
+
+      const int channelIndex = channelIt->second;
+      const bool ownedChannel =
+          std::find(entry.clearChannels.begin(), entry.clearChannels.end(),
+                    channelIndex) != entry.clearChannels.end() ||
+          std::any_of(entry.inputSums.begin(), entry.inputSums.end(),
+                      [channelIndex](const SumOp &sum) {
+                        return sum.dstChannelIndex == channelIndex;
+                      });
+      if (!ownedChannel)
+        entry.aliasedInputChannels.push_back(channelIndex);
     }
 
-    const TNodeDescriptor *desc = nullptr;
-    if (nodeRegistry != nullptr)
-      desc = nodeRegistry->descriptorFor(entry.nodeSnapshot.typeKey);
+    if (entry.voiceLane) {
+      newSortedNodes.push_back(std::move(entry));
+      continue;
+    }
 
-    if (desc != nullptr && desc->instanceFactory) {
+    const auto previousIt = previousEntries.find(entry.nodeId);
+    if (previousIt != previousEntries.end() &&
+        previousIt->second->nodeSnapshot.typeKey == entry.nodeSnapshot.typeKey &&
+        previousIt->second->voiceCount == entry.voiceCount &&
+        !textParamsChanged(desc, previousIt->second->nodeSnapshot,
+                           entry.nodeSnapshot)) {
+      entry.instance = previousIt->second->instance;
+      entry.voiceAllocator = previousIt->second->voiceAllocator;
+      reusedEntries[entry.nodeId] = previousIt->second;
+    } else if (desc != nullptr && desc->instanceFactory) {
       entry.instance = desc->instanceFactory();
       if (entry.instance) {
+        std::vector<juce::String> parameterKeys;
+        for (const auto &spec : desc->paramSpecs)
+          parameterKeys.push_back(spec.key);
+        entry.instance->bindParameterKeys(std::move(parameterKeys));
+        entry.instance->setVoiceCount(
+            juce::jlimit(1, TVoiceAllocator::kMaxVoices, entry.voiceCount));
+
         entry.instance->prepareToPlay(sampleRate, blockSize);
         entry.instance->reset();
-        for (const auto &[key, value] : entry.nodeSnapshot.params)
-          entry.instance->setParameterValue(key, paramValueToFloat(value));
+        for (const auto &[key, value] : entry.nodeSnapshot.params) {
+          applyParamValue(*entry.instance, findParamSpecIndex(desc, key), key,
+                          paramValueToFloat(value));
+        }
+        for (std::size_t specIndex = 0; specIndex < desc->paramSpecs.size();
+             ++specIndex) {
+          const auto &spec = desc->paramSpecs[specIndex];
+          if (spec.valueType == TParamValueType::String) {
+            entry.instance->setParameterText(
+                static_cast<int>(specIndex),
+                paramValueOrDefault(entry.nodeSnapshot, spec).toString());
+          }
+        }
       }
     }
 
+    // A reused allocator is still live on the audio thread, so a new voice
+    // count gets a fresh allocator instead of resizing the shared one.
+    if (groupIt != voiceGroupByLeader.end() && groupIt->second->allocatesVoices) {
+      if (entry.voiceAllocator == nullptr ||
+          entry.voiceAllocator->getVoiceCount() !=
+              juce::jlimit(1, TVoiceAllocator::kMaxVoices, entry.voiceCount)) {
+        entry.voiceAllocator = std::make_shared<TVoiceAllocator>();
+        entry.voiceAllocator->setVoiceCount(entry.voiceCount);
+      }
+    } else {
+      entry.voiceAllocator = nullptr;
+    }
+
     newSortedNodes.push_back(std::move(entry));
   }
 
-  for (const auto &endpoint : doc.controlState.inputEndpoints) {
+  for (const auto &endpoint : planDoc.controlState.inputEndpoints) {
     for (const auto &port : endpoint.ports) {
-      const auto key = makeRailPortKey(endpoint.endpointId, port.portId);
-      if (usedRailInputKeys.find(key) == usedRailInputKeys.end())
-        continue;
-
-      if (port.dataType == TPortDataType::MIDI)
+      const int channelIndex =
+          bufferPlan.channelForRailInput(endpoint.endpointId, port.portId);
+      if (port.dataType == TPortDataType::MIDI || channelIndex < 0)
         continue;
 
       RailInputSource source;
       source.endpointId = endpoint.endpointId;
       source.portId = port.portId;
-      source.channelIndex = portChannelCounter;
+      source.channelIndex = channelIndex;
       source.deviceChannelIndex = endpoint.kind == TSystemRailEndpointKind::audioInput
                                       ? juce::jmax(0, findRailPortIndex(endpoint, port.portId))
                                       : -1;
       source.dataType = port.dataType;
-      railInputChannelMap[key] = portChannelCounter;
       railInputSources.push_back(std::move(source));
-      ++portChannelCounter;
     }
   }
 
@@ -183,100 +423,79 @@ bool TGraphRuntime::buildGraph(const TGraphDocument &doc) {
   for (std::size_t index = 0; index < newSortedNodes.size(); ++index)
     entryIndexByNodeId[newSortedNodes[index].nodeId] = index;
 
-  for (const auto &conn : doc.connections) {
-    if (!conn.isValid())
+  // Math nodes whose results only feed other math nodes run as one tape
+  // per group. Nodes that sum fan-in or clear an input channel keep their
+  // own entry, as the tape reads every input in place.
+  std::map<NodeId, TGraphFusionPlan::Candidate> fusionCandidates;
+  for (const auto &entry : newSortedNodes) {
+    const auto *expression =
+        dynamic_cast<const TExpressionNodeInstance *>(entry.instance.get());
+    if (expression == nullptr || entry.voiceLane || entry.voiceCount > 1 ||
+        entry.nodeSnapshot.bypassed || !entry.inputSums.empty()) {
       continue;
+    }
 
-    if (conn.from.isNodePort() && conn.to.isNodePort()) {
-      const auto *sourceNode = doc.findNode(conn.from.nodeId);
-      const auto *targetNode = doc.findNode(conn.to.nodeId);
-      const auto *sourcePort = sourceNode != nullptr ? sourceNode->findPort(conn.from.portId) : nullptr;
-      const auto *targetPort = targetNode != nullptr ? targetNode->findPort(conn.to.portId) : nullptr;
-      const auto srcEntryIt = entryIndexByNodeId.find(conn.from.nodeId);
-      const auto dstEntryIt = entryIndexByNodeId.find(conn.to.nodeId);
-      if (srcEntryIt == entryIndexByNodeId.end() || dstEntryIt == entryIndexByNodeId.end() ||
-          sourcePort == nullptr || targetPort == nullptr) {
-        continue;
-      }
-
-      if (sourcePort->dataType == TPortDataType::MIDI &&
-          targetPort->dataType == TPortDataType::MIDI) {
-        MidiRoute route;
-        route.sourceNodeIndex = srcEntryIt->second;
-        route.sourcePortId = conn.from.portId;
-        route.targetNodeIndex = dstEntryIt->second;
-        route.targetPortId = conn.to.portId;
-        midiRoutes.push_back(std::move(route));
-        continue;
-      }
-
-      const auto srcChannelIt = globalPortIndexMap.find(conn.from.portId);
-      auto &dstEntry = newSortedNodes[dstEntryIt->second];
-      const auto dstChannelIt = dstEntry.portChannels.find(conn.to.portId);
-      if (srcChannelIt == globalPortIndexMap.end() ||
-          dstChannelIt == dstEntry.portChannels.end()) {
+    TGraphFusionPlan::Candidate candidate;
+    for (const auto &port : entry.nodeSnapshot.ports) {
+      if (port.dataType == TPortDataType::MIDI)
         continue;
-      }
+      if (port.direction == TPortDirection::Input)
+        candidate.operandPorts.push_back(port.portId);
+      else
+        candidate.outputPort = port.portId;
+    }
 
-      dstEntry.preProcessMixes.push_back(
-          {srcChannelIt->second, dstChannelIt->second});
+    const auto outputIt = entry.portChannels.find(candidate.outputPort);
+    if (static_cast<int>(candidate.operandPorts.size()) != expression->getNumOperands() ||
+        outputIt == entry.portChannels.end() ||
+        std::any_of(entry.clearChannels.begin(), entry.clearChannels.end(),
+                    [outputIt](int channelIndex) {
+                      return channelIndex != outputIt->second;
+                    })) {
       continue;
     }
+    fusionCandidates[entry.nodeId] = std::move(candidate);
+  }
 
-    if (conn.from.isRailPort() && conn.to.isNodePort()) {
-      const auto *endpoint = doc.controlState.findEndpoint(conn.from.railEndpointId);
-      const auto *targetNode = doc.findNode(conn.to.nodeId);
-      const auto *targetPort = targetNode != nullptr ? targetNode->findPort(conn.to.portId) : nullptr;
-      const auto dstEntryIt = entryIndexByNodeId.find(conn.to.nodeId);
-      if (endpoint == nullptr || targetPort == nullptr || dstEntryIt == entryIndexByNodeId.end())
-        continue;
-
-      if (endpoint->kind == TSystemRailEndpointKind::midiInput &&
-          targetPort->dataType == TPortDataType::MIDI) {
-        RailMidiInputTarget target;
-        target.endpointId = conn.from.railEndpointId;
-        target.portId = conn.from.railPortId;
-        target.targetNodeIndex = dstEntryIt->second;
-        target.targetPortId = conn.to.portId;
-        railMidiInputTargets.push_back(std::move(target));
-        continue;
-      }
-
-      const auto srcChannelIt = railInputChannelMap.find(
-          makeRailPortKey(conn.from.railEndpointId, conn.from.railPortId));
-      auto &dstEntry = newSortedNodes[dstEntryIt->second];
-      const auto dstChannelIt = dstEntry.portChannels.find(conn.to.portId);
-      if (srcChannelIt == railInputChannelMap.end() ||
-          dstChannelIt == dstEntry.portChannels.end()) {
-        continue;
-      }
+  TGraphFusionPlan fusionPlan;
+  fusionPlan.build(planDoc, sortedIds, fusionCandidates);
+  for (const auto &group : fusionPlan.groups) {
+    auto fused = std::make_shared<FusedExpression>();
+    for (const auto &member : group.members) {
+      const auto entryIndex = entryIndexByNodeId[member.nodeId];
+      fused->memberEntries.push_back(entryIndex);
+      fused->memberOperands.push_back(member.operands);
+      newSortedNodes[entryIndex].fusedMember = true;
+    }
+    TGraphNodeRender::assembleFused(
+        *fused, newSortedNodes, [&newSortedNodes](std::size_t entryIndex)
+            -> const TExpressionNodeInstance & {
+          return static_cast<const TExpressionNodeInstance &>(
+              *newSortedNodes[entryIndex].instance);
+        });
+
+    auto &root = newSortedNodes[fused->memberEntries.back()];
+    root.fusedMember = false;
+    root.fusedExpression = std::move(fused);
+    // The tape writes the whole output itself, and the output may share a
+    // channel with an input of an earlier member, so it is not cleared.
+    root.clearChannels.clear();
+  }
 
-      dstEntry.preProcessMixes.push_back(
-          {srcChannelIt->second, dstChannelIt->second});
+  for (const auto &conn : planDoc.connections) {
+    if (!conn.isValid())
       continue;
-    }
 
     if (conn.from.isNodePort() && conn.to.isRailPort()) {
-      const auto *endpoint = doc.controlState.findEndpoint(conn.to.railEndpointId);
-      const auto *sourceNode = doc.findNode(conn.from.nodeId);
+      const auto *endpoint = planDoc.controlState.findEndpoint(conn.to.railEndpointId);
+      const auto *sourceNode = planDoc.findNode(conn.from.nodeId);
       const auto *sourcePort = sourceNode != nullptr ? sourceNode->findPort(conn.from.portId) : nullptr;
       const auto srcEntryIt = entryIndexByNodeId.find(conn.from.nodeId);
       if (endpoint == nullptr || sourcePort == nullptr || srcEntryIt == entryIndexByNodeId.end())
         continue;
 
-      if (endpoint->kind == TSystemRailEndpointKind::midiOutput &&
-          sourcePort->dataType == TPortDataType::MIDI) {
-        RailMidiOutputTarget target;
-        target.endpointId = conn.to.railEndpointId;
-        target.portId = conn.to.railPortId;
-        target.sourceNodeIndex = srcEntryIt->second;
-        target.sourcePortId = conn.from.portId;
-        railMidiOutputTargets.push_back(std::move(target));
-        continue;
-      }
-
-      const auto srcChannelIt = globalPortIndexMap.find(conn.from.portId);
-      if (srcChannelIt == globalPortIndexMap.end() ||
+      const int sourceChannelIndex = bufferPlan.channelForPort(conn.from.portId);
+      if (sourceChannelIndex < 0 ||
           endpoint->kind != TSystemRailEndpointKind::audioOutput) {
         continue;
       }
@@ -289,33 +508,120 @@ bool TGraphRuntime::buildGraph(const TGraphDocument &doc) {
       RailOutputTarget target;
       target.endpointId = endpoint->endpointId;
       target.portId = conn.to.railPortId;
-      target.sourceChannelIndex = srcChannelIt->second;
+      target.sourceChannelIndex = sourceChannelIndex;
       target.deviceChannelIndex = deviceChannelIndex;
       target.dataType = sourcePort->dataType;
       railOutputTargets.push_back(std::move(target));
     }
   }
 
+  // Block constants stay unexpanded only while every reader takes them as
+  // such; rail outputs and fan-in sums always read full blocks.
+  std::map<PortId, int> incomingCountByInput;
+  for (const auto &conn : planDoc.connections) {
+    if (conn.isValid() && conn.to.isNodePort())
+      ++incomingCountByInput[conn.to.portId];
+  }
+
+  std::set<PortId> audioRateOutputs;
+  std::set<PortId> silenceWatchedOutputs;
+  for (const auto &conn : planDoc.connections) {
+    if (!conn.isValid() || !conn.from.isNodePort())
+      continue;
+
+    if (conn.to.isNodePort()) {
+      const auto readerIt = entryIndexByNodeId.find(conn.to.nodeId);
+      if (readerIt != entryIndexByNodeId.end() &&
+          newSortedNodes[readerIt->second].tailLengthMs >= 0.0f) {
+        silenceWatchedOutputs.insert(conn.from.portId);
+      }
+    }
+
+    if (conn.to.isRailPort() || constantInputPorts.count(conn.to.portId) == 0 ||
+        incomingCountByInput[conn.to.portId] > 1) {
+      audioRateOutputs.insert(conn.from.portId);
+    }
+  }
+
+  std::vector<std::set<std::size_t>> successorSets(newSortedNodes.size());
+  for (std::size_t index = 0; index < newSortedNodes.size(); ++index) {
+    for (const NodeId neighbor : adj[newSortedNodes[index].nodeId]) {
+      const auto it = entryIndexByNodeId.find(neighbor);
+      if (it != entryIndexByNodeId.end())
+        successorSets[index].insert(it->second);
+    }
+  }
+
+  // The first voice renders every voice of its node, so it waits for
+  // whatever any of them reads, and the other voices' entries wait for it.
+  for (const auto &group : voicePlan.groups) {
+    const auto leaderIndex = entryIndexByNodeId[group.nodeId];
+    for (std::size_t voice = 1; voice < group.voiceNodeIds.size(); ++voice) {
+      const auto laneIndex = entryIndexByNodeId[group.voiceNodeIds[voice]];
+      for (std::size_t index = 0; index < leaderIndex; ++index) {
+        if (successorSets[index].count(laneIndex) != 0)
+          successorSets[index].insert(leaderIndex);
+      }
+      successorSets[leaderIndex].insert(laneIndex);
+    }
+  }
+
+  std::vector<std::vector<std::size_t>> successorLists(newSortedNodes.size());
+  for (std::size_t index = 0; index < newSortedNodes.size(); ++index)
+    successorLists[index].assign(successorSets[index].begin(), successorSets[index].end());
+
   auto newState = new RenderState();
+  if (previousState != nullptr) {
+    for (const auto &update : previousState->commitParamUpdates) {
+      const bool stillOwned = std::any_of(
+          reusedEntries.begin(), reusedEntries.end(), [&update](const auto &pair) {
+            return pair.second->instance == update.instance;
+          });
+      if (stillOwned)
+        newState->commitParamUpdates.push_back(update);
+    }
+  }
+
   newState->generation =
       buildGenerationCounter.fetch_add(1, std::memory_order_relaxed) + 1;
   newState->sortedNodes = std::move(newSortedNodes);
   newState->railInputSources = std::move(railInputSources);
   newState->railOutputTargets = std::move(railOutputTargets);
-  newState->railMidiInputTargets = std::move(railMidiInputTargets);
-  newState->railMidiOutputTargets = std::move(railMidiOutputTargets);
-  newState->midiRoutes = std::move(midiRoutes);
-  newState->globalPortBuffer.setSize(
-      portChannelCounter > 0 ? portChannelCounter : 1, juce::jmax(1, blockSize),
-      false, false, true);
+  newState->midiFabric.build(planDoc, sortedIds);
+  newState->schedule.build(successorLists);
+  newState->parallelEligible =
+      static_cast<int>(newState->sortedNodes.size()) >= kMinParallelNodeCount &&
+      newState->schedule.maxLevelWidth >= 2;
+  newState->globalPortBuffer.setSize(juce::jmax(1, bufferPlan.channelCount),
+                                     juce::jmax(1, blockSize), false, false,
+                                     true);
   newState->globalPortBuffer.clear();
-  newState->totalAllocatedChannels = portChannelCounter;
+  newState->channelSignals = std::make_unique<ChannelSignal[]>(
+      static_cast<std::size_t>(juce::jmax(1, bufferPlan.channelCount)));
+  std::fill_n(newState->channelSignals.get(), juce::jmax(1, bufferPlan.channelCount),
+              ChannelSignal::Active);
+  newState->channelStrides = std::make_unique<int[]>(
+      static_cast<std::size_t>(juce::jmax(1, bufferPlan.channelCount)));
+  std::fill_n(newState->channelStrides.get(), juce::jmax(1, bufferPlan.channelCount), 1);
+  newState->silenceChannel = bufferPlan.silenceChannel;
+  if (newState->silenceChannel >= 0) {
+    newState->channelSignals[static_cast<std::size_t>(newState->silenceChannel)] =
+        ChannelSignal::Zeroed;
+    newState->channelStrides[static_cast<std::size_t>(newState->silenceChannel)] =
+        TProcessContext::kConstantStride;
+  }
+  newState->totalAllocatedChannels = bufferPlan.channelCount;
+  newState->naivePortChannels = bufferPlan.naiveChannelCount;
+  newState->aliasedInputCount = bufferPlan.aliasedInputCount;
+  newState->summedInputCount = bufferPlan.summedInputCount;
+  newState->fusedNodeCount = fusionPlan.fusedNodeCount;
 
-  for (const auto &entry : newState->sortedNodes) {
+  for (auto &entry : newState->sortedNodes) {
     const TNodeDescriptor *desc = nullptr;
     if (nodeRegistry != nullptr)
       desc = nodeRegistry->descriptorFor(entry.nodeSnapshot.typeKey);
 
+    entry.telemetryBegin = newState->portTelemetry.size();
     for (const auto &port : entry.nodeSnapshot.ports) {
       if (port.direction != TPortDirection::Output ||
           port.dataType == TPortDataType::MIDI) {
@@ -326,32 +632,36 @@ bool TGraphRuntime::buildGraph(const TGraphDocument &doc) {
       if (channelIt == entry.portChannels.end())
         continue;
 
-      newState->portTelemetryIndex[port.portId] = newState->portTelemetry.size();
       newState->portTelemetry.push_back(
-          {port.portId, entry.nodeId, channelIt->second, port.dataType});
+          {port.portId, entry.nodeId, channelIt->second, port.dataType,
+           audioRateOutputs.count(port.portId) != 0,
+           silenceWatchedOutputs.count(port.portId) != 0});
+    }
+    entry.telemetryEnd = newState->portTelemetry.size();
+    if (entry.voiceLane) {
+      ++newState->voiceLaneCount;
+      continue;
     }
 
-    std::set<juce::String> dispatchKeys;
+    std::vector<juce::String> dispatchKeys;
     if (desc != nullptr) {
       for (const auto &spec : desc->paramSpecs)
-        dispatchKeys.insert(spec.key);
+        dispatchKeys.push_back(spec.key);
     }
 
     for (const auto &[key, value] : entry.nodeSnapshot.params) {
       juce::ignoreUnused(value);
-      dispatchKeys.insert(key);
+      if (findParamSpecIndex(desc, key) < 0)
+        dispatchKeys.push_back(key);
     }
 
-    for (const auto &key : dispatchKeys) {
-      const TParamSpec *paramSpec = nullptr;
-      if (desc != nullptr) {
-        for (const auto &candidate : desc->paramSpecs) {
-          if (candidate.key == key) {
-            paramSpec = &candidate;
-            break;
-          }
-        }
-      }
+    for (int paramIndex = 0; paramIndex < static_cast<int>(dispatchKeys.size());
+         ++paramIndex) {
+      const auto &key = dispatchKeys[static_cast<std::size_t>(paramIndex)];
+      const int specIndex = findParamSpecIndex(desc, key);
+      const TParamSpec *paramSpec =
+          specIndex >= 0 ? &desc->paramSpecs[static_cast<std::size_t>(specIndex)]
+                         : nullptr;
 
       const auto valueIt = entry.nodeSnapshot.params.find(key);
       const juce::var initialValue =
@@ -363,25 +673,108 @@ bool TGraphRuntime::buildGraph(const TGraphDocument &doc) {
       dispatch.nodeId = entry.nodeId;
       dispatch.instance = entry.instance.get();
       dispatch.paramKey = key;
+      dispatch.paramIndex = paramIndex;
+      dispatch.specIndex = specIndex;
       dispatch.currentValue = paramValueToFloat(initialValue);
       dispatch.targetValue = dispatch.currentValue;
       dispatch.smoothingEnabled = shouldSmoothParam(paramSpec, initialValue);
-      writeParamKey(dispatch.paramKeyUtf8, key);
+
+      const auto reusedIt = reusedEntries.find(entry.nodeId);
+      if (reusedIt != reusedEntries.end() && entry.instance != nullptr) {
+        const auto &previousParams = reusedIt->second->nodeSnapshot.params;
+        const auto previousValueIt = previousParams.find(key);
+        const juce::var previousValue =
+            previousValueIt != previousParams.end()
+                ? previousValueIt->second
+                : (paramSpec != nullptr ? paramSpec->defaultValue : juce::var{});
+
+        if (previousValue != initialValue) {
+          if (dispatch.smoothingEnabled) {
+            dispatch.currentValue = paramValueToFloat(previousValue);
+          } else {
+            newState->commitParamUpdates.push_back(
+                {entry.instance, key, specIndex, dispatch.targetValue});
+          }
+        }
+      }
+
       newState->paramDispatches.push_back(std::move(dispatch));
     }
   }
 
-  if (!newState->portTelemetry.empty()) {
-    newState->portLevels =
-        std::make_unique<std::atomic<float>[]>(newState->portTelemetry.size());
-    for (std::size_t index = 0; index < newState->portTelemetry.size(); ++index)
-      newState->portLevels[index].store(0.0f, std::memory_order_relaxed);
+  newState->paramEvents.reserve(newState->paramDispatches.size());
+
+  // Shed the lowest priority first and, within a priority, the node the
+  // registry expects to cost the most.
+  struct ShedCandidate {
+    int priority = 0;
+    int cost = 0;
+    std::size_t index = 0;
+  };
+  std::vector<ShedCandidate> shedCandidates;
+  for (std::size_t index = 0; index < newState->sortedNodes.size(); ++index) {
+    const auto &entry = newState->sortedNodes[index];
+    if (entry.voiceAllocator != nullptr)
+      newState->voiceSources.push_back(index);
+    if (entry.voiceLane || entry.voiceCount > 1)
+      continue;
+
+    const TNodeDescriptor *desc =
+        nodeRegistry != nullptr ? nodeRegistry->descriptorFor(entry.nodeSnapshot.typeKey)
+                                : nullptr;
+    if (desc != nullptr && desc->capabilities.shedPriority >= 0) {
+      shedCandidates.push_back({desc->capabilities.shedPriority,
+                                desc->capabilities.estimatedCpuCost, index});
+    }
+  }
+  std::stable_sort(shedCandidates.begin(), shedCandidates.end(),
+                   [](const ShedCandidate &lhs, const ShedCandidate &rhs) {
+                     return lhs.priority != rhs.priority ? lhs.priority < rhs.priority
+                                                         : lhs.cost > rhs.cost;
+                   });
+  for (const auto &candidate : shedCandidates)
+    newState->shedOrder.push_back(candidate.index);
+
+  const int reusedNodeCount = static_cast<int>(reusedEntries.size());
+  lastBuildReusedNodeCount.store(reusedNodeCount, std::memory_order_relaxed);
+  lastBuildCreatedNodeCount.store(
+      static_cast<int>(newState->sortedNodes.size()) - newState->voiceLaneCount -
+          reusedNodeCount,
+      std::memory_order_relaxed);
+  lastBuildDestroyedNodeCount.store(
+      static_cast<int>(previousEntries.size()) - reusedNodeCount,
+      std::memory_order_relaxed);
+
+  // Voices are timed together on their first voice's entry.
+  std::vector<NodeId> profiledNodeIds;
+  std::vector<std::size_t> profiledEntries;
+  profiledNodeIds.reserve(newState->sortedNodes.size());
+  for (std::size_t index = 0; index < newState->sortedNodes.size(); ++index) {
+    if (newState->sortedNodes[index].voiceLane)
+      continue;
+    profiledNodeIds.push_back(newState->sortedNodes[index].nodeId);
+    profiledEntries.push_back(index);
+  }
+  {
+    const juce::ScopedLock lock(profilerLock);
+    const auto profileSlots = nodeProfiler.assignSlots(profiledNodeIds);
+    for (std::size_t index = 0; index < profiledEntries.size(); ++index)
+      newState->sortedNodes[profiledEntries[index]].profileSlot = profileSlots[index];
+  }
+
+  newState->meterSlots =
+      std::make_unique<std::atomic<int>[]>(newState->portTelemetry.size());
+  newState->meterLevels =
+      std::make_unique<TPortMeterBank::BlockLevel[]>(newState->portTelemetry.size());
+  {
+    const juce::ScopedLock lock(meterLock);
+    refreshMeterSlotsLocked(*newState);
   }
 
   {
     const juce::ScopedLock lock(paramSurfaceLock);
     rebuildParamSurfaceLocked(doc);
-    rebuildQueuedParamDispatchLocked(*newState);
+    publishParamRoutesLocked(*newState);
   }
 
   const std::uint64_t buildMicros =
@@ -396,10 +789,18 @@ bool TGraphRuntime::buildGraph(const TGraphDocument &doc) {
     pendingGeneration.store(0, std::memory_order_release);
     rebuildPending.store(false, std::memory_order_release);
     rebuildCommitCount.fetch_add(1, std::memory_order_relaxed);
-    activeNodeCount.store(static_cast<int>(newState->sortedNodes.size()),
-                          std::memory_order_relaxed);
+    activeNodeCount.store(
+        static_cast<int>(newState->sortedNodes.size()) - newState->voiceLaneCount,
+        std::memory_order_relaxed);
     allocatedPortChannels.store(newState->totalAllocatedChannels,
                                 std::memory_order_relaxed);
+    naivePortChannels.store(newState->naivePortChannels,
+                            std::memory_order_relaxed);
+    aliasedInputCount.store(newState->aliasedInputCount,
+                            std::memory_order_relaxed);
+    summedInputCount.store(newState->summedInputCount,
+                           std::memory_order_relaxed);
+    fusedNodeCount.store(newState->fusedNodeCount, std::memory_order_relaxed);
     outputFadeSamplesRemaining = 0;
     outputFadeCurrentGain = 1.0f;
   } else {
@@ -413,11 +814,130 @@ bool TGraphRuntime::buildGraph(const TGraphDocument &doc) {
   return true;
 }
 
+// Reads only what the build fixed; parameter values come from the node
+// snapshots rather than the dispatches the audio thread is updating.
+bool TGraphRuntime::describeStaticPlan(TGraphStaticPlan &plan) const {
+  RenderState::Ptr state = pendingState.get();
+  if (state == nullptr)
+    state = activeState.get();
+  if (state == nullptr)
+    return false;
+
+  plan = {};
+  std::map<NodeId, int> entryIndexByNodeId;
+  for (std::size_t index = 0; index < state->sortedNodes.size(); ++index) {
+    const auto &entry = state->sortedNodes[index];
+    entryIndexByNodeId.emplace(entry.nodeId, static_cast<int>(index));
+    const TNodeDescriptor *desc =
+        nodeRegistry != nullptr ? nodeRegistry->descriptorFor(entry.nodeSnapshot.typeKey)
+                                : nullptr;
+
+    TGraphStaticPlan::Entry planEntry;
+    planEntry.nodeId = entry.nodeId;
+    planEntry.typeKey = entry.nodeSnapshot.typeKey;
+    planEntry.runs = entry.instance != nullptr && !entry.nodeSnapshot.bypassed;
+    planEntry.portSlots = entry.portSlots;
+    planEntry.inputSums = entry.inputSums;
+    planEntry.clearChannels = entry.clearChannels;
+    planEntry.aliasedInputChannels = entry.aliasedInputChannels;
+    for (auto telemetry = entry.telemetryBegin; telemetry < entry.telemetryEnd;
+         ++telemetry) {
+      const auto &port = state->portTelemetry[telemetry];
+      planEntry.outputs.push_back(
+          {port.channelIndex, port.expandConstant, port.detectSilence});
+    }
+    planEntry.tailLengthMs = entry.tailLengthMs;
+    planEntry.voiceCount = entry.voiceCount;
+    planEntry.voiceLane = entry.voiceLane;
+    planEntry.allocatesVoices = entry.voiceAllocator != nullptr;
+    planEntry.fusedMember = entry.fusedMember;
+
+    if (entry.fusedExpression != nullptr) {
+      const auto &fused = *entry.fusedExpression;
+      TGraphStaticPlan::FusionGroup group;
+      for (const auto memberEntry : fused.memberEntries)
+        group.memberEntries.push_back(static_cast<int>(memberEntry));
+      group.operands = fused.memberOperands;
+      group.outputSlot = fused.outputSlot;
+      planEntry.fusionGroup = static_cast<int>(plan.fusionGroups.size());
+      plan.fusionGroups.push_back(std::move(group));
+    }
+
+    if (entry.instance != nullptr && !entry.voiceLane && desc != nullptr) {
+      for (const auto &[key, value] : entry.nodeSnapshot.params) {
+        const int specIndex = findParamSpecIndex(desc, key);
+        if (specIndex >= 0)
+          planEntry.initialParams.push_back({specIndex, paramValueToFloat(value)});
+      }
+      for (std::size_t specIndex = 0; specIndex < desc->paramSpecs.size();
+           ++specIndex) {
+        const auto &spec = desc->paramSpecs[specIndex];
+        if (spec.valueType == TParamValueType::String) {
+          planEntry.textParams.push_back(
+              {static_cast<int>(specIndex),
+               paramValueOrDefault(entry.nodeSnapshot, spec).toString()});
+        }
+      }
+    }
+
+    plan.entries.push_back(std::move(planEntry));
+  }
+
+  // Key-only dispatches reach no instance through the string overload, so
+  // they are left out.
+  for (const auto &dispatch : state->paramDispatches) {
+    const auto entryIt = entryIndexByNodeId.find(dispatch.nodeId);
+    if (dispatch.specIndex < 0 || dispatch.instance == nullptr ||
+        entryIt == entryIndexByNodeId.end()) {
+      continue;
+    }
+
+    const auto &entry = state->sortedNodes[static_cast<std::size_t>(entryIt->second)];
+    const auto *desc = nodeRegistry->descriptorFor(entry.nodeSnapshot.typeKey);
+    const auto &spec = desc->paramSpecs[static_cast<std::size_t>(dispatch.specIndex)];
+
+    TGraphStaticPlan::Param param;
+    param.entryIndex = entryIt->second;
+    param.specIndex = dispatch.specIndex;
+    param.nodeId = dispatch.nodeId;
+    param.paramKey = dispatch.paramKey;
+    param.initialValue =
+        paramValueToFloat(paramValueOrDefault(entry.nodeSnapshot, spec));
+    param.smoothing = dispatch.smoothingEnabled;
+    plan.params.push_back(std::move(param));
+  }
+
+  for (const auto &railInput : state->railInputSources) {
+    plan.railInputs.push_back(
+        {railInput.channelIndex,
+         railInput.dataType == TPortDataType::Audio ? railInput.deviceChannelIndex : -1});
+  }
+  for (const auto &railOutput : state->railOutputTargets) {
+    if (railOutput.dataType == TPortDataType::Audio)
+      plan.railOutputs.push_back(
+          {railOutput.sourceChannelIndex, railOutput.deviceChannelIndex});
+  }
+
+  const auto &fabric = state->midiFabric;
+  plan.midi.inputs = fabric.inputs;
+  plan.midi.sourceBlocks = fabric.sourceBlocks;
+  plan.midi.nodes = fabric.nodes;
+  plan.midi.railOutputBlocks = fabric.railOutputBlocks;
+  plan.midi.deviceInputBlock = fabric.deviceInputBlock;
+  plan.midi.emptyBlock = fabric.emptyBlock;
+  plan.midi.blockCount = static_cast<int>(fabric.blocks.size());
+  plan.channelCount = state->totalAllocatedChannels;
+  plan.silenceChannel = state->silenceChannel;
+  return true;
+}
+
 void TGraphRuntime::prepareToPlay(double sampleRate,
                                   int maximumExpectedSamplesPerBlock) {
   currentSampleRate.store(sampleRate, std::memory_order_relaxed);
   currentBlockSize.store(juce::jmax(1, maximumExpectedSamplesPerBlock),
                          std::memory_order_relaxed);
+  workerPool.start(requestedWorkerThreadCount.load(std::memory_order_relaxed),
+                   requestedWorkerCpuMask.load(std::memory_order_relaxed));
 
   if (const auto state = activeState.get())
     prepareStateForPlayback(*state, sampleRate, maximumExpectedSamplesPerBlock);
@@ -449,6 +969,29 @@ void TGraphRuntime::setCurrentChannelLayout(int inputChannels,
                            std::memory_order_relaxed);
 }
 
+void TGraphRuntime::setWorkerThreadCount(int numHelperThreads) noexcept {
+  requestedWorkerThreadCount.store(
+      juce::jlimit(0, TGraphWorkerPool::kMaxParticipants - 1, numHelperThreads),
+      std::memory_order_relaxed);
+}
+
+int TGraphRuntime::getWorkerThreadCount() const noexcept {
+  return requestedWorkerThreadCount.load(std::memory_order_relaxed);
+}
+
+void TGraphRuntime::setWorkerCpuMask(juce::uint32 helperCpuMask) noexcept {
+  requestedWorkerCpuMask.store(helperCpuMask, std::memory_order_relaxed);
+}
+
+juce::uint32 TGraphRuntime::getWorkerCpuMask() const noexcept {
+  return requestedWorkerCpuMask.load(std::memory_order_relaxed);
+}
+
+int TGraphRuntime::getDefaultWorkerThreadCount() noexcept {
+  return juce::jlimit(0, TGraphWorkerPool::kMaxParticipants - 1,
+                      juce::SystemStats::getNumPhysicalCpus() - 1);
+}
+
 void TGraphRuntime::processBlock(juce::AudioBuffer<float> &deviceBuffer,
                                  juce::MidiBuffer &midiMessages) {
   const int inputChannels = juce::jmin(
@@ -482,7 +1025,7 @@ void TGraphRuntime::processBlockInternal(
   juce::ScopedNoDenormals noDenormals;
   const auto processStartTicks = juce::Time::getHighResolutionTicks();
 
-  commitPendingStateIfNeeded();
+  const bool committedState = commitPendingStateIfNeeded();
 
   processBlockCount.fetch_add(1, std::memory_order_relaxed);
   lastOutputChannels.store(deviceBuffer.getNumChannels(),
@@ -507,9 +1050,9 @@ void TGraphRuntime::processBlockInternal(
     return;
   }
 
-  const int numSamples = juce::jmin(deviceBuffer.getNumSamples(),
-                                    state->globalPortBuffer.getNumSamples());
-  if (numSamples <= 0) {
+  const int numSamples = deviceBuffer.getNumSamples();
+  const int preparedSamples = state->globalPortBuffer.getNumSamples();
+  if (numSamples <= 0 || preparedSamples <= 0) {
     mutedFallbackActive.store(true, std::memory_order_relaxed);
     smoothingActiveCount.store(0, std::memory_order_relaxed);
     clipDetected.store(false, std::memory_order_relaxed);
@@ -520,286 +1063,628 @@ void TGraphRuntime::processBlockInternal(
         ticksToMicros(juce::Time::getHighResolutionTicks() - processStartTicks);
     lastProcessMicros.store(elapsedMicros, std::memory_order_relaxed);
     updateAtomicMax(maxProcessMicros, elapsedMicros);
+    if (committedState)
+      updateAtomicMax(maxCommitBlockMicros, elapsedMicros);
     return;
   }
 
   mutedFallbackActive.store(false, std::memory_order_relaxed);
-  state->globalPortBuffer.clear();
 
-  for (auto &entry : state->sortedNodes) {
-    for (auto &bufferEntry : entry.midiInputBuffers)
-      bufferEntry.second.clear();
-    for (auto &bufferEntry : entry.midiOutputBuffers)
-      bufferEntry.second.clear();
+  // Changes without an offset, or for cells the state does not route, are
+  // handled at once; the rest wait for their sub-block. A cell drained
+  // twice in one block can overflow the reserved events; it applies early.
+  auto &paramEvents = state->paramEvents;
+  paramEvents.clear();
+  const int drainedParamChanges =
+      paramChangeQueue.drain([&](int cell, float value, int sampleOffset) {
+        const int dispatchSlot =
+            cell < static_cast<int>(state->dispatchByCell.size())
+                ? state->dispatchByCell[static_cast<std::size_t>(cell)]
+                : -1;
+        const ParamEvent event{dispatchSlot, value,
+                               juce::jmin(sampleOffset, numSamples - 1)};
+        if (event.sampleOffset > 0 && dispatchSlot >= 0 &&
+            paramEvents.size() < paramEvents.capacity()) {
+          paramEvents.push_back(event);
+        } else {
+          applyParamEvent(*state, event);
+        }
+      });
+
+  blockSkippedNodeCount.store(0, std::memory_order_relaxed);
+  const int minSubBlock = juce::jmax(1, minSubBlockSamples.load(std::memory_order_relaxed));
+  // Port buffers only hold the prepared block size, so longer device blocks
+  // are rendered in chunks no larger than that.
+  const int internalBlock = internalBlockSamples.load(std::memory_order_relaxed);
+  const int maxSubBlock = internalBlock > 0 ? juce::jmin(preparedSamples, internalBlock)
+                                            : preparedSamples;
+  if (numSamples > preparedSamples)
+    chunkedBlockCount.fetch_add(1, std::memory_order_relaxed);
+  const int subBlockCount = TGraphNodeRender::renderSubBlocks(
+      numSamples, minSubBlock, maxSubBlock, paramEvents, deviceInputMidiCaptureBuffer,
+      [&](const ParamEvent &event) { applyParamEvent(*state, event); },
+      [&](int subBlockStart, int subBlockEnd, int subBlockIndex) {
+        const NodeBlockContext block{
+            TGraphNodeRender::makeSubBlock(inputBufferOverride, deviceBuffer,
+                                           subBlockStart, subBlockEnd,
+                                           subBlockInputView, subBlockDeviceView),
+            subBlockIndex == 0};
+        renderSubBlock(*state, block, midiMessages);
+      });
+
+  publishPortMeters(*state);
+  lastSubBlockCount.store(subBlockCount, std::memory_order_relaxed);
+  if (subBlockCount > 1)
+    splitBlockCount.fetch_add(1, std::memory_order_relaxed);
+
+  const int skippedNodes = blockSkippedNodeCount.load(std::memory_order_relaxed);
+  lastSkippedNodeCount.store(skippedNodes, std::memory_order_relaxed);
+  if (skippedNodes > 0) {
+    skippedNodeCount.fetch_add(static_cast<std::uint64_t>(skippedNodes),
+                               std::memory_order_relaxed);
   }
 
-  for (const auto &railInput : state->railInputSources) {
-    if (railInput.channelIndex < 0 ||
-        railInput.channelIndex >= state->globalPortBuffer.getNumChannels()) {
-      continue;
-    }
-
-    auto *destination =
-        state->globalPortBuffer.getWritePointer(railInput.channelIndex);
-    if (railInput.dataType == TPortDataType::Audio && inputBufferOverride != nullptr &&
-        railInput.deviceChannelIndex >= 0 &&
-        railInput.deviceChannelIndex < inputBufferOverride->getNumChannels()) {
-      juce::FloatVectorOperations::copy(
-          destination,
-          inputBufferOverride->getReadPointer(railInput.deviceChannelIndex),
-          numSamples);
-    } else {
-      juce::FloatVectorOperations::clear(destination, numSamples);
-    }
+  int activeVoices = 0;
+  for (const auto index : state->voiceSources) {
+    auto &allocator = *state->sortedNodes[index].voiceAllocator;
+    activeVoices += allocator.getActiveVoiceCount();
+    if (const auto steals = allocator.takeStealCount())
+      voiceStealCount.fetch_add(steals, std::memory_order_relaxed);
   }
+  activeVoiceCount.store(activeVoices, std::memory_order_relaxed);
 
-  if (!deviceInputMidiCaptureBuffer.isEmpty()) {
-    for (const auto &railInput : state->railMidiInputTargets) {
-      if (railInput.targetNodeIndex >= state->sortedNodes.size())
-        continue;
-
-      auto &dstEntry = state->sortedNodes[railInput.targetNodeIndex];
-      const auto dstIt = dstEntry.midiInputBuffers.find(railInput.targetPortId);
-      if (dstIt == dstEntry.midiInputBuffers.end())
-        continue;
-
-      dstIt->second.addEvents(deviceInputMidiCaptureBuffer, 0, numSamples, 0);
+  if (nodeProfiler.isEnabled()) {
+    for (const auto &entry : state->sortedNodes) {
+      if (entry.processedThisBlock)
+        nodeProfiler.record(entry.profileSlot, entry.nodeId, entry.lastProcessTicks);
     }
   }
 
-  int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
-  paramQueueFifo.prepareToRead(paramQueueFifo.getNumReady(), start1, size1,
-                               start2, size2);
-
-  auto applyParamChange = [&](const ParamChange &change) {
-    ParamDispatch *dispatch = nullptr;
+  if (outputFadeSamplesRemaining > 0) {
+    const int fadeSamples = juce::jmin(outputFadeSamplesRemaining, numSamples);
+    const float startGain = outputFadeCurrentGain;
+    const float gainStep =
+        fadeSamples > 0 ? (1.0f - startGain) / (float)fadeSamples : 0.0f;
 
-    if (change.generation == state->generation && change.dispatchSlot >= 0 &&
-        change.dispatchSlot < static_cast<int>(state->paramDispatches.size())) {
-      dispatch = &state->paramDispatches[static_cast<std::size_t>(change.dispatchSlot)];
-    } else {
-      for (auto &candidate : state->paramDispatches) {
-        if (dispatchMatches(candidate, change.nodeId, change.paramKey)) {
-          dispatch = &candidate;
-          break;
-        }
+    for (int channelIndex = 0; channelIndex < deviceBuffer.getNumChannels();
+         ++channelIndex) {
+      auto *samples = deviceBuffer.getWritePointer(channelIndex);
+      float gain = startGain;
+      for (int sampleIndex = 0; sampleIndex < fadeSamples; ++sampleIndex) {
+        samples[sampleIndex] *= gain;
+        gain += gainStep;
       }
     }
 
-    if (dispatch == nullptr || dispatch->instance == nullptr) {
-      droppedParamChangeCount.fetch_add(1, std::memory_order_relaxed);
-      return;
+    outputFadeCurrentGain = juce::jmin(1.0f, startGain + gainStep * fadeSamples);
+    outputFadeSamplesRemaining -= fadeSamples;
+    if (outputFadeSamplesRemaining <= 0) {
+      outputFadeSamplesRemaining = 0;
+      outputFadeCurrentGain = 1.0f;
     }
+  }
 
-    if (dispatch->smoothingEnabled) {
-      dispatch->targetValue = change.value;
-      return;
+  bool clipped = false;
+  bool denormal = false;
+  for (int channelIndex = 0; channelIndex < deviceBuffer.getNumChannels();
+       ++channelIndex) {
+    const float *samples = deviceBuffer.getReadPointer(channelIndex);
+    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
+      const float sample = samples[sampleIndex];
+      const float magnitude = std::abs(sample);
+      if (magnitude > 1.0f)
+        clipped = true;
+      if (magnitude > 0.0f && magnitude < 1.0e-20f)
+        denormal = true;
     }
+  }
 
-    dispatch->currentValue = change.value;
-    dispatch->targetValue = change.value;
-    dispatch->instance->setParameterValue(dispatch->paramKey, change.value);
-    paramChangeCount.fetch_add(1, std::memory_order_relaxed);
-    reportParamValueChange(change.nodeId, dispatch->paramKey, change.value);
-  };
+  clipDetected.store(clipped, std::memory_order_relaxed);
+  denormalDetected.store(denormal, std::memory_order_relaxed);
 
-  for (int i = 0; i < size1; ++i)
-    applyParamChange(paramQueueData[start1 + i]);
-  for (int i = 0; i < size2; ++i)
-    applyParamChange(paramQueueData[start2 + i]);
-  paramQueueFifo.finishedRead(size1 + size2);
+  const auto elapsedMicros =
+      ticksToMicros(juce::Time::getHighResolutionTicks() - processStartTicks);
+  lastProcessMicros.store(elapsedMicros, std::memory_order_relaxed);
+  updateAtomicMax(maxProcessMicros, elapsedMicros);
+  if (committedState)
+    updateAtomicMax(maxCommitBlockMicros, elapsedMicros);
 
   const double sampleRate = currentSampleRate.load(std::memory_order_relaxed);
-  const float rampAlpha =
-      (sampleRate > 0.0)
-          ? juce::jlimit(0.0f, 1.0f,
-                         static_cast<float>((double)numSamples / sampleRate) /
-                             0.03f)
-          : 1.0f;
-  int smoothingCount = 0;
+  const double blockBudgetMicros =
+      sampleRate > 0.0 ? ((double)numSamples / sampleRate) * 1000000.0 : 0.0;
+  const bool overBudget =
+      blockBudgetMicros > 0.0 && (double)elapsedMicros > blockBudgetMicros;
+  xrunDetected.store(overBudget, std::memory_order_relaxed);
+  if (blockBudgetMicros > 0.0) {
+    const auto load = static_cast<float>((double)elapsedMicros / blockBudgetMicros);
+    blockLatency.recordBlock(load);
+    updateLoadShedding(*state, load, (double)numSamples / sampleRate,
+                       blockBudgetMicros);
+  }
+  if (overBudget) {
+    recordOverBudgetBlock(*state, numSamples, elapsedMicros, blockBudgetMicros,
+                          committedState, drainedParamChanges);
+  }
+}
 
-  for (auto &dispatch : state->paramDispatches) {
-    if (!dispatch.smoothingEnabled || dispatch.instance == nullptr)
-      continue;
+// Renders one sub-block as if it were a whole block: device input and MIDI
+// are read from the sub-block's range, and its outputs land at the same
+// range of the device buffer and MIDI output.
+void TGraphRuntime::renderSubBlock(RenderState &state, const NodeBlockContext &block,
+                                   juce::MidiBuffer &midiMessages) noexcept {
+  const int numSamples = block.numSamples;
+  auto nodeRender = nodeRenderFor(state);
+  for (const auto &railInput : state.railInputSources) {
+    nodeRender.readRailInput(railInput.channelIndex,
+                             railInput.dataType == TPortDataType::Audio
+                                 ? railInput.deviceChannelIndex
+                                 : -1,
+                             block);
+  }
+
+  const int droppedDeviceMidi = state.midiFabric.captureDeviceInput(
+      deviceInputMidiCaptureBuffer, block.startSample, numSamples);
+  if (droppedDeviceMidi > 0) {
+    droppedMidiEventCount.fetch_add(static_cast<std::uint64_t>(droppedDeviceMidi),
+                                    std::memory_order_relaxed);
+  }
+
+  const float rampAlpha = TGraphNodeRender::smoothingAlpha(
+      numSamples, currentSampleRate.load(std::memory_order_relaxed));
+  int smoothingCount = 0;
 
-    const float delta = dispatch.targetValue - dispatch.currentValue;
-    if (std::abs(delta) <= 0.0001f) {
-      dispatch.currentValue = dispatch.targetValue;
+  for (auto &dispatch : state.paramDispatches) {
+    if (!dispatch.smoothingEnabled || dispatch.instance == nullptr ||
+        !TGraphNodeRender::smoothTowards(dispatch.currentValue, dispatch.targetValue,
+                                         rampAlpha)) {
       continue;
     }
 
-    dispatch.currentValue += delta * rampAlpha;
-    if (std::abs(dispatch.targetValue - dispatch.currentValue) <= 0.0005f)
-      dispatch.currentValue = dispatch.targetValue;
-
-    dispatch.instance->setParameterValue(dispatch.paramKey, dispatch.currentValue);
+    applyParamValue(*dispatch.instance, dispatch.specIndex, dispatch.paramKey,
+                    dispatch.currentValue);
     paramChangeCount.fetch_add(1, std::memory_order_relaxed);
-    reportParamValueChange(dispatch.nodeId, dispatch.paramKey,
-                           dispatch.currentValue);
+    paramValueMirror.write(dispatch.cell, dispatch.currentValue);
 
-    if (std::abs(dispatch.targetValue - dispatch.currentValue) > 0.0005f)
+    if (TGraphNodeRender::isSmoothing(dispatch.currentValue, dispatch.targetValue))
       ++smoothingCount;
   }
 
   smoothingActiveCount.store(smoothingCount, std::memory_order_relaxed);
 
-  for (std::size_t entryIndex = 0; entryIndex < state->sortedNodes.size(); ++entryIndex) {
-    auto &entry = state->sortedNodes[entryIndex];
-
-    for (const auto &mix : entry.preProcessMixes) {
-      state->globalPortBuffer.addFrom(mix.dstChannelIndex, 0,
-                                      state->globalPortBuffer,
-                                      mix.srcChannelIndex, 0, numSamples);
+  if (state.parallelEligible && workerPool.getNumHelperThreads() > 0) {
+    NodeTaskRunner runner(*this, state, block);
+    workerPool.run(state.schedule, runner);
+    if (block.firstSubBlock)
+      parallelBlockCount.fetch_add(1, std::memory_order_relaxed);
+    for (int index = 0; index < TGraphWorkerPool::kMaxParticipants; ++index) {
+      workerBusyMicros[static_cast<std::size_t>(index)].store(
+          workerPool.getLastBusyMicros(index), std::memory_order_relaxed);
     }
+  } else {
+    const auto serialStartTicks = juce::Time::getHighResolutionTicks();
+    for (std::size_t entryIndex = 0; entryIndex < state.sortedNodes.size(); ++entryIndex)
+      processNodeEntry(state, entryIndex, block);
+
+    workerBusyMicros[0].store(
+        ticksToMicros(juce::Time::getHighResolutionTicks() - serialStartTicks),
+        std::memory_order_relaxed);
+    for (int index = 1; index < TGraphWorkerPool::kMaxParticipants; ++index)
+      workerBusyMicros[static_cast<std::size_t>(index)].store(0, std::memory_order_relaxed);
+  }
 
-    juce::MidiBuffer *nodeMidiInput = nullptr;
-    if (!entry.midiInputBuffers.empty())
-      nodeMidiInput = &entry.midiInputBuffers.begin()->second;
-
-    juce::MidiBuffer *nodeMidiOutput = nullptr;
-    if (!entry.midiOutputBuffers.empty())
-      nodeMidiOutput = &entry.midiOutputBuffers.begin()->second;
-
-    if (entry.instance && !entry.nodeSnapshot.bypassed) {
-      TProcessContext ctx;
-      ctx.globalPortBuffer = &state->globalPortBuffer;
-      ctx.inputAudioBuffer = inputBufferOverride;
-      ctx.deviceAudioBuffer = &deviceBuffer;
-      ctx.midiMessages = nodeMidiInput;
-      ctx.deviceMidiMessages = &deviceInputMidiCaptureBuffer;
-      ctx.midiOutputMessages = nodeMidiOutput;
-      ctx.portToChannel = &entry.portChannels;
-      ctx.nodeData = &entry.nodeSnapshot;
-      ctx.paramValueReporter = this;
-      entry.instance->processSamples(ctx);
+  state.midiFabric.renderRailOutputs(midiMessages, block.startSample, numSamples);
+
+  for (const auto &railOutput : state.railOutputTargets) {
+    if (railOutput.dataType == TPortDataType::Audio) {
+      nodeRender.writeRailOutput(railOutput.sourceChannelIndex,
+                                 railOutput.deviceChannelIndex, block);
     }
+  }
+}
 
-    for (const auto &route : state->midiRoutes) {
-      if (route.sourceNodeIndex != entryIndex)
-        continue;
+void TGraphRuntime::applyParamEvent(RenderState &state,
+                                    const ParamEvent &event) noexcept {
+  auto *dispatch =
+      event.dispatchSlot >= 0
+          ? &state.paramDispatches[static_cast<std::size_t>(event.dispatchSlot)]
+          : nullptr;
+  if (dispatch == nullptr || dispatch->instance == nullptr) {
+    droppedParamChangeCount.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
 
-      const auto srcIt = entry.midiOutputBuffers.find(route.sourcePortId);
-      if (srcIt == entry.midiOutputBuffers.end() || srcIt->second.isEmpty() ||
-          route.targetNodeIndex >= state->sortedNodes.size()) {
-        continue;
-      }
+  if (dispatch->smoothingEnabled) {
+    dispatch->targetValue = event.value;
+    return;
+  }
 
-      auto &dstEntry = state->sortedNodes[route.targetNodeIndex];
-      const auto dstIt = dstEntry.midiInputBuffers.find(route.targetPortId);
-      if (dstIt == dstEntry.midiInputBuffers.end())
-        continue;
+  dispatch->currentValue = event.value;
+  dispatch->targetValue = event.value;
+  applyParamValue(*dispatch->instance, dispatch->specIndex, dispatch->paramKey,
+                  event.value);
+  paramChangeCount.fetch_add(1, std::memory_order_relaxed);
+  paramValueMirror.write(dispatch->cell, event.value);
+}
 
-      dstIt->second.addEvents(srcIt->second, 0, numSamples, 0);
-    }
+// Runs on the audio thread only for blocks that missed their deadline, so
+// the scan for the slowest nodes stays off the common path.
+void TGraphRuntime::recordOverBudgetBlock(const RenderState &state, int numSamples,
+                                          std::uint64_t elapsedMicros,
+                                          double budgetMicros, bool committedState,
+                                          int paramChanges) noexcept {
+  TBlockLatencyMonitor::XrunRecord record;
+  record.blockIndex = processBlockCount.load(std::memory_order_relaxed) - 1;
+  record.timeMillis = juce::Time::currentTimeMillis();
+  record.generation = state.generation;
+  record.elapsedMicros = static_cast<float>(elapsedMicros);
+  record.budgetMicros = static_cast<float>(budgetMicros);
+  record.numSamples = numSamples;
+  record.paramChanges = paramChanges;
+  record.rebuildCommitted = committedState;
+  record.paramBurst = paramChanges >= TBlockLatencyMonitor::kParamBurstThreshold;
+
+  auto &topNodes = record.topNodes;
+  for (const auto &entry : state.sortedNodes) {
+    const auto micros = static_cast<float>(
+        juce::Time::highResolutionTicksToSeconds(entry.lastProcessTicks) * 1000000.0);
+    if (micros <= topNodes.back().micros)
+      continue;
 
-    for (const auto &target : state->railMidiOutputTargets) {
-      if (target.sourceNodeIndex != entryIndex)
-        continue;
+    auto slot = topNodes.size() - 1;
+    for (; slot > 0 && micros > topNodes[slot - 1].micros; --slot)
+      topNodes[slot] = topNodes[slot - 1];
+    topNodes[slot] = {entry.nodeId, micros};
+  }
 
-      const auto srcIt = entry.midiOutputBuffers.find(target.sourcePortId);
-      if (srcIt == entry.midiOutputBuffers.end() || srcIt->second.isEmpty())
-        continue;
+  blockLatency.recordXrun(record);
+}
 
-      midiMessages.addEvents(srcIt->second, 0, numSamples, 0);
-    }
+// Runs after every block. A shed node keeps the cost it had when it was
+// shed, decayed over time, so the restore decision can check that it fits
+// again; nodes come back in the reverse order they left.
+void TGraphRuntime::updateLoadShedding(RenderState &state, float load,
+                                       double blockSeconds,
+                                       double budgetMicros) noexcept {
+  const bool canShed = state.shedCount < state.shedOrder.size();
+  float unshedCost = -1.0f;
+  float &restoreCost =
+      state.shedCount > 0
+          ? state.sortedNodes[state.shedOrder[state.shedCount - 1]].shedCost
+          : unshedCost;
+  const auto action = loadShedder.update(load, blockSeconds, canShed, restoreCost);
+  if (action == TLoadShedder::Action::none)
+    return;
+
+  if (action == TLoadShedder::Action::shed) {
+    auto &entry = state.sortedNodes[state.shedOrder[state.shedCount++]];
+    entry.shedCost = static_cast<float>(
+        (double)ticksToMicros(entry.lastProcessTicks) / budgetMicros);
+    entry.shedState = ShedState::FadingOut;
+    loadShedder.recordEvent(entry.nodeId, false, loadShedder.getSmoothedLoad());
+  } else {
+    auto &entry = state.sortedNodes[state.shedOrder[--state.shedCount]];
+    entry.shedState = ShedState::FadingIn;
+    loadShedder.recordEvent(entry.nodeId, true, loadShedder.getSmoothedLoad());
   }
 
-  for (const auto &railOutput : state->railOutputTargets) {
-    if (railOutput.dataType != TPortDataType::Audio ||
-        railOutput.sourceChannelIndex < 0 ||
-        railOutput.sourceChannelIndex >= state->globalPortBuffer.getNumChannels() ||
-        railOutput.deviceChannelIndex < 0 ||
-        railOutput.deviceChannelIndex >= deviceBuffer.getNumChannels()) {
+  shedNodeCount.store(static_cast<int>(state.shedCount), std::memory_order_relaxed);
+}
+
+// Ramps the node's audio outputs towards the target of its fade and settles
+// the shed state once the ramp is complete.
+void TGraphRuntime::applyShedFade(RenderState &state, NodeEntry &entry,
+                                  int numSamples) noexcept {
+  const bool fadingOut = entry.shedState == ShedState::FadingOut;
+  const float step =
+      (fadingOut ? -1.0f : 1.0f) / static_cast<float>(kShedFadeSamples);
+  const float startGain = entry.shedGain;
+  auto *channelStrides = state.channelStrides.get();
+  for (std::size_t index = entry.telemetryBegin; index < entry.telemetryEnd; ++index) {
+    const auto &telemetry = state.portTelemetry[index];
+    if (telemetry.dataType != TPortDataType::Audio)
       continue;
+
+    auto &stride = channelStrides[static_cast<std::size_t>(telemetry.channelIndex)];
+    auto *samples = state.globalPortBuffer.getWritePointer(telemetry.channelIndex);
+    if (stride != 1) {
+      TProcessContext::expandControlRate(samples, stride, numSamples);
+      stride = 1;
     }
 
-    deviceBuffer.addFrom(railOutput.deviceChannelIndex, 0,
-                         state->globalPortBuffer,
-                         railOutput.sourceChannelIndex, 0, numSamples);
+    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
+      samples[sampleIndex] *=
+          juce::jlimit(0.0f, 1.0f, startGain + step * (float)(sampleIndex + 1));
+    }
   }
 
-  if (outputFadeSamplesRemaining > 0) {
-    const int fadeSamples = juce::jmin(outputFadeSamplesRemaining, numSamples);
-    const float startGain = outputFadeCurrentGain;
-    const float gainStep =
-        fadeSamples > 0 ? (1.0f - startGain) / (float)fadeSamples : 0.0f;
+  entry.shedGain = juce::jlimit(0.0f, 1.0f, startGain + step * (float)numSamples);
+  if (fadingOut && entry.shedGain <= 0.0f)
+    entry.shedState = ShedState::Shed;
+  else if (!fadingOut && entry.shedGain >= 1.0f)
+    entry.shedState = ShedState::Active;
+}
 
-    for (int channelIndex = 0; channelIndex < deviceBuffer.getNumChannels();
-         ++channelIndex) {
-      auto *samples = deviceBuffer.getWritePointer(channelIndex);
-      float gain = startGain;
-      for (int sampleIndex = 0; sampleIndex < fadeSamples; ++sampleIndex) {
-        samples[sampleIndex] *= gain;
-        gain += gainStep;
+void TGraphRuntime::processNodeEntry(RenderState &state, std::size_t entryIndex,
+                                     const NodeBlockContext &block) noexcept {
+  auto &entry = state.sortedNodes[entryIndex];
+  auto *channelSignals = state.channelSignals.get();
+  if (block.firstSubBlock) {
+    entry.lastProcessTicks = 0;
+    entry.processedThisBlock = false;
+  }
+
+  // The other voices of a polyphonic node are rendered by its first voice,
+  // fused members by their group's root.
+  if (entry.voiceLane || entry.fusedMember)
+    return;
+
+  int droppedMidiEvents = state.midiFabric.prepareNode(entryIndex);
+  const auto voiceCount = static_cast<std::size_t>(
+      juce::jlimit(1, TVoiceAllocator::kMaxVoices, entry.voiceCount));
+
+  // Nodes that honour the silence contract stop running once their inputs
+  // have been silent for the declared tail. Skipped, bypassed, shed and
+  // instance-less nodes leave their outputs untouched and only mark them.
+  bool runNode = entry.instance && !entry.nodeSnapshot.bypassed &&
+                 entry.shedState != ShedState::Shed;
+  if (runNode && nodeRenderFor(state).skipsSilentNode(entry, entryIndex,
+                                                      entry.tailSamples,
+                                                      entry.silentSamples,
+                                                      block.numSamples)) {
+    runNode = false;
+    blockSkippedNodeCount.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  if (!runNode) {
+    // A fade has nothing to ramp while the node is not running.
+    if (entry.shedState == ShedState::FadingOut) {
+      entry.shedState = ShedState::Shed;
+      entry.shedGain = 0.0f;
+    } else if (entry.shedState == ShedState::FadingIn) {
+      entry.shedState = ShedState::Active;
+      entry.shedGain = 1.0f;
+    }
+
+    for (std::size_t voice = 0; voice < voiceCount; ++voice) {
+      const auto &voiceEntry = state.sortedNodes[entryIndex + voice];
+      for (std::size_t index = voiceEntry.telemetryBegin; index < voiceEntry.telemetryEnd;
+           ++index) {
+        const auto &telemetry = state.portTelemetry[index];
+        channelSignals[static_cast<std::size_t>(telemetry.channelIndex)] =
+            ChannelSignal::Stale;
+        if (state.meterSlots[index].load(std::memory_order_relaxed) >= 0)
+          state.meterLevels[index].add(0.0f, 0.0f, block.numSamples);
       }
     }
 
-    outputFadeCurrentGain = juce::jmin(1.0f, startGain + gainStep * fadeSamples);
-    outputFadeSamplesRemaining -= fadeSamples;
-    if (outputFadeSamplesRemaining <= 0) {
-      outputFadeSamplesRemaining = 0;
-      outputFadeCurrentGain = 1.0f;
+    if (droppedMidiEvents > 0) {
+      droppedMidiEventCount.fetch_add(static_cast<std::uint64_t>(droppedMidiEvents),
+                                      std::memory_order_relaxed);
     }
+    return;
   }
 
-  bool clipped = false;
-  bool denormal = false;
-  for (int channelIndex = 0; channelIndex < deviceBuffer.getNumChannels();
-       ++channelIndex) {
-    const float *samples = deviceBuffer.getReadPointer(channelIndex);
-    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
-      const float sample = samples[sampleIndex];
-      const float magnitude = std::abs(sample);
-      if (magnitude > 1.0f)
-        clipped = true;
-      if (magnitude > 0.0f && magnitude < 1.0e-20f)
-        denormal = true;
+  std::array<TProcessContext, TVoiceAllocator::kMaxVoices> voiceContexts;
+  for (std::size_t voice = 0; voice < voiceCount; ++voice)
+    prepareNodeContext(state, entryIndex + voice, block, voiceContexts[voice]);
+  voiceContexts[0].voiceAllocator = entry.voiceAllocator.get();
+
+  const auto nodeStartTicks = juce::Time::getHighResolutionTicks();
+  if (entry.fusedExpression != nullptr)
+    renderFusedExpression(state, entry, voiceContexts[0]);
+  else if (voiceCount > 1)
+    entry.instance->processVoices(voiceContexts.data(), static_cast<int>(voiceCount));
+  else
+    entry.instance->processSamples(voiceContexts[0]);
+  const auto processTicks = juce::Time::getHighResolutionTicks() - nodeStartTicks;
+  if (entry.fusedExpression != nullptr) {
+    // Fused members are profiled as equal shares of their tape.
+    const auto &members = entry.fusedExpression->memberEntries;
+    for (const auto memberIndex : members) {
+      auto &member = state.sortedNodes[memberIndex];
+      member.lastProcessTicks +=
+          processTicks / static_cast<juce::int64>(members.size());
+      member.processedThisBlock = true;
     }
+  } else {
+    entry.lastProcessTicks += processTicks;
+  }
+  entry.processedThisBlock = true;
+  droppedMidiEvents += state.midiFabric.countOutputDrops(entryIndex);
+  if (entry.shedState != ShedState::Active)
+    applyShedFade(state, entry, block.numSamples);
+
+  if (droppedMidiEvents > 0) {
+    droppedMidiEventCount.fetch_add(static_cast<std::uint64_t>(droppedMidiEvents),
+                                    std::memory_order_relaxed);
   }
 
-  clipDetected.store(clipped, std::memory_order_relaxed);
-  denormalDetected.store(denormal, std::memory_order_relaxed);
+  for (std::size_t voice = 0; voice < voiceCount; ++voice)
+    publishNodeOutputs(state, state.sortedNodes[entryIndex + voice], block.numSamples);
+}
 
-  if (state->portLevels) {
-    for (std::size_t index = 0; index < state->portTelemetry.size(); ++index) {
-      const auto &telemetry = state->portTelemetry[index];
-      if (telemetry.channelIndex < 0 ||
-          telemetry.channelIndex >= state->globalPortBuffer.getNumChannels()) {
-        continue;
-      }
+// Adds what only the editor's nodes read to the shared context.
+void TGraphRuntime::prepareNodeContext(RenderState &state, std::size_t entryIndex,
+                                       const NodeBlockContext &block,
+                                       TProcessContext &ctx) noexcept {
+  auto &entry = state.sortedNodes[entryIndex];
+  nodeRenderFor(state).prepareContext(entry, entry.blockSlots, entryIndex, block, ctx);
+  ctx.portToChannel = &entry.portChannels;
+  ctx.nodeData = &entry.nodeSnapshot;
+  ctx.paramValueReporter = this;
+}
+
+// Meters the fused members' results that are subscribed; they never reach
+// their own channels.
+void TGraphRuntime::renderFusedExpression(RenderState &state, const NodeEntry &root,
+                                          const TProcessContext &ctx) noexcept {
+  auto &fused = *root.fusedExpression;
+  const auto lastMember = fused.memberEntries.size() - 1;
+  bool metered = false;
+  for (std::size_t member = 0; member < lastMember && !metered; ++member) {
+    const auto &entry = state.sortedNodes[fused.memberEntries[member]];
+    for (auto index = entry.telemetryBegin; index < entry.telemetryEnd; ++index)
+      metered = metered || state.meterSlots[index].load(std::memory_order_relaxed) >= 0;
+  }
 
-      const float measured = measureSignalLevel(
-          state->globalPortBuffer.getReadPointer(telemetry.channelIndex),
-          numSamples);
-      const float previous =
-          state->portLevels[index].load(std::memory_order_relaxed);
-      state->portLevels[index].store(
-          smoothMeterLevel(previous, measured), std::memory_order_relaxed);
+  auto *levels = metered ? fused.levels.data() : nullptr;
+  nodeRenderFor(state).renderFused(fused, ctx, levels);
+  if (levels == nullptr)
+    return;
+
+  for (std::size_t member = 0; member < lastMember; ++member) {
+    const auto &entry = state.sortedNodes[fused.memberEntries[member]];
+    for (auto index = entry.telemetryBegin; index < entry.telemetryEnd; ++index) {
+      if (state.meterSlots[index].load(std::memory_order_relaxed) >= 0)
+        state.meterLevels[index].add(levels[member].peak, levels[member].rms,
+                                     ctx.numSamples);
     }
   }
+}
 
-  const auto elapsedMicros =
-      ticksToMicros(juce::Time::getHighResolutionTicks() - processStartTicks);
-  lastProcessMicros.store(elapsedMicros, std::memory_order_relaxed);
-  updateAtomicMax(maxProcessMicros, elapsedMicros);
+// Meter right after the node ran; a later node may reuse the channel. Only
+// subscribed ports are measured, and publishPortMeters publishes them once
+// the device block is done.
+void TGraphRuntime::publishNodeOutputs(RenderState &state, const NodeEntry &entry,
+                                       int numSamples) noexcept {
+  auto nodeRender = nodeRenderFor(state);
+  for (std::size_t index = entry.telemetryBegin; index < entry.telemetryEnd; ++index) {
+    const auto &telemetry = state.portTelemetry[index];
+    const int meterSlot = state.meterSlots[index].load(std::memory_order_relaxed);
+    TGraphNodeRender::Level level;
+    nodeRender.publishOutput(telemetry.channelIndex, telemetry.expandConstant,
+                             telemetry.detectSilence, numSamples,
+                             meterSlot >= 0 ? &level : nullptr);
+    if (meterSlot >= 0)
+      state.meterLevels[index].add(level.peak, level.rms, numSamples);
+  }
+}
+
+void TGraphRuntime::publishPortMeters(RenderState &state) noexcept {
+  for (std::size_t index = 0; index < state.portTelemetry.size(); ++index) {
+    auto &level = state.meterLevels[index];
+    if (level.numSamples > 0)
+      portMeters.publish(state.meterSlots[index].load(std::memory_order_relaxed), level);
+  }
+}
 
+TGraphNodeRender TGraphRuntime::nodeRenderFor(RenderState &state) noexcept {
+  return {state.globalPortBuffer, state.channelSignals.get(), state.channelStrides.get(),
+          state.silenceChannel, state.midiFabric, deviceInputMidiCaptureBuffer};
+}
+
+void TGraphRuntime::setNodeProfilingEnabled(bool shouldProfile) noexcept {
+  nodeProfiler.setEnabled(shouldProfile);
+}
+
+bool TGraphRuntime::isNodeProfilingEnabled() const noexcept {
+  return nodeProfiler.isEnabled();
+}
+
+void TGraphRuntime::resetNodeProfiles() noexcept { nodeProfiler.reset(); }
+
+// Sorted by mean cost, most expensive first. budgetShare relates the recent
+// cost to the time one block may take at the current rate and size.
+std::vector<TGraphRuntime::NodeProfile> TGraphRuntime::getNodeProfiles() const {
+  std::vector<TNodeProfiler::NodeProfile> profiles;
+  {
+    const juce::ScopedLock lock(profilerLock);
+    profiles = nodeProfiler.snapshot();
+  }
+
+  const double sampleRate = currentSampleRate.load(std::memory_order_relaxed);
+  const int blockSize = currentBlockSize.load(std::memory_order_relaxed);
   const double blockBudgetMicros =
-      sampleRate > 0.0 ? ((double)numSamples / sampleRate) * 1000000.0 : 0.0;
-  xrunDetected.store(blockBudgetMicros > 0.0 &&
-                         (double)elapsedMicros > blockBudgetMicros,
-                     std::memory_order_relaxed);
+      sampleRate > 0.0 ? (static_cast<double>(blockSize) * 1.0e6) / sampleRate : 0.0;
+
+  std::vector<NodeProfile> result;
+  result.reserve(profiles.size());
+  for (const auto &profile : profiles) {
+    NodeProfile nodeProfile;
+    nodeProfile.timing = profile;
+    nodeProfile.budgetShare =
+        blockBudgetMicros > 0.0
+            ? static_cast<float>(profile.recentMicros / blockBudgetMicros)
+            : 0.0f;
+    result.push_back(nodeProfile);
+  }
+
+  std::sort(result.begin(), result.end(), [](const auto &lhs, const auto &rhs) {
+    return lhs.timing.meanMicros > rhs.timing.meanMicros;
+  });
+  return result;
 }
 
-float TGraphRuntime::getPortLevel(PortId portId) const noexcept {
-  const auto state = activeState.get();
-  if (!state || !state->portLevels)
-    return 0.0f;
+int TGraphRuntime::subscribePortMeter(PortId portId) {
+  const juce::ScopedLock lock(meterLock);
+  const int meterSlot = portMeters.subscribe(portId);
+  if (meterSlot >= 0) {
+    if (const auto state = activeState.get())
+      refreshMeterSlotsLocked(*state);
+    if (const auto state = pendingState.get())
+      refreshMeterSlotsLocked(*state);
+  }
+
+  return meterSlot;
+}
+
+void TGraphRuntime::unsubscribePortMeter(int meterSlot) {
+  const juce::ScopedLock lock(meterLock);
+  portMeters.unsubscribe(meterSlot);
+  if (const auto state = activeState.get())
+    refreshMeterSlotsLocked(*state);
+  if (const auto state = pendingState.get())
+    refreshMeterSlotsLocked(*state);
+}
 
-  const auto it = state->portTelemetryIndex.find(portId);
-  if (it == state->portTelemetryIndex.end())
-    return 0.0f;
+bool TGraphRuntime::readPortMeter(int meterSlot,
+                                  TPortMeterBank::Reading &reading) const noexcept {
+  return portMeters.read(meterSlot, reading);
+}
+
+void TGraphRuntime::refreshMeterSlotsLocked(RenderState &state) const {
+  std::map<PortId, int> slotByPort;
+  for (int meterSlot = 0; meterSlot < TPortMeterBank::kMaxSlots; ++meterSlot) {
+    const auto portId = portMeters.getSlotPort(meterSlot);
+    if (portId != kInvalidPortId)
+      slotByPort[portId] = meterSlot;
+  }
+
+  for (std::size_t index = 0; index < state.portTelemetry.size(); ++index) {
+    const auto slotIt = slotByPort.find(state.portTelemetry[index].portId);
+    state.meterSlots[index].store(slotIt != slotByPort.end() ? slotIt->second : -1,
+                                  std::memory_order_relaxed);
+  }
+}
+
+TGraphRuntime::BlockLatencyReport TGraphRuntime::getBlockLatencyReport() const {
+  BlockLatencyReport report;
+  report.summary = blockLatency.summarize();
+  report.histogram = blockLatency.getHistogram();
+  report.recentXruns = blockLatency.getRecentXruns();
+  return report;
+}
 
-  return state->portLevels[it->second].load(std::memory_order_relaxed);
+void TGraphRuntime::resetBlockLatency() noexcept {
+  blockLatency.reset();
+  maxProcessMicros.store(0, std::memory_order_relaxed);
+}
+
+void TGraphRuntime::setLoadSheddingEnabled(bool shouldShed) noexcept {
+  loadShedder.setEnabled(shouldShed);
+}
+
+bool TGraphRuntime::isLoadSheddingEnabled() const noexcept {
+  return loadShedder.isEnabled();
+}
+
+void TGraphRuntime::setLoadSheddingThresholds(float shedLoad,
+                                              float restoreLoad) noexcept {
+  loadShedder.setThresholds(shedLoad, restoreLoad);
+}
+
+std::vector<TLoadShedder::Event> TGraphRuntime::getLoadShedEvents() const {
+  return loadShedder.getRecentEvents();
 }
 
 TGraphRuntime::RuntimeStats TGraphRuntime::getRuntimeStats() const noexcept {
@@ -811,6 +1696,26 @@ TGraphRuntime::RuntimeStats TGraphRuntime::getRuntimeStats() const noexcept {
   stats.activeNodeCount = activeNodeCount.load(std::memory_order_relaxed);
   stats.allocatedPortChannels =
       allocatedPortChannels.load(std::memory_order_relaxed);
+  stats.naivePortChannels = naivePortChannels.load(std::memory_order_relaxed);
+  stats.aliasedInputCount = aliasedInputCount.load(std::memory_order_relaxed);
+  stats.summedInputCount = summedInputCount.load(std::memory_order_relaxed);
+  stats.fusedNodeCount = fusedNodeCount.load(std::memory_order_relaxed);
+  stats.lastSkippedNodeCount =
+      lastSkippedNodeCount.load(std::memory_order_relaxed);
+  stats.skippedNodeCount = skippedNodeCount.load(std::memory_order_relaxed);
+  stats.lastSubBlockCount = lastSubBlockCount.load(std::memory_order_relaxed);
+  stats.shedNodeCount = shedNodeCount.load(std::memory_order_relaxed);
+  stats.shedEventCount = loadShedder.getShedCount();
+  stats.restoreEventCount = loadShedder.getRestoreCount();
+  stats.activeVoiceCount = activeVoiceCount.load(std::memory_order_relaxed);
+  stats.voiceStealCount = voiceStealCount.load(std::memory_order_relaxed);
+  const auto streamerStats = TSampleStreamer::get().getStats();
+  stats.activeStreamCount = streamerStats.activeStreamCount;
+  stats.diskUnderrunCount = streamerStats.diskUnderrunCount;
+  stats.smoothedBlockLoad = loadShedder.getSmoothedLoad();
+  stats.splitBlockCount = splitBlockCount.load(std::memory_order_relaxed);
+  stats.chunkedBlockCount = chunkedBlockCount.load(std::memory_order_relaxed);
+  stats.meteredPortCount = portMeters.getNumSubscribedPorts();
   stats.largestBlockSeen = largestBlockSeen.load(std::memory_order_relaxed);
   stats.largestOutputChannelCountSeen =
       largestOutputChannelCountSeen.load(std::memory_order_relaxed);
@@ -824,8 +1729,16 @@ TGraphRuntime::RuntimeStats TGraphRuntime::getRuntimeStats() const noexcept {
   stats.paramChangeCount = paramChangeCount.load(std::memory_order_relaxed);
   stats.droppedParamChangeCount =
       droppedParamChangeCount.load(std::memory_order_relaxed);
-  stats.droppedParamNotificationCount =
-      droppedParamNotificationCount.load(std::memory_order_relaxed);
+  stats.coalescedParamChangeCount =
+      coalescedParamChangeCount.load(std::memory_order_relaxed);
+  stats.droppedMidiEventCount =
+      droppedMidiEventCount.load(std::memory_order_relaxed);
+  const auto blockLoad = blockLatency.summarize();
+  stats.overBudgetBlockCount = blockLoad.overBudgetCount;
+  stats.blockLoadP50 = blockLoad.p50Load;
+  stats.blockLoadP99 = blockLoad.p99Load;
+  stats.blockLoadP999 = blockLoad.p999Load;
+  stats.blockLoadMax = blockLoad.maxLoad;
   stats.activeGeneration = activeGeneration.load(std::memory_order_relaxed);
   stats.pendingGeneration = pendingGeneration.load(std::memory_order_relaxed);
   stats.rebuildPending = rebuildPending.load(std::memory_order_relaxed);
@@ -836,12 +1749,28 @@ TGraphRuntime::RuntimeStats TGraphRuntime::getRuntimeStats() const noexcept {
       mutedFallbackActive.load(std::memory_order_relaxed);
   stats.lastBuildMilliseconds =
       microsToMilliseconds(lastBuildMicros.load(std::memory_order_relaxed));
+  stats.lastBuildReusedNodeCount =
+      lastBuildReusedNodeCount.load(std::memory_order_relaxed);
+  stats.lastBuildCreatedNodeCount =
+      lastBuildCreatedNodeCount.load(std::memory_order_relaxed);
+  stats.lastBuildDestroyedNodeCount =
+      lastBuildDestroyedNodeCount.load(std::memory_order_relaxed);
   stats.maxBuildMilliseconds =
       microsToMilliseconds(maxBuildMicros.load(std::memory_order_relaxed));
+  stats.maxCommitBlockMilliseconds =
+      microsToMilliseconds(maxCommitBlockMicros.load(std::memory_order_relaxed));
+  stats.deferredFreesPending =
+      deferredFreesPending.load(std::memory_order_relaxed);
   stats.lastProcessMilliseconds =
       microsToMilliseconds(lastProcessMicros.load(std::memory_order_relaxed));
   stats.maxProcessMilliseconds =
       microsToMilliseconds(maxProcessMicros.load(std::memory_order_relaxed));
+  stats.workerCount = workerPool.getNumParticipants();
+  stats.parallelBlockCount = parallelBlockCount.load(std::memory_order_relaxed);
+  for (std::size_t index = 0; index < stats.workerBusyMilliseconds.size(); ++index) {
+    stats.workerBusyMilliseconds[index] = microsToMilliseconds(
+        workerBusyMicros[index].load(std::memory_order_relaxed));
+  }
 
   const double blockDurationMs =
       (stats.sampleRate > 0.0 && stats.preparedBlockSize > 0)
@@ -900,49 +1829,67 @@ void TGraphRuntime::audioDeviceIOCallbackWithContext(
 
 void TGraphRuntime::queueParameterChange(NodeId nodeId,
                                          const juce::String &paramKey,
-                                         float value) {
-  int dispatchSlot = -1;
-  std::uint64_t generation = 0;
-  {
-    const juce::ScopedLock lock(paramSurfaceLock);
-    const juce::String paramId = makeTeulParamId(nodeId, paramKey);
-    const auto it = queuedParamDispatchSlotById.find(paramId);
-    if (it != queuedParamDispatchSlotById.end()) {
-      dispatchSlot = it->second;
-      generation = queuedParamDispatchGeneration;
-    }
-  }
+                                         float value, int sampleOffset) {
+  const ParamRouteReader reader(paramRouteReaders);
+  pushParamChange(findParamCell(nodeId, -1, &paramKey), value, sampleOffset);
+}
+
+void TGraphRuntime::queueParameterChange(NodeId nodeId, int paramIndex,
+                                         float value, int sampleOffset) {
+  const ParamRouteReader reader(paramRouteReaders);
+  pushParamChange(findParamCell(nodeId, paramIndex, nullptr), value, sampleOffset);
+}
+
+void TGraphRuntime::setMinimumSubBlockSize(int numSamples) noexcept {
+  minSubBlockSamples.store(juce::jmax(1, numSamples), std::memory_order_relaxed);
+}
+
+int TGraphRuntime::getMinimumSubBlockSize() const noexcept {
+  return minSubBlockSamples.load(std::memory_order_relaxed);
+}
+
+void TGraphRuntime::setInternalBlockSize(int numSamples) noexcept {
+  internalBlockSamples.store(juce::jmax(0, numSamples), std::memory_order_relaxed);
+}
+
+int TGraphRuntime::getInternalBlockSize() const noexcept {
+  return internalBlockSamples.load(std::memory_order_relaxed);
+}
 
-  int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
-  paramQueueFifo.prepareToWrite(1, start1, size1, start2, size2);
+int TGraphRuntime::findParamCell(NodeId nodeId, int paramIndex,
+                                 const juce::String *paramKey) const noexcept {
+  // Callers hold a ParamRouteReader until they are done with the cell.
+  const auto *routes = paramRoutes.load(std::memory_order_seq_cst);
+  if (routes == nullptr)
+    return -1;
 
-  ParamChange *slot = nullptr;
-  if (size1 > 0)
-    slot = &paramQueueData[start1];
-  else if (size2 > 0)
-    slot = &paramQueueData[start2];
+  return paramKey != nullptr ? routes->findCell(nodeId, *paramKey)
+                             : routes->findCell(nodeId, paramIndex);
+}
 
-  if (slot == nullptr) {
+void TGraphRuntime::pushParamChange(int cell, float value,
+                                    int sampleOffset) noexcept {
+  switch (paramChangeQueue.push(cell, value, sampleOffset)) {
+  case TParamChangeQueue::PushResult::queued:
+    break;
+  case TParamChangeQueue::PushResult::coalesced:
+    coalescedParamChangeCount.fetch_add(1, std::memory_order_relaxed);
+    break;
+  case TParamChangeQueue::PushResult::rejected:
     droppedParamChangeCount.fetch_add(1, std::memory_order_relaxed);
-    paramQueueFifo.finishedWrite(0);
-    return;
+    break;
   }
-
-  slot->nodeId = nodeId;
-  slot->generation = generation;
-  slot->dispatchSlot = dispatchSlot;
-  slot->value = value;
-  writeParamKey(slot->paramKey, sizeof(slot->paramKey), paramKey);
-  paramQueueFifo.finishedWrite(1);
 }
 
 std::vector<TTeulExposedParam> TGraphRuntime::listExposedParams() const {
   const juce::ScopedLock lock(paramSurfaceLock);
+  drainParamValueMirrorLocked();
   return exposedParams;
 }
 
 juce::var TGraphRuntime::getParam(const juce::String &paramId) const {
   const juce::ScopedLock lock(paramSurfaceLock);
+  drainParamValueMirrorLocked();
   const auto it = exposedParamIndexById.find(paramId);
   if (it == exposedParamIndexById.end())
     return {};
@@ -962,6 +1909,9 @@ bool TGraphRuntime::setParam(const juce::String &paramId,
     if (it == exposedParamIndexById.end())
       return false;
 
+    // Fold in values rendered so far first, so they cannot overwrite this one
+    // on the next read.
+    drainParamValueMirrorLocked();
     auto &param = exposedParams[it->second];
     const juce::var prototype = param.currentValue.isVoid() ? param.defaultValue
                                                             : param.currentValue;
@@ -979,56 +1929,42 @@ bool TGraphRuntime::setParam(const juce::String &paramId,
   return true;
 }
 
-void TGraphRuntime::addListener(Listener *listener) { listeners.add(listener); }
+void TGraphRuntime::addListener(Listener *listener) {
+  listeners.add(listener);
+  if (!isTimerRunning())
+    startTimerHz(kParamPollHz);
+}
 
 void TGraphRuntime::removeListener(Listener *listener) {
   listeners.remove(listener);
+  if (listeners.isEmpty())
+    stopTimer();
 }
 
 void TGraphRuntime::handleAsyncUpdate() {
-  const bool surfaceChanged =
-      surfaceChangedPending.exchange(false, std::memory_order_acq_rel);
-
-  int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
-  paramNotificationFifo.prepareToRead(paramNotificationFifo.getNumReady(),
-                                      start1, size1, start2, size2);
-
-  std::vector<TTeulExposedParam> changed;
-  changed.reserve(static_cast<std::size_t>(size1 + size2));
-
-  auto drainNotification = [&](const PendingParamNotification &notification) {
-    const juce::String key = juce::String::fromUTF8(notification.paramKey);
-    TTeulExposedParam updated;
-
-    const bool didUpdate = [&] {
-      const juce::ScopedLock lock(paramSurfaceLock);
-      const juce::String paramId = makeTeulParamId(notification.nodeId, key);
-      const auto it = exposedParamIndexById.find(paramId);
-      if (it == exposedParamIndexById.end())
-        return false;
-
-      auto &param = exposedParams[it->second];
-      const juce::var prototype = param.currentValue.isVoid() ? param.defaultValue
-                                                              : param.currentValue;
-      const juce::var coerced = coerceNumericValue(prototype, notification.value);
-      return updateParamSurfaceValueLocked(notification.nodeId, key, coerced,
-                                           &updated);
-    }();
-
-    if (didUpdate)
-      changed.push_back(std::move(updated));
-  };
-
-  for (int i = 0; i < size1; ++i)
-    drainNotification(paramNotificationData[start1 + i]);
-  for (int i = 0; i < size2; ++i)
-    drainNotification(paramNotificationData[start2 + i]);
-  paramNotificationFifo.finishedRead(size1 + size2);
+  collectRetiredStates();
+  {
+    const juce::ScopedLock lock(paramSurfaceLock);
+    reclaimParamRoutesLocked();
+  }
 
-  if (surfaceChanged) {
+  if (surfaceChangedPending.exchange(false, std::memory_order_acq_rel)) {
     listeners.call(
         [](Listener &listener) { listener.teulParamSurfaceChanged(); });
   }
+}
+
+void TGraphRuntime::timerCallback() { publishParamValueChanges(); }
+
+void TGraphRuntime::publishParamValueChanges() {
+  std::vector<TTeulExposedParam> changed;
+  {
+    const juce::ScopedLock lock(paramSurfaceLock);
+    drainParamValueMirrorLocked();
+    for (const auto exposedIndex : unpublishedParamValues)
+      changed.push_back(exposedParams[exposedIndex]);
+    unpublishedParamValues.clear();
+  }
 
   for (const auto &param : changed) {
     listeners.call(
@@ -1036,16 +1972,40 @@ void TGraphRuntime::handleAsyncUpdate() {
   }
 }
 
+// Folds the values the render threads wrote since the last drain into the
+// surface. Readers drain too, so the surface is current with or without
+// listeners; the cells stay marked until the poll publishes them.
+void TGraphRuntime::drainParamValueMirrorLocked() const {
+  paramValueMirror.poll([&](int cell, float value) {
+    const int exposedIndex =
+        cell < static_cast<int>(exposedParamIndexByCell.size())
+            ? exposedParamIndexByCell[static_cast<std::size_t>(cell)]
+            : -1;
+    if (exposedIndex < 0)
+      return;
+
+    auto &param = exposedParams[static_cast<std::size_t>(exposedIndex)];
+    const juce::var prototype = param.currentValue.isVoid() ? param.defaultValue
+                                                            : param.currentValue;
+    param.currentValue = coerceNumericValue(prototype, value);
+    if (auto *node = surfaceDocument.findNode(param.nodeId))
+      node->params[param.paramKey] = param.currentValue;
+    unpublishedParamValues.insert(static_cast<std::size_t>(exposedIndex));
+  });
+}
+
 void TGraphRuntime::reportParamValueChange(NodeId nodeId,
                                            const juce::String &paramKey,
                                            float value) {
-  enqueueParamNotification(nodeId, paramKey, value);
+  const ParamRouteReader reader(paramRouteReaders);
+  paramValueMirror.write(findParamCell(nodeId, -1, &paramKey), value);
 }
 
 void TGraphRuntime::rebuildParamSurfaceLocked(const TGraphDocument &doc) {
   surfaceDocument = doc;
   exposedParams.clear();
   exposedParamIndexById.clear();
+  unpublishedParamValues.clear();
 
   for (const auto &node : surfaceDocument.nodes) {
     std::vector<TTeulExposedParam> nodeParams;
@@ -1096,40 +2056,148 @@ bool TGraphRuntime::updateParamSurfaceValueLocked(
   return true;
 }
 
-void TGraphRuntime::rebuildQueuedParamDispatchLocked(const RenderState &state) {
-  queuedParamDispatchSlotById.clear();
-  queuedParamDispatchGeneration = state.generation;
-
+// Cells stay with their (node, key) across builds. A cell whose parameter
+// is gone is recycled only after every table naming it was freed, the audio
+// thread runs a state built without it and no change for it is pending.
+void TGraphRuntime::publishParamRoutesLocked(RenderState &state) {
+  // Dispatches of one node are contiguous and ordered by paramIndex; the
+  // table lists nodes by id so producers can binary search it.
+  std::vector<std::pair<NodeId, std::size_t>> nodeStarts;
   for (std::size_t index = 0; index < state.paramDispatches.size(); ++index) {
-    const auto &dispatch = state.paramDispatches[index];
-    queuedParamDispatchSlotById[makeTeulParamId(dispatch.nodeId, dispatch.paramKey)] =
-        static_cast<int>(index);
+    if (state.paramDispatches[index].paramIndex == 0)
+      nodeStarts.emplace_back(state.paramDispatches[index].nodeId, index);
   }
-}
+  std::sort(nodeStarts.begin(), nodeStarts.end());
+
+  auto routes = std::make_unique<ParamRouteTable>();
+  std::map<std::pair<NodeId, juce::String>, int> liveCells;
+  for (const auto &[nodeId, start] : nodeStarts) {
+    routes->nodeIds.push_back(nodeId);
+    routes->nodeParamBegin.push_back(static_cast<int>(routes->cells.size()));
+
+    for (auto index = start; index < state.paramDispatches.size() &&
+                             state.paramDispatches[index].nodeId == nodeId;
+         ++index) {
+      auto &dispatch = state.paramDispatches[index];
+      auto key = std::make_pair(nodeId, dispatch.paramKey);
+      int cell = -1;
+      const auto cellIt = paramCellByKey.find(key);
+      if (cellIt != paramCellByKey.end()) {
+        cell = cellIt->second;
+      } else if (!freeParamCells.empty()) {
+        cell = freeParamCells.back();
+        freeParamCells.pop_back();
+      } else if (nextParamCell < TParamChangeQueue::kMaxCells) {
+        cell = nextParamCell++;
+      }
+
+      dispatch.cell = cell;
+      if (cell >= 0) {
+        liveCells.emplace(std::move(key), cell);
+        if (static_cast<int>(state.dispatchByCell.size()) <= cell)
+          state.dispatchByCell.resize(static_cast<std::size_t>(cell) + 1, -1);
+        state.dispatchByCell[static_cast<std::size_t>(cell)] = static_cast<int>(index);
+      }
 
-void TGraphRuntime::enqueueParamNotification(NodeId nodeId,
-                                             const juce::String &paramKey,
-                                             float value) {
-  int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
-  paramNotificationFifo.prepareToWrite(1, start1, size1, start2, size2);
+      routes->cells.push_back(cell);
+      routes->paramKeys.push_back(dispatch.paramKey);
+    }
+  }
+  routes->nodeParamBegin.push_back(static_cast<int>(routes->cells.size()));
+
+  for (const auto &[key, cell] : paramCellByKey) {
+    if (liveCells.count(key) == 0)
+      retiredParamCells.push_back({cell, state.generation});
+  }
+  paramCellByKey = std::move(liveCells);
+
+  exposedParamIndexByCell.assign(state.dispatchByCell.size(), -1);
+  for (const auto &[key, cell] : paramCellByKey) {
+    const auto exposedIt =
+        exposedParamIndexById.find(makeTeulParamId(key.first, key.second));
+    if (exposedIt != exposedParamIndexById.end()) {
+      exposedParamIndexByCell[static_cast<std::size_t>(cell)] =
+          static_cast<int>(exposedIt->second);
+    }
+  }
 
-  PendingParamNotification *slot = nullptr;
-  if (size1 > 0)
-    slot = &paramNotificationData[start1];
-  else if (size2 > 0)
-    slot = &paramNotificationData[start2];
+  paramRoutes.store(routes.get(), std::memory_order_seq_cst);
+  if (currentParamRoutes != nullptr)
+    retiredParamRoutes.push_back(std::move(currentParamRoutes));
+  currentParamRoutes = std::move(routes);
+  reclaimParamRoutesLocked();
+}
 
-  if (slot == nullptr) {
-    droppedParamNotificationCount.fetch_add(1, std::memory_order_relaxed);
-    paramNotificationFifo.finishedWrite(0);
+void TGraphRuntime::reclaimParamRoutesLocked() {
+  if (paramRouteReaders.load(std::memory_order_seq_cst) != 0)
     return;
+
+  retiredParamRoutes.clear();
+
+  const auto runningGeneration = activeGeneration.load(std::memory_order_acquire);
+  const auto retiredEnd = std::remove_if(
+      retiredParamCells.begin(), retiredParamCells.end(),
+      [this, runningGeneration](const RetiredParamCell &retired) {
+        if (retired.generation > runningGeneration ||
+            paramChangeQueue.isPending(retired.cell) ||
+            paramValueMirror.isDirty(retired.cell)) {
+          return false;
+        }
+
+        freeParamCells.push_back(retired.cell);
+        return true;
+      });
+  retiredParamCells.erase(retiredEnd, retiredParamCells.end());
+}
+
+int TGraphRuntime::ParamRouteTable::findNode(NodeId nodeId) const noexcept {
+  const auto it = std::lower_bound(nodeIds.begin(), nodeIds.end(), nodeId);
+  if (it == nodeIds.end() || *it != nodeId)
+    return -1;
+
+  return static_cast<int>(std::distance(nodeIds.begin(), it));
+}
+
+int TGraphRuntime::ParamRouteTable::findCell(NodeId nodeId,
+                                             int paramIndex) const noexcept {
+  const int node = findNode(nodeId);
+  if (node < 0 || paramIndex < 0)
+    return -1;
+
+  const int param = nodeParamBegin[static_cast<std::size_t>(node)] + paramIndex;
+  if (param >= nodeParamBegin[static_cast<std::size_t>(node) + 1])
+    return -1;
+
+  return cells[static_cast<std::size_t>(param)];
+}
+
+int TGraphRuntime::ParamRouteTable::findCell(
+    NodeId nodeId, const juce::String &paramKey) const noexcept {
+  const int node = findNode(nodeId);
+  if (node < 0)
+    return -1;
+
+  for (int param = nodeParamBegin[static_cast<std::size_t>(node)];
+       param < nodeParamBegin[static_cast<std::size_t>(node) + 1]; ++param) {
+    if (paramKeys[static_cast<std::size_t>(param)] == paramKey)
+      return cells[static_cast<std::size_t>(param)];
   }
 
-  slot->nodeId = nodeId;
-  slot->value = value;
-  writeParamKey(slot->paramKey, sizeof(slot->paramKey), paramKey);
-  paramNotificationFifo.finishedWrite(1);
-  triggerAsyncUpdate();
+  return -1;
+}
+
+const juce::String *
+TGraphRuntime::ParamRouteTable::findParamKey(NodeId nodeId,
+                                             int paramIndex) const noexcept {
+  const int node = findNode(nodeId);
+  if (node < 0 || paramIndex < 0)
+    return nullptr;
+
+  const int param = nodeParamBegin[static_cast<std::size_t>(node)] + paramIndex;
+  if (param >= nodeParamBegin[static_cast<std::size_t>(node) + 1])
+    return nullptr;
+
+  return &paramKeys[static_cast<std::size_t>(param)];
 }
 
 void TGraphRuntime::prepareStateForPlayback(
@@ -1147,6 +2215,9 @@ void TGraphRuntime::prepareStateForPlayback(
   for (auto &entry : state.sortedNodes) {
     if (entry.instance)
       entry.instance->prepareToPlay(sampleRate, blockSize);
+    entry.tailSamples =
+        TGraphNodeRender::tailLengthToSamples(entry.tailLengthMs, sampleRate);
+    entry.silentSamples = 0;
   }
 }
 
@@ -1155,21 +2226,61 @@ bool TGraphRuntime::commitPendingStateIfNeeded() noexcept {
   if (!nextState)
     return false;
 
-  activeState.set(nextState.get());
+  retireState(activeState.exchange(nextState.get()));
+  for (const auto &update : nextState->commitParamUpdates)
+    applyParamValue(*update.instance, update.specIndex, update.paramKey,
+                    update.value);
+
   activeGeneration.store(nextState->generation, std::memory_order_release);
   pendingGeneration.store(0, std::memory_order_release);
   rebuildPending.store(false, std::memory_order_release);
   rebuildCommitCount.fetch_add(1, std::memory_order_relaxed);
-  activeNodeCount.store(static_cast<int>(nextState->sortedNodes.size()),
-                        std::memory_order_relaxed);
+  activeNodeCount.store(
+      static_cast<int>(nextState->sortedNodes.size()) - nextState->voiceLaneCount,
+      std::memory_order_relaxed);
   allocatedPortChannels.store(nextState->totalAllocatedChannels,
                               std::memory_order_relaxed);
+  naivePortChannels.store(nextState->naivePortChannels,
+                          std::memory_order_relaxed);
+  aliasedInputCount.store(nextState->aliasedInputCount,
+                          std::memory_order_relaxed);
+  summedInputCount.store(nextState->summedInputCount,
+                         std::memory_order_relaxed);
+  fusedNodeCount.store(nextState->fusedNodeCount, std::memory_order_relaxed);
+  shedNodeCount.store(0, std::memory_order_relaxed);
   outputFadeSamplesRemaining = juce::jmax(
       1, juce::jmin(currentBlockSize.load(std::memory_order_relaxed), 128));
   outputFadeCurrentGain = 0.0f;
   return true;
 }
 
+void TGraphRuntime::retireState(RenderState *state) noexcept {
+  if (state == nullptr)
+    return;
+
+  // The audio thread never drops the last reference itself: the outgoing
+  // state is parked here and released by collectRetiredStates().
+  auto *head = retiredStates.load(std::memory_order_relaxed);
+  do {
+    state->nextRetired = head;
+  } while (!retiredStates.compare_exchange_weak(head, state,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
+  deferredFreesPending.fetch_add(1, std::memory_order_relaxed);
+  triggerAsyncUpdate();
+}
+
+void TGraphRuntime::collectRetiredStates() {
+  auto *state = retiredStates.exchange(nullptr, std::memory_order_acquire);
+  while (state != nullptr) {
+    auto *next = state->nextRetired;
+    state->nextRetired = nullptr;
+    state->decReferenceCount();
+    deferredFreesPending.fetch_sub(1, std::memory_order_relaxed);
+    state = next;
+  }
+}
+
 float TGraphRuntime::paramValueToFloat(const juce::var &value) {
   if (value.isBool())
     return static_cast<float>((bool)value ? 1.0 : 0.0);
@@ -1202,26 +2313,6 @@ juce::var TGraphRuntime::coerceValueLike(const juce::var &prototype,
   return candidate;
 }
 
-float TGraphRuntime::measureSignalLevel(const float *samples,
-                                        int numSamples) noexcept {
-  if (samples == nullptr || numSamples <= 0)
-    return 0.0f;
-
-  float peak = 0.0f;
-  for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
-    peak = juce::jmax(peak, std::abs(samples[sampleIndex]));
-
-  return juce::jlimit(0.0f, 1.0f, peak);
-}
-
-float TGraphRuntime::smoothMeterLevel(float previousLevel,
-                                      float measuredLevel) noexcept {
-  if (measuredLevel >= previousLevel)
-    return measuredLevel;
-
-  return juce::jmax(measuredLevel, previousLevel * 0.84f);
-}
-
 bool TGraphRuntime::shouldSmoothParam(const TParamSpec *paramSpec,
                                       const juce::var &initialValue) noexcept {
   if (paramSpec == nullptr)
@@ -1232,6 +2323,7 @@ bool TGraphRuntime::shouldSmoothParam(const TParamSpec *paramSpec,
   if (paramSpec->isReadOnly || paramSpec->isDiscrete ||
       paramSpec->valueType == TParamValueType::Bool ||
       paramSpec->valueType == TParamValueType::Enum ||
+      paramSpec->valueType == TParamValueType::String ||
       paramSpec->preferredWidget == TParamWidgetHint::Toggle ||
       paramSpec->preferredWidget == TParamWidgetHint::Combo) {
     return false;
@@ -1240,29 +2332,12 @@ bool TGraphRuntime::shouldSmoothParam(const TParamSpec *paramSpec,
   return true;
 }
 
-void TGraphRuntime::writeParamKey(char *dest,
-                                  std::size_t destSize,
-                                  const juce::String &paramKey) {
-  if (dest == nullptr || destSize == 0)
-    return;
-
-  std::memset(dest, 0, destSize);
-  paramKey.copyToUTF8(dest, static_cast<int>(destSize));
-}
-
-void TGraphRuntime::writeParamKey(std::array<char, 32> &dest,
-                                  const juce::String &paramKey) {
-  writeParamKey(dest.data(), dest.size(), paramKey);
-}
-
-bool TGraphRuntime::dispatchMatches(const ParamDispatch &dispatch,
-                                    NodeId nodeId,
-                                    const char *paramKey) noexcept {
-  if (dispatch.nodeId != nodeId || paramKey == nullptr)
-    return false;
-
-  return std::strncmp(dispatch.paramKeyUtf8.data(), paramKey,
-                      dispatch.paramKeyUtf8.size()) == 0;
+void TGraphRuntime::applyParamValue(TNodeInstance &instance, int specIndex,
+                                    const juce::String &paramKey, float value) {
+  if (specIndex >= 0)
+    instance.setParameterValue(specIndex, value);
+  else
+    instance.setParameterValue(paramKey, value);
 }
 
 std::uint64_t TGraphRuntime::ticksToMicros(juce::int64 tickDelta) noexcept {
@@ -3,13 +3,29 @@
 #include "../Bridge/ITeulParamProvider.h"
 #include "../Model/TGraphDocument.h"
 #include "../Registry/TNodeRegistry.h"
+#include "TExpressionTape.h"
+#include "TGraphBufferPlan.h"
+#include "TGraphFusionPlan.h"
+#include "TGraphMidiFabric.h"
+#include "TGraphNodeRender.h"
+#include "TGraphStaticPlan.h"
+#include "TGraphVoicePlan.h"
+#include "TGraphWorkerPool.h"
 #include "TNodeInstance.h"
+#include "TBlockLatencyMonitor.h"
+#include "TLoadShedder.h"
+#include "TNodeProfiler.h"
+#include "TParamChangeQueue.h"
+#include "TParamValueMirror.h"
+#include "TPortMeterBank.h"
+#include "TVoiceAllocator.h"
 #include <JuceHeader.h>
 #include <array>
 #include <atomic>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
 namespace Teul {
@@ -17,6 +33,7 @@ namespace Teul {
 class TGraphRuntime : public juce::AudioIODeviceCallback,
                       public ITeulParamProvider,
                       private juce::AsyncUpdater,
+                      private juce::Timer,
                       private TParamValueReporter {
 public:
   struct RuntimeStats {
@@ -26,15 +43,35 @@ public:
     int lastOutputChannels = 0;
     int activeNodeCount = 0;
     int allocatedPortChannels = 0;
+    int naivePortChannels = 0;
+    int aliasedInputCount = 0;
+    int summedInputCount = 0;
+    int fusedNodeCount = 0;
     int largestBlockSeen = 0;
     int largestOutputChannelCountSeen = 0;
     int smoothingActiveCount = 0;
+    int lastSkippedNodeCount = 0;
+    int lastSubBlockCount = 0;
+    int shedNodeCount = 0;
+    int activeVoiceCount = 0;
+    // Process-wide: every runtime shares the sample streamer.
+    int activeStreamCount = 0;
+    int meteredPortCount = 0;
     std::uint64_t processBlockCount = 0;
+    std::uint64_t skippedNodeCount = 0;
+    std::uint64_t splitBlockCount = 0;
+    std::uint64_t chunkedBlockCount = 0;
     std::uint64_t rebuildRequestCount = 0;
     std::uint64_t rebuildCommitCount = 0;
     std::uint64_t paramChangeCount = 0;
     std::uint64_t droppedParamChangeCount = 0;
-    std::uint64_t droppedParamNotificationCount = 0;
+    std::uint64_t coalescedParamChangeCount = 0;
+    std::uint64_t droppedMidiEventCount = 0;
+    std::uint64_t overBudgetBlockCount = 0;
+    std::uint64_t shedEventCount = 0;
+    std::uint64_t restoreEventCount = 0;
+    std::uint64_t voiceStealCount = 0;
+    std::uint64_t diskUnderrunCount = 0;
     std::uint64_t activeGeneration = 0;
     std::uint64_t pendingGeneration = 0;
     bool rebuildPending = false;
@@ -43,10 +80,23 @@ public:
     bool xrunDetected = false;
     bool mutedFallbackActive = false;
     float cpuLoadPercent = 0.0f;
+    float blockLoadP50 = 0.0f;
+    float blockLoadP99 = 0.0f;
+    float blockLoadP999 = 0.0f;
+    float blockLoadMax = 0.0f;
+    float smoothedBlockLoad = 0.0f;
     double lastBuildMilliseconds = 0.0;
     double maxBuildMilliseconds = 0.0;
+    int lastBuildReusedNodeCount = 0;
+    int lastBuildCreatedNodeCount = 0;
+    int lastBuildDestroyedNodeCount = 0;
     double lastProcessMilliseconds = 0.0;
     double maxProcessMilliseconds = 0.0;
+    double maxCommitBlockMilliseconds = 0.0;
+    int deferredFreesPending = 0;
+    int workerCount = 1;
+    std::uint64_t parallelBlockCount = 0;
+    std::array<double, TGraphWorkerPool::kMaxParticipants> workerBusyMilliseconds{};
   };
 
   explicit TGraphRuntime(const TNodeRegistry *registry);
@@ -54,11 +104,22 @@ public:
 
   bool buildGraph(const TGraphDocument &doc);
 
+  // Describes the newest built graph for a statically compiled render.
+  // False until a build succeeded.
+  bool describeStaticPlan(TGraphStaticPlan &plan) const;
+
   void prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock);
   void releaseResources();
   void processBlock(juce::AudioBuffer<float> &deviceBuffer,
                     juce::MidiBuffer &midiMessages);
   void setCurrentChannelLayout(int inputChannels, int outputChannels) noexcept;
+  void setWorkerThreadCount(int numHelperThreads) noexcept;
+  int getWorkerThreadCount() const noexcept;
+  static int getDefaultWorkerThreadCount() noexcept;
+  // Zero, the default, leaves helper threads unpinned. Takes effect on the
+  // next prepareToPlay.
+  void setWorkerCpuMask(juce::uint32 helperCpuMask) noexcept;
+  juce::uint32 getWorkerCpuMask() const noexcept;
 
   void audioDeviceAboutToStart(juce::AudioIODevice *device) override;
   void audioDeviceStopped() override;
@@ -67,11 +128,67 @@ public:
       float *const *outputChannelData, int numOutputChannels, int numSamples,
       const juce::AudioIODeviceCallbackContext &context) override;
 
+  // sampleOffset places the change inside the next processed block. Only
+  // producers that run in step with the audio callback can use it; others
+  // pass 0. The block is split there unless the change lands within the
+  // minimum sub-block size of the previous split, in which case it is
+  // applied at that split instead.
   void queueParameterChange(NodeId nodeId, const juce::String &paramKey,
-                            float value);
-  float getPortLevel(PortId portId) const noexcept;
+                            float value, int sampleOffset = 0);
+  void queueParameterChange(NodeId nodeId, int paramIndex, float value,
+                            int sampleOffset = 0);
+
+  // Device blocks are rendered in sub-blocks that start at parameter changes
+  // and device MIDI events, no shorter than this many samples.
+  static constexpr int kDefaultMinSubBlockSamples = 32;
+  void setMinimumSubBlockSize(int numSamples) noexcept;
+  int getMinimumSubBlockSize() const noexcept;
+
+  // Blocks longer than the prepared size are rendered in chunks of that
+  // size. A non-zero internal block size caps every sub-block further, which
+  // bounds modulation latency under hosts with large buffers; 0 disables it.
+  void setInternalBlockSize(int numSamples) noexcept;
+  int getInternalBlockSize() const noexcept;
+
+  struct NodeProfile {
+    TNodeProfiler::NodeProfile timing;
+    float budgetShare = 0.0f;
+  };
+
+  // Nodes are always timed for xrun forensics; the per-node histograms are
+  // only fed while enabled. Profiles survive rebuilds for nodes that remain.
+  void setNodeProfilingEnabled(bool shouldProfile) noexcept;
+  bool isNodeProfilingEnabled() const noexcept;
+  void resetNodeProfiles() noexcept;
+  std::vector<NodeProfile> getNodeProfiles() const;
+
+  // Port meters are computed only for subscribed ports. Subscriptions are
+  // shared per port; readers poll the returned slot without lookups.
+  int subscribePortMeter(PortId portId);
+  void unsubscribePortMeter(int meterSlot);
+  bool readPortMeter(int meterSlot, TPortMeterBank::Reading &reading) const noexcept;
   RuntimeStats getRuntimeStats() const noexcept;
 
+  struct BlockLatencyReport {
+    TBlockLatencyMonitor::LoadSummary summary;
+    std::vector<TBlockLatencyMonitor::Bucket> histogram;
+    std::vector<TBlockLatencyMonitor::XrunRecord> recentXruns;
+  };
+
+  // Block load is process time over the block's real-time budget. Resetting
+  // starts a new observation window and also clears the process-time max.
+  BlockLatencyReport getBlockLatencyReport() const;
+  void resetBlockLatency() noexcept;
+
+  // Off by default. While enabled, nodes whose descriptor sets a
+  // shedPriority are bypassed with a short fade when the smoothed block load
+  // rises above the shed threshold, and brought back once there is room.
+  // Rebuilds start with every node running again.
+  void setLoadSheddingEnabled(bool shouldShed) noexcept;
+  bool isLoadSheddingEnabled() const noexcept;
+  void setLoadSheddingThresholds(float shedLoad, float restoreLoad) noexcept;
+  std::vector<TLoadShedder::Event> getLoadShedEvents() const;
+
   std::vector<TTeulExposedParam> listExposedParams() const override;
   juce::var getParam(const juce::String &paramId) const override;
   bool setParam(const juce::String &paramId, const juce::var &value) override;
@@ -80,23 +197,48 @@ public:
 
 private:
   void handleAsyncUpdate() override;
+  void timerCallback() override;
   void reportParamValueChange(NodeId nodeId,
                               const juce::String &paramKey,
                               float value) override;
 
-  struct MixOp {
-    int srcChannelIndex = -1;
-    int dstChannelIndex = -1;
-  };
+  using SumOp = TGraphBufferPlan::SumOp;
+
+  using ChannelSignal = TGraphNodeRender::ChannelSignal;
+  using FusedExpression = TGraphNodeRender::FusedExpression;
 
-  struct NodeEntry {
+  // Load shedding state of a node. Fading nodes still run while their audio
+  // outputs ramp over kShedFadeSamples.
+  enum class ShedState : std::uint8_t { Active, FadingOut, Shed, FadingIn };
+  static constexpr int kShedFadeSamples = 256;
+
+  struct NodeEntry : TGraphNodeRender::NodePorts {
     NodeId nodeId = kInvalidNodeId;
     TNode nodeSnapshot;
-    std::unique_ptr<TNodeInstance> instance;
-    std::vector<MixOp> preProcessMixes;
+    std::shared_ptr<TNodeInstance> instance;
     std::map<PortId, int> portChannels;
-    std::map<PortId, juce::MidiBuffer> midiInputBuffers;
-    std::map<PortId, juce::MidiBuffer> midiOutputBuffers;
+    std::vector<TPortSlot> blockSlots;
+    std::size_t telemetryBegin = 0;
+    std::size_t telemetryEnd = 0;
+    float tailLengthMs = -1.0f;
+    int tailSamples = -1;
+    int silentSamples = 0;
+    int profileSlot = -1;
+    juce::int64 lastProcessTicks = 0;
+    bool processedThisBlock = false;
+    ShedState shedState = ShedState::Active;
+    float shedGain = 1.0f;
+    float shedCost = 0.0f;
+    // Polyphonic nodes: the first voice's entry renders the voiceCount
+    // entries that follow it, itself included, in one call. The other
+    // voices' entries only carry their plan and telemetry.
+    int voiceCount = 1;
+    bool voiceLane = false;
+    std::shared_ptr<TVoiceAllocator> voiceAllocator;
+    // Fused math nodes: the group's root entry owns the tape and renders
+    // every member; the members' entries only carry their telemetry.
+    bool fusedMember = false;
+    std::shared_ptr<FusedExpression> fusedExpression;
   };
 
   struct PortTelemetry {
@@ -104,6 +246,8 @@ private:
     NodeId nodeId = kInvalidNodeId;
     int channelIndex = -1;
     TPortDataType dataType = TPortDataType::Audio;
+    bool expandConstant = false;
+    bool detectSilence = false;
   };
 
   struct RailInputSource {
@@ -122,53 +266,67 @@ private:
     TPortDataType dataType = TPortDataType::Audio;
   };
 
-  struct RailMidiInputTarget {
-    juce::String endpointId;
-    juce::String portId;
-    std::size_t targetNodeIndex = 0;
-    PortId targetPortId = kInvalidPortId;
-  };
-
-  struct RailMidiOutputTarget {
-    juce::String endpointId;
-    juce::String portId;
-    std::size_t sourceNodeIndex = 0;
-    PortId sourcePortId = kInvalidPortId;
-  };
-
-  struct MidiRoute {
-    std::size_t sourceNodeIndex = 0;
-    PortId sourcePortId = kInvalidPortId;
-    std::size_t targetNodeIndex = 0;
-    PortId targetPortId = kInvalidPortId;
-  };
-
+  // paramIndex is the node-local dispatch index: descriptor paramSpecs first,
+  // in spec order, then any extra keys stored on the node. specIndex is -1
+  // for the extra keys, which still go through the string overload.
   struct ParamDispatch {
     NodeId nodeId = kInvalidNodeId;
     TNodeInstance *instance = nullptr;
     juce::String paramKey;
-    std::array<char, 32> paramKeyUtf8{};
+    int paramIndex = -1;
+    int specIndex = -1;
+    int cell = -1;
     float currentValue = 0.0f;
     float targetValue = 0.0f;
     bool smoothingEnabled = false;
   };
 
+  struct ParamEvent {
+    int dispatchSlot = -1;
+    float value = 0.0f;
+    int sampleOffset = 0;
+  };
+
+  // Parameter edits for instances carried over from the previous state; they
+  // are applied on the audio thread when the state is committed.
+  struct CommitParamUpdate {
+    std::shared_ptr<TNodeInstance> instance;
+    juce::String paramKey;
+    int specIndex = -1;
+    float value = 0.0f;
+  };
+
   struct RenderState : public juce::ReferenceCountedObject {
     using Ptr = juce::ReferenceCountedObjectPtr<RenderState>;
 
     std::vector<NodeEntry> sortedNodes;
     juce::AudioBuffer<float> globalPortBuffer;
     std::vector<PortTelemetry> portTelemetry;
-    std::map<PortId, std::size_t> portTelemetryIndex;
-    std::unique_ptr<std::atomic<float>[]> portLevels;
+    std::unique_ptr<std::atomic<int>[]> meterSlots;
+    std::unique_ptr<TPortMeterBank::BlockLevel[]> meterLevels;
+    std::unique_ptr<ChannelSignal[]> channelSignals;
+    std::unique_ptr<int[]> channelStrides;
+    int silenceChannel = -1;
     std::vector<RailInputSource> railInputSources;
     std::vector<RailOutputTarget> railOutputTargets;
-    std::vector<RailMidiInputTarget> railMidiInputTargets;
-    std::vector<RailMidiOutputTarget> railMidiOutputTargets;
-    std::vector<MidiRoute> midiRoutes;
+    TGraphMidiFabric midiFabric;
     std::vector<ParamDispatch> paramDispatches;
+    std::vector<int> dispatchByCell;
+    std::vector<ParamEvent> paramEvents;
+    std::vector<CommitParamUpdate> commitParamUpdates;
+    std::vector<std::size_t> shedOrder;
+    std::size_t shedCount = 0;
+    std::vector<std::size_t> voiceSources;
+    int voiceLaneCount = 0;
+    TGraphSchedule schedule;
+    bool parallelEligible = false;
     std::uint64_t generation = 0;
     int totalAllocatedChannels = 0;
+    int naivePortChannels = 0;
+    int aliasedInputCount = 0;
+    int summedInputCount = 0;
+    int fusedNodeCount = 0;
+    RenderState *nextRetired = nullptr;
   };
 
   struct AtomicState {
@@ -183,11 +341,16 @@ private:
     }
 
     void set(RenderState *newState) {
+      if (auto *old = exchange(newState))
+        old->decReferenceCount();
+    }
+
+    // Hands the reference held on the previous state to the caller instead
+    // of releasing it, so the audio thread can retire it without freeing.
+    RenderState *exchange(RenderState *newState) noexcept {
       if (newState)
         newState->incReferenceCount();
-      auto *old = state.exchange(newState, std::memory_order_release);
-      if (old)
-        old->decReferenceCount();
+      return state.exchange(newState, std::memory_order_acq_rel);
     }
 
     RenderState::Ptr take() {
@@ -199,61 +362,106 @@ private:
     }
   };
 
-  struct ParamChange {
-    NodeId nodeId = kInvalidNodeId;
+  // Immutable map from (node, paramIndex) to a change-queue cell. Producers
+  // look it up without locking inside a ParamRouteReader; a replaced table
+  // is freed and a retired cell recycled only while no reader is in flight.
+  // Cells outlive builds, so a change resolved against an older table still
+  // reaches the same parameter.
+  struct ParamRouteTable {
+    std::vector<NodeId> nodeIds;
+    std::vector<int> nodeParamBegin;
+    std::vector<int> cells;
+    std::vector<juce::String> paramKeys;
+
+    int findNode(NodeId nodeId) const noexcept;
+    int findCell(NodeId nodeId, int paramIndex) const noexcept;
+    int findCell(NodeId nodeId, const juce::String &paramKey) const noexcept;
+    const juce::String *findParamKey(NodeId nodeId, int paramIndex) const noexcept;
+  };
+
+  struct RetiredParamCell {
+    int cell = -1;
     std::uint64_t generation = 0;
-    int dispatchSlot = -1;
-    float value = 0.0f;
-    char paramKey[32] = {0};
   };
 
-  static constexpr int kMaxParamQueueSize = 1024;
-  juce::AbstractFifo paramQueueFifo{kMaxParamQueueSize};
-  std::array<ParamChange, kMaxParamQueueSize> paramQueueData;
+  // Brackets a route lookup together with the push or mirror write that
+  // uses the cell it found; the cell may be recycled once it closes.
+  class ParamRouteReader {
+  public:
+    explicit ParamRouteReader(std::atomic<int> &readersToHold) noexcept
+        : readers(readersToHold) {
+      readers.fetch_add(1, std::memory_order_seq_cst);
+    }
+    ~ParamRouteReader() { readers.fetch_sub(1, std::memory_order_release); }
 
-  struct PendingParamNotification {
-    NodeId nodeId = kInvalidNodeId;
-    float value = 0.0f;
-    char paramKey[32] = {0};
+  private:
+    std::atomic<int> &readers;
   };
 
-  static constexpr int kMaxParamNotificationQueueSize = 1024;
-  juce::AbstractFifo paramNotificationFifo{kMaxParamNotificationQueueSize};
-  std::array<PendingParamNotification, kMaxParamNotificationQueueSize>
-      paramNotificationData;
+  struct NodeBlockContext : TGraphNodeRender::Block {
+    bool firstSubBlock = true;
+  };
+
+  class NodeTaskRunner;
+
+  static constexpr int kMinParallelNodeCount = 8;
+  TParamChangeQueue paramChangeQueue;
+
+  // Render threads write parameter values here. Surface reads drain it;
+  // listeners are notified of the cells that changed at kParamPollHz.
+  static constexpr int kParamPollHz = 30;
+  mutable TParamValueMirror paramValueMirror;
 
   void processBlockInternal(juce::AudioBuffer<float> &deviceBuffer,
                             juce::MidiBuffer &midiMessages,
                             const juce::AudioBuffer<float> *inputBufferOverride);
+  void processNodeEntry(RenderState &state, std::size_t entryIndex,
+                        const NodeBlockContext &block) noexcept;
+  void prepareNodeContext(RenderState &state, std::size_t entryIndex,
+                          const NodeBlockContext &block,
+                          TProcessContext &ctx) noexcept;
+  void publishNodeOutputs(RenderState &state, const NodeEntry &entry,
+                          int numSamples) noexcept;
+  void publishPortMeters(RenderState &state) noexcept;
+  void renderFusedExpression(RenderState &state, const NodeEntry &root,
+                             const TProcessContext &ctx) noexcept;
+  TGraphNodeRender nodeRenderFor(RenderState &state) noexcept;
+  void renderSubBlock(RenderState &state, const NodeBlockContext &block,
+                      juce::MidiBuffer &midiMessages) noexcept;
+  void applyParamEvent(RenderState &state, const ParamEvent &event) noexcept;
+  void recordOverBudgetBlock(const RenderState &state, int numSamples,
+                             std::uint64_t elapsedMicros, double budgetMicros,
+                             bool committedState, int paramChanges) noexcept;
+  void updateLoadShedding(RenderState &state, float load, double blockSeconds,
+                          double budgetMicros) noexcept;
+  static void applyShedFade(RenderState &state, NodeEntry &entry,
+                            int numSamples) noexcept;
+  void refreshMeterSlotsLocked(RenderState &state) const;
   void rebuildParamSurfaceLocked(const TGraphDocument &doc);
   bool updateParamSurfaceValueLocked(NodeId nodeId,
                                      const juce::String &paramKey,
                                      const juce::var &value,
                                      TTeulExposedParam *updatedParam = nullptr);
-  void rebuildQueuedParamDispatchLocked(const RenderState &state);
-  void enqueueParamNotification(NodeId nodeId,
-                                const juce::String &paramKey,
-                                float value);
+  void publishParamRoutesLocked(RenderState &state);
+  void reclaimParamRoutesLocked();
+  int findParamCell(NodeId nodeId, int paramIndex,
+                    const juce::String *paramKey) const noexcept;
+  void pushParamChange(int cell, float value, int sampleOffset = 0) noexcept;
+  void publishParamValueChanges();
+  void drainParamValueMirrorLocked() const;
   void prepareStateForPlayback(RenderState &state,
                                double sampleRate,
                                int maximumExpectedSamplesPerBlock);
   bool commitPendingStateIfNeeded() noexcept;
+  void retireState(RenderState *state) noexcept;
+  void collectRetiredStates();
   static float paramValueToFloat(const juce::var &value);
   static juce::var coerceValueLike(const juce::var &prototype,
                                    const juce::var &candidate);
-  static float measureSignalLevel(const float *samples, int numSamples) noexcept;
-  static float smoothMeterLevel(float previousLevel,
-                                float measuredLevel) noexcept;
   static bool shouldSmoothParam(const TParamSpec *paramSpec,
                                 const juce::var &initialValue) noexcept;
-  static void writeParamKey(char *dest,
-                            std::size_t destSize,
-                            const juce::String &paramKey);
-  static void writeParamKey(std::array<char, 32> &dest,
-                            const juce::String &paramKey);
-  static bool dispatchMatches(const ParamDispatch &dispatch,
-                              NodeId nodeId,
-                              const char *paramKey) noexcept;
+  static void applyParamValue(TNodeInstance &instance, int specIndex,
+                              const juce::String &paramKey, float value);
   static std::uint64_t ticksToMicros(juce::int64 tickDelta) noexcept;
   static double microsToMilliseconds(std::uint64_t micros) noexcept;
   static void updateAtomicMax(std::atomic<std::uint64_t> &target,
@@ -268,17 +476,37 @@ private:
   int outputFadeSamplesRemaining = 0;
   float outputFadeCurrentGain = 1.0f;
 
+  juce::CriticalSection meterLock;
+  TPortMeterBank portMeters;
+  mutable juce::CriticalSection profilerLock;
+  TNodeProfiler nodeProfiler;
+  TBlockLatencyMonitor blockLatency;
+  TLoadShedder loadShedder;
+  std::atomic<int> shedNodeCount{0};
+  std::atomic<int> activeVoiceCount{0};
+  std::atomic<std::uint64_t> voiceStealCount{0};
+
   mutable juce::CriticalSection paramSurfaceLock;
-  TGraphDocument surfaceDocument;
-  std::vector<TTeulExposedParam> exposedParams;
+  // Mutable so surface reads can fold in the render threads' latest values.
+  mutable TGraphDocument surfaceDocument;
+  mutable std::vector<TTeulExposedParam> exposedParams;
+  mutable std::set<std::size_t> unpublishedParamValues;
   std::map<juce::String, std::size_t> exposedParamIndexById;
-  std::map<juce::String, int> queuedParamDispatchSlotById;
-  std::uint64_t queuedParamDispatchGeneration = 0;
+  std::unique_ptr<ParamRouteTable> currentParamRoutes;
+  std::vector<std::unique_ptr<ParamRouteTable>> retiredParamRoutes;
+  std::map<std::pair<NodeId, juce::String>, int> paramCellByKey;
+  std::vector<int> freeParamCells;
+  std::vector<RetiredParamCell> retiredParamCells;
+  std::vector<int> exposedParamIndexByCell;
+  int nextParamCell = 0;
+  std::atomic<const ParamRouteTable *> paramRoutes{nullptr};
+  mutable std::atomic<int> paramRouteReaders{0};
   juce::ListenerList<Listener> listeners;
   std::atomic<bool> surfaceChangedPending{false};
 
   AtomicState activeState;
   AtomicState pendingState;
+  std::atomic<RenderState *> retiredStates{nullptr};
 
   std::atomic<std::uint64_t> buildGenerationCounter{0};
   std::atomic<std::uint64_t> activeGeneration{0};
@@ -290,24 +518,51 @@ private:
   std::atomic<std::uint64_t> rebuildCommitCount{0};
   std::atomic<std::uint64_t> paramChangeCount{0};
   std::atomic<std::uint64_t> droppedParamChangeCount{0};
-  std::atomic<std::uint64_t> droppedParamNotificationCount{0};
+  std::atomic<std::uint64_t> coalescedParamChangeCount{0};
+  std::atomic<std::uint64_t> droppedMidiEventCount{0};
   std::atomic<std::uint64_t> lastBuildMicros{0};
   std::atomic<std::uint64_t> maxBuildMicros{0};
+  std::atomic<int> lastBuildReusedNodeCount{0};
+  std::atomic<int> lastBuildCreatedNodeCount{0};
+  std::atomic<int> lastBuildDestroyedNodeCount{0};
   std::atomic<std::uint64_t> lastProcessMicros{0};
   std::atomic<std::uint64_t> maxProcessMicros{0};
+  std::atomic<std::uint64_t> maxCommitBlockMicros{0};
+  std::atomic<int> deferredFreesPending{0};
   std::atomic<int> activeNodeCount{0};
   std::atomic<int> allocatedPortChannels{0};
+  std::atomic<int> naivePortChannels{0};
+  std::atomic<int> aliasedInputCount{0};
+  std::atomic<int> summedInputCount{0};
+  std::atomic<int> fusedNodeCount{0};
   std::atomic<int> largestBlockSeen{0};
   std::atomic<int> largestOutputChannelCountSeen{0};
   std::atomic<int> smoothingActiveCount{0};
+  std::atomic<int> blockSkippedNodeCount{0};
+  std::atomic<int> lastSkippedNodeCount{0};
+  std::atomic<std::uint64_t> skippedNodeCount{0};
+  std::atomic<int> minSubBlockSamples{kDefaultMinSubBlockSamples};
+  std::atomic<int> lastSubBlockCount{0};
+  std::atomic<std::uint64_t> splitBlockCount{0};
+  std::atomic<std::uint64_t> chunkedBlockCount{0};
+  std::atomic<int> internalBlockSamples{0};
   std::atomic<bool> clipDetected{false};
   std::atomic<bool> denormalDetected{false};
   std::atomic<bool> xrunDetected{false};
   std::atomic<bool> mutedFallbackActive{false};
+  std::atomic<std::uint64_t> parallelBlockCount{0};
+  std::array<std::atomic<std::uint64_t>, TGraphWorkerPool::kMaxParticipants>
+      workerBusyMicros{};
+
+  std::atomic<int> requestedWorkerThreadCount{getDefaultWorkerThreadCount()};
+  std::atomic<juce::uint32> requestedWorkerCpuMask{0};
+  TGraphWorkerPool workerPool;
 
   juce::MidiBuffer deviceCallbackMidiScratch;
   juce::MidiBuffer deviceInputMidiCaptureBuffer;
   juce::AudioBuffer<float> deviceInputCaptureBuffer;
+  juce::AudioBuffer<float> subBlockInputView;
+  juce::AudioBuffer<float> subBlockDeviceView;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TGraphRuntime)
 };
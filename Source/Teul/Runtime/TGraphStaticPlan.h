@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../Model/TTypes.h"
+#include "TGraphBufferPlan.h"
+#include "TGraphFusionPlan.h"
+#include "TGraphMidiFabric.h"
+#include "TGraphNodeRender.h"
+#include "TNodeInstance.h"
+#include <JuceHeader.h>
+#include <vector>
+
+namespace Teul {
+
+// Everything TGraphRuntime decided while building a graph, as plain tables:
+// the entry order with voice lanes expanded, port buffer channels, fan-in
+// sums, fused math groups, MIDI routing and the parameter dispatch order.
+// A RuntimeModule export is generated from it, and TGraphStaticRenderer
+// replays it without a document, a registry or string keys.
+struct TGraphStaticPlan {
+  struct Output {
+    int channelIndex = -1;
+    bool expandConstant = false;
+    bool detectSilence = false;
+  };
+
+  // Values the runtime applies to a new instance, in the node's key order.
+  struct InitialParam {
+    int specIndex = -1;
+    float value = 0.0f;
+  };
+
+  struct TextParam {
+    int specIndex = -1;
+    juce::String text;
+  };
+
+  struct Entry : TGraphNodeRender::NodePorts {
+    NodeId nodeId = kInvalidNodeId;
+    juce::String typeKey;
+    // An instance that is not bypassed; other entries only mark their
+    // outputs stale.
+    bool runs = false;
+    std::vector<Output> outputs;
+    float tailLengthMs = -1.0f;
+    int voiceCount = 1;
+    bool voiceLane = false;
+    bool allocatesVoices = false;
+    bool fusedMember = false;
+    int fusionGroup = -1;
+    std::vector<InitialParam> initialParams;
+    std::vector<TextParam> textParams;
+  };
+
+  // Members in tape order, the root last; operand k of member m reads the
+  // result of operands[m][k].member or, when that is -1, slot slotIndex of
+  // the member's own entry.
+  struct FusionGroup {
+    std::vector<int> memberEntries;
+    std::vector<std::vector<TGraphFusionPlan::Operand>> operands;
+    int outputSlot = -1;
+  };
+
+  // Spec-indexed parameters in the runtime's dispatch order.
+  struct Param {
+    int entryIndex = -1;
+    int specIndex = -1;
+    NodeId nodeId = kInvalidNodeId;
+    juce::String paramKey;
+    float initialValue = 0.0f;
+    bool smoothing = false;
+  };
+
+  struct RailInput {
+    int channelIndex = -1;
+    // -1 for rails that are not audio inputs; those stay silent.
+    int deviceChannelIndex = -1;
+  };
+
+  struct RailOutput {
+    int sourceChannelIndex = -1;
+    int deviceChannelIndex = -1;
+  };
+
+  struct Midi {
+    std::vector<TGraphMidiFabric::Input> inputs;
+    std::vector<int> sourceBlocks;
+    std::vector<TGraphMidiFabric::NodeMidi> nodes;
+    std::vector<int> railOutputBlocks;
+    int deviceInputBlock = -1;
+    int emptyBlock = -1;
+    int blockCount = 0;
+  };
+
+  std::vector<Entry> entries;
+  std::vector<FusionGroup> fusionGroups;
+  std::vector<Param> params;
+  std::vector<RailInput> railInputs;
+  std::vector<RailOutput> railOutputs;
+  Midi midi;
+  int channelCount = 0;
+  int silenceChannel = -1;
+};
+
+} // namespace Teul
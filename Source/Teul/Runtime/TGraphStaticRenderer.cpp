@@ -0,0 +1,246 @@
+#include "TGraphStaticRenderer.h"
+
+namespace Teul {
+
+TGraphStaticRenderer::TGraphStaticRenderer(TGraphStaticPlan planToRender)
+    : plan(std::move(planToRender)) {
+  const auto numChannels = static_cast<std::size_t>(juce::jmax(1, plan.channelCount));
+  const auto numEntries = plan.entries.size();
+  channelSignals.resize(numChannels);
+  channelStrides.resize(numChannels);
+  tailSamples.resize(numEntries);
+  silentSamples.resize(numEntries);
+  voiceAllocators.resize(numEntries);
+  expressions.resize(numEntries, nullptr);
+  for (const auto &entry : plan.entries)
+    blockSlots.push_back(entry.portSlots);
+
+  midiFabric.inputs = plan.midi.inputs;
+  midiFabric.sourceBlocks = plan.midi.sourceBlocks;
+  midiFabric.nodes = plan.midi.nodes;
+  midiFabric.railOutputBlocks = plan.midi.railOutputBlocks;
+  midiFabric.deviceInputBlock = plan.midi.deviceInputBlock;
+  midiFabric.emptyBlock = plan.midi.emptyBlock;
+
+  paramStates.resize(plan.params.size());
+  paramValues = std::make_unique<std::atomic<float>[]>(
+      juce::jmax<std::size_t>(1, plan.params.size()));
+  paramEvents.reserve(plan.params.size());
+
+  portBuffer.setSize(static_cast<int>(numChannels), preparedBlockSize, false, false,
+                     true);
+  reset();
+}
+
+void TGraphStaticRenderer::prepare(double sampleRate,
+                                   int maximumExpectedSamplesPerBlock) {
+  currentSampleRate = sampleRate;
+  preparedBlockSize = juce::jmax(1, maximumExpectedSamplesPerBlock);
+  if (portBuffer.getNumSamples() != preparedBlockSize) {
+    portBuffer.setSize(portBuffer.getNumChannels(), preparedBlockSize, false, false,
+                       true);
+  }
+  portBuffer.clear();
+
+  for (std::size_t index = 0; index < plan.entries.size(); ++index) {
+    tailSamples[index] =
+        TGraphNodeRender::tailLengthToSamples(plan.entries[index].tailLengthMs, sampleRate);
+    silentSamples[index] = 0;
+  }
+}
+
+void TGraphStaticRenderer::setCurrentChannelLayout(int inputChannels,
+                                                   int outputChannels) noexcept {
+  juce::ignoreUnused(outputChannels);
+  inputChannelCount.store(juce::jmax(0, inputChannels), std::memory_order_relaxed);
+}
+
+void TGraphStaticRenderer::bindExpression(int entryIndex,
+                                          const TExpressionNodeInstance &instance) {
+  if (entryIndex >= 0 && entryIndex < static_cast<int>(expressions.size()))
+    expressions[static_cast<std::size_t>(entryIndex)] = &instance;
+}
+
+void TGraphStaticRenderer::reset() {
+  std::fill(channelSignals.begin(), channelSignals.end(), ChannelSignal::Active);
+  std::fill(channelStrides.begin(), channelStrides.end(), 1);
+  if (plan.silenceChannel >= 0) {
+    channelSignals[static_cast<std::size_t>(plan.silenceChannel)] = ChannelSignal::Zeroed;
+    channelStrides[static_cast<std::size_t>(plan.silenceChannel)] =
+        TProcessContext::kConstantStride;
+  }
+  portBuffer.clear();
+  midiFabric.allocate(plan.midi.blockCount);
+  prepare(currentSampleRate, preparedBlockSize);
+
+  for (std::size_t index = 0; index < plan.entries.size(); ++index) {
+    const auto &entry = plan.entries[index];
+    voiceAllocators[index].reset();
+    if (entry.allocatesVoices) {
+      voiceAllocators[index] = std::make_unique<TVoiceAllocator>();
+      voiceAllocators[index]->setVoiceCount(entry.voiceCount);
+    }
+  }
+
+  paramChangeQueue.drain([](int, float, int) {});
+  for (std::size_t index = 0; index < plan.params.size(); ++index) {
+    const float initialValue = plan.params[index].initialValue;
+    paramStates[index] = {initialValue, initialValue};
+    paramValues[index].store(initialValue, std::memory_order_relaxed);
+  }
+
+  buildFusedTapes();
+}
+
+bool TGraphStaticRenderer::setParameter(int paramIndex, float value,
+                                        int sampleOffset) noexcept {
+  if (paramIndex < 0 || paramIndex >= getNumParameters())
+    return false;
+
+  paramValues[static_cast<std::size_t>(paramIndex)].store(value,
+                                                          std::memory_order_relaxed);
+  return paramChangeQueue.push(paramIndex, value, juce::jmax(0, sampleOffset)) !=
+         TParamChangeQueue::PushResult::rejected;
+}
+
+float TGraphStaticRenderer::getParameter(int paramIndex) const noexcept {
+  if (paramIndex < 0 || paramIndex >= getNumParameters())
+    return 0.0f;
+
+  return paramValues[static_cast<std::size_t>(paramIndex)].load(
+      std::memory_order_relaxed);
+}
+
+const juce::AudioBuffer<float> *TGraphStaticRenderer::captureDeviceInput(
+    const juce::AudioBuffer<float> &deviceBuffer, juce::MidiBuffer &midiMessages) {
+  const int numSamples = deviceBuffer.getNumSamples();
+  const int inputChannels = juce::jmin(
+      inputChannelCount.load(std::memory_order_relaxed), deviceBuffer.getNumChannels());
+  if (inputChannels > 0 && numSamples > 0) {
+    deviceInputCapture.setSize(inputChannels, numSamples, false, false, true);
+    for (int channelIndex = 0; channelIndex < inputChannels; ++channelIndex)
+      deviceInputCapture.copyFrom(channelIndex, 0, deviceBuffer, channelIndex, 0,
+                                  numSamples);
+  } else {
+    deviceInputCapture.setSize(1, juce::jmax(1, numSamples), false, false, true);
+    deviceInputCapture.clear();
+  }
+
+  deviceMidiCapture.clear();
+  if (numSamples > 0)
+    deviceMidiCapture.addEvents(midiMessages, 0, numSamples, 0);
+  midiMessages.clear();
+  return inputChannels > 0 ? &deviceInputCapture : nullptr;
+}
+
+TGraphNodeRender TGraphStaticRenderer::nodeRender() noexcept {
+  return {portBuffer, channelSignals.data(), channelStrides.data(),
+          plan.silenceChannel, midiFabric, deviceMidiCapture};
+}
+
+void TGraphStaticRenderer::beginSubBlock(const Block &block) noexcept {
+  auto render = nodeRender();
+  for (const auto &railInput : plan.railInputs)
+    render.readRailInput(railInput.channelIndex, railInput.deviceChannelIndex, block);
+
+  midiFabric.captureDeviceInput(deviceMidiCapture, block.startSample, block.numSamples);
+}
+
+void TGraphStaticRenderer::endSubBlock(const Block &block,
+                                       juce::MidiBuffer &midiMessages) noexcept {
+  midiFabric.renderRailOutputs(midiMessages, block.startSample, block.numSamples);
+
+  auto render = nodeRender();
+  for (const auto &railOutput : plan.railOutputs) {
+    render.writeRailOutput(railOutput.sourceChannelIndex, railOutput.deviceChannelIndex,
+                           block);
+  }
+}
+
+const TProcessContext *TGraphStaticRenderer::beginNode(int entryIndex,
+                                                       const Block &block) noexcept {
+  const auto index = static_cast<std::size_t>(entryIndex);
+  midiFabric.prepareNode(index);
+
+  auto render = nodeRender();
+  if (render.skipsSilentNode(plan.entries[index], index, tailSamples[index],
+                             silentSamples[index], block.numSamples)) {
+    markOutputsStale(entryIndex);
+    return nullptr;
+  }
+
+  const int voiceCount =
+      juce::jlimit(1, TVoiceAllocator::kMaxVoices, plan.entries[index].voiceCount);
+  for (int voice = 0; voice < voiceCount; ++voice) {
+    const auto voiceIndex = index + static_cast<std::size_t>(voice);
+    render.prepareContext(plan.entries[voiceIndex], blockSlots[voiceIndex], voiceIndex,
+                          block, contexts[static_cast<std::size_t>(voice)]);
+  }
+  contexts[0].voiceAllocator = voiceAllocators[index].get();
+  return contexts.data();
+}
+
+void TGraphStaticRenderer::endNode(int entryIndex, const Block &block) noexcept {
+  const int voiceCount = juce::jlimit(
+      1, TVoiceAllocator::kMaxVoices,
+      plan.entries[static_cast<std::size_t>(entryIndex)].voiceCount);
+  auto render = nodeRender();
+  for (int voice = 0; voice < voiceCount; ++voice) {
+    for (const auto &output : plan.entries[static_cast<std::size_t>(entryIndex + voice)].outputs) {
+      render.publishOutput(output.channelIndex, output.expandConstant,
+                           output.detectSilence, block.numSamples, nullptr);
+    }
+  }
+}
+
+void TGraphStaticRenderer::skipNode(int entryIndex) noexcept {
+  midiFabric.prepareNode(static_cast<std::size_t>(entryIndex));
+  markOutputsStale(entryIndex);
+}
+
+void TGraphStaticRenderer::markOutputsStale(int entryIndex) noexcept {
+  const int voiceCount = juce::jlimit(
+      1, TVoiceAllocator::kMaxVoices,
+      plan.entries[static_cast<std::size_t>(entryIndex)].voiceCount);
+  for (int voice = 0; voice < voiceCount; ++voice) {
+    for (const auto &output : plan.entries[static_cast<std::size_t>(entryIndex + voice)].outputs)
+      channelSignals[static_cast<std::size_t>(output.channelIndex)] = ChannelSignal::Stale;
+  }
+}
+
+void TGraphStaticRenderer::renderFused(int entryIndex,
+                                       const TProcessContext &context) noexcept {
+  const int fusionGroup = plan.entries[static_cast<std::size_t>(entryIndex)].fusionGroup;
+  if (fusionGroup >= 0) {
+    nodeRender().renderFused(fusedTapes[static_cast<std::size_t>(fusionGroup)], context,
+                             nullptr);
+  }
+}
+
+// A group with an unbound member keeps an empty tape and leaves its output
+// untouched.
+void TGraphStaticRenderer::buildFusedTapes() {
+  fusedTapes.clear();
+  fusedTapes.resize(plan.fusionGroups.size());
+  for (std::size_t groupIndex = 0; groupIndex < plan.fusionGroups.size(); ++groupIndex) {
+    const auto &group = plan.fusionGroups[groupIndex];
+    const bool bound = std::all_of(
+        group.memberEntries.begin(), group.memberEntries.end(), [this](int entryIndex) {
+          return expressions[static_cast<std::size_t>(entryIndex)] != nullptr;
+        });
+    if (!bound)
+      continue;
+
+    auto &fused = fusedTapes[groupIndex];
+    for (const int entryIndex : group.memberEntries)
+      fused.memberEntries.push_back(static_cast<std::size_t>(entryIndex));
+    fused.memberOperands = group.operands;
+    TGraphNodeRender::assembleFused(
+        fused, plan.entries,
+        [this](std::size_t entryIndex) -> const TExpressionNodeInstance & {
+          return *expressions[entryIndex];
+        });
+  }
+}
+
+} // namespace Teul
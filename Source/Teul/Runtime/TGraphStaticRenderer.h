@@ -0,0 +1,186 @@
+#pragma once
+
+#include "TExpressionTape.h"
+#include "TGraphMidiFabric.h"
+#include "TGraphNodeRender.h"
+#include "TGraphStaticPlan.h"
+#include "TNodeInstance.h"
+#include "TParamChangeQueue.h"
+#include "TVoiceAllocator.h"
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Teul {
+
+// Render loop of a statically compiled RuntimeModule. It replays a
+// TGraphStaticPlan through the TGraphNodeRender steps TGraphRuntime uses,
+// so both render the same samples. The generated class owns the node
+// instances as concrete members and runs them from its renderNodes(), in
+// plan order:
+//
+//   if (const auto *contexts = renderer.beginNode(3, block)) {
+//     node3.processSamples(contexts[0]);
+//     renderer.endNode(3, block);
+//   }
+//
+// Graph::applyParameter(paramIndex, value) forwards a plan parameter to its
+// instance. There are no rebuilds, meters, profiling or load shedding.
+class TGraphStaticRenderer {
+public:
+  using Block = TGraphNodeRender::Block;
+
+  explicit TGraphStaticRenderer(TGraphStaticPlan planToRender);
+
+  const TGraphStaticPlan &getPlan() const noexcept { return plan; }
+
+  // Sizes the port buffer; the caller prepares its instances itself.
+  void prepare(double sampleRate, int maximumExpectedSamplesPerBlock);
+  void setCurrentChannelLayout(int inputChannels, int outputChannels) noexcept;
+
+  // Fused groups read the parameters of their members' instances, so every
+  // member is bound before reset() builds the tapes.
+  void bindExpression(int entryIndex, const TExpressionNodeInstance &instance);
+
+  // Back to the state of a fresh build: silent buffers, parameters at their
+  // initial values and pending changes dropped. Not while processing.
+  void reset();
+
+  int getNumParameters() const noexcept {
+    return static_cast<int>(plan.params.size());
+  }
+
+  // Any thread. sampleOffset works as in TGraphRuntime::queueParameterChange.
+  bool setParameter(int paramIndex, float value, int sampleOffset = 0) noexcept;
+  float getParameter(int paramIndex) const noexcept;
+
+  template <typename Graph>
+  void process(Graph &graph, juce::AudioBuffer<float> &deviceBuffer,
+               juce::MidiBuffer &midiMessages) noexcept {
+    const auto *inputBuffer = captureDeviceInput(deviceBuffer, midiMessages);
+    juce::ScopedNoDenormals noDenormals;
+    deviceBuffer.clear();
+
+    const int numSamples = deviceBuffer.getNumSamples();
+    if (numSamples <= 0 || preparedBlockSize <= 0)
+      return;
+
+    paramEvents.clear();
+    paramChangeQueue.drain([&](int paramIndex, float value, int sampleOffset) {
+      const ParamEvent event{paramIndex, value, juce::jmin(sampleOffset, numSamples - 1)};
+      if (event.sampleOffset > 0 && paramEvents.size() < paramEvents.capacity())
+        paramEvents.push_back(event);
+      else
+        applyParamEvent(graph, event);
+    });
+
+    TGraphNodeRender::renderSubBlocks(
+        numSamples, kMinSubBlockSamples, preparedBlockSize, paramEvents,
+        deviceMidiCapture,
+        [&](const ParamEvent &event) { applyParamEvent(graph, event); },
+        [&](int subBlockStart, int subBlockEnd, int) {
+          const auto block = TGraphNodeRender::makeSubBlock(
+              inputBuffer, deviceBuffer, subBlockStart, subBlockEnd,
+              subBlockInputView, subBlockDeviceView);
+          beginSubBlock(block);
+          smoothParameters(graph, block.numSamples);
+          graph.renderNodes(*this, block);
+          endSubBlock(block, midiMessages);
+        });
+  }
+
+  // Called from Graph::renderNodes for every entry that is neither a voice
+  // lane nor a fused member. beginNode returns the contexts of the entry's
+  // voices, or nullptr when the node skips this sub-block; endNode follows
+  // every non-null beginNode. Entries that never run call skipNode instead.
+  const TProcessContext *beginNode(int entryIndex, const Block &block) noexcept;
+  void renderFused(int entryIndex, const TProcessContext &context) noexcept;
+  void endNode(int entryIndex, const Block &block) noexcept;
+  void skipNode(int entryIndex) noexcept;
+
+private:
+  using ChannelSignal = TGraphNodeRender::ChannelSignal;
+
+  struct ParamState {
+    float currentValue = 0.0f;
+    float targetValue = 0.0f;
+  };
+
+  struct ParamEvent {
+    int paramIndex = -1;
+    float value = 0.0f;
+    int sampleOffset = 0;
+  };
+
+  template <typename Graph>
+  void applyParamEvent(Graph &graph, const ParamEvent &event) noexcept {
+    const auto index = static_cast<std::size_t>(event.paramIndex);
+    auto &param = paramStates[index];
+    if (plan.params[index].smoothing) {
+      param.targetValue = event.value;
+      return;
+    }
+
+    param.currentValue = event.value;
+    param.targetValue = event.value;
+    graph.applyParameter(event.paramIndex, event.value);
+  }
+
+  template <typename Graph>
+  void smoothParameters(Graph &graph, int numSamples) noexcept {
+    const float rampAlpha = TGraphNodeRender::smoothingAlpha(numSamples, currentSampleRate);
+    for (std::size_t index = 0; index < paramStates.size(); ++index) {
+      auto &param = paramStates[index];
+      if (plan.params[index].smoothing &&
+          TGraphNodeRender::smoothTowards(param.currentValue, param.targetValue,
+                                          rampAlpha)) {
+        graph.applyParameter(static_cast<int>(index), param.currentValue);
+      }
+    }
+  }
+
+  const juce::AudioBuffer<float> *captureDeviceInput(
+      const juce::AudioBuffer<float> &deviceBuffer, juce::MidiBuffer &midiMessages);
+  TGraphNodeRender nodeRender() noexcept;
+  void beginSubBlock(const Block &block) noexcept;
+  void endSubBlock(const Block &block, juce::MidiBuffer &midiMessages) noexcept;
+  void markOutputsStale(int entryIndex) noexcept;
+  void buildFusedTapes();
+
+  static constexpr int kMinSubBlockSamples = 32;
+
+  TGraphStaticPlan plan;
+  double currentSampleRate = 48000.0;
+  int preparedBlockSize = 256;
+  std::atomic<int> inputChannelCount{0};
+
+  juce::AudioBuffer<float> portBuffer;
+  std::vector<ChannelSignal> channelSignals;
+  std::vector<int> channelStrides;
+  std::vector<int> tailSamples;
+  std::vector<int> silentSamples;
+  std::vector<std::vector<TPortSlot>> blockSlots;
+  std::vector<std::unique_ptr<TVoiceAllocator>> voiceAllocators;
+  std::vector<const TExpressionNodeInstance *> expressions;
+  std::vector<TGraphNodeRender::FusedExpression> fusedTapes;
+  TGraphMidiFabric midiFabric;
+  std::array<TProcessContext, TVoiceAllocator::kMaxVoices> contexts;
+
+  TParamChangeQueue paramChangeQueue;
+  std::vector<ParamState> paramStates;
+  std::unique_ptr<std::atomic<float>[]> paramValues;
+  std::vector<ParamEvent> paramEvents;
+
+  juce::MidiBuffer deviceMidiCapture;
+  juce::AudioBuffer<float> deviceInputCapture;
+  juce::AudioBuffer<float> subBlockInputView;
+  juce::AudioBuffer<float> subBlockDeviceView;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TGraphStaticRenderer)
+};
+
+} // namespace Teul
@@ -0,0 +1,195 @@
+#include "TGraphVoicePlan.h"
+
+#include "TVoiceAllocator.h"
+#include <algorithm>
+
+namespace Teul {
+namespace {
+
+bool isMidiEndpoint(const TGraphDocument &doc, const TEndpoint &endpoint) {
+  if (!endpoint.isNodePort())
+    return false;
+
+  const auto *node = doc.findNode(endpoint.nodeId);
+  const auto *port = node != nullptr ? node->findPort(endpoint.portId) : nullptr;
+  return port != nullptr && port->dataType == TPortDataType::MIDI;
+}
+
+} // namespace
+
+int TGraphVoicePlan::voiceCountFor(const TNode &node, const TNodeDescriptor &desc) {
+  juce::var value;
+  const auto paramIt = node.params.find(kVoiceCountParamKey);
+  if (paramIt != node.params.end()) {
+    value = paramIt->second;
+  } else {
+    for (const auto &spec : desc.paramSpecs) {
+      if (spec.key == kVoiceCountParamKey)
+        value = spec.defaultValue;
+    }
+  }
+
+  const int requested = value.isVoid() ? 1 : static_cast<int>(value);
+  return juce::jlimit(1,
+                      juce::jmin(TVoiceAllocator::kMaxVoices,
+                                 juce::jmax(1, desc.capabilities.maxPolyphony)),
+                      requested);
+}
+
+bool TGraphVoicePlan::build(const TGraphDocument &doc,
+                            const std::vector<NodeId> &buildOrder,
+                            const TNodeRegistry *registry) {
+  groups.clear();
+  order.clear();
+  if (registry == nullptr)
+    return false;
+
+  std::map<NodeId, std::vector<NodeId>> signalSources;
+  for (const auto &conn : doc.connections) {
+    if (conn.isValid() && conn.from.isNodePort() && conn.to.isNodePort() &&
+        !isMidiEndpoint(doc, conn.from) && !isMidiEndpoint(doc, conn.to)) {
+      signalSources[conn.to.nodeId].push_back(conn.from.nodeId);
+    }
+  }
+
+  // Regions are numbered in the order of their sources; mono nodes have no
+  // entry in regionByNode.
+  std::map<NodeId, int> regionByNode;
+  std::vector<int> regionVoiceCounts;
+  std::vector<VoiceGroup> regionNodes;
+  for (const auto nodeId : buildOrder) {
+    const auto *node = doc.findNode(nodeId);
+    const auto *desc = node != nullptr ? registry->descriptorFor(node->typeKey) : nullptr;
+    if (desc == nullptr)
+      continue;
+
+    if (desc->capabilities.allocatesVoices) {
+      const int voiceCount = voiceCountFor(*node, *desc);
+      if (voiceCount > 1) {
+        regionByNode[nodeId] = static_cast<int>(regionVoiceCounts.size());
+        regionVoiceCounts.push_back(voiceCount);
+        regionNodes.push_back({nodeId, true, {}});
+      }
+      continue;
+    }
+
+    int region = -1;
+    bool mixedRegions = false;
+    for (const auto sourceId : signalSources[nodeId]) {
+      const auto regionIt = regionByNode.find(sourceId);
+      if (regionIt == regionByNode.end())
+        continue;
+      if (region >= 0 && region != regionIt->second)
+        mixedRegions = true;
+      region = regionIt->second;
+    }
+
+    if (region >= 0 && !mixedRegions &&
+        desc->capabilities.maxPolyphony >=
+            regionVoiceCounts[static_cast<std::size_t>(region)]) {
+      regionByNode[nodeId] = region;
+      regionNodes.push_back({nodeId, false, {}});
+    }
+  }
+
+  if (regionNodes.empty())
+    return false;
+
+  expandedDoc = doc;
+  NodeId nextNodeId = doc.getNextNodeId();
+  PortId nextPortId = doc.getNextPortId();
+  ConnectionId nextConnectionId = doc.getNextConnectionId();
+  for (const auto &node : doc.nodes) {
+    nextNodeId = juce::jmax(nextNodeId, node.nodeId + 1);
+    for (const auto &port : node.ports)
+      nextPortId = juce::jmax(nextPortId, port.portId + 1);
+  }
+  for (const auto &conn : doc.connections)
+    nextConnectionId = juce::jmax(nextConnectionId, conn.connectionId + 1);
+
+  std::map<NodeId, std::size_t> groupByNode;
+  std::map<PortId, std::vector<PortId>> voicePorts;
+  for (auto &group : regionNodes) {
+    const int voiceCount = regionVoiceCounts[static_cast<std::size_t>(
+        regionByNode[group.nodeId])];
+    const TNode prototype = *doc.findNode(group.nodeId);
+    group.voiceNodeIds.push_back(prototype.nodeId);
+    for (const auto &port : prototype.ports)
+      voicePorts[port.portId].push_back(port.portId);
+
+    for (int voice = 1; voice < voiceCount; ++voice) {
+      TNode copy = prototype;
+      copy.nodeId = nextNodeId++;
+      for (auto &port : copy.ports) {
+        const PortId prototypePortId = port.portId;
+        port.portId = nextPortId++;
+        port.ownerNodeId = copy.nodeId;
+        voicePorts[prototypePortId].push_back(port.portId);
+      }
+      group.voiceNodeIds.push_back(copy.nodeId);
+      expandedDoc.nodes.push_back(std::move(copy));
+    }
+
+    groupByNode[group.nodeId] = groups.size();
+    groups.push_back(std::move(group));
+  }
+
+  auto voiceEndpoint = [&](const TEndpoint &endpoint, std::size_t voice) {
+    auto copy = endpoint;
+    const auto &group = groups[groupByNode[endpoint.nodeId]];
+    copy.nodeId = group.voiceNodeIds[voice];
+    copy.portId = voicePorts[endpoint.portId][voice];
+    return copy;
+  };
+
+  auto voiceCountOf = [&](const TEndpoint &endpoint) -> std::size_t {
+    if (!endpoint.isNodePort())
+      return 1;
+    const auto groupIt = groupByNode.find(endpoint.nodeId);
+    return groupIt != groupByNode.end()
+               ? groups[groupIt->second].voiceNodeIds.size()
+               : 1;
+  };
+
+  for (const auto &conn : doc.connections) {
+    if (!conn.isValid() || isMidiEndpoint(doc, conn.from) ||
+        isMidiEndpoint(doc, conn.to)) {
+      continue;
+    }
+
+    // Only a voice source can be fed by another region; its first voice
+    // takes the sum of that region's voices.
+    const auto fromVoices = voiceCountOf(conn.from);
+    auto toVoices = voiceCountOf(conn.to);
+    if (fromVoices > 1 && toVoices != fromVoices)
+      toVoices = 1;
+
+    for (std::size_t voice = 1; voice < juce::jmax(fromVoices, toVoices); ++voice) {
+      TConnection copy;
+      copy.connectionId = nextConnectionId++;
+      copy.from = fromVoices > 1 ? voiceEndpoint(conn.from, voice) : conn.from;
+      copy.to = toVoices > 1 ? voiceEndpoint(conn.to, voice) : conn.to;
+      expandedDoc.connections.push_back(std::move(copy));
+    }
+  }
+
+  expandedDoc.setNextNodeId(nextNodeId);
+  expandedDoc.setNextPortId(nextPortId);
+  expandedDoc.setNextConnectionId(nextConnectionId);
+
+  order.reserve(expandedDoc.nodes.size());
+  for (const auto nodeId : buildOrder) {
+    const auto groupIt = groupByNode.find(nodeId);
+    if (groupIt == groupByNode.end()) {
+      order.push_back(nodeId);
+      continue;
+    }
+
+    const auto &voiceNodeIds = groups[groupIt->second].voiceNodeIds;
+    order.insert(order.end(), voiceNodeIds.begin(), voiceNodeIds.end());
+  }
+
+  return true;
+}
+
+} // namespace Teul
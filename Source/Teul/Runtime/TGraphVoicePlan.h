@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../Model/TGraphDocument.h"
+#include "../Registry/TNodeRegistry.h"
+#include <JuceHeader.h>
+#include <map>
+#include <vector>
+
+namespace Teul {
+
+// Polyphonic regions resolved at build time. A node whose descriptor
+// allocates voices starts a region with as many voices as its "voices"
+// parameter asks for. A node fed by exactly one region joins it when its
+// maxPolyphony covers that voice count; every other node stays mono.
+// expandedDoc holds one copy of each region node per extra voice. Signal
+// connections inside a region are wired voice to voice, mono signals fan
+// out into every voice, and voices leaving a region are summed by the
+// buffer plan like any other fan-in. MIDI connections are not copied: the
+// document node of the source handles the notes of all its voices.
+struct TGraphVoicePlan {
+  static constexpr const char *kVoiceCountParamKey = "voices";
+
+  struct VoiceGroup {
+    NodeId nodeId = kInvalidNodeId;
+    bool allocatesVoices = false;
+    // Every voice of the node, the document node first.
+    std::vector<NodeId> voiceNodeIds;
+  };
+
+  std::vector<VoiceGroup> groups;
+  TGraphDocument expandedDoc;
+  // The build order with each node's voices right after it.
+  std::vector<NodeId> order;
+
+  // Returns false and leaves the plan empty when no region has more than
+  // one voice; the document is then built as it is.
+  bool build(const TGraphDocument &doc, const std::vector<NodeId> &buildOrder,
+             const TNodeRegistry *registry);
+
+  static int voiceCountFor(const TNode &node, const TNodeDescriptor &desc);
+};
+
+} // namespace Teul
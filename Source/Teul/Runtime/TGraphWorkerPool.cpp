@@ -0,0 +1,346 @@
+#include "TGraphWorkerPool.h"
+
+#if JUCE_INTEL
+#include <immintrin.h>
+#endif
+
+namespace Teul {
+namespace {
+
+constexpr int kSpinsBeforeYield = 64;
+constexpr std::uint64_t kHelperSpinMicros = 500;
+
+std::uint64_t ticksToMicros(juce::int64 tickDelta) noexcept {
+  const auto ticksPerSecond = juce::Time::getHighResolutionTicksPerSecond();
+  if (tickDelta <= 0 || ticksPerSecond <= 0)
+    return 0;
+
+  return static_cast<std::uint64_t>((tickDelta * 1000000) / ticksPerSecond);
+}
+
+int nextPowerOfTwo(int value) noexcept {
+  int result = 1;
+  while (result < value)
+    result <<= 1;
+  return result;
+}
+
+} // namespace
+
+void TWorkStealingDeque::allocate(int capacity) {
+  const int size = nextPowerOfTwo(juce::jmax(2, capacity));
+  ring = std::make_unique<std::atomic<int>[]>(static_cast<std::size_t>(size));
+  for (int index = 0; index < size; ++index)
+    ring[static_cast<std::size_t>(index)].store(kEmpty, std::memory_order_relaxed);
+  mask = size - 1;
+  reset();
+}
+
+void TWorkStealingDeque::reset() noexcept {
+  top.store(0, std::memory_order_relaxed);
+  bottom.store(0, std::memory_order_relaxed);
+}
+
+void TWorkStealingDeque::push(int task) noexcept {
+  const auto b = bottom.load(std::memory_order_relaxed);
+  ring[static_cast<std::size_t>(b & mask)].store(task, std::memory_order_relaxed);
+  bottom.store(b + 1, std::memory_order_release);
+}
+
+int TWorkStealingDeque::pop() noexcept {
+  const auto b = bottom.load(std::memory_order_relaxed) - 1;
+  bottom.store(b, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto t = top.load(std::memory_order_relaxed);
+
+  if (t > b) {
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return kEmpty;
+  }
+
+  int task = ring[static_cast<std::size_t>(b & mask)].load(std::memory_order_relaxed);
+  if (t == b) {
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+      task = kEmpty;
+    }
+    bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  return task;
+}
+
+int TWorkStealingDeque::steal() noexcept {
+  auto t = top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const auto b = bottom.load(std::memory_order_acquire);
+  if (t >= b)
+    return kEmpty;
+
+  const int task = ring[static_cast<std::size_t>(t & mask)].load(std::memory_order_relaxed);
+  if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                   std::memory_order_relaxed)) {
+    return kEmpty;
+  }
+
+  return task;
+}
+
+void TGraphSchedule::build(
+    const std::vector<std::vector<std::size_t>> &successorLists) {
+  const auto numTasks = successorLists.size();
+  predecessorCounts.assign(numTasks, 0);
+  successorOffsets.assign(numTasks + 1, 0);
+  successors.clear();
+  levels.assign(numTasks, 0);
+  levelCount = 0;
+  maxLevelWidth = 0;
+
+  for (std::size_t task = 0; task < numTasks; ++task) {
+    successorOffsets[task] = static_cast<std::uint32_t>(successors.size());
+    for (const auto successor : successorLists[task]) {
+      successors.push_back(static_cast<std::uint32_t>(successor));
+      ++predecessorCounts[successor];
+    }
+  }
+  successorOffsets[numTasks] = static_cast<std::uint32_t>(successors.size());
+
+  // Tasks are already in topological order, so one forward pass settles the
+  // longest-path level of every task.
+  for (std::size_t task = 0; task < numTasks; ++task) {
+    for (auto index = successorOffsets[task]; index < successorOffsets[task + 1];
+         ++index) {
+      auto &successorLevel = levels[successors[index]];
+      successorLevel = juce::jmax(successorLevel, levels[task] + 1);
+    }
+    levelCount = juce::jmax(levelCount, levels[task] + 1);
+  }
+
+  std::vector<int> widthByLevel(static_cast<std::size_t>(levelCount), 0);
+  for (const int level : levels)
+    maxLevelWidth = juce::jmax(maxLevelWidth, ++widthByLevel[static_cast<std::size_t>(level)]);
+
+  pendingCounts = std::make_unique<std::atomic<int>[]>(juce::jmax<std::size_t>(1, numTasks));
+  for (auto &deque : deques)
+    deque.allocate(static_cast<int>(numTasks));
+}
+
+class TGraphWorkerPool::HelperThread final : public juce::Thread {
+public:
+  HelperThread(TGraphWorkerPool &ownerIn, int participantIndexIn)
+      : juce::Thread("Teul Graph Worker " + juce::String(participantIndexIn)),
+        owner(ownerIn), participantIndex(participantIndexIn) {}
+
+  void run() override { owner.helperLoop(*this); }
+
+  TGraphWorkerPool &owner;
+  const int participantIndex;
+  std::atomic<bool> sleeping{false};
+};
+
+TGraphWorkerPool::TGraphWorkerPool() {
+  for (auto &busy : lastBusyMicros)
+    busy.store(0, std::memory_order_relaxed);
+}
+
+TGraphWorkerPool::~TGraphWorkerPool() { stop(); }
+
+void TGraphWorkerPool::start(int numHelperThreads, juce::uint32 helperCpuMask) {
+  const int clamped = juce::jlimit(0, kMaxParticipants - 1, numHelperThreads);
+  if (clamped == static_cast<int>(helpers.size()) &&
+      helperCpuMask == pinnedCpuMask)
+    return;
+
+  stop();
+  pinnedCpuMask = helperCpuMask;
+
+  juce::uint32 remainingCpus = helperCpuMask;
+  for (int index = 0; index < clamped; ++index) {
+    auto helper = std::make_unique<HelperThread>(*this, index + 1);
+    if (helperCpuMask != 0) {
+      if (remainingCpus == 0)
+        remainingCpus = helperCpuMask;
+      const juce::uint32 cpu = remainingCpus & (~remainingCpus + 1u);
+      remainingCpus &= ~cpu;
+      helper->setAffinityMask(cpu);
+    }
+    if (!helper->startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(8)))
+      helper->startThread(juce::Thread::Priority::highest);
+    helpers.push_back(std::move(helper));
+  }
+
+  numHelpers.store(static_cast<int>(helpers.size()), std::memory_order_release);
+}
+
+void TGraphWorkerPool::stop() {
+  numHelpers.store(0, std::memory_order_release);
+
+  for (auto &helper : helpers) {
+    helper->signalThreadShouldExit();
+    helper->notify();
+  }
+
+  for (auto &helper : helpers)
+    helper->stopThread(2000);
+
+  helpers.clear();
+}
+
+void TGraphWorkerPool::run(TGraphSchedule &schedule, TaskRunner &runner) noexcept {
+  const int numTasks = schedule.getNumTasks();
+  if (numTasks <= 0)
+    return;
+
+  const int participants =
+      juce::jlimit(1, kMaxParticipants, getNumParticipants());
+  activeParticipants = participants;
+
+  for (int task = 0; task < numTasks; ++task) {
+    schedule.pendingCounts[static_cast<std::size_t>(task)].store(
+        schedule.predecessorCounts[static_cast<std::size_t>(task)],
+        std::memory_order_relaxed);
+  }
+
+  for (auto &deque : schedule.deques)
+    deque.reset();
+
+  int nextOwner = 0;
+  for (int task = 0; task < numTasks; ++task) {
+    if (schedule.predecessorCounts[static_cast<std::size_t>(task)] != 0)
+      continue;
+
+    schedule.deques[static_cast<std::size_t>(nextOwner)].push(task);
+    nextOwner = (nextOwner + 1) % participants;
+  }
+
+  for (auto &busy : lastBusyMicros)
+    busy.store(0, std::memory_order_relaxed);
+
+  currentSchedule.store(&schedule, std::memory_order_relaxed);
+  currentRunner.store(&runner, std::memory_order_relaxed);
+  remainingTasks.store(numTasks, std::memory_order_relaxed);
+  blockOpen.store(true, std::memory_order_seq_cst);
+  blockEpoch.fetch_add(1, std::memory_order_seq_cst);
+
+  for (int index = 0; index < participants - 1; ++index) {
+    auto &helper = *helpers[static_cast<std::size_t>(index)];
+    if (helper.sleeping.exchange(false, std::memory_order_seq_cst))
+      helper.notify();
+  }
+
+  runParticipant(0);
+
+  blockOpen.store(false, std::memory_order_seq_cst);
+  int spins = 0;
+  while (joinedHelpers.load(std::memory_order_seq_cst) != 0) {
+    if (++spins % kSpinsBeforeYield == 0)
+      juce::Thread::yield();
+    else
+      cpuRelax();
+  }
+
+  currentSchedule.store(nullptr, std::memory_order_relaxed);
+  currentRunner.store(nullptr, std::memory_order_relaxed);
+}
+
+std::uint64_t TGraphWorkerPool::getLastBusyMicros(int participantIndex) const noexcept {
+  if (participantIndex < 0 || participantIndex >= kMaxParticipants)
+    return 0;
+
+  return lastBusyMicros[static_cast<std::size_t>(participantIndex)].load(
+      std::memory_order_relaxed);
+}
+
+void TGraphWorkerPool::runParticipant(int participantIndex) noexcept {
+  juce::ScopedNoDenormals noDenormals;
+  auto *schedule = currentSchedule.load(std::memory_order_relaxed);
+  auto *runner = currentRunner.load(std::memory_order_relaxed);
+  if (schedule == nullptr || runner == nullptr)
+    return;
+
+  const int participants = activeParticipants;
+  auto &ownDeque = schedule->deques[static_cast<std::size_t>(participantIndex)];
+  juce::int64 busyTicks = 0;
+  int idleSpins = 0;
+
+  while (remainingTasks.load(std::memory_order_acquire) > 0) {
+    int task = ownDeque.pop();
+    for (int offset = 1; task == TWorkStealingDeque::kEmpty && offset < participants;
+         ++offset) {
+      const int victim = (participantIndex + offset) % participants;
+      task = schedule->deques[static_cast<std::size_t>(victim)].steal();
+    }
+
+    if (task == TWorkStealingDeque::kEmpty) {
+      if (++idleSpins % kSpinsBeforeYield == 0)
+        juce::Thread::yield();
+      else
+        cpuRelax();
+      continue;
+    }
+
+    idleSpins = 0;
+    const auto taskStartTicks = juce::Time::getHighResolutionTicks();
+    runner->runTask(task);
+    busyTicks += juce::Time::getHighResolutionTicks() - taskStartTicks;
+
+    const auto first = schedule->successorOffsets[static_cast<std::size_t>(task)];
+    const auto last = schedule->successorOffsets[static_cast<std::size_t>(task) + 1];
+    for (auto index = first; index < last; ++index) {
+      const auto successor = schedule->successors[index];
+      if (schedule->pendingCounts[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        ownDeque.push(static_cast<int>(successor));
+    }
+
+    remainingTasks.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  lastBusyMicros[static_cast<std::size_t>(participantIndex)].store(
+      ticksToMicros(busyTicks), std::memory_order_relaxed);
+}
+
+void TGraphWorkerPool::helperLoop(HelperThread &helper) {
+  std::uint64_t seenEpoch = blockEpoch.load(std::memory_order_acquire);
+  auto idleSinceTicks = juce::Time::getHighResolutionTicks();
+
+  while (!helper.threadShouldExit()) {
+    const auto epoch = blockEpoch.load(std::memory_order_seq_cst);
+    if (epoch == seenEpoch) {
+      if (ticksToMicros(juce::Time::getHighResolutionTicks() - idleSinceTicks) <
+          kHelperSpinMicros) {
+        cpuRelax();
+        continue;
+      }
+
+      helper.sleeping.store(true, std::memory_order_seq_cst);
+      if (blockEpoch.load(std::memory_order_seq_cst) == seenEpoch)
+        helper.wait(50);
+      helper.sleeping.store(false, std::memory_order_seq_cst);
+      idleSinceTicks = juce::Time::getHighResolutionTicks();
+      continue;
+    }
+
+    seenEpoch = epoch;
+    joinedHelpers.fetch_add(1, std::memory_order_seq_cst);
+    if (blockOpen.load(std::memory_order_seq_cst) &&
+        helper.participantIndex < activeParticipants) {
+      runParticipant(helper.participantIndex);
+    }
+    joinedHelpers.fetch_sub(1, std::memory_order_seq_cst);
+    idleSinceTicks = juce::Time::getHighResolutionTicks();
+  }
+}
+
+void TGraphWorkerPool::cpuRelax() noexcept {
+#if JUCE_INTEL
+  _mm_pause();
+#elif JUCE_ARM && (defined(__aarch64__) || defined(_M_ARM64))
+#if JUCE_MSVC
+  __yield();
+#else
+  __asm__ __volatile__("yield");
+#endif
+#endif
+}
+
+} // namespace Teul
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Teul {
+
+// Bounded Chase-Lev deque. Capacity is fixed at allocation time and the
+// owner resets it between blocks, so push never has to grow the ring.
+class TWorkStealingDeque {
+public:
+  static constexpr int kEmpty = -1;
+
+  void allocate(int capacity);
+  void reset() noexcept;
+  void push(int task) noexcept;
+  int pop() noexcept;
+  int steal() noexcept;
+
+private:
+  alignas(64) std::atomic<std::int64_t> top{0};
+  alignas(64) std::atomic<std::int64_t> bottom{0};
+  std::unique_ptr<std::atomic<int>[]> ring;
+  std::int64_t mask = 0;
+};
+
+struct TGraphSchedule {
+  static constexpr int kMaxParticipants = 8;
+
+  std::vector<int> predecessorCounts;
+  std::vector<std::uint32_t> successorOffsets;
+  std::vector<std::uint32_t> successors;
+  std::vector<int> levels;
+  int levelCount = 0;
+  int maxLevelWidth = 0;
+
+  std::unique_ptr<std::atomic<int>[]> pendingCounts;
+  std::array<TWorkStealingDeque, kMaxParticipants> deques;
+
+  void build(const std::vector<std::vector<std::size_t>> &successorLists);
+  int getNumTasks() const noexcept {
+    return static_cast<int>(predecessorCounts.size());
+  }
+};
+
+class TGraphWorkerPool {
+public:
+  static constexpr int kMaxParticipants = TGraphSchedule::kMaxParticipants;
+
+  class TaskRunner {
+  public:
+    virtual ~TaskRunner() = default;
+    virtual void runTask(int taskIndex) noexcept = 0;
+  };
+
+  TGraphWorkerPool();
+  ~TGraphWorkerPool();
+
+  // Helpers float unless helperCpuMask names the CPUs they may use; each
+  // helper is then pinned to the next CPU of the mask in turn. Keep the
+  // audio callback's CPU out of the mask.
+  void start(int numHelperThreads, juce::uint32 helperCpuMask = 0);
+  void stop();
+
+  int getNumHelperThreads() const noexcept {
+    return numHelpers.load(std::memory_order_acquire);
+  }
+  int getNumParticipants() const noexcept { return getNumHelperThreads() + 1; }
+
+  // Runs every task of the schedule, using the calling thread as participant
+  // zero. Returns once all tasks finished and no helper touches the schedule.
+  void run(TGraphSchedule &schedule, TaskRunner &runner) noexcept;
+
+  std::uint64_t getLastBusyMicros(int participantIndex) const noexcept;
+
+private:
+  class HelperThread;
+
+  void runParticipant(int participantIndex) noexcept;
+  void helperLoop(HelperThread &helper);
+  static void cpuRelax() noexcept;
+
+  std::vector<std::unique_ptr<HelperThread>> helpers;
+  std::atomic<int> numHelpers{0};
+  juce::uint32 pinnedCpuMask = 0;
+
+  std::atomic<std::uint64_t> blockEpoch{0};
+  std::atomic<bool> blockOpen{false};
+  std::atomic<int> joinedHelpers{0};
+  std::atomic<int> remainingTasks{0};
+  std::atomic<TGraphSchedule *> currentSchedule{nullptr};
+  std::atomic<TaskRunner *> currentRunner{nullptr};
+  int activeParticipants = 1;
+
+  std::array<std::atomic<std::uint64_t>, kMaxParticipants> lastBusyMicros{};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TGraphWorkerPool)
+};
+
+} // namespace Teul
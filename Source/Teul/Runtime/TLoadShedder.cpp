@@ -0,0 +1,104 @@
+#include "TLoadShedder.h"
+
+#include <cmath>
+
+namespace Teul {
+
+TLoadShedder::TLoadShedder() = default;
+
+void TLoadShedder::setEnabled(bool shouldShed) noexcept {
+  enabled.store(shouldShed, std::memory_order_relaxed);
+}
+
+bool TLoadShedder::isEnabled() const noexcept {
+  return enabled.load(std::memory_order_relaxed);
+}
+
+// The restore threshold is kept below the shed threshold so a restored node
+// cannot push the load straight back over it.
+void TLoadShedder::setThresholds(float shedLoad, float restoreLoad) noexcept {
+  const float shed = juce::jlimit(0.05f, 4.0f, shedLoad);
+  shedThreshold.store(shed, std::memory_order_relaxed);
+  restoreThreshold.store(juce::jlimit(0.0f, shed * 0.95f, restoreLoad),
+                         std::memory_order_relaxed);
+}
+
+float TLoadShedder::getShedThreshold() const noexcept {
+  return shedThreshold.load(std::memory_order_relaxed);
+}
+
+float TLoadShedder::getRestoreThreshold() const noexcept {
+  return restoreThreshold.load(std::memory_order_relaxed);
+}
+
+TLoadShedder::Action TLoadShedder::update(float load, double blockSeconds,
+                                          bool canShed, float &restoreCost) noexcept {
+  if (!(load >= 0.0f) || blockSeconds <= 0.0)
+    return Action::none;
+
+  const float alpha =
+      static_cast<float>(1.0 - std::exp(-blockSeconds / kSmoothingSeconds));
+  const float previous = smoothedLoad.load(std::memory_order_relaxed);
+  const float smoothed = previous + (load - previous) * alpha;
+  smoothedLoad.store(smoothed, std::memory_order_relaxed);
+
+  if (!isEnabled()) {
+    holdRemainingSeconds = 0.0;
+    if (restoreCost < 0.0f)
+      return Action::none;
+
+    restoreCount.fetch_add(1, std::memory_order_relaxed);
+    return Action::restore;
+  }
+
+  if (restoreCost > 0.0f)
+    restoreCost *= static_cast<float>(std::exp(-blockSeconds / kCostDecaySeconds));
+
+  if (holdRemainingSeconds > 0.0) {
+    holdRemainingSeconds -= blockSeconds;
+    return Action::none;
+  }
+
+  if (canShed && smoothed > shedThreshold.load(std::memory_order_relaxed)) {
+    holdRemainingSeconds = kHoldSeconds;
+    shedCount.fetch_add(1, std::memory_order_relaxed);
+    return Action::shed;
+  }
+
+  if (restoreCost >= 0.0f &&
+      smoothed + restoreCost < restoreThreshold.load(std::memory_order_relaxed)) {
+    holdRemainingSeconds = kHoldSeconds;
+    restoreCount.fetch_add(1, std::memory_order_relaxed);
+    return Action::restore;
+  }
+
+  return Action::none;
+}
+
+void TLoadShedder::recordEvent(NodeId nodeId, bool restored, float load) noexcept {
+  Event event;
+  event.timeMillis = juce::Time::currentTimeMillis();
+  event.nodeId = nodeId;
+  event.restored = restored;
+  event.load = load;
+  events.push(event);
+}
+
+float TLoadShedder::getSmoothedLoad() const noexcept {
+  return smoothedLoad.load(std::memory_order_relaxed);
+}
+
+std::uint64_t TLoadShedder::getShedCount() const noexcept {
+  return shedCount.load(std::memory_order_relaxed);
+}
+
+std::uint64_t TLoadShedder::getRestoreCount() const noexcept {
+  return restoreCount.load(std::memory_order_relaxed);
+}
+
+// Oldest first.
+std::vector<TLoadShedder::Event> TLoadShedder::getRecentEvents() const {
+  return events.readRecent();
+}
+
+} // namespace Teul
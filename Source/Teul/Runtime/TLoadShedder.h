@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../Model/TTypes.h"
+#include "TSeqlockRing.h"
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace Teul {
+
+// Graceful degradation for graphs that outgrow the block budget. The audio
+// thread feeds every block's load; while the smoothed load sits above the
+// shed threshold the runtime bypasses one sheddable node per decision, and
+// restores the most recently shed node once the load plus what that node
+// cost fits under the restore threshold. Decisions are spaced by a hold time
+// so each one shows up in the smoothed load before the next is taken. The
+// remembered cost decays while the node stays shed, so a node whose cost
+// was inflated by a passing spike is retried eventually.
+class TLoadShedder {
+public:
+  static constexpr int kMaxEvents = 32;
+  static constexpr float kDefaultShedThreshold = 0.85f;
+  static constexpr float kDefaultRestoreThreshold = 0.6f;
+  static constexpr double kSmoothingSeconds = 0.1;
+  static constexpr double kHoldSeconds = 0.25;
+  static constexpr double kCostDecaySeconds = 2.0;
+
+  enum class Action { none, shed, restore };
+
+  struct Event {
+    juce::int64 timeMillis = 0;
+    NodeId nodeId = kInvalidNodeId;
+    bool restored = false;
+    float load = 0.0f;
+  };
+
+  TLoadShedder();
+
+  // Any thread. Disabling lets the audio thread restore shed nodes one per
+  // block without waiting for headroom.
+  void setEnabled(bool shouldShed) noexcept;
+  bool isEnabled() const noexcept;
+  void setThresholds(float shedLoad, float restoreLoad) noexcept;
+  float getShedThreshold() const noexcept;
+  float getRestoreThreshold() const noexcept;
+
+  // Audio thread. restoreCost is the load the next node to restore took
+  // before it was shed, or negative when no node is shed; it is decayed in
+  // place.
+  Action update(float load, double blockSeconds, bool canShed,
+                float &restoreCost) noexcept;
+  void recordEvent(NodeId nodeId, bool restored, float load) noexcept;
+
+  float getSmoothedLoad() const noexcept;
+  std::uint64_t getShedCount() const noexcept;
+  std::uint64_t getRestoreCount() const noexcept;
+  std::vector<Event> getRecentEvents() const;
+
+private:
+  std::atomic<bool> enabled{false};
+  std::atomic<float> shedThreshold{kDefaultShedThreshold};
+  std::atomic<float> restoreThreshold{kDefaultRestoreThreshold};
+  std::atomic<float> smoothedLoad{0.0f};
+  std::atomic<std::uint64_t> shedCount{0};
+  std::atomic<std::uint64_t> restoreCount{0};
+  double holdRemainingSeconds = 0.0;
+
+  TSeqlockRing<Event, kMaxEvents> events;
+};
+
+} // namespace Teul
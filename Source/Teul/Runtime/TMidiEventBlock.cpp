@@ -0,0 +1,55 @@
+#include "TMidiEventBlock.h"
+
+#include <cstring>
+#include <limits>
+
+namespace Teul {
+
+void TMidiEventBlock::allocate(int maxEventCount, int maxByteCount) {
+  maxEvents = juce::jmax(1, maxEventCount);
+  maxBytes = juce::jmax(1, maxByteCount);
+  events = std::make_unique<Event[]>(static_cast<std::size_t>(maxEvents));
+  bytes = std::make_unique<juce::uint8[]>(static_cast<std::size_t>(maxBytes));
+  clear();
+}
+
+void TMidiEventBlock::clear() noexcept {
+  numEvents = 0;
+  numBytesUsed = 0;
+  droppedEvents = 0;
+}
+
+bool TMidiEventBlock::addEvent(const void *data, int numBytes,
+                               int samplePosition) noexcept {
+  if (data == nullptr || numBytes <= 0)
+    return true;
+
+  if (numEvents >= maxEvents || numBytes > maxBytes - numBytesUsed ||
+      numBytes > std::numeric_limits<std::uint16_t>::max()) {
+    ++droppedEvents;
+    return false;
+  }
+
+  std::memcpy(bytes.get() + numBytesUsed, data, static_cast<std::size_t>(numBytes));
+
+  // Events usually arrive in time order, so this rarely shifts anything.
+  int insertIndex = numEvents;
+  while (insertIndex > 0 && events[insertIndex - 1].samplePosition > samplePosition) {
+    events[insertIndex] = events[insertIndex - 1];
+    --insertIndex;
+  }
+
+  events[insertIndex] = {samplePosition, static_cast<std::uint32_t>(numBytesUsed),
+                         static_cast<std::uint16_t>(numBytes)};
+  ++numEvents;
+  numBytesUsed += numBytes;
+  return true;
+}
+
+juce::MidiMessageMetadata TMidiEventBlock::getEvent(int eventIndex) const noexcept {
+  const auto &event = events[static_cast<std::size_t>(eventIndex)];
+  return {bytes.get() + event.byteOffset, static_cast<int>(event.numBytes),
+          event.samplePosition};
+}
+
+} // namespace Teul
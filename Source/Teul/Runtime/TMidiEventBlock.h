@@ -0,0 +1,76 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstdint>
+#include <memory>
+
+namespace Teul {
+
+// Time-ordered MIDI events of one port for one block. Storage is allocated
+// when the graph is built; events that do not fit are dropped and counted
+// instead of growing the arena on the audio thread.
+class TMidiEventBlock {
+public:
+  static constexpr int kDefaultMaxEvents = 1024;
+  static constexpr int kDefaultMaxBytes = 16384;
+
+  class Iterator {
+  public:
+    Iterator(const TMidiEventBlock &owner, int index) noexcept
+        : block(&owner), eventIndex(index) {}
+
+    juce::MidiMessageMetadata operator*() const noexcept {
+      return block->getEvent(eventIndex);
+    }
+    Iterator &operator++() noexcept {
+      ++eventIndex;
+      return *this;
+    }
+    bool operator==(const Iterator &other) const noexcept {
+      return eventIndex == other.eventIndex;
+    }
+    bool operator!=(const Iterator &other) const noexcept {
+      return eventIndex != other.eventIndex;
+    }
+
+  private:
+    const TMidiEventBlock *block = nullptr;
+    int eventIndex = 0;
+  };
+
+  void allocate(int maxEventCount, int maxByteCount);
+  void clear() noexcept;
+
+  bool addEvent(const void *data, int numBytes, int samplePosition) noexcept;
+  bool addEvent(const juce::MidiMessage &message, int samplePosition) noexcept {
+    return addEvent(message.getRawData(), message.getRawDataSize(), samplePosition);
+  }
+
+  bool isEmpty() const noexcept { return numEvents == 0; }
+  int getNumEvents() const noexcept { return numEvents; }
+  int getNumDroppedEvents() const noexcept { return droppedEvents; }
+  int getSamplePosition(int eventIndex) const noexcept {
+    return events[static_cast<std::size_t>(eventIndex)].samplePosition;
+  }
+  juce::MidiMessageMetadata getEvent(int eventIndex) const noexcept;
+
+  Iterator begin() const noexcept { return {*this, 0}; }
+  Iterator end() const noexcept { return {*this, numEvents}; }
+
+private:
+  struct Event {
+    int samplePosition = 0;
+    std::uint32_t byteOffset = 0;
+    std::uint16_t numBytes = 0;
+  };
+
+  std::unique_ptr<Event[]> events;
+  std::unique_ptr<juce::uint8[]> bytes;
+  int maxEvents = 0;
+  int maxBytes = 0;
+  int numEvents = 0;
+  int numBytesUsed = 0;
+  int droppedEvents = 0;
+};
+
+} // namespace Teul
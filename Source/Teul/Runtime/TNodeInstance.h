@@ -2,8 +2,11 @@
 
 #include "../Model/TNode.h"
 #include "../Model/TTypes.h"
+#include "TMidiEventBlock.h"
+#include "TVoiceAllocator.h"
 #include <JuceHeader.h>
 #include <map>
+#include <vector>
 
 namespace Teul {
 
@@ -15,16 +18,133 @@ public:
                                       float value) = 0;
 };
 
+// Channel of one descriptor port in the runtime port buffer. MIDI ports and
+// ports missing from the node keep kNoChannel. Unconnected signal inputs
+// still read the shared silence channel; connected tells them apart.
+struct TPortSlot {
+  static constexpr int kNoChannel = -1;
+
+  int channelIndex = kNoChannel;
+  bool connected = false;
+};
+
 struct TProcessContext {
+  static constexpr int kConstantStride = 0;
+
   juce::AudioBuffer<float> *globalPortBuffer = nullptr;
   const juce::AudioBuffer<float> *inputAudioBuffer = nullptr;
   juce::AudioBuffer<float> *deviceAudioBuffer = nullptr;
-  juce::MidiBuffer *midiMessages = nullptr;
+  const TMidiEventBlock *midiMessages = nullptr;
   const juce::MidiBuffer *deviceMidiMessages = nullptr;
-  juce::MidiBuffer *midiOutputMessages = nullptr;
+  TMidiEventBlock *midiOutputMessages = nullptr;
   const std::map<PortId, int> *portToChannel = nullptr;
   const TNode *nodeData = nullptr;
   TParamValueReporter *paramValueReporter = nullptr;
+
+  // Resolved once per graph build, indexed like the descriptor's portSpecs.
+  const TPortSlot *portSlots = nullptr;
+  int numPortSlots = 0;
+
+  // Samples to render this call. It can be anything from 1 up to the size
+  // passed to prepareToPlay and is usually less than the port buffer holds,
+  // so never size work from globalPortBuffer.
+  int numSamples = 0;
+
+  // The runtime may render a device block in several sub-blocks, split at
+  // parameter changes, device MIDI events and the prepared block size. This
+  // is where the current one starts. Port buffers, MIDI blocks and the
+  // device buffers are already relative to it; deviceMidiMessages still
+  // covers the whole device block.
+  int blockSampleOffset = 0;
+
+  // How each port buffer channel is stored this block: 1 is audio rate,
+  // N > 1 one value per N samples, kConstantStride one value for the whole
+  // block. Only the start of such a channel is valid. The runtime expands
+  // control-rate outputs for their readers, and constants too unless every
+  // reader's port declares acceptsConstant.
+  int *channelStrides = nullptr;
+
+  // Set on the first voice of a node that allocates voices; assigns the
+  // notes of the block to the voices of its region.
+  TVoiceAllocator *voiceAllocator = nullptr;
+
+  int getPortChannel(int slotIndex) const noexcept {
+    return (portSlots != nullptr && slotIndex >= 0 && slotIndex < numPortSlots)
+               ? portSlots[slotIndex].channelIndex
+               : TPortSlot::kNoChannel;
+  }
+
+  bool isPortConnected(int slotIndex) const noexcept {
+    return portSlots != nullptr && slotIndex >= 0 && slotIndex < numPortSlots &&
+           portSlots[slotIndex].connected;
+  }
+
+  const float *getInputSamples(int slotIndex) const noexcept {
+    const int channelIndex = getPortChannel(slotIndex);
+    return (globalPortBuffer != nullptr && channelIndex >= 0)
+               ? globalPortBuffer->getReadPointer(channelIndex)
+               : nullptr;
+  }
+
+  float *getOutputSamples(int slotIndex) const noexcept {
+    const int channelIndex = getPortChannel(slotIndex);
+    return (globalPortBuffer != nullptr && channelIndex >= 0)
+               ? globalPortBuffer->getWritePointer(channelIndex)
+               : nullptr;
+  }
+
+  bool getInputConstant(int slotIndex, float &value) const noexcept {
+    const int channelIndex = getPortChannel(slotIndex);
+    if (globalPortBuffer == nullptr || channelStrides == nullptr ||
+        channelIndex < 0 || channelStrides[channelIndex] != kConstantStride) {
+      return false;
+    }
+
+    value = globalPortBuffer->getReadPointer(channelIndex)[0];
+    return true;
+  }
+
+  void setOutputConstant(int slotIndex, float value) const noexcept {
+    auto *samples = getOutputSamples(slotIndex);
+    if (samples == nullptr)
+      return;
+
+    if (channelStrides == nullptr) {
+      juce::FloatVectorOperations::fill(samples, value, numSamples);
+      return;
+    }
+
+    samples[0] = value;
+    channelStrides[getPortChannel(slotIndex)] = kConstantStride;
+  }
+
+  // The node wrote one value per stride samples to the start of the output.
+  void setOutputControlRate(int slotIndex, int stride) const noexcept {
+    const int channelIndex = getPortChannel(slotIndex);
+    if (globalPortBuffer == nullptr || channelIndex < 0 || stride <= 1)
+      return;
+
+    if (channelStrides != nullptr) {
+      channelStrides[channelIndex] = stride;
+      return;
+    }
+
+    expandControlRate(globalPortBuffer->getWritePointer(channelIndex), stride,
+                      numSamples);
+  }
+
+  // Sample-and-hold in place, back to front so no value is overwritten
+  // before it has been spread.
+  static void expandControlRate(float *samples, int stride,
+                                int numSamples) noexcept {
+    if (stride == kConstantStride) {
+      juce::FloatVectorOperations::fill(samples, samples[0], numSamples);
+      return;
+    }
+
+    for (int sampleIndex = numSamples - 1; sampleIndex > 0; --sampleIndex)
+      samples[sampleIndex] = samples[sampleIndex / stride];
+  }
 };
 
 class TNodeInstance {
@@ -35,8 +155,40 @@ public:
                              int maximumExpectedSamplesPerBlock) {}
   virtual void releaseResources() {}
   virtual void processSamples(const TProcessContext &context) {}
+
+  // Nodes in a polyphonic region render all their voices in one call, one
+  // context per voice. Overrides keep per-voice state in arrays and run the
+  // voices as lanes of a single loop.
+  virtual void processVoices(const TProcessContext *voiceContexts,
+                             int numVoices) {
+    for (int voice = 0; voice < numVoices; ++voice)
+      processSamples(voiceContexts[voice]);
+  }
+
+  // paramIndex follows the descriptor's paramSpecs order. The default
+  // forwards to the string overload so key-based nodes keep working.
+  virtual void setParameterValue(int paramIndex, float newValue) {
+    if (paramIndex >= 0 && paramIndex < static_cast<int>(parameterKeys.size()))
+      setParameterValue(parameterKeys[static_cast<std::size_t>(paramIndex)], newValue);
+  }
   virtual void setParameterValue(const juce::String &paramKey, float newValue) {}
+
+  // Text parameters such as file paths, applied on the message thread
+  // before the instance is published. A running instance never sees a new
+  // text: the runtime recreates the node instead.
+  virtual void setParameterText(int paramIndex, const juce::String &text) {}
+
+  // Voices processVoices will be called with, set on the message thread
+  // before any text parameter. A new count recreates the node.
+  virtual void setVoiceCount(int numVoices) {}
   virtual void reset() {}
+
+  void bindParameterKeys(std::vector<juce::String> keys) {
+    parameterKeys = std::move(keys);
+  }
+
+private:
+  std::vector<juce::String> parameterKeys;
 };
 
 } // namespace Teul
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "TNodeProfiler.h"
+
+#include <cmath>
+
+namespace Teul {
+namespace {
+
+constexpr std::uint64_t kBaseNanos = 128;
+
+} // namespace
+
+TNodeProfiler::TNodeProfiler() : slots(std::make_unique<Slot[]>(kMaxNodes)) {
+  const auto ticksPerSecond = juce::Time::getHighResolutionTicksPerSecond();
+  if (ticksPerSecond > 0)
+    nanosPerTick = 1.0e9 / static_cast<double>(ticksPerSecond);
+
+  freeSlots.reserve(kMaxNodes);
+  for (int slot = kMaxNodes - 1; slot >= 0; --slot)
+    freeSlots.push_back(slot);
+}
+
+std::vector<int> TNodeProfiler::assignSlots(const std::vector<NodeId> &nodeIds) {
+  std::map<NodeId, int> retained;
+  std::vector<int> assigned(nodeIds.size(), -1);
+  for (std::size_t index = 0; index < nodeIds.size(); ++index) {
+    const auto it = slotByNode.find(nodeIds[index]);
+    if (it != slotByNode.end()) {
+      assigned[index] = it->second;
+      retained.emplace(it->first, it->second);
+      slotByNode.erase(it);
+    }
+  }
+
+  for (const auto &[nodeId, slot] : slotByNode) {
+    slots[static_cast<std::size_t>(slot)].nodeId.store(kInvalidNodeId,
+                                                       std::memory_order_relaxed);
+    freeSlots.push_back(slot);
+  }
+
+  for (std::size_t index = 0; index < nodeIds.size(); ++index) {
+    if (assigned[index] >= 0 || freeSlots.empty())
+      continue;
+
+    const int slot = freeSlots.back();
+    freeSlots.pop_back();
+    auto &target = slots[static_cast<std::size_t>(slot)];
+    clearSlot(target);
+    target.nodeId.store(nodeIds[index], std::memory_order_release);
+    retained.emplace(nodeIds[index], slot);
+    assigned[index] = slot;
+  }
+
+  slotByNode = std::move(retained);
+  return assigned;
+}
+
+void TNodeProfiler::reset() noexcept {
+  for (int slot = 0; slot < kMaxNodes; ++slot)
+    clearSlot(slots[static_cast<std::size_t>(slot)]);
+}
+
+std::vector<TNodeProfiler::NodeProfile> TNodeProfiler::snapshot() const {
+  std::vector<NodeProfile> profiles;
+  profiles.reserve(slotByNode.size());
+  for (const auto &[nodeId, slotIndex] : slotByNode) {
+    const auto &slot = slots[static_cast<std::size_t>(slotIndex)];
+    std::array<std::uint32_t, kBucketCount> counts{};
+    std::uint64_t histogramTotal = 0;
+    for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+      counts[static_cast<std::size_t>(bucket)] =
+          slot.buckets[static_cast<std::size_t>(bucket)].load(std::memory_order_relaxed);
+      histogramTotal += counts[static_cast<std::size_t>(bucket)];
+    }
+
+    NodeProfile profile;
+    profile.nodeId = nodeId;
+    profile.sampleCount = slot.count.load(std::memory_order_relaxed);
+    if (profile.sampleCount > 0) {
+      profile.meanMicros =
+          static_cast<double>(slot.totalNanos.load(std::memory_order_relaxed)) /
+          static_cast<double>(profile.sampleCount) / 1000.0;
+    }
+    profile.maxMicros =
+        static_cast<double>(slot.maxNanos.load(std::memory_order_relaxed)) / 1000.0;
+    profile.recentMicros = slot.recentMicros.load(std::memory_order_relaxed);
+
+    const auto percentile = [&](double fraction) {
+      const auto rank = static_cast<std::uint64_t>(
+          std::ceil(fraction * static_cast<double>(histogramTotal)));
+      std::uint64_t cumulative = 0;
+      for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+        cumulative += counts[static_cast<std::size_t>(bucket)];
+        if (cumulative >= rank)
+          return juce::jmin(bucketUpperMicros(bucket), profile.maxMicros);
+      }
+      return profile.maxMicros;
+    };
+
+    if (histogramTotal > 0) {
+      profile.p50Micros = percentile(0.50);
+      profile.p99Micros = percentile(0.99);
+    }
+
+    profiles.push_back(profile);
+  }
+
+  return profiles;
+}
+
+void TNodeProfiler::record(int slotIndex, NodeId nodeId,
+                           juce::int64 elapsedTicks) noexcept {
+  if (slotIndex < 0 || slotIndex >= kMaxNodes || elapsedTicks < 0)
+    return;
+
+  auto &slot = slots[static_cast<std::size_t>(slotIndex)];
+  if (slot.nodeId.load(std::memory_order_relaxed) != nodeId)
+    return;
+
+  const auto nanos =
+      static_cast<std::uint64_t>(static_cast<double>(elapsedTicks) * nanosPerTick);
+  slot.buckets[static_cast<std::size_t>(bucketForNanos(nanos))].fetch_add(
+      1, std::memory_order_relaxed);
+  slot.count.fetch_add(1, std::memory_order_relaxed);
+  slot.totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+
+  // A node runs on one thread at a time, so plain load/store is enough.
+  if (nanos > slot.maxNanos.load(std::memory_order_relaxed))
+    slot.maxNanos.store(nanos, std::memory_order_relaxed);
+  const float micros = static_cast<float>(nanos) / 1000.0f;
+  const float recent = slot.recentMicros.load(std::memory_order_relaxed);
+  slot.recentMicros.store(recent + (micros - recent) * 0.05f,
+                          std::memory_order_relaxed);
+}
+
+// Bucket 0 holds everything under 128 ns; after that each octave is split
+// into four linear steps.
+int TNodeProfiler::bucketForNanos(std::uint64_t nanos) noexcept {
+  const auto scaled = nanos / kBaseNanos;
+  if (scaled == 0)
+    return 0;
+
+  int octave = 0;
+  while (octave < 62 && (scaled >> (octave + 1)) != 0)
+    ++octave;
+
+  const auto step = octave >= 2 ? (scaled >> (octave - 2)) & 3u
+                                : (scaled << (2 - octave)) & 3u;
+  return juce::jmin(kBucketCount - 1, 1 + octave * 4 + static_cast<int>(step));
+}
+
+double TNodeProfiler::bucketUpperMicros(int bucket) noexcept {
+  if (bucket <= 0)
+    return static_cast<double>(kBaseNanos) / 1000.0;
+
+  const int octave = (bucket - 1) / 4;
+  const int step = (bucket - 1) % 4;
+  return static_cast<double>(kBaseNanos) * std::ldexp(1.0, octave) *
+         (1.0 + (step + 1) * 0.25) / 1000.0;
+}
+
+void TNodeProfiler::clearSlot(Slot &slot) noexcept {
+  for (auto &bucket : slot.buckets)
+    bucket.store(0, std::memory_order_relaxed);
+  slot.count.store(0, std::memory_order_relaxed);
+  slot.totalNanos.store(0, std::memory_order_relaxed);
+  slot.maxNanos.store(0, std::memory_order_relaxed);
+  slot.recentMicros.store(0.0f, std::memory_order_relaxed);
+}
+
+} // namespace Teul
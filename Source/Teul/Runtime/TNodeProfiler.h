@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../Model/TTypes.h"
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Teul {
+
+// Optional per-node timing. Each profiled node owns a slot with a
+// log-scale histogram (four buckets per octave from 128 ns), so p50/p99 can
+// be read at any time without locks. Slots follow their node across
+// rebuilds; the render threads only touch the slot of the node they run.
+class TNodeProfiler {
+public:
+  static constexpr int kMaxNodes = 1024;
+  static constexpr int kBucketCount = 64;
+
+  struct NodeProfile {
+    NodeId nodeId = kInvalidNodeId;
+    std::uint64_t sampleCount = 0;
+    double meanMicros = 0.0;
+    double p50Micros = 0.0;
+    double p99Micros = 0.0;
+    double maxMicros = 0.0;
+    double recentMicros = 0.0;
+  };
+
+  TNodeProfiler();
+
+  void setEnabled(bool shouldEnable) noexcept {
+    enabled.store(shouldEnable, std::memory_order_relaxed);
+  }
+  bool isEnabled() const noexcept {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  // Message thread. Returns the slot for each node, keeping the slots (and
+  // history) of nodes seen before; nodes absent from the list lose theirs.
+  // Nodes beyond kMaxNodes get -1 and are not profiled.
+  std::vector<int> assignSlots(const std::vector<NodeId> &nodeIds);
+  void reset() noexcept;
+  std::vector<NodeProfile> snapshot() const;
+
+  // Render threads.
+  void record(int slot, NodeId nodeId, juce::int64 elapsedTicks) noexcept;
+
+private:
+  struct Slot {
+    std::atomic<NodeId> nodeId{kInvalidNodeId};
+    std::array<std::atomic<std::uint32_t>, kBucketCount> buckets{};
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> totalNanos{0};
+    std::atomic<std::uint64_t> maxNanos{0};
+    std::atomic<float> recentMicros{0.0f};
+  };
+
+  static int bucketForNanos(std::uint64_t nanos) noexcept;
+  static double bucketUpperMicros(int bucket) noexcept;
+  static void clearSlot(Slot &slot) noexcept;
+
+  std::unique_ptr<Slot[]> slots;
+  std::map<NodeId, int> slotByNode;
+  std::vector<int> freeSlots;
+  std::atomic<bool> enabled{false};
+  double nanosPerTick = 1.0;
+};
+
+} // namespace Teul
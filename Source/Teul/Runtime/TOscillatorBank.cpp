@@ -0,0 +1,232 @@
+#include "TOscillatorBank.h"
+
+#include <cmath>
+
+namespace Teul {
+namespace {
+
+constexpr int kTableStride = TOscillatorTables::kTableSize + 1;
+constexpr int kNumBandLimitedWaveforms = 3;
+
+// Harmonics above a quarter of the table size are dropped even at the
+// lowest levels; linear interpolation would attenuate them anyway.
+int harmonicLimitForLevel(int level) {
+  return juce::jmin(TOscillatorTables::kTableSize / 4,
+                    (TOscillatorTables::kTableSize / 2) >> level);
+}
+
+// Fourier coefficient of harmonic k; triangle terms are cosines.
+double harmonicCoefficient(TOscillatorWaveform waveform, int k) {
+  const double pi = juce::MathConstants<double>::pi;
+  switch (waveform) {
+  case TOscillatorWaveform::Triangle:
+    return (k % 2) != 0 ? -8.0 / (pi * pi * k * k) : 0.0;
+  case TOscillatorWaveform::Square:
+    return (k % 2) != 0 ? 4.0 / (pi * k) : 0.0;
+  case TOscillatorWaveform::Saw:
+    return 2.0 / (pi * k);
+  case TOscillatorWaveform::Sine:
+  default:
+    return k == 1 ? 1.0 : 0.0;
+  }
+}
+
+} // namespace
+
+const TOscillatorTables &TOscillatorTables::get() {
+  static const TOscillatorTables tables;
+  return tables;
+}
+
+TOscillatorTables::TOscillatorTables()
+    : storage(static_cast<std::size_t>((1 + kNumBandLimitedWaveforms * kNumLevels) *
+                                       kTableStride)) {
+  std::vector<double> sine(static_cast<std::size_t>(kTableSize));
+  for (int index = 0; index < kTableSize; ++index) {
+    sine[static_cast<std::size_t>(index)] =
+        std::sin(juce::MathConstants<double>::twoPi * index / kTableSize);
+    storage[static_cast<std::size_t>(index)] =
+        static_cast<float>(sine[static_cast<std::size_t>(index)]);
+  }
+  storage[static_cast<std::size_t>(kTableSize)] = storage[0];
+
+  // Levels are filled from the top down so each one only adds the
+  // harmonics the level above it left out.
+  std::vector<double> sum(static_cast<std::size_t>(kTableSize));
+  for (const auto waveform : {TOscillatorWaveform::Triangle,
+                              TOscillatorWaveform::Square,
+                              TOscillatorWaveform::Saw}) {
+    std::fill(sum.begin(), sum.end(), 0.0);
+    const int quarterTurn =
+        waveform == TOscillatorWaveform::Triangle ? kTableSize / 4 : 0;
+    int harmonicsDone = 0;
+    for (int level = kNumLevels - 1; level >= 0; --level) {
+      const int harmonicLimit = harmonicLimitForLevel(level);
+      for (int k = harmonicsDone + 1; k <= harmonicLimit; ++k) {
+        const double coefficient = harmonicCoefficient(waveform, k);
+        if (coefficient == 0.0)
+          continue;
+
+        for (int index = 0; index < kTableSize; ++index) {
+          const int basisIndex = (k * index + quarterTurn) % kTableSize;
+          sum[static_cast<std::size_t>(index)] +=
+              coefficient * sine[static_cast<std::size_t>(basisIndex)];
+        }
+      }
+      harmonicsDone = juce::jmax(harmonicsDone, harmonicLimit);
+
+      auto *table = storage.data() + offsetOf(waveform, level);
+      for (int index = 0; index < kTableSize; ++index)
+        table[index] = static_cast<float>(sum[static_cast<std::size_t>(index)]);
+      table[kTableSize] = table[0];
+    }
+  }
+}
+
+const float *TOscillatorTables::getTable(TOscillatorWaveform waveform,
+                                         int level) const noexcept {
+  return storage.data() + offsetOf(waveform, level);
+}
+
+std::size_t TOscillatorTables::offsetOf(TOscillatorWaveform waveform,
+                                        int level) noexcept {
+  if (waveform == TOscillatorWaveform::Sine)
+    return 0;
+
+  const int waveformIndex = static_cast<int>(waveform) - 1;
+  const int tableIndex = 1 + waveformIndex * kNumLevels +
+                         juce::jlimit(0, kNumLevels - 1, level);
+  return static_cast<std::size_t>(tableIndex * kTableStride);
+}
+
+void TOscillatorBank::reset() noexcept {
+  phases.fill(0.0f);
+  controlValue = 0.0f;
+  controlTarget = 0.0f;
+  controlStep = 0.0f;
+  controlRemaining = 0;
+  controlPrimed = false;
+}
+
+void TOscillatorBank::render(TOscillatorWaveform waveform, Block &block) noexcept {
+  if (block.laneCount <= 1)
+    renderLanes<1>(waveform, block);
+  else if (block.laneCount <= 4)
+    renderLanes<4>(waveform, block);
+  else
+    renderLanes<kLanes>(waveform, block);
+}
+
+template <int LaneWidth>
+void TOscillatorBank::renderLanes(TOscillatorWaveform waveform,
+                                  Block &block) noexcept {
+  // Levels of one waveform sit next to each other; the sine has only one.
+  const float *levelZero = TOscillatorTables::get().getTable(waveform, 0);
+  const int levelStride = waveform == TOscillatorWaveform::Sine ? 0 : kTableStride;
+
+  // Audio-rate pitch is turned into increments and table offsets a chunk at
+  // a time, one lane after another, so exp2 runs over contiguous samples.
+  constexpr int kChunkSize = 32;
+  std::array<std::array<float, kChunkSize>, LaneWidth> increments{};
+  std::array<std::array<int, kChunkSize>, LaneWidth> offsets{};
+  for (std::size_t lane = 0; lane < LaneWidth; ++lane) {
+    increments[lane].fill(block.increments[lane]);
+    offsets[lane].fill(levelStride *
+                       TOscillatorTables::levelForIncrement(block.increments[lane]));
+  }
+
+  std::array<float, LaneWidth> frame{};
+  for (int chunkStart = 0; chunkStart < block.numSamples; chunkStart += kChunkSize) {
+    const int chunkLength = juce::jmin(kChunkSize, block.numSamples - chunkStart);
+    if (block.audioRatePitch) {
+      for (std::size_t lane = 0; lane < LaneWidth; ++lane) {
+        const float *pitch = block.pitches[lane];
+        if (pitch == nullptr)
+          continue;
+
+        pitch += chunkStart;
+        auto &laneIncrements = increments[lane];
+        auto &laneOffsets = offsets[lane];
+        for (int index = 0; index < chunkLength; ++index) {
+          laneIncrements[static_cast<std::size_t>(index)] =
+              juce::jlimit(0.0f, block.maxFrequency,
+                           block.frequency * fastExp2(pitch[index])) *
+              block.inverseSampleRate;
+        }
+        for (int index = 0; index < chunkLength; ++index) {
+          laneOffsets[static_cast<std::size_t>(index)] =
+              levelStride * TOscillatorTables::levelForIncrement(
+                                laneIncrements[static_cast<std::size_t>(index)]);
+        }
+        block.increments[lane] =
+            increments[lane][static_cast<std::size_t>(chunkLength - 1)];
+      }
+    }
+
+    for (int index = 0; index < chunkLength; ++index) {
+      const auto chunkIndex = static_cast<std::size_t>(index);
+      for (std::size_t lane = 0; lane < LaneWidth; ++lane) {
+        frame[lane] = TOscillatorTables::read(levelZero + offsets[lane][chunkIndex],
+                                              phases[lane]) *
+                      block.gain;
+        phases[lane] += increments[lane][chunkIndex];
+        phases[lane] -= phases[lane] >= 1.0f ? 1.0f : 0.0f;
+      }
+
+      const int sampleIndex = chunkStart + index;
+      for (int lane = 0; lane < block.laneCount; ++lane) {
+        if (auto *output = block.outputs[static_cast<std::size_t>(lane)])
+          output[sampleIndex] = frame[static_cast<std::size_t>(lane)];
+      }
+    }
+  }
+}
+
+void TOscillatorBank::renderControl(TOscillatorWaveform waveform, float increment,
+                                    float *output, int numSamples) noexcept {
+  int sampleIndex = 0;
+  while (sampleIndex < numSamples) {
+    if (controlRemaining == 0) {
+      if (!controlPrimed) {
+        controlValue = evaluateShape(waveform, phases[0]);
+        controlPrimed = true;
+      }
+
+      phases[0] += increment * static_cast<float>(kControlInterval);
+      phases[0] -= std::floor(phases[0]);
+      controlTarget = evaluateShape(waveform, phases[0]);
+      controlStep = (controlTarget - controlValue) /
+                    static_cast<float>(kControlInterval);
+      controlRemaining = kControlInterval;
+    }
+
+    const int run = juce::jmin(controlRemaining, numSamples - sampleIndex);
+    for (int index = 0; index < run; ++index) {
+      controlValue += controlStep;
+      output[sampleIndex + index] = controlValue;
+    }
+
+    sampleIndex += run;
+    controlRemaining -= run;
+    if (controlRemaining == 0)
+      controlValue = controlTarget;
+  }
+}
+
+float TOscillatorBank::evaluateShape(TOscillatorWaveform waveform,
+                                     float phase) noexcept {
+  switch (waveform) {
+  case TOscillatorWaveform::Triangle:
+    return 1.0f - 4.0f * std::abs(phase - 0.5f);
+  case TOscillatorWaveform::Square:
+    return phase < 0.5f ? 1.0f : -1.0f;
+  case TOscillatorWaveform::Saw:
+    return 1.0f - 2.0f * phase;
+  case TOscillatorWaveform::Sine:
+  default:
+    return TOscillatorTables::read(
+        TOscillatorTables::get().getTable(TOscillatorWaveform::Sine, 0), phase);
+  }
+}
+
+} // namespace Teul
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "TDspMath.h"
+#include "TVoiceAllocator.h"
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Teul {
+
+enum class TOscillatorWaveform : int { Sine = 0, Triangle, Square, Saw };
+
+// Read-only band-limited tables shared by every oscillator. Each waveform
+// has one table per octave of phase increment, holding only the harmonics
+// that stay below Nyquist there. Built on first use; call get() from a
+// non-audio thread first, prepareToPlay does.
+class TOscillatorTables {
+public:
+  static constexpr int kTableSize = 2048;
+  static constexpr int kNumLevels = 11;
+
+  static const TOscillatorTables &get();
+
+  const float *getTable(TOscillatorWaveform waveform, int level) const noexcept;
+
+  // Level whose harmonics all stay below Nyquist at this phase increment:
+  // the binary exponent of the table step, rounded up. Branch free so that
+  // per-sample level tracking vectorises.
+  static int levelForIncrement(float increment) noexcept {
+    const float tableStep = increment * static_cast<float>(kTableSize);
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &tableStep, sizeof(bits));
+    const int exponent = static_cast<int>((bits >> 23) & 0xffu) - 127;
+    const int level = exponent + static_cast<int>((bits & 0x7fffffu) != 0);
+    return juce::jlimit(0, kNumLevels - 1, level);
+  }
+
+  // Linear interpolation; phase must be in [0, 1).
+  static float read(const float *table, float phase) noexcept {
+    const float position = phase * static_cast<float>(kTableSize);
+    const int index = static_cast<int>(position);
+    const float fraction = position - static_cast<float>(index);
+    return table[index] + (table[index + 1] - table[index]) * fraction;
+  }
+
+private:
+  TOscillatorTables();
+
+  static std::size_t offsetOf(TOscillatorWaveform waveform, int level) noexcept;
+
+  // The sine table first, then kNumLevels tables per other waveform; every
+  // table carries one guard sample.
+  std::vector<float> storage;
+};
+
+// Phase accumulators for up to kLanes voices of one oscillator, rendered as
+// lanes of one loop with the waveform chosen once per block. Audio-rate
+// output reads the band-limited tables; control-rate output evaluates the
+// exact shapes every kControlInterval samples and ramps between them.
+class TOscillatorBank {
+public:
+  static constexpr int kLanes = TVoiceAllocator::kMaxVoices;
+  static constexpr int kControlInterval = 16;
+
+  struct Block {
+    std::array<float *, kLanes> outputs{};
+    // Per-sample V/Oct input of a lane, or nullptr for a block-constant
+    // increment.
+    std::array<const float *, kLanes> pitches{};
+    std::array<float, kLanes> increments{};
+    bool audioRatePitch = false;
+    int laneCount = 1;
+    int numSamples = 0;
+    float frequency = 440.0f;
+    float maxFrequency = 0.0f;
+    float inverseSampleRate = 0.0f;
+    float gain = 1.0f;
+  };
+
+  void reset() noexcept;
+
+  void render(TOscillatorWaveform waveform, Block &block) noexcept;
+  void renderControl(TOscillatorWaveform waveform, float increment,
+                     float *output, int numSamples) noexcept;
+
+  // The unfiltered shape, as control-rate output uses it.
+  static float evaluateShape(TOscillatorWaveform waveform, float phase) noexcept;
+
+private:
+  template <int LaneWidth>
+  void renderLanes(TOscillatorWaveform waveform, Block &block) noexcept;
+
+  std::array<float, kLanes> phases{};
+  float controlValue = 0.0f;
+  float controlTarget = 0.0f;
+  float controlStep = 0.0f;
+  int controlRemaining = 0;
+  bool controlPrimed = false;
+};
+
+} // namespace Teul
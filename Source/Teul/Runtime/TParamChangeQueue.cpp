@@ -0,0 +1,42 @@
+#include "TParamChangeQueue.h"
+
+namespace Teul {
+
+TParamChangeQueue::TParamChangeQueue()
+    : changes(std::make_unique<std::atomic<std::uint64_t>[]>(kMaxCells)),
+      pending(std::make_unique<std::atomic<bool>[]>(kMaxCells)),
+      ring(std::make_unique<RingEntry[]>(kMaxCells)) {
+  for (int cell = 0; cell < kMaxCells; ++cell) {
+    changes[static_cast<std::size_t>(cell)].store(0, std::memory_order_relaxed);
+    pending[static_cast<std::size_t>(cell)].store(false, std::memory_order_relaxed);
+  }
+}
+
+// The value is stored before the pending flag is raised, and the consumer
+// lowers the flag before loading the value, so the newest value is never
+// left behind: at worst it is applied twice.
+TParamChangeQueue::PushResult TParamChangeQueue::push(int cell, float value,
+                                                      int sampleOffset) noexcept {
+  if (cell < 0 || cell >= kMaxCells)
+    return PushResult::rejected;
+
+  changes[static_cast<std::size_t>(cell)].store(
+      pack(value, sampleOffset > 0 ? sampleOffset : 0), std::memory_order_relaxed);
+  if (pending[static_cast<std::size_t>(cell)].exchange(true,
+                                                       std::memory_order_acq_rel)) {
+    return PushResult::coalesced;
+  }
+
+  const auto position = tail.fetch_add(1, std::memory_order_relaxed);
+  auto &entry = ring[position & kRingMask];
+  entry.cell = cell;
+  entry.sequence.store(position + 1, std::memory_order_release);
+  return PushResult::queued;
+}
+
+bool TParamChangeQueue::isPending(int cell) const noexcept {
+  return cell >= 0 && cell < kMaxCells &&
+         pending[static_cast<std::size_t>(cell)].load(std::memory_order_acquire);
+}
+
+} // namespace Teul
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace Teul {
+
+// Parameter transport from any number of producer threads to the audio
+// thread. Every parameter owns a cell holding its latest value; a cell is
+// enqueued only when it goes from idle to pending, so a burst of changes to
+// one parameter collapses into a single entry carrying the newest value.
+// Since a cell is queued at most once, the ring never holds more entries
+// than there are cells and producers never wait or fail for space. A change
+// may carry a sample offset into the next block; value and offset are
+// stored as one word so a coalesced change never pairs one push's value
+// with another's offset.
+class TParamChangeQueue {
+public:
+  static constexpr int kMaxCells = 8192;
+
+  enum class PushResult { queued, coalesced, rejected };
+
+  TParamChangeQueue();
+
+  // Any thread; wait-free.
+  PushResult push(int cell, float value, int sampleOffset = 0) noexcept;
+
+  // Audio thread. Calls fn(cell, value, sampleOffset) once per pending
+  // cell; an entry whose producer is still publishing it waits for the
+  // next drain.
+  template <typename Fn> int drain(Fn &&fn) noexcept {
+    int drained = 0;
+    for (;;) {
+      auto &entry = ring[head & kRingMask];
+      if (entry.sequence.load(std::memory_order_acquire) != head + 1)
+        break;
+
+      const int cell = entry.cell;
+      ++head;
+      pending[static_cast<std::size_t>(cell)].exchange(false,
+                                                       std::memory_order_acq_rel);
+      const auto change =
+          changes[static_cast<std::size_t>(cell)].load(std::memory_order_relaxed);
+      fn(cell, unpackValue(change), static_cast<int>(change >> 32));
+      ++drained;
+    }
+
+    return drained;
+  }
+
+  bool isPending(int cell) const noexcept;
+
+private:
+  static constexpr std::uint32_t kRingMask = kMaxCells - 1;
+  static_assert((kMaxCells & (kMaxCells - 1)) == 0,
+                "ring capacity must be a power of two");
+
+  static std::uint64_t pack(float value, int sampleOffset) noexcept {
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(sampleOffset)) << 32) |
+           bits;
+  }
+
+  static float unpackValue(std::uint64_t change) noexcept {
+    const auto bits = static_cast<std::uint32_t>(change);
+    float value = 0.0f;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  struct RingEntry {
+    std::atomic<std::uint32_t> sequence{0};
+    int cell = -1;
+  };
+
+  std::unique_ptr<std::atomic<std::uint64_t>[]> changes;
+  std::unique_ptr<std::atomic<bool>[]> pending;
+  std::unique_ptr<RingEntry[]> ring;
+  std::atomic<std::uint32_t> tail{0};
+  std::uint32_t head = 0;
+};
+
+} // namespace Teul
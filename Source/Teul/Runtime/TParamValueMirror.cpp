@@ -0,0 +1,34 @@
+#include "TParamValueMirror.h"
+
+namespace Teul {
+
+TParamValueMirror::TParamValueMirror()
+    : values(std::make_unique<std::atomic<float>[]>(kMaxCells)),
+      dirty(std::make_unique<std::atomic<std::uint64_t>[]>(kWordCount)) {
+  for (int cell = 0; cell < kMaxCells; ++cell)
+    values[static_cast<std::size_t>(cell)].store(0.0f, std::memory_order_relaxed);
+  for (int word = 0; word < kWordCount; ++word)
+    dirty[static_cast<std::size_t>(word)].store(0, std::memory_order_relaxed);
+}
+
+// The value is stored before its bit is raised, so a poll that clears the
+// bit reads this value or a newer one whose bit is raised again.
+void TParamValueMirror::write(int cell, float value) noexcept {
+  if (cell < 0 || cell >= kMaxCells)
+    return;
+
+  values[static_cast<std::size_t>(cell)].store(value, std::memory_order_relaxed);
+  const auto bit = std::uint64_t{1} << (cell % 64);
+  dirty[static_cast<std::size_t>(cell / 64)].fetch_or(bit, std::memory_order_release);
+}
+
+bool TParamValueMirror::isDirty(int cell) const noexcept {
+  if (cell < 0 || cell >= kMaxCells)
+    return false;
+
+  const auto bit = std::uint64_t{1} << (cell % 64);
+  return (dirty[static_cast<std::size_t>(cell / 64)].load(std::memory_order_acquire) &
+          bit) != 0;
+}
+
+} // namespace Teul
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace Teul {
+
+// Latest value of every parameter cell, written by the render threads and
+// polled by the message thread. A write stores the value and raises the
+// cell's dirty bit; a poll visits only raised bits, so both sides cost in
+// proportion to what changed. Intermediate values between polls are not
+// kept, only the newest.
+class TParamValueMirror {
+public:
+  static constexpr int kMaxCells = 8192;
+
+  TParamValueMirror();
+
+  // Any thread; wait-free.
+  void write(int cell, float value) noexcept;
+
+  bool isDirty(int cell) const noexcept;
+
+  // Message thread. Calls fn(cell, value) for every cell written since the
+  // previous poll and clears its dirty bit.
+  template <typename Fn> int poll(Fn &&fn) {
+    int visited = 0;
+    for (int word = 0; word < kWordCount; ++word) {
+      auto &dirtyWord = dirty[static_cast<std::size_t>(word)];
+      if (dirtyWord.load(std::memory_order_relaxed) == 0)
+        continue;
+
+      auto bits = dirtyWord.exchange(0, std::memory_order_acquire);
+      for (int bit = 0; bits != 0; ++bit, bits >>= 1) {
+        if ((bits & 1u) == 0)
+          continue;
+
+        const int cell = word * 64 + bit;
+        fn(cell, values[static_cast<std::size_t>(cell)].load(
+                     std::memory_order_relaxed));
+        ++visited;
+      }
+    }
+
+    return visited;
+  }
+
+private:
+  static constexpr int kWordCount = kMaxCells / 64;
+  static_assert(kMaxCells % 64 == 0, "cells must fill whole dirty words");
+
+  std::unique_ptr<std::atomic<float>[]> values;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> dirty;
+};
+
+} // namespace Teul
@@ -0,0 +1,136 @@
+#include "TPortMeterBank.h"
+
+#include <cmath>
+
+namespace Teul {
+
+int TPortMeterBank::subscribe(PortId portId) {
+  if (portId == kInvalidPortId)
+    return -1;
+
+  int freeSlot = -1;
+  for (int slotIndex = 0; slotIndex < kMaxSlots; ++slotIndex) {
+    auto &slot = slots[static_cast<std::size_t>(slotIndex)];
+    if (slot.subscriberCount > 0 &&
+        slot.portId.load(std::memory_order_relaxed) == portId) {
+      ++slot.subscriberCount;
+      return slotIndex;
+    }
+
+    if (freeSlot < 0 && slot.subscriberCount == 0)
+      freeSlot = slotIndex;
+  }
+
+  if (freeSlot < 0)
+    return -1;
+
+  auto &slot = slots[static_cast<std::size_t>(freeSlot)];
+  slot.subscriberCount = 1;
+  slot.peak.store(0.0f, std::memory_order_relaxed);
+  slot.rms.store(0.0f, std::memory_order_relaxed);
+  slot.portId.store(portId, std::memory_order_release);
+  subscribedCount.fetch_add(1, std::memory_order_relaxed);
+  return freeSlot;
+}
+
+void TPortMeterBank::unsubscribe(int slotIndex) {
+  if (slotIndex < 0 || slotIndex >= kMaxSlots)
+    return;
+
+  auto &slot = slots[static_cast<std::size_t>(slotIndex)];
+  if (slot.subscriberCount <= 0 || --slot.subscriberCount > 0)
+    return;
+
+  slot.portId.store(kInvalidPortId, std::memory_order_release);
+  subscribedCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+PortId TPortMeterBank::getSlotPort(int slotIndex) const noexcept {
+  if (slotIndex < 0 || slotIndex >= kMaxSlots)
+    return kInvalidPortId;
+
+  return slots[static_cast<std::size_t>(slotIndex)].portId.load(
+      std::memory_order_acquire);
+}
+
+bool TPortMeterBank::read(int slotIndex, Reading &reading) const noexcept {
+  if (slotIndex < 0 || slotIndex >= kMaxSlots)
+    return false;
+
+  const auto &slot = slots[static_cast<std::size_t>(slotIndex)];
+  for (int attempt = 0; attempt < 4; ++attempt) {
+    const auto before = slot.sequence.load(std::memory_order_acquire);
+    if ((before & 1u) != 0)
+      continue;
+
+    const float peak = slot.peak.load(std::memory_order_relaxed);
+    const float rms = slot.rms.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != before)
+      continue;
+
+    reading.peak = peak;
+    reading.rms = rms;
+    reading.version = before / 2;
+    return true;
+  }
+
+  return false;
+}
+
+void TPortMeterBank::publish(int slotIndex, float peak, float rms) noexcept {
+  if (slotIndex < 0 || slotIndex >= kMaxSlots)
+    return;
+
+  auto &slot = slots[static_cast<std::size_t>(slotIndex)];
+  const float previousPeak = slot.peak.load(std::memory_order_relaxed);
+  const float smoothedPeak =
+      peak >= previousPeak ? peak : juce::jmax(peak, previousPeak * 0.84f);
+
+  const auto sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.peak.store(smoothedPeak, std::memory_order_relaxed);
+  slot.rms.store(rms, std::memory_order_relaxed);
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void TPortMeterBank::publish(int slotIndex, BlockLevel &level) noexcept {
+  if (level.numSamples > 0) {
+    publish(slotIndex, level.peak,
+            static_cast<float>(std::sqrt(level.sumOfSquares / level.numSamples)));
+  }
+  level = {};
+}
+
+// Peak comes from JUCE's vectorised min/max. The squares are accumulated in
+// eight independent lanes so the loop vectorises without fast-math.
+void TPortMeterBank::measure(const float *samples, int numSamples, float &peak,
+                             float &rms) noexcept {
+  peak = 0.0f;
+  rms = 0.0f;
+  if (samples == nullptr || numSamples <= 0)
+    return;
+
+  const auto range = juce::FloatVectorOperations::findMinAndMax(samples, numSamples);
+  peak = juce::jlimit(0.0f, 1.0f,
+                      juce::jmax(std::abs(range.getStart()), std::abs(range.getEnd())));
+
+  constexpr int kLanes = 8;
+  float lanes[kLanes] = {};
+  int sampleIndex = 0;
+  for (; sampleIndex + kLanes <= numSamples; sampleIndex += kLanes) {
+    for (int lane = 0; lane < kLanes; ++lane)
+      lanes[lane] += samples[sampleIndex + lane] * samples[sampleIndex + lane];
+  }
+
+  float sumOfSquares = 0.0f;
+  for (const float lane : lanes)
+    sumOfSquares += lane;
+  for (; sampleIndex < numSamples; ++sampleIndex)
+    sumOfSquares += samples[sampleIndex] * samples[sampleIndex];
+
+  rms = std::sqrt(sumOfSquares / static_cast<float>(numSamples));
+}
+
+} // namespace Teul
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../Model/TTypes.h"
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Teul {
+
+// Fixed table of port meters shared by the audio thread and the editor. The
+// editor subscribes the ports it is showing and polls readings by slot, so
+// nothing is measured for ports nobody looks at. Each slot is a seqlock:
+// a reading never mixes two blocks, and its version advances once per
+// published block. subscribe/unsubscribe must not run concurrently with
+// each other; read and publish are lock-free.
+class TPortMeterBank {
+public:
+  static constexpr int kMaxSlots = 256;
+
+  struct Reading {
+    float peak = 0.0f;
+    float rms = 0.0f;
+    std::uint32_t version = 0;
+  };
+
+  // Returns the slot metering portId, sharing it with earlier subscribers,
+  // or -1 when the table is full.
+  int subscribe(PortId portId);
+  void unsubscribe(int slotIndex);
+
+  PortId getSlotPort(int slotIndex) const noexcept;
+  int getNumSubscribedPorts() const noexcept {
+    return subscribedCount.load(std::memory_order_relaxed);
+  }
+
+  // Levels of one port over the sub-blocks of a device block, so a split
+  // block is still published once.
+  struct BlockLevel {
+    float peak = 0.0f;
+    double sumOfSquares = 0.0;
+    int numSamples = 0;
+
+    void add(float subBlockPeak, float subBlockRms, int subBlockSamples) noexcept {
+      peak = juce::jmax(peak, subBlockPeak);
+      sumOfSquares += static_cast<double>(subBlockRms) * subBlockRms * subBlockSamples;
+      numSamples += subBlockSamples;
+    }
+  };
+
+  bool read(int slotIndex, Reading &reading) const noexcept;
+
+  // Audio thread. Peaks rise immediately and fall back gradually.
+  void publish(int slotIndex, float peak, float rms) noexcept;
+  // Publishes a level that holds samples and clears it.
+  void publish(int slotIndex, BlockLevel &level) noexcept;
+
+  static void measure(const float *samples, int numSamples, float &peak,
+                      float &rms) noexcept;
+
+private:
+  struct Slot {
+    std::atomic<PortId> portId{kInvalidPortId};
+    std::atomic<std::uint32_t> sequence{0};
+    std::atomic<float> peak{0.0f};
+    std::atomic<float> rms{0.0f};
+    int subscriberCount = 0;
+  };
+
+  std::array<Slot, kMaxSlots> slots;
+  std::atomic<int> subscribedCount{0};
+};
+
+} // namespace Teul
@@ -0,0 +1,280 @@
+#include "TSampleStreamer.h"
+
+#include <algorithm>
+
+namespace Teul {
+namespace {
+
+constexpr int kPollIntervalMs = 5;
+// Frames between page touches; small enough for 24-bit stereo pages.
+constexpr int kTouchStrideFrames = 512;
+std::atomic<int> liveSourceCount{0};
+
+} // namespace
+
+TSampleSource::TSampleSource() {
+  liveSourceCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+TSampleSource::~TSampleSource() {
+  liveSourceCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+int TSampleSource::readResident(juce::int64 startFrame, float *left, float *right,
+                                int numFrames) const noexcept {
+  const int available = static_cast<int>(
+      juce::jlimit<juce::int64>(0, numFrames, residentFrames - startFrame));
+  if (available <= 0 || startFrame < 0)
+    return 0;
+
+  if (storage == Storage::Mapped) {
+    float *destinations[] = {left, right};
+    mappedReader->read(destinations, numChannels, startFrame, available);
+  } else {
+    const auto offset = static_cast<int>(startFrame);
+    std::copy_n(head.getReadPointer(0, offset), available, left);
+    std::copy_n(head.getReadPointer(1, offset), available, right);
+    return available;
+  }
+
+  if (numChannels == 1)
+    std::copy_n(left, available, right);
+  return available;
+}
+
+void TSampleStream::start(juce::int64 fromFrame) noexcept {
+  readChunks.store(writtenChunks.load(std::memory_order_acquire),
+                   std::memory_order_release);
+  ++generation;
+  requestedFrame.store(fromFrame, std::memory_order_relaxed);
+  requestedGeneration.store(generation, std::memory_order_release);
+  active.store(true, std::memory_order_release);
+}
+
+void TSampleStream::stop() noexcept {
+  active.store(false, std::memory_order_release);
+  ++generation;
+  requestedGeneration.store(generation, std::memory_order_release);
+}
+
+int TSampleStream::read(juce::int64 position, float *left, float *right,
+                        int numFrames) noexcept {
+  int copied = 0;
+  while (copied < numFrames) {
+    const auto readIndex = readChunks.load(std::memory_order_relaxed);
+    if (readIndex == writtenChunks.load(std::memory_order_acquire))
+      break;
+
+    const auto &chunk = chunks[readIndex % kChunkCount];
+    const juce::int64 wanted = position + copied;
+    const juce::int64 chunkEnd = chunk.startFrame + chunk.frameCount;
+    if (chunk.generation != generation || chunkEnd <= wanted) {
+      readChunks.store(readIndex + 1, std::memory_order_release);
+      continue;
+    }
+    if (chunk.startFrame > wanted)
+      break;
+
+    const int offset = static_cast<int>(wanted - chunk.startFrame);
+    const int count = juce::jmin(numFrames - copied, chunk.frameCount - offset);
+    std::copy_n(chunk.left.data() + offset, count, left + copied);
+    std::copy_n(chunk.right.data() + offset, count, right + copied);
+    copied += count;
+    if (offset + count == chunk.frameCount)
+      readChunks.store(readIndex + 1, std::memory_order_release);
+  }
+
+  return copied;
+}
+
+TSampleStreamer &TSampleStreamer::get() {
+  static TSampleStreamer streamer;
+  return streamer;
+}
+
+TSampleStreamer::TSampleStreamer() : juce::Thread("Teul Sample Streamer") {
+  formatManager.registerBasicFormats();
+}
+
+TSampleStreamer::~TSampleStreamer() { stopThread(2000); }
+
+std::shared_ptr<const TSampleSource>
+TSampleStreamer::openSource(const juce::File &file) {
+  const auto key = file.getFullPathName();
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    const auto existing = sources.find(key);
+    if (existing != sources.end()) {
+      if (auto source = existing->second.lock())
+        return source;
+    }
+  }
+
+  std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+  if (reader == nullptr || reader->lengthInSamples <= 0 || reader->numChannels == 0)
+    return nullptr;
+
+  auto source = std::make_shared<TSampleSource>();
+  source->lengthInFrames = reader->lengthInSamples;
+  source->sampleRate = reader->sampleRate > 0.0 ? reader->sampleRate : 48000.0;
+  source->numChannels = juce::jmin(2, static_cast<int>(reader->numChannels));
+
+  if (file.getSize() <= TSampleSource::kMaxMappedBytes) {
+    if (auto *format = formatManager.findFormatForFileExtension(file.getFileExtension())) {
+      std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(
+          format->createMemoryMappedReader(file));
+      if (mapped != nullptr && mapped->mapEntireFile()) {
+        // Fault every page in now rather than on the audio thread.
+        const auto section = mapped->getMappedSection();
+        for (auto frame = section.getStart(); frame < section.getEnd();
+             frame += kTouchStrideFrames) {
+          mapped->touchSample(frame);
+        }
+        source->storage = TSampleSource::Storage::Mapped;
+        source->residentFrames =
+            juce::jmin(source->lengthInFrames, section.getEnd());
+        source->mappedReader = std::move(mapped);
+      }
+    }
+  }
+
+  if (source->mappedReader == nullptr) {
+    const auto headFrames = static_cast<int>(juce::jmin<juce::int64>(
+        source->lengthInFrames, TSampleSource::kHeadFrames));
+    source->head.setSize(2, headFrames);
+    reader->read(source->head.getArrayOfWritePointers(), source->numChannels, 0,
+                 headFrames);
+    if (source->numChannels == 1)
+      source->head.copyFrom(1, 0, source->head, 0, 0, headFrames);
+    source->residentFrames = headFrames;
+    if (headFrames < source->lengthInFrames) {
+      source->storage = TSampleSource::Storage::Streamed;
+      source->streamReader = std::move(reader);
+    }
+  }
+
+  const std::lock_guard<std::mutex> lock(mutex);
+  for (auto it = sources.begin(); it != sources.end();) {
+    if (it->second.expired())
+      it = sources.erase(it);
+    else
+      ++it;
+  }
+  sources[key] = source;
+  return source;
+}
+
+void TSampleStreamer::registerStream(TSampleStream &stream,
+                                     const TSampleSource &source) {
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    stream.source = &source;
+    streams.push_back(&stream);
+    registeredStreamCount.store(static_cast<int>(streams.size()),
+                                std::memory_order_relaxed);
+  }
+
+  if (!isThreadRunning())
+    startThread(juce::Thread::Priority::high);
+}
+
+void TSampleStreamer::unregisterStream(TSampleStream &stream) {
+  std::unique_lock<std::mutex> lock(mutex);
+  streams.erase(std::remove(streams.begin(), streams.end(), &stream), streams.end());
+  registeredStreamCount.store(static_cast<int>(streams.size()),
+                              std::memory_order_relaxed);
+  fillDone.wait(lock, [&] { return fillingStream != &stream; });
+}
+
+TSampleStreamer::Stats TSampleStreamer::getStats() const noexcept {
+  Stats stats;
+  stats.diskUnderrunCount = diskUnderrunCount.load(std::memory_order_relaxed);
+  stats.activeStreamCount = activeStreamCount.load(std::memory_order_relaxed);
+  stats.registeredStreamCount =
+      registeredStreamCount.load(std::memory_order_relaxed);
+  stats.openSourceCount = liveSourceCount.load(std::memory_order_relaxed);
+  return stats;
+}
+
+// Each pass works on a copy of the stream list and holds the lock only to
+// claim the next stream, so opening and registering never wait on the disk.
+void TSampleStreamer::run() {
+  std::vector<TSampleStream *> pass;
+  while (!threadShouldExit()) {
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      pass = streams;
+    }
+
+    bool filled = false;
+    int active = 0;
+    for (auto *stream : pass) {
+      {
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (std::find(streams.begin(), streams.end(), stream) == streams.end())
+          continue;
+        fillingStream = stream;
+      }
+
+      filled = fillStream(*stream) || filled;
+      active += stream->active.load(std::memory_order_relaxed) ? 1 : 0;
+
+      {
+        const std::lock_guard<std::mutex> lock(mutex);
+        fillingStream = nullptr;
+      }
+      fillDone.notify_all();
+    }
+    activeStreamCount.store(active, std::memory_order_relaxed);
+
+    if (!filled)
+      wait(kPollIntervalMs);
+  }
+}
+
+// Reads ahead until the ring is full or the file ends, restarting from the
+// requested frame when the voice was retriggered.
+bool TSampleStreamer::fillStream(TSampleStream &stream) {
+  const auto *source = stream.source;
+  if (source == nullptr || source->streamReader == nullptr ||
+      !stream.active.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  const auto requested = stream.requestedGeneration.load(std::memory_order_acquire);
+  if (requested != stream.producerGeneration) {
+    stream.producerGeneration = requested;
+    stream.producerFrame = stream.requestedFrame.load(std::memory_order_relaxed);
+  }
+
+  bool filled = false;
+  while (stream.producerFrame < source->lengthInFrames) {
+    const auto written = stream.writtenChunks.load(std::memory_order_relaxed);
+    if (written - stream.readChunks.load(std::memory_order_acquire) >=
+            static_cast<std::uint32_t>(TSampleStream::kChunkCount) ||
+        stream.requestedGeneration.load(std::memory_order_acquire) !=
+            stream.producerGeneration) {
+      break;
+    }
+
+    auto &chunk = stream.chunks[written % TSampleStream::kChunkCount];
+    const auto frameCount = static_cast<int>(juce::jmin<juce::int64>(
+        TSampleStream::kChunkFrames, source->lengthInFrames - stream.producerFrame));
+    float *destinations[] = {chunk.left.data(), chunk.right.data()};
+    source->streamReader->read(destinations, source->numChannels,
+                               stream.producerFrame, frameCount);
+    if (source->numChannels == 1)
+      std::copy_n(chunk.left.data(), frameCount, chunk.right.data());
+
+    chunk.startFrame = stream.producerFrame;
+    chunk.frameCount = frameCount;
+    chunk.generation = stream.producerGeneration;
+    stream.writtenChunks.store(written + 1, std::memory_order_release);
+    stream.producerFrame += frameCount;
+    filled = true;
+  }
+
+  return filled;
+}
+
+} // namespace Teul
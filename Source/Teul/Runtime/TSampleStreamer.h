@@ -0,0 +1,149 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Teul {
+
+// Audio of one file, shared by every player of it. Files the format can
+// memory-map and that fit kMaxMappedBytes are mapped whole and read in
+// place; anything else keeps its first kHeadFrames decoded in memory, so
+// a trigger sounds at once, and streams the rest through TSampleStream.
+class TSampleSource {
+public:
+  static constexpr int kHeadFrames = 1 << 16;
+  static constexpr juce::int64 kMaxMappedBytes = juce::int64(256) << 20;
+
+  enum class Storage { Mapped, Preloaded, Streamed };
+
+  TSampleSource();
+  ~TSampleSource();
+
+  Storage getStorage() const noexcept { return storage; }
+  juce::int64 getLengthInFrames() const noexcept { return lengthInFrames; }
+  double getSampleRate() const noexcept { return sampleRate; }
+
+  // Frames readResident can serve: the whole file unless it streams.
+  juce::int64 getResidentFrames() const noexcept { return residentFrames; }
+
+  // Copies resident frames [startFrame, startFrame + numFrames) to
+  // left/right and returns how many there were. Mapped reads keep no
+  // state, so players on different workers may share a source.
+  int readResident(juce::int64 startFrame, float *left, float *right,
+                   int numFrames) const noexcept;
+
+private:
+  friend class TSampleStreamer;
+
+  Storage storage = Storage::Preloaded;
+  juce::int64 lengthInFrames = 0;
+  juce::int64 residentFrames = 0;
+  double sampleRate = 48000.0;
+  int numChannels = 0;
+  std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader;
+  juce::AudioBuffer<float> head;
+  // Read by the streamer thread only.
+  std::unique_ptr<juce::AudioFormatReader> streamReader;
+};
+
+// Read-ahead of one playing voice: a single-producer, single-consumer ring
+// of decoded chunks. The streamer thread fills it past the source's head;
+// the voice drains it from the audio thread. Each trigger bumps the
+// generation, and chunks read ahead for an earlier trigger are skipped.
+class TSampleStream {
+public:
+  static constexpr int kChunkFrames = 2048;
+  static constexpr int kChunkCount = 16;
+
+  // Audio thread. Starts reading ahead from fromFrame.
+  void start(juce::int64 fromFrame) noexcept;
+  void stop() noexcept;
+
+  // Audio thread. Copies the frames from position on that have been read
+  // ahead, up to numFrames, and returns how many that was. Positions must
+  // not go backwards between start() calls.
+  int read(juce::int64 position, float *left, float *right,
+           int numFrames) noexcept;
+
+private:
+  friend class TSampleStreamer;
+
+  struct Chunk {
+    juce::int64 startFrame = 0;
+    int frameCount = 0;
+    std::uint32_t generation = 0;
+    std::array<float, kChunkFrames> left{};
+    std::array<float, kChunkFrames> right{};
+  };
+
+  std::array<Chunk, kChunkCount> chunks;
+  std::atomic<std::uint32_t> writtenChunks{0};
+  std::atomic<std::uint32_t> readChunks{0};
+  std::atomic<std::uint32_t> requestedGeneration{0};
+  std::atomic<juce::int64> requestedFrame{0};
+  std::atomic<bool> active{false};
+  std::uint32_t generation = 0;
+
+  // Streamer thread only.
+  const TSampleSource *source = nullptr;
+  std::uint32_t producerGeneration = 0;
+  juce::int64 producerFrame = 0;
+};
+
+// Opens sample sources through juce_audio_formats and runs the one
+// background thread that keeps every registered stream read ahead. Opening,
+// registering and unregistering happen on the message thread. Disk reads
+// run outside the lock; unregistering a stream waits for a read of it that
+// is already under way.
+class TSampleStreamer : private juce::Thread {
+public:
+  struct Stats {
+    std::uint64_t diskUnderrunCount = 0;
+    int activeStreamCount = 0;
+    int registeredStreamCount = 0;
+    int openSourceCount = 0;
+  };
+
+  static TSampleStreamer &get();
+  ~TSampleStreamer() override;
+
+  // Sources are shared while any player holds them; nullptr when the file
+  // cannot be decoded.
+  std::shared_ptr<const TSampleSource> openSource(const juce::File &file);
+
+  void registerStream(TSampleStream &stream, const TSampleSource &source);
+  void unregisterStream(TSampleStream &stream);
+
+  // Audio thread: a voice ran out of read-ahead.
+  void noteUnderrun() noexcept {
+    diskUnderrunCount.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Any thread; lock-free.
+  Stats getStats() const noexcept;
+
+private:
+  TSampleStreamer();
+
+  void run() override;
+  bool fillStream(TSampleStream &stream);
+
+  juce::AudioFormatManager formatManager;
+  std::mutex mutex;
+  std::condition_variable fillDone;
+  std::map<juce::String, std::weak_ptr<TSampleSource>> sources;
+  std::vector<TSampleStream *> streams;
+  TSampleStream *fillingStream = nullptr;
+  std::atomic<std::uint64_t> diskUnderrunCount{0};
+  std::atomic<int> activeStreamCount{0};
+  std::atomic<int> registeredStreamCount{0};
+};
+
+} // namespace Teul
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Teul {
+
+// Ring of the most recent Capacity records, written by one thread (usually
+// the audio thread) without locks or allocation and read from any thread.
+// Each slot is guarded by a sequence count that is odd while the writer
+// fills it; a reader retries a torn slot a few times and skips records the
+// writer has already overwritten.
+template <typename Record, int Capacity> class TSeqlockRing {
+public:
+  static_assert(std::is_trivially_copyable_v<Record>,
+                "records are copied word by word");
+  static_assert(Capacity > 0, "ring needs at least one slot");
+
+  TSeqlockRing() : slots(std::make_unique<Slot[]>(Capacity)) {}
+
+  // Writer thread only; wait-free.
+  void push(const Record &record) noexcept {
+    std::array<std::uint64_t, kWordCount> words{};
+    std::memcpy(words.data(), &record, sizeof(Record));
+
+    const auto recordIndex = count.load(std::memory_order_relaxed);
+    auto &slot = slots[static_cast<std::size_t>(recordIndex % Capacity)];
+    const auto sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.recordIndex.store(recordIndex, std::memory_order_relaxed);
+    for (std::size_t word = 0; word < kWordCount; ++word)
+      slot.words[word].store(words[word], std::memory_order_relaxed);
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+
+    count.store(recordIndex + 1, std::memory_order_release);
+  }
+
+  // Records pushed so far; the next push gets this index.
+  std::uint64_t getCount() const noexcept {
+    return count.load(std::memory_order_acquire);
+  }
+
+  // Fails when the writer is rewriting the slot or has already reused it
+  // for a newer record.
+  bool read(std::uint64_t recordIndex, Record &record) const noexcept {
+    const auto &slot = slots[static_cast<std::size_t>(recordIndex % Capacity)];
+    std::array<std::uint64_t, kWordCount> words{};
+    for (int attempt = 0; attempt < 4; ++attempt) {
+      const auto before = slot.sequence.load(std::memory_order_acquire);
+      if ((before & 1u) != 0)
+        continue;
+
+      const bool sameRecord =
+          slot.recordIndex.load(std::memory_order_relaxed) == recordIndex;
+      for (std::size_t word = 0; word < kWordCount; ++word)
+        words[word] = slot.words[word].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) != before)
+        continue;
+
+      if (!sameRecord)
+        return false;
+
+      std::memcpy(static_cast<void *>(&record), words.data(), sizeof(Record));
+      return true;
+    }
+
+    return false;
+  }
+
+  // Oldest first, starting no earlier than firstIndex.
+  std::vector<Record> readRecent(std::uint64_t firstIndex = 0) const {
+    const auto total = getCount();
+    if (total > static_cast<std::uint64_t>(Capacity))
+      firstIndex = std::max(firstIndex, total - static_cast<std::uint64_t>(Capacity));
+
+    std::vector<Record> records;
+    for (auto recordIndex = firstIndex; recordIndex < total; ++recordIndex) {
+      Record record;
+      if (read(recordIndex, record))
+        records.push_back(record);
+    }
+
+    return records;
+  }
+
+private:
+  static constexpr std::size_t kWordCount =
+      (sizeof(Record) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+  struct Slot {
+    std::atomic<std::uint32_t> sequence{0};
+    std::atomic<std::uint64_t> recordIndex{0};
+    std::array<std::atomic<std::uint64_t>, kWordCount> words{};
+  };
+
+  std::unique_ptr<Slot[]> slots;
+  std::atomic<std::uint64_t> count{0};
+};
+
+} // namespace Teul
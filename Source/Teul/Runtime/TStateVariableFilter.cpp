@@ -0,0 +1,249 @@
+#include "TStateVariableFilter.h"
+
+#include "TDspMath.h"
+#include <cmath>
+
+namespace Teul {
+
+void TStateVariableFilter::prepare(double newSampleRate) noexcept {
+  sampleRate = juce::jmax(1.0, newSampleRate);
+  staleVoices = ~0u;
+}
+
+void TStateVariableFilter::reset() noexcept {
+  ic1eq.fill(0.0f);
+  ic2eq.fill(0.0f);
+}
+
+void TStateVariableFilter::setCutoff(float newCutoffHz) noexcept {
+  newCutoffHz = juce::jlimit(20.0f, 20000.0f, newCutoffHz);
+  if (newCutoffHz != cutoffHz) {
+    cutoffHz = newCutoffHz;
+    staleVoices = ~0u;
+  }
+}
+
+void TStateVariableFilter::setResonance(float newResonance) noexcept {
+  const float newDamping = 1.0f / juce::jlimit(0.1f, 12.0f, newResonance);
+  if (newDamping != damping) {
+    damping = newDamping;
+    staleVoices = ~0u;
+  }
+}
+
+float TStateVariableFilter::gainFor(float cv) const noexcept {
+  const float frequency = juce::jlimit(20.0f, (float)(sampleRate * 0.49),
+                                       cutoffHz * fastExp2(cv));
+  return static_cast<float>(
+      std::tan(juce::MathConstants<double>::pi * frequency / sampleRate));
+}
+
+void TStateVariableFilter::setVoiceGain(int voice, float g) noexcept {
+  const float newA1 = 1.0f / (1.0f + g * (g + damping));
+  for (int channel = 0; channel < 2; ++channel) {
+    const auto lane = static_cast<std::size_t>(2 * voice + channel);
+    gains[lane] = g;
+    a1[lane] = newA1;
+    a2[lane] = g * newA1;
+    a3[lane] = g * g * newA1;
+  }
+  ++coefficientUpdateCount;
+}
+
+void TStateVariableFilter::render(Mode mode, const Block &block) noexcept {
+  const int voiceCount = juce::jlimit(1, kMaxVoices, block.voiceCount);
+  for (int voice = 0; voice < voiceCount; ++voice) {
+    const auto index = static_cast<std::size_t>(voice);
+    const std::uint32_t voiceBit = 1u << voice;
+    if (block.cvInputs[index] != nullptr)
+      continue;
+
+    if ((staleVoices & voiceBit) != 0 || block.cvValues[index] != voiceCv[index]) {
+      voiceCv[index] = block.cvValues[index];
+      setVoiceGain(voice, gainFor(voiceCv[index]));
+      staleVoices &= ~voiceBit;
+    }
+  }
+
+  const int laneCount = 2 * voiceCount;
+  const auto dispatch = [&](auto filterMode) {
+    constexpr Mode kMode = decltype(filterMode)::value;
+    if (block.audioRateCv) {
+      if (laneCount <= 2)
+        renderModulatedLanes<kMode, 2>(block);
+      else if (laneCount <= 8)
+        renderModulatedLanes<kMode, 8>(block);
+      else
+        renderModulatedLanes<kMode, kMaxLanes>(block);
+    } else if (laneCount <= 2) {
+      renderLanes<kMode, 2>(block);
+    } else if (laneCount <= 8) {
+      renderLanes<kMode, 8>(block);
+    } else {
+      renderLanes<kMode, kMaxLanes>(block);
+    }
+  };
+
+  switch (mode) {
+  case Mode::HighPass:
+    dispatch(std::integral_constant<Mode, Mode::HighPass>{});
+    break;
+  case Mode::BandPass:
+    dispatch(std::integral_constant<Mode, Mode::BandPass>{});
+    break;
+  case Mode::LowPass:
+  default:
+    dispatch(std::integral_constant<Mode, Mode::LowPass>{});
+    break;
+  }
+}
+
+namespace {
+
+// Lanes past the block's voices read a silent constant and are not
+// written back.
+template <int LaneWidth>
+void resolveLanes(const TStateVariableFilter::Block &block, int laneCount,
+                  const float &silence,
+                  std::array<const float *, LaneWidth> &inputs,
+                  std::array<int, LaneWidth> &strides) noexcept {
+  for (std::size_t lane = 0; lane < LaneWidth; ++lane) {
+    const bool active =
+        static_cast<int>(lane) < laneCount && block.inputs[lane] != nullptr;
+    inputs[lane] = active ? block.inputs[lane] : &silence;
+    strides[lane] = active ? 1 : 0;
+  }
+}
+
+template <TStateVariableFilter::Mode FilterMode>
+float selectOutput(float v0, float v1, float v2, float damping) noexcept {
+  if constexpr (FilterMode == TStateVariableFilter::Mode::HighPass)
+    return v0 - damping * v1 - v2;
+  else if constexpr (FilterMode == TStateVariableFilter::Mode::BandPass)
+    return damping * v1;
+  else
+    return v2;
+}
+
+} // namespace
+
+template <TStateVariableFilter::Mode FilterMode, int LaneWidth>
+void TStateVariableFilter::renderLanes(const Block &block) noexcept {
+  const int laneCount = 2 * juce::jlimit(1, kMaxVoices, block.voiceCount);
+  const float silence = 0.0f;
+  std::array<const float *, LaneWidth> inputs{};
+  std::array<int, LaneWidth> strides{};
+  resolveLanes<LaneWidth>(block, laneCount, silence, inputs, strides);
+
+  std::array<float, LaneWidth> frame{};
+  for (int sampleIndex = 0; sampleIndex < block.numSamples; ++sampleIndex) {
+    for (std::size_t lane = 0; lane < LaneWidth; ++lane) {
+      const float v0 = inputs[lane][sampleIndex * strides[lane]];
+      const float v3 = v0 - ic2eq[lane];
+      const float v1 = a1[lane] * ic1eq[lane] + a2[lane] * v3;
+      const float v2 = ic2eq[lane] + a2[lane] * ic1eq[lane] + a3[lane] * v3;
+      ic1eq[lane] = 2.0f * v1 - ic1eq[lane];
+      ic2eq[lane] = 2.0f * v2 - ic2eq[lane];
+      frame[lane] = selectOutput<FilterMode>(v0, v1, v2, damping);
+    }
+
+    for (int lane = 0; lane < laneCount; ++lane) {
+      if (auto *output = block.outputs[static_cast<std::size_t>(lane)])
+        output[sampleIndex] = frame[static_cast<std::size_t>(lane)];
+    }
+  }
+}
+
+template <TStateVariableFilter::Mode FilterMode, int LaneWidth>
+void TStateVariableFilter::renderModulatedLanes(const Block &block) noexcept {
+  const int voiceCount = juce::jlimit(1, kMaxVoices, block.voiceCount);
+  const int laneCount = 2 * voiceCount;
+  const float silence = 0.0f;
+  std::array<const float *, LaneWidth> inputs{};
+  std::array<int, LaneWidth> strides{};
+  resolveLanes<LaneWidth>(block, laneCount, silence, inputs, strides);
+
+  std::array<float, LaneWidth> laneGains{};
+  for (std::size_t lane = 0; lane < LaneWidth; ++lane)
+    laneGains[lane] = gains[lane];
+
+  std::array<float, LaneWidth> gainSteps{};
+  std::array<float, LaneWidth> frame{};
+  for (int chunkStart = 0; chunkStart < block.numSamples;
+       chunkStart += kCoefficientInterval) {
+    const int chunkLength =
+        juce::jmin(kCoefficientInterval, block.numSamples - chunkStart);
+
+    // Each modulated voice ramps g towards the value its CV asks for at
+    // the end of the chunk.
+    gainSteps.fill(0.0f);
+    for (int voice = 0; voice < voiceCount && 2 * voice < LaneWidth; ++voice) {
+      const auto index = static_cast<std::size_t>(voice);
+      const float *cv = block.cvInputs[index];
+      if (cv == nullptr)
+        continue;
+
+      const float chunkCv = cv[chunkStart + chunkLength - 1];
+      const std::uint32_t voiceBit = 1u << voice;
+      if ((staleVoices & voiceBit) == 0 && chunkCv == voiceCv[index])
+        continue;
+
+      const float target = gainFor(chunkCv);
+      ++coefficientUpdateCount;
+      voiceCv[index] = chunkCv;
+      if ((staleVoices & voiceBit) != 0) {
+        // Nothing valid to ramp from after a settings change.
+        staleVoices &= ~voiceBit;
+        laneGains[2 * index] = target;
+        laneGains[2 * index + 1] = target;
+        continue;
+      }
+
+      const float step =
+          (target - laneGains[2 * index]) / static_cast<float>(chunkLength);
+      gainSteps[2 * index] = step;
+      gainSteps[2 * index + 1] = step;
+    }
+
+    for (int index = 0; index < chunkLength; ++index) {
+      const int sampleIndex = chunkStart + index;
+      for (std::size_t lane = 0; lane < LaneWidth; ++lane) {
+        const float g = laneGains[lane] + gainSteps[lane];
+        laneGains[lane] = g;
+        const float laneA1 = 1.0f / (1.0f + g * (g + damping));
+        const float laneA2 = g * laneA1;
+        const float laneA3 = g * laneA2;
+
+        const float v0 = inputs[lane][sampleIndex * strides[lane]];
+        const float v3 = v0 - ic2eq[lane];
+        const float v1 = laneA1 * ic1eq[lane] + laneA2 * v3;
+        const float v2 = ic2eq[lane] + laneA2 * ic1eq[lane] + laneA3 * v3;
+        ic1eq[lane] = 2.0f * v1 - ic1eq[lane];
+        ic2eq[lane] = 2.0f * v2 - ic2eq[lane];
+        frame[lane] = selectOutput<FilterMode>(v0, v1, v2, damping);
+      }
+
+      for (int lane = 0; lane < laneCount; ++lane) {
+        if (auto *output = block.outputs[static_cast<std::size_t>(lane)])
+          output[sampleIndex] = frame[static_cast<std::size_t>(lane)];
+      }
+    }
+  }
+
+  // Leave the stored coefficients matching where the ramps ended.
+  for (int voice = 0; voice < voiceCount; ++voice) {
+    if (block.cvInputs[static_cast<std::size_t>(voice)] == nullptr)
+      continue;
+
+    const auto lane = static_cast<std::size_t>(2 * voice);
+    const float g = laneGains[lane];
+    for (int channel = 0; channel < 2; ++channel) {
+      gains[lane + channel] = g;
+      a1[lane + channel] = 1.0f / (1.0f + g * (g + damping));
+      a2[lane + channel] = g * a1[lane + channel];
+      a3[lane + channel] = g * a2[lane + channel];
+    }
+  }
+}
+
+} // namespace Teul
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "TVoiceAllocator.h"
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+
+namespace Teul {
+
+// Trapezoidal (TPT) state-variable filter for stereo voices. Lanes are
+// voice-major channel pairs: lane 2v is the left channel of voice v and
+// lane 2v + 1 its right, so L/R run side by side and share coefficients.
+// Coefficients are recomputed only when the cutoff, the resonance or a
+// voice's Freq CV changes. Audio-rate CV is sampled every
+// kCoefficientInterval samples and g is ramped between, which the TPT form
+// takes without the instability direct-form biquads show under modulation.
+class TStateVariableFilter {
+public:
+  enum class Mode : int { LowPass = 0, HighPass, BandPass };
+
+  static constexpr int kMaxVoices = TVoiceAllocator::kMaxVoices;
+  static constexpr int kMaxLanes = 2 * kMaxVoices;
+  static constexpr int kCoefficientInterval = 16;
+
+  struct Block {
+    std::array<const float *, kMaxLanes> inputs{};
+    std::array<float *, kMaxLanes> outputs{};
+    // Freq CV in octaves. A voice with an audio-rate input has it in
+    // cvInputs; otherwise cvValues holds its block-constant value.
+    std::array<const float *, kMaxVoices> cvInputs{};
+    std::array<float, kMaxVoices> cvValues{};
+    bool audioRateCv = false;
+    int voiceCount = 1;
+    int numSamples = 0;
+  };
+
+  void prepare(double newSampleRate) noexcept;
+  void reset() noexcept;
+
+  void setCutoff(float newCutoffHz) noexcept;
+  void setResonance(float newResonance) noexcept;
+
+  void render(Mode mode, const Block &block) noexcept;
+
+  // Coefficient sets computed since construction; the kernel benchmarks
+  // read it to confirm unchanged settings cost nothing.
+  std::uint64_t getCoefficientUpdateCount() const noexcept {
+    return coefficientUpdateCount;
+  }
+
+private:
+  template <Mode FilterMode, int LaneWidth>
+  void renderLanes(const Block &block) noexcept;
+  template <Mode FilterMode, int LaneWidth>
+  void renderModulatedLanes(const Block &block) noexcept;
+
+  float gainFor(float cv) const noexcept;
+  void setVoiceGain(int voice, float g) noexcept;
+
+  double sampleRate = 48000.0;
+  float cutoffHz = 1000.0f;
+  float damping = 1.0f / 0.707f;
+  // One bit per voice whose coefficients no longer match the settings.
+  std::uint32_t staleVoices = ~0u;
+  std::uint64_t coefficientUpdateCount = 0;
+
+  // CV each voice's coefficients were computed for.
+  std::array<float, kMaxVoices> voiceCv{};
+  std::array<float, kMaxLanes> gains{};
+  std::array<float, kMaxLanes> a1{};
+  std::array<float, kMaxLanes> a2{};
+  std::array<float, kMaxLanes> a3{};
+  std::array<float, kMaxLanes> ic1eq{};
+  std::array<float, kMaxLanes> ic2eq{};
+};
+
+} // namespace Teul
@@ -0,0 +1,85 @@
+#include "TVoiceAllocator.h"
+
+namespace Teul {
+
+void TVoiceAllocator::setVoiceCount(int numVoices) noexcept {
+  const int newCount = juce::jlimit(1, kMaxVoices, numVoices);
+  for (int voice = newCount; voice < voiceCount; ++voice)
+    voices[static_cast<std::size_t>(voice)].held = false;
+  voiceCount = newCount;
+}
+
+void TVoiceAllocator::reset() noexcept {
+  voices.fill({});
+  nextStamp = 1;
+  pendingSteals = 0;
+}
+
+TVoiceAllocator::Assignment TVoiceAllocator::noteOn(int noteNumber,
+                                                    float velocity) noexcept {
+  Assignment assignment;
+  int oldestReleased = -1;
+  int oldestHeld = -1;
+  for (int voice = 0; voice < voiceCount; ++voice) {
+    const auto &candidate = voices[static_cast<std::size_t>(voice)];
+    if (candidate.held && candidate.noteNumber == noteNumber) {
+      assignment.voice = voice;
+      break;
+    }
+
+    int &oldest = candidate.held ? oldestHeld : oldestReleased;
+    if (oldest < 0 || candidate.stamp < voices[static_cast<std::size_t>(oldest)].stamp)
+      oldest = voice;
+  }
+
+  if (assignment.voice < 0) {
+    assignment.voice = oldestReleased >= 0 ? oldestReleased : oldestHeld;
+    assignment.stolen = oldestReleased < 0;
+    if (assignment.stolen)
+      ++pendingSteals;
+  }
+
+  auto &voice = voices[static_cast<std::size_t>(assignment.voice)];
+  voice.noteNumber = noteNumber;
+  voice.velocity = velocity;
+  voice.held = true;
+  voice.stamp = nextStamp++;
+  return assignment;
+}
+
+void TVoiceAllocator::noteOff(int noteNumber) noexcept {
+  for (int voice = 0; voice < voiceCount; ++voice) {
+    auto &candidate = voices[static_cast<std::size_t>(voice)];
+    if (candidate.held && candidate.noteNumber == noteNumber) {
+      candidate.held = false;
+      candidate.stamp = nextStamp++;
+    }
+  }
+}
+
+void TVoiceAllocator::releaseAll() noexcept {
+  for (int voice = 0; voice < voiceCount; ++voice) {
+    auto &candidate = voices[static_cast<std::size_t>(voice)];
+    if (candidate.held) {
+      candidate.held = false;
+      candidate.stamp = nextStamp++;
+    }
+  }
+}
+
+int TVoiceAllocator::getActiveVoiceCount() const noexcept {
+  int active = 0;
+  for (int voice = 0; voice < voiceCount; ++voice) {
+    if (voices[static_cast<std::size_t>(voice)].held)
+      ++active;
+  }
+  return active;
+}
+
+std::uint64_t TVoiceAllocator::takeStealCount() noexcept {
+  const auto steals = pendingSteals;
+  pendingSteals = 0;
+  return steals;
+}
+
+} // namespace Teul
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+
+namespace Teul {
+
+// Note-to-voice assignment for one polyphonic region. A note takes a free
+// voice, the one released longest ago, so release tails of recent notes
+// keep sounding; with every voice held the oldest note is stolen. Used on
+// the audio thread only; the runtime collects the counters after each
+// block.
+class TVoiceAllocator {
+public:
+  static constexpr int kMaxVoices = 8;
+
+  struct Assignment {
+    int voice = -1;
+    bool stolen = false;
+  };
+
+  struct Voice {
+    int noteNumber = 60;
+    float velocity = 0.0f;
+    bool held = false;
+    std::uint64_t stamp = 0;
+  };
+
+  void setVoiceCount(int numVoices) noexcept;
+  int getVoiceCount() const noexcept { return voiceCount; }
+  void reset() noexcept;
+
+  // A note that is already held keeps its voice and is retriggered there.
+  Assignment noteOn(int noteNumber, float velocity) noexcept;
+  void noteOff(int noteNumber) noexcept;
+  void releaseAll() noexcept;
+
+  const Voice &getVoice(int voice) const noexcept {
+    return voices[static_cast<std::size_t>(voice)];
+  }
+
+  int getActiveVoiceCount() const noexcept;
+  std::uint64_t takeStealCount() noexcept;
+
+private:
+  std::array<Voice, kMaxVoices> voices{};
+  int voiceCount = 1;
+  std::uint64_t nextStamp = 1;
+  std::uint64_t pendingSteals = 0;
+};
+
+} // namespace Teul
@@ -38,25 +38,6 @@ Teul::NodeId findNodeIdByLabel(const Teul::TGraphDocument &document,
   return Teul::kInvalidNodeId;
 }
 
-float valueForLaneAtSample(const Teul::TVerificationAutomationLane &lane,
-                           int sampleIndex,
-                           int totalSamples,
-                           double sampleRate) {
-  if (lane.mode == Teul::TVerificationAutomationMode::Linear) {
-    if (totalSamples <= 1)
-      return lane.endValue;
-    const float progress = juce::jlimit(
-        0.0f, 1.0f,
-        static_cast<float>(sampleIndex) / static_cast<float>(totalSamples - 1));
-    return lane.startValue + ((lane.endValue - lane.startValue) * progress);
-  }
-
-  const int stepIntervalSamples = juce::jmax(
-      1, juce::roundToInt(juce::jmax(0.001, lane.stepIntervalSeconds) * sampleRate));
-  const int segmentIndex = sampleIndex / stepIntervalSamples;
-  return (segmentIndex % 2 == 0) ? lane.startValue : lane.endValue;
-}
-
 void writeTextArtifact(const juce::File &file, const juce::String &text) {
   juce::ignoreUnused(file.replaceWithText(text, false, false, "\r\n"));
 }
@@ -139,6 +120,7 @@ bool loadManifest(const juce::File &manifestFile,
       lane.startValue = static_cast<float>(laneObject->getProperty("startValue"));
       lane.endValue = static_cast<float>(laneObject->getProperty("endValue"));
       lane.stepIntervalSeconds = static_cast<double>(laneObject->getProperty("stepIntervalSeconds"));
+      lane.sampleAccurate = static_cast<bool>(laneObject->getProperty("sampleAccurate"));
       manifestOut.stimulus.automationLanes.push_back(std::move(lane));
     }
   }
@@ -220,11 +202,13 @@ bool renderCompiledRuntimeWithStimulus(TRuntimeClass &runtimeModule,
   for (int blockStart = 0; blockStart < totalSamples; blockStart += profile.blockSize) {
     const int blockSamples = juce::jmin(profile.blockSize, totalSamples - blockStart);
     for (const auto &resolvedLane : resolvedLanes) {
-      const float value = valueForLaneAtSample(resolvedLane.second, blockStart,
-                                               totalSamples, profile.sampleRate);
-      runtimeModule.setParamById(
-          Teul::makeTeulParamId(resolvedLane.first, resolvedLane.second.paramKey),
-          value);
+      const int paramIndex = runtimeModule.paramIndexForId(
+          Teul::makeTeulParamId(resolvedLane.first, resolvedLane.second.paramKey));
+      for (const auto &change : Teul::makeAutomationChangesForBlock(
+               resolvedLane.second, blockStart, blockSamples, totalSamples,
+               profile.sampleRate)) {
+        runtimeModule.setParamByIndex(paramIndex, change.value, change.sampleOffset);
+      }
     }
 
     juce::AudioBuffer<float> blockBuffer(profile.outputChannels, blockSamples);
@@ -303,11 +287,18 @@ bool renderRuntimeGraphWithStimulus(const Teul::TNodeRegistry &registry,
   for (int blockStart = 0; blockStart < totalSamples; blockStart += profile.blockSize) {
     const int blockSamples = juce::jmin(profile.blockSize, totalSamples - blockStart);
     for (const auto &resolvedLane : resolvedLanes) {
-      const float value = valueForLaneAtSample(resolvedLane.second, blockStart,
-                                               totalSamples, profile.sampleRate);
-      runtime.setParam(
-          Teul::makeTeulParamId(resolvedLane.first, resolvedLane.second.paramKey),
-          value);
+      for (const auto &change : Teul::makeAutomationChangesForBlock(
+               resolvedLane.second, blockStart, blockSamples, totalSamples,
+               profile.sampleRate)) {
+        if (change.sampleOffset == 0) {
+          runtime.setParam(
+              Teul::makeTeulParamId(resolvedLane.first, resolvedLane.second.paramKey),
+              change.value);
+        } else {
+          runtime.queueParameterChange(resolvedLane.first, resolvedLane.second.paramKey,
+                                       change.value, change.sampleOffset);
+        }
+      }
     }
 
     juce::AudioBuffer<float> blockBuffer(profile.outputChannels, blockSamples);
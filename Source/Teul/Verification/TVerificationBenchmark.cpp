@@ -34,6 +34,15 @@ juce::var makeArtifactFileEntry(const juce::String &role,
   entry->setProperty("exists", file.exists());
   return juce::var(entry);
 }
+// Wall-clock speedup is only a gate on optimised builds with enough physical
+// cores to spread the helpers; elsewhere it is reported but not checked.
+bool canEnforceParallelSpeedup() {
+#if JUCE_DEBUG
+  return false;
+#else
+  return juce::SystemStats::getNumPhysicalCpus() >= 4;
+#endif
+}
 bool isFiniteRuntimeStats(const TGraphRuntime::RuntimeStats &stats) {
   return std::isfinite(stats.sampleRate) && std::isfinite(stats.cpuLoadPercent) &&
          std::isfinite(stats.lastBuildMilliseconds) &&
@@ -51,6 +60,17 @@ TGraphRuntime::RuntimeStats maxRuntimeStats(const TGraphRuntime::RuntimeStats &l
   result.activeNodeCount = juce::jmax(lhs.activeNodeCount, rhs.activeNodeCount);
   result.allocatedPortChannels =
       juce::jmax(lhs.allocatedPortChannels, rhs.allocatedPortChannels);
+  result.naivePortChannels =
+      juce::jmax(lhs.naivePortChannels, rhs.naivePortChannels);
+  result.aliasedInputCount =
+      juce::jmax(lhs.aliasedInputCount, rhs.aliasedInputCount);
+  result.summedInputCount =
+      juce::jmax(lhs.summedInputCount, rhs.summedInputCount);
+  result.fusedNodeCount = juce::jmax(lhs.fusedNodeCount, rhs.fusedNodeCount);
+  result.lastSkippedNodeCount =
+      juce::jmax(lhs.lastSkippedNodeCount, rhs.lastSkippedNodeCount);
+  result.meteredPortCount =
+      juce::jmax(lhs.meteredPortCount, rhs.meteredPortCount);
   result.largestBlockSeen = juce::jmax(lhs.largestBlockSeen, rhs.largestBlockSeen);
   result.largestOutputChannelCountSeen = juce::jmax(
       lhs.largestOutputChannelCountSeen, rhs.largestOutputChannelCountSeen);
@@ -64,8 +84,30 @@ TGraphRuntime::RuntimeStats maxRuntimeStats(const TGraphRuntime::RuntimeStats &l
   result.paramChangeCount = juce::jmax(lhs.paramChangeCount, rhs.paramChangeCount);
   result.droppedParamChangeCount =
       juce::jmax(lhs.droppedParamChangeCount, rhs.droppedParamChangeCount);
-  result.droppedParamNotificationCount = juce::jmax(
-      lhs.droppedParamNotificationCount, rhs.droppedParamNotificationCount);
+  result.coalescedParamChangeCount =
+      juce::jmax(lhs.coalescedParamChangeCount, rhs.coalescedParamChangeCount);
+  result.droppedMidiEventCount =
+      juce::jmax(lhs.droppedMidiEventCount, rhs.droppedMidiEventCount);
+  result.overBudgetBlockCount =
+      juce::jmax(lhs.overBudgetBlockCount, rhs.overBudgetBlockCount);
+  result.shedEventCount = juce::jmax(lhs.shedEventCount, rhs.shedEventCount);
+  result.restoreEventCount =
+      juce::jmax(lhs.restoreEventCount, rhs.restoreEventCount);
+  result.shedNodeCount = juce::jmax(lhs.shedNodeCount, rhs.shedNodeCount);
+  result.activeVoiceCount =
+      juce::jmax(lhs.activeVoiceCount, rhs.activeVoiceCount);
+  result.voiceStealCount = juce::jmax(lhs.voiceStealCount, rhs.voiceStealCount);
+  result.activeStreamCount =
+      juce::jmax(lhs.activeStreamCount, rhs.activeStreamCount);
+  result.diskUnderrunCount =
+      juce::jmax(lhs.diskUnderrunCount, rhs.diskUnderrunCount);
+  result.skippedNodeCount =
+      juce::jmax(lhs.skippedNodeCount, rhs.skippedNodeCount);
+  result.splitBlockCount = juce::jmax(lhs.splitBlockCount, rhs.splitBlockCount);
+  result.chunkedBlockCount =
+      juce::jmax(lhs.chunkedBlockCount, rhs.chunkedBlockCount);
+  result.lastSubBlockCount =
+      juce::jmax(lhs.lastSubBlockCount, rhs.lastSubBlockCount);
   result.activeGeneration = juce::jmax(lhs.activeGeneration, rhs.activeGeneration);
   result.pendingGeneration = juce::jmax(lhs.pendingGeneration, rhs.pendingGeneration);
   result.rebuildPending = lhs.rebuildPending || rhs.rebuildPending;
@@ -74,14 +116,37 @@ TGraphRuntime::RuntimeStats maxRuntimeStats(const TGraphRuntime::RuntimeStats &l
   result.xrunDetected = lhs.xrunDetected || rhs.xrunDetected;
   result.mutedFallbackActive = lhs.mutedFallbackActive || rhs.mutedFallbackActive;
   result.cpuLoadPercent = juce::jmax(lhs.cpuLoadPercent, rhs.cpuLoadPercent);
+  result.blockLoadP50 = juce::jmax(lhs.blockLoadP50, rhs.blockLoadP50);
+  result.blockLoadP99 = juce::jmax(lhs.blockLoadP99, rhs.blockLoadP99);
+  result.blockLoadP999 = juce::jmax(lhs.blockLoadP999, rhs.blockLoadP999);
+  result.blockLoadMax = juce::jmax(lhs.blockLoadMax, rhs.blockLoadMax);
+  result.smoothedBlockLoad =
+      juce::jmax(lhs.smoothedBlockLoad, rhs.smoothedBlockLoad);
   result.lastBuildMilliseconds =
       juce::jmax(lhs.lastBuildMilliseconds, rhs.lastBuildMilliseconds);
   result.maxBuildMilliseconds =
       juce::jmax(lhs.maxBuildMilliseconds, rhs.maxBuildMilliseconds);
+  result.lastBuildReusedNodeCount =
+      juce::jmax(lhs.lastBuildReusedNodeCount, rhs.lastBuildReusedNodeCount);
+  result.lastBuildCreatedNodeCount =
+      juce::jmax(lhs.lastBuildCreatedNodeCount, rhs.lastBuildCreatedNodeCount);
+  result.lastBuildDestroyedNodeCount =
+      juce::jmax(lhs.lastBuildDestroyedNodeCount, rhs.lastBuildDestroyedNodeCount);
   result.lastProcessMilliseconds =
       juce::jmax(lhs.lastProcessMilliseconds, rhs.lastProcessMilliseconds);
   result.maxProcessMilliseconds =
       juce::jmax(lhs.maxProcessMilliseconds, rhs.maxProcessMilliseconds);
+  result.maxCommitBlockMilliseconds =
+      juce::jmax(lhs.maxCommitBlockMilliseconds, rhs.maxCommitBlockMilliseconds);
+  result.deferredFreesPending =
+      juce::jmax(lhs.deferredFreesPending, rhs.deferredFreesPending);
+  result.workerCount = juce::jmax(lhs.workerCount, rhs.workerCount);
+  result.parallelBlockCount =
+      juce::jmax(lhs.parallelBlockCount, rhs.parallelBlockCount);
+  for (std::size_t index = 0; index < result.workerBusyMilliseconds.size(); ++index) {
+    result.workerBusyMilliseconds[index] = juce::jmax(
+        lhs.workerBusyMilliseconds[index], rhs.workerBusyMilliseconds[index]);
+  }
   return result;
 }
 struct BenchmarkCaseSpec {
@@ -115,6 +180,10 @@ std::vector<BenchmarkCaseSpec> makeRepresentativeBenchmarkCases() {
                    makeStepAutomationStimulus("Delay", "mix", 0.15f, 0.75f,
                                               0.25),
                    {1.00f, 0.50, 5.0}});
+  cases.push_back({"G6",
+                   makePrimaryVerificationRenderProfile(),
+                   makeSweepAutomationStimulus("Pan 1", "pan", -1.0f, 1.0f),
+                   {8.00f, 1.20, 12.0, 1.15}});
   return cases;
 }
 juce::File makeSuiteArtifactDirectory(const juce::String &suiteId) {
@@ -245,6 +314,16 @@ juce::String buildFailureReason(const TVerificationBenchmarkCaseReport &report)
             << " > " << juce::String(report.thresholds.maxBuildMilliseconds, 6)
             << ")";
   }
+  if (report.parallelSpeedupEnforced &&
+      report.thresholds.minParallelSpeedup > 0.0 &&
+      report.worstRuntimeStats.parallelBlockCount > 0 &&
+      report.parallelSpeedup < report.thresholds.minParallelSpeedup) {
+    if (failure.isNotEmpty())
+      failure << "; ";
+    failure << "parallelSpeedup below baseline ("
+            << juce::String(report.parallelSpeedup, 6) << " < "
+            << juce::String(report.thresholds.minParallelSpeedup, 6) << ")";
+  }
   return failure;
 }
 juce::String buildBenchmarkCaseSummaryText(
@@ -274,6 +353,33 @@ juce::String buildBenchmarkCaseSummaryText(
   summary << "worstMaxBuildMilliseconds="
           << juce::String(report.worstRuntimeStats.maxBuildMilliseconds, 6)
           << "\r\n";
+  summary << "workerCount=" << report.worstRuntimeStats.workerCount << "\r\n";
+  summary << "parallelBlockCount="
+          << juce::String(static_cast<juce::int64>(
+                 report.worstRuntimeStats.parallelBlockCount))
+          << "\r\n";
+  for (int index = 0; index < report.worstRuntimeStats.workerCount &&
+                      index < static_cast<int>(
+                                  report.worstRuntimeStats.workerBusyMilliseconds.size());
+       ++index) {
+    summary << "worker" << index << "BusyMilliseconds="
+            << juce::String(report.worstRuntimeStats
+                                .workerBusyMilliseconds[static_cast<std::size_t>(index)],
+                            6)
+            << "\r\n";
+  }
+  if (report.thresholds.minParallelSpeedup > 0.0) {
+    summary << "thresholdMinParallelSpeedup="
+            << juce::String(report.thresholds.minParallelSpeedup, 6) << "\r\n";
+    summary << "serialRenderMilliseconds="
+            << juce::String(report.serialRenderMilliseconds, 6) << "\r\n";
+    summary << "parallelRenderMilliseconds="
+            << juce::String(report.parallelRenderMilliseconds, 6) << "\r\n";
+    summary << "parallelSpeedup=" << juce::String(report.parallelSpeedup, 6)
+            << "\r\n";
+    summary << "parallelSpeedupEnforced="
+            << (report.parallelSpeedupEnforced ? "true" : "false") << "\r\n";
+  }
   if (report.failureReason.isNotEmpty())
     summary << "failureReason=" << report.failureReason << "\r\n";
   return summary;
@@ -305,6 +411,20 @@ juce::var makeBenchmarkCaseArtifactBundle(const juce::File &artifactDirectory,
                     report.worstRuntimeStats.maxProcessMilliseconds);
   root->setProperty("worstMaxBuildMilliseconds",
                     report.worstRuntimeStats.maxBuildMilliseconds);
+  root->setProperty("workerCount", report.worstRuntimeStats.workerCount);
+  root->setProperty("parallelBlockCount",
+                    static_cast<juce::int64>(
+                        report.worstRuntimeStats.parallelBlockCount));
+  if (report.thresholds.minParallelSpeedup > 0.0) {
+    root->setProperty("thresholdMinParallelSpeedup",
+                      report.thresholds.minParallelSpeedup);
+    root->setProperty("serialRenderMilliseconds", report.serialRenderMilliseconds);
+    root->setProperty("parallelRenderMilliseconds",
+                      report.parallelRenderMilliseconds);
+    root->setProperty("parallelSpeedup", report.parallelSpeedup);
+    root->setProperty("parallelSpeedupEnforced",
+                      report.parallelSpeedupEnforced);
+  }
   if (report.failureReason.isNotEmpty())
     root->setProperty("failureReason", report.failureReason);
   root->setProperty("files", juce::var(files));
@@ -419,7 +539,7 @@ bool runRepresentativeBenchmarkGate(const TNodeRegistry &registry,
     ~ArtifactScope() { finalizeBenchmarkSuiteArtifacts(directory, report); }
   } artifactScope{suiteArtifactDirectory, reportOut};
   const auto caseSpecs = makeRepresentativeBenchmarkCases();
-  const auto fixtures = makeRepresentativeVerificationGraphSet(registry);
+  const auto fixtures = makeBenchmarkVerificationGraphSet(registry);
   for (const auto &caseSpec : caseSpecs) {
     TVerificationBenchmarkCaseReport caseReport;
     caseReport.graphId = caseSpec.fixtureId;
@@ -427,6 +547,7 @@ bool runRepresentativeBenchmarkGate(const TNodeRegistry &registry,
     caseReport.profileId = caseSpec.profile.profileId;
     caseReport.iterationCount = reportOut.iterationCount;
     caseReport.thresholds = caseSpec.thresholds;
+    caseReport.parallelSpeedupEnforced = canEnforceParallelSpeedup();
     const auto *fixture = findFixtureById(fixtures, caseSpec.fixtureId);
     if (fixture == nullptr) {
       caseReport.failureReason = "Representative benchmark fixture was not found.";
@@ -460,6 +581,21 @@ bool runRepresentativeBenchmarkGate(const TNodeRegistry &registry,
               juce::String(iteration + 1) + ".";
           break;
         }
+        if (caseSpec.thresholds.minParallelSpeedup > 0.0) {
+          auto serialProfile = caseSpec.profile;
+          serialProfile.workerThreadCount = 0;
+          TVerificationRenderResult serialResult;
+          if (!renderGraphWithStimulus(registry, fixture->document, serialProfile,
+                                       caseSpec.stimulus, serialResult,
+                                       &renderError)) {
+            caseReport.failureReason =
+                "Serial reference render failed at iteration " +
+                juce::String(iteration + 1) + ": " + renderError;
+            break;
+          }
+          caseReport.serialRenderMilliseconds += serialResult.renderMilliseconds;
+          caseReport.parallelRenderMilliseconds += renderResult.renderMilliseconds;
+        }
         caseReport.totalRenderedSamples += renderResult.totalSamples;
         caseReport.totalRenderedBlocks += renderResult.renderedBlockCount;
         caseReport.worstRuntimeStats =
@@ -468,6 +604,10 @@ bool runRepresentativeBenchmarkGate(const TNodeRegistry &registry,
                 : maxRuntimeStats(caseReport.worstRuntimeStats,
                                   renderResult.runtimeStats);
       }
+      if (caseReport.parallelRenderMilliseconds > 0.0) {
+        caseReport.parallelSpeedup = caseReport.serialRenderMilliseconds /
+                                     caseReport.parallelRenderMilliseconds;
+      }
       if (caseReport.failureReason.isEmpty())
         caseReport.failureReason = buildFailureReason(caseReport);
       caseReport.passed = caseReport.failureReason.isEmpty();
@@ -6,6 +6,7 @@ struct TVerificationBenchmarkThresholds {
   float maxCpuLoadPercent = 0.0f;
   double maxProcessMilliseconds = 0.0;
   double maxBuildMilliseconds = 0.0;
+  double minParallelSpeedup = 0.0;
 };
 struct TVerificationBenchmarkCaseReport {
   juce::String graphId;
@@ -19,6 +20,10 @@ struct TVerificationBenchmarkCaseReport {
   juce::String failureReason;
   TVerificationBenchmarkThresholds thresholds;
   TGraphRuntime::RuntimeStats worstRuntimeStats;
+  double serialRenderMilliseconds = 0.0;
+  double parallelRenderMilliseconds = 0.0;
+  double parallelSpeedup = 0.0;
+  bool parallelSpeedupEnforced = false;
 };
 struct TVerificationBenchmarkSuiteReport {
   juce::String suiteId;
@@ -244,6 +244,10 @@ std::vector<CompiledParityCaseSpec> makeRepresentativeCaseSpecs(
       {"G2", makePrimaryVerificationRenderProfile(), makeSweepAutomationStimulus("LowPass", "cutoff", 320.0f, 7200.0f)},
       {"G4", makePrimaryVerificationRenderProfile(), makeMidiPhraseStimulus()},
       {"G5", makePrimaryVerificationRenderProfile(), makeStepAutomationStimulus("Delay", "mix", 0.15f, 0.75f, 0.25)},
+      {"G7", makePrimaryVerificationRenderProfile(), makeMidiChordStimulus()},
+      {"G7", makeSecondaryVerificationRenderProfile(), makeMidiChordStimulus()},
+      {"G8", makePrimaryVerificationRenderProfile(), makeSampleAccurateStepStimulus("Limit", "max", 0.5f, 0.2f, 0.0105)},
+      {"G8", makeSecondaryVerificationRenderProfile(), makeSampleAccurateStepStimulus("Limit", "max", 0.5f, 0.2f, 0.0105)},
   };
 
   std::vector<CompiledParityCaseSpec> caseSpecs;
@@ -311,6 +315,7 @@ juce::var makeManifestJson(const CompiledParityCaseSpec &caseSpec,
     laneObject->setProperty("startValue", lane.startValue);
     laneObject->setProperty("endValue", lane.endValue);
     laneObject->setProperty("stepIntervalSeconds", lane.stepIntervalSeconds);
+    laneObject->setProperty("sampleAccurate", lane.sampleAccurate);
     laneArray.add(juce::var(laneObject));
   }
   stimulusObject->setProperty("automationLanes", juce::var(laneArray));
@@ -742,7 +747,7 @@ bool runRepresentativeCompiledRuntimeParity(
     return false;
   }
 
-  const auto fixtures = makeRepresentativeVerificationGraphSet(registry);
+  const auto fixtures = makeCompiledParityVerificationGraphSet(registry);
   juce::String errorMessage;
   auto caseSpecs = makeRepresentativeCaseSpecs(fixtures, suiteDirectory, &errorMessage);
   if (caseSpecs.empty()) {
@@ -0,0 +1,889 @@
+#include "Teul/Verification/TVerificationDspKernels.h"
+#include "Teul/Registry/TNodeRegistry.h"
+#include "Teul/Runtime/TDelayEffects.h"
+#include "Teul/Runtime/TExpressionTape.h"
+#include "Teul/Runtime/TNodeInstance.h"
+#include "Teul/Runtime/TOscillatorBank.h"
+#include "Teul/Runtime/TSampleStreamer.h"
+#include "Teul/Runtime/TStateVariableFilter.h"
+#include <array>
+#include <cmath>
+#include <complex>
+#include <functional>
+#include <iterator>
+#include <limits>
+namespace Teul {
+namespace {
+constexpr double kKernelSampleRate = 48000.0;
+constexpr int kKernelBlockSize = 256;
+constexpr int kSpectrumSize = 8192;
+juce::String sanitizePathFragment(const juce::String &text) {
+  juce::String cleaned;
+  for (const auto ch : text) {
+    if (juce::CharacterFunctions::isLetterOrDigit(ch))
+      cleaned << ch;
+    else
+      cleaned << '_';
+  }
+  return cleaned.trimCharactersAtEnd("_").trimCharactersAtStart("_");
+}
+void writeTextArtifact(const juce::File &file, const juce::String &text) {
+  juce::ignoreUnused(file.replaceWithText(text, false, false, "\r\n"));
+}
+void writeJsonArtifact(const juce::File &file, const juce::var &json) {
+  juce::ignoreUnused(file.replaceWithText(juce::JSON::toString(json, true), false,
+                                          false, "\r\n"));
+}
+juce::String relativeArtifactPath(const juce::File &root, const juce::File &file) {
+  const auto path = file.getFullPathName();
+  if (path.isEmpty())
+    return {};
+  return file.getRelativePathFrom(root).replaceCharacter('\\', '/');
+}
+juce::var makeArtifactFileEntry(const juce::String &role,
+                                const juce::File &root,
+                                const juce::File &file) {
+  auto *entry = new juce::DynamicObject();
+  entry->setProperty("role", role);
+  entry->setProperty("relativePath", relativeArtifactPath(root, file));
+  entry->setProperty("exists", file.exists());
+  return juce::var(entry);
+}
+// Keeps timed loops from being optimised away.
+volatile float kernelSink = 0.0f;
+struct DspKernelMeasurement {
+  double value = 0.0;
+  double reference = 0.0;
+  bool hasReference = false;
+};
+struct DspKernelCaseSpec {
+  juce::String kernelId;
+  juce::String metricId;
+  double threshold = 0.0;
+  std::function<DspKernelMeasurement(int iterationCount)> measure;
+};
+// The per-sample oscillator the bank replaced: exp2 through std::pow and a
+// waveform switch inside the loop.
+float renderReferenceOscillator(int waveform, float frequency, const float *pitch,
+                                float *output, int numSamples, float phase) {
+  for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
+    const float currentFrequency =
+        pitch != nullptr ? frequency * std::pow(2.0f, pitch[sampleIndex]) : frequency;
+    switch (waveform) {
+    case 1:
+      output[sampleIndex] = 1.0f - 4.0f * std::abs(phase - 0.5f);
+      break;
+    case 2:
+      output[sampleIndex] = phase < 0.5f ? 1.0f : -1.0f;
+      break;
+    case 3:
+      output[sampleIndex] = 1.0f - 2.0f * phase;
+      break;
+    default:
+      output[sampleIndex] = std::sin(phase * juce::MathConstants<float>::twoPi);
+      break;
+    }
+    phase += currentFrequency / (float)kKernelSampleRate;
+    phase -= std::floor(phase);
+  }
+  return phase;
+}
+TOscillatorBank::Block makeBankBlock(int laneCount, float frequency,
+                                     std::vector<std::vector<float>> &outputs) {
+  TOscillatorBank::Block block;
+  block.laneCount = laneCount;
+  block.numSamples = kKernelBlockSize;
+  block.frequency = frequency;
+  block.maxFrequency = (float)(kKernelSampleRate * 0.45);
+  block.inverseSampleRate = 1.0f / (float)kKernelSampleRate;
+  outputs.assign(static_cast<std::size_t>(laneCount),
+                 std::vector<float>(static_cast<std::size_t>(kKernelBlockSize)));
+  for (int lane = 0; lane < laneCount; ++lane) {
+    block.outputs[static_cast<std::size_t>(lane)] =
+        outputs[static_cast<std::size_t>(lane)].data();
+    block.increments[static_cast<std::size_t>(lane)] =
+        frequency * (1.0f + 0.01f * lane) * block.inverseSampleRate;
+  }
+  return block;
+}
+void fft(std::vector<std::complex<double>> &data) {
+  const auto size = data.size();
+  for (std::size_t index = 1, reversed = 0; index < size; ++index) {
+    auto bit = size >> 1;
+    for (; (reversed & bit) != 0; bit >>= 1)
+      reversed ^= bit;
+    reversed ^= bit;
+    if (index < reversed)
+      std::swap(data[index], data[reversed]);
+  }
+  for (std::size_t length = 2; length <= size; length <<= 1) {
+    const double angle = -juce::MathConstants<double>::twoPi / (double)length;
+    const std::complex<double> step(std::cos(angle), std::sin(angle));
+    for (std::size_t start = 0; start < size; start += length) {
+      std::complex<double> twiddle(1.0, 0.0);
+      for (std::size_t offset = 0; offset < length / 2; ++offset) {
+        const auto even = data[start + offset];
+        const auto odd = data[start + offset + length / 2] * twiddle;
+        data[start + offset] = even + odd;
+        data[start + offset + length / 2] = even - odd;
+        twiddle *= step;
+      }
+    }
+  }
+}
+// Power outside the harmonics of a bin-centred fundamental, relative to the
+// power on them, in dB. A Hann window keeps leakage within a few bins of
+// each harmonic.
+double measureAliasDecibels(const std::vector<float> &signal, int fundamentalBin) {
+  std::vector<std::complex<double>> spectrum(static_cast<std::size_t>(kSpectrumSize));
+  for (int index = 0; index < kSpectrumSize; ++index) {
+    const double window =
+        0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * index / kSpectrumSize);
+    spectrum[static_cast<std::size_t>(index)] =
+        window * signal[static_cast<std::size_t>(index)];
+  }
+  fft(spectrum);
+  double harmonicPower = 0.0;
+  double aliasPower = 0.0;
+  for (int bin = 1; bin < kSpectrumSize / 2; ++bin) {
+    const int nearestHarmonic =
+        juce::jmax(1, (bin + fundamentalBin / 2) / fundamentalBin) * fundamentalBin;
+    const double power = std::norm(spectrum[static_cast<std::size_t>(bin)]);
+    if (std::abs(bin - nearestHarmonic) <= 3)
+      harmonicPower += power;
+    else
+      aliasPower += power;
+  }
+  return 10.0 * std::log10(juce::jmax(aliasPower, 1.0e-30) /
+                           juce::jmax(harmonicPower, 1.0e-30));
+}
+DspKernelMeasurement measureOscillatorAlias(TOscillatorWaveform waveform,
+                                            int fundamentalBin) {
+  const float frequency =
+      (float)(fundamentalBin * kKernelSampleRate / kSpectrumSize);
+  std::vector<std::vector<float>> outputs;
+  TOscillatorBank bank;
+  auto block = makeBankBlock(1, frequency, outputs);
+  std::vector<float> bankSignal;
+  while ((int)bankSignal.size() < kSpectrumSize) {
+    bank.render(waveform, block);
+    bankSignal.insert(bankSignal.end(), outputs[0].begin(), outputs[0].end());
+  }
+  std::vector<float> referenceSignal(static_cast<std::size_t>(kSpectrumSize));
+  renderReferenceOscillator(static_cast<int>(waveform), frequency, nullptr,
+                            referenceSignal.data(), kSpectrumSize, 0.0f);
+  return {measureAliasDecibels(bankSignal, fundamentalBin),
+          measureAliasDecibels(referenceSignal, fundamentalBin), true};
+}
+DspKernelMeasurement measureExp2Error() {
+  double maxError = 0.0;
+  for (int step = -20000; step <= 20000; ++step) {
+    const float x = (float)step * 0.0005f;
+    const double exact = std::exp2((double)x);
+    maxError = juce::jmax(maxError, std::abs((double)fastExp2(x) - exact) / exact);
+  }
+  return {maxError, 0.0, false};
+}
+DspKernelMeasurement measureSineError() {
+  std::vector<std::vector<float>> outputs;
+  TOscillatorBank bank;
+  auto block = makeBankBlock(1, 997.0f, outputs);
+  float phase = 0.0f;
+  double maxError = 0.0;
+  for (int blockIndex = 0; blockIndex < 64; ++blockIndex) {
+    bank.render(TOscillatorWaveform::Sine, block);
+    for (int index = 0; index < kKernelBlockSize; ++index) {
+      const double exact = std::sin(juce::MathConstants<double>::twoPi * phase);
+      maxError = juce::jmax(
+          maxError, std::abs((double)outputs[0][static_cast<std::size_t>(index)] - exact));
+      phase += block.increments[0];
+      phase -= phase >= 1.0f ? 1.0f : 0.0f;
+    }
+  }
+  return {maxError, 0.0, false};
+}
+// The control-rate LFO against its exact shape at the fastest rate.
+DspKernelMeasurement measureControlRateError() {
+  TOscillatorBank bank;
+  const float increment = 20.0f / (float)kKernelSampleRate;
+  std::vector<float> output(static_cast<std::size_t>(kKernelBlockSize));
+  double phase = 0.0;
+  double maxError = 0.0;
+  for (int blockIndex = 0; blockIndex < 64; ++blockIndex) {
+    bank.renderControl(TOscillatorWaveform::Sine, increment, output.data(),
+                       kKernelBlockSize);
+    for (int index = 0; index < kKernelBlockSize; ++index) {
+      phase += increment;
+      const double exact = std::sin(juce::MathConstants<double>::twoPi * phase);
+      maxError = juce::jmax(
+          maxError, std::abs((double)output[static_cast<std::size_t>(index)] - exact));
+    }
+  }
+  return {maxError, 0.0, false};
+}
+// Nanoseconds per voice sample for the bank against the per-sample
+// reference, with a pitch input that changes every sample when asked.
+DspKernelMeasurement measureOscillatorThroughput(int laneCount, bool audioRatePitch,
+                                                 int iterationCount) {
+  std::vector<float> pitch(static_cast<std::size_t>(kKernelBlockSize));
+  for (int index = 0; index < kKernelBlockSize; ++index)
+    pitch[static_cast<std::size_t>(index)] = 0.25f * std::sin(0.05f * index);
+  const int blockCount = 512 * juce::jmax(1, iterationCount);
+  const double voiceSamples =
+      (double)blockCount * kKernelBlockSize * (double)laneCount;
+  std::vector<std::vector<float>> outputs;
+  TOscillatorBank bank;
+  auto block = makeBankBlock(laneCount, 220.0f, outputs);
+  if (audioRatePitch) {
+    block.audioRatePitch = true;
+    for (int lane = 0; lane < laneCount; ++lane)
+      block.pitches[static_cast<std::size_t>(lane)] = pitch.data();
+  }
+  const auto bankStart = juce::Time::getHighResolutionTicks();
+  for (int blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+    bank.render(TOscillatorWaveform::Saw, block);
+    kernelSink = kernelSink + outputs[0][0];
+  }
+  const double bankSeconds = juce::Time::highResolutionTicksToSeconds(
+      juce::Time::getHighResolutionTicks() - bankStart);
+  std::vector<float> phases(static_cast<std::size_t>(laneCount), 0.0f);
+  const auto referenceStart = juce::Time::getHighResolutionTicks();
+  for (int blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+    for (int lane = 0; lane < laneCount; ++lane) {
+      auto &output = outputs[static_cast<std::size_t>(lane)];
+      phases[static_cast<std::size_t>(lane)] = renderReferenceOscillator(
+          3, 220.0f * (1.0f + 0.01f * lane), audioRatePitch ? pitch.data() : nullptr,
+          output.data(), kKernelBlockSize, phases[static_cast<std::size_t>(lane)]);
+    }
+    kernelSink = kernelSink + outputs[0][0];
+  }
+  const double referenceSeconds = juce::Time::highResolutionTicksToSeconds(
+      juce::Time::getHighResolutionTicks() - referenceStart);
+  return {bankSeconds * 1.0e9 / voiceSamples,
+          referenceSeconds * 1.0e9 / voiceSamples, true};
+}
+// Steady-state low-pass gain against the analogue prototype the TPT form
+// maps onto through the prewarped bilinear transform.
+DspKernelMeasurement measureFilterResponseError() {
+  constexpr float cutoff = 1000.0f;
+  constexpr float resonance = 2.0f;
+  constexpr int length = 16384;
+  double maxError = 0.0;
+  for (const double frequency : {100.0, 700.0, 1000.0, 1400.0, 5000.0}) {
+    TStateVariableFilter filter;
+    filter.prepare(kKernelSampleRate);
+    filter.setCutoff(cutoff);
+    filter.setResonance(resonance);
+    std::vector<float> input(static_cast<std::size_t>(length));
+    std::vector<float> output(static_cast<std::size_t>(length));
+    for (int index = 0; index < length; ++index) {
+      input[static_cast<std::size_t>(index)] = (float)std::sin(
+          juce::MathConstants<double>::twoPi * frequency * index / kKernelSampleRate);
+    }
+    TStateVariableFilter::Block block;
+    block.inputs[0] = input.data();
+    block.outputs[0] = output.data();
+    block.numSamples = length;
+    filter.render(TStateVariableFilter::Mode::LowPass, block);
+
+    double energy = 0.0;
+    for (int index = length / 2; index < length; ++index)
+      energy += (double)output[static_cast<std::size_t>(index)] *
+                output[static_cast<std::size_t>(index)];
+    const double measured = std::sqrt(2.0 * energy / (length / 2));
+    const double w =
+        std::tan(juce::MathConstants<double>::pi * frequency / kKernelSampleRate) /
+        std::tan(juce::MathConstants<double>::pi * cutoff / kKernelSampleRate);
+    const double k = 1.0 / resonance;
+    const double expected =
+        1.0 / std::sqrt((1.0 - w * w) * (1.0 - w * w) + k * k * w * w);
+    maxError = juce::jmax(maxError, std::abs(20.0 * std::log10(measured / expected)));
+  }
+  return {maxError, 0.0, false};
+}
+// Coefficient sets computed over 512 blocks after the first, with
+// unchanged settings and an unchanged constant Freq CV.
+DspKernelMeasurement measureFilterStaticUpdates() {
+  TStateVariableFilter filter;
+  filter.prepare(kKernelSampleRate);
+  std::vector<float> input(static_cast<std::size_t>(kKernelBlockSize), 0.25f);
+  std::vector<float> output(static_cast<std::size_t>(kKernelBlockSize));
+  TStateVariableFilter::Block block;
+  block.voiceCount = TStateVariableFilter::kMaxVoices;
+  block.numSamples = kKernelBlockSize;
+  for (std::size_t lane = 0; lane < TStateVariableFilter::kMaxLanes; ++lane) {
+    block.inputs[lane] = input.data();
+    block.outputs[lane] = output.data();
+  }
+  block.cvValues.fill(0.5f);
+  filter.render(TStateVariableFilter::Mode::LowPass, block);
+  const auto primed = filter.getCoefficientUpdateCount();
+  for (int blockIndex = 0; blockIndex < 512; ++blockIndex) {
+    filter.setCutoff(1000.0f);
+    filter.render(TStateVariableFilter::Mode::LowPass, block);
+  }
+  return {(double)(filter.getCoefficientUpdateCount() - primed), 0.0, false};
+}
+// The per-channel filter the kernel replaced: one channel at a time, and
+// with a Freq CV input a tan and pow for every sample.
+void renderReferenceFilter(const float *input, const float *cv, float *output,
+                           int numSamples, float cutoff, float damping,
+                           float &ic1eq, float &ic2eq) {
+  float a1 = 0.0f;
+  float a2 = 0.0f;
+  float a3 = 0.0f;
+  for (int index = 0; index < numSamples; ++index) {
+    if (index == 0 || cv != nullptr) {
+      const float frequency = juce::jlimit(
+          20.0f, (float)(kKernelSampleRate * 0.49),
+          cutoff * (cv != nullptr ? std::pow(2.0f, cv[index]) : 1.0f));
+      const float g = (float)std::tan(juce::MathConstants<double>::pi * frequency /
+                                      kKernelSampleRate);
+      a1 = 1.0f / (1.0f + g * (g + damping));
+      a2 = g * a1;
+      a3 = g * a2;
+    }
+    const float v3 = input[index] - ic2eq;
+    const float v1 = a1 * ic1eq + a2 * v3;
+    const float v2 = ic2eq + a2 * ic1eq + a3 * v3;
+    ic1eq = 2.0f * v1 - ic1eq;
+    ic2eq = 2.0f * v2 - ic2eq;
+    output[index] = v2;
+  }
+}
+// Nanoseconds per channel sample for stereo voices against the per-channel
+// reference, with a Freq CV that changes every sample when asked.
+DspKernelMeasurement measureFilterThroughput(int voiceCount, bool audioRateCv,
+                                             int iterationCount) {
+  const int laneCount = 2 * voiceCount;
+  std::vector<float> cv(static_cast<std::size_t>(kKernelBlockSize));
+  std::vector<float> input(static_cast<std::size_t>(kKernelBlockSize));
+  for (int index = 0; index < kKernelBlockSize; ++index) {
+    cv[static_cast<std::size_t>(index)] = std::sin(0.05f * index);
+    input[static_cast<std::size_t>(index)] = std::sin(0.3f * index);
+  }
+  std::vector<std::vector<float>> outputs(
+      static_cast<std::size_t>(laneCount),
+      std::vector<float>(static_cast<std::size_t>(kKernelBlockSize)));
+  const int blockCount = 512 * juce::jmax(1, iterationCount);
+  const double channelSamples =
+      (double)blockCount * kKernelBlockSize * (double)laneCount;
+
+  TStateVariableFilter filter;
+  filter.prepare(kKernelSampleRate);
+  TStateVariableFilter::Block block;
+  block.voiceCount = voiceCount;
+  block.numSamples = kKernelBlockSize;
+  block.audioRateCv = audioRateCv;
+  for (int lane = 0; lane < laneCount; ++lane) {
+    block.inputs[static_cast<std::size_t>(lane)] = input.data();
+    block.outputs[static_cast<std::size_t>(lane)] =
+        outputs[static_cast<std::size_t>(lane)].data();
+  }
+  if (audioRateCv) {
+    for (int voice = 0; voice < voiceCount; ++voice)
+      block.cvInputs[static_cast<std::size_t>(voice)] = cv.data();
+  }
+  const auto kernelStart = juce::Time::getHighResolutionTicks();
+  for (int blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+    filter.render(TStateVariableFilter::Mode::LowPass, block);
+    kernelSink = kernelSink + outputs[0][0];
+  }
+  const double kernelSeconds = juce::Time::highResolutionTicksToSeconds(
+      juce::Time::getHighResolutionTicks() - kernelStart);
+
+  std::vector<float> ic1eq(static_cast<std::size_t>(laneCount), 0.0f);
+  std::vector<float> ic2eq(static_cast<std::size_t>(laneCount), 0.0f);
+  const auto referenceStart = juce::Time::getHighResolutionTicks();
+  for (int blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+    for (int lane = 0; lane < laneCount; ++lane) {
+      const auto index = static_cast<std::size_t>(lane);
+      renderReferenceFilter(input.data(), audioRateCv ? cv.data() : nullptr,
+                            outputs[index].data(), kKernelBlockSize, 1000.0f,
+                            1.0f / 0.707f, ic1eq[index], ic2eq[index]);
+    }
+    kernelSink = kernelSink + outputs[0][0];
+  }
+  const double referenceSeconds = juce::Time::highResolutionTicksToSeconds(
+      juce::Time::getHighResolutionTicks() - referenceStart);
+  return {kernelSeconds * 1.0e9 / channelSamples,
+          referenceSeconds * 1.0e9 / channelSamples, true};
+}
+// A sine delayed by a fractional number of samples against the exact
+// delayed sine, once the time ramp has settled.
+DspKernelMeasurement measureDelayInterpolationError() {
+  constexpr double frequency = 1000.0;
+  constexpr double delaySamples = 100.37;
+  TStereoDelay delay;
+  delay.prepare(kKernelSampleRate);
+  delay.setDelayMs((float)(delaySamples * 1000.0 / kKernelSampleRate));
+  delay.setFeedback(0.0f);
+  delay.setMix(1.0f);
+  std::vector<float> input(static_cast<std::size_t>(kKernelBlockSize));
+  std::vector<float> output(static_cast<std::size_t>(kKernelBlockSize));
+  TStereoDelay::Block block;
+  block.inputs[0] = input.data();
+  block.outputs[0] = output.data();
+  block.numSamples = kKernelBlockSize;
+  double maxError = 0.0;
+  for (int blockIndex = 0; blockIndex < 16; ++blockIndex) {
+    const int start = blockIndex * kKernelBlockSize;
+    for (int index = 0; index < kKernelBlockSize; ++index) {
+      input[static_cast<std::size_t>(index)] = (float)std::sin(
+          juce::MathConstants<double>::twoPi * frequency * (start + index) /
+          kKernelSampleRate);
+    }
+    delay.render(block);
+    if (blockIndex == 0)
+      continue;
+    for (int index = 0; index < kKernelBlockSize; ++index) {
+      const double exact = std::sin(juce::MathConstants<double>::twoPi * frequency *
+                                    (start + index - delaySamples) / kKernelSampleRate);
+      maxError = juce::jmax(
+          maxError, std::abs((double)output[static_cast<std::size_t>(index)] - exact));
+    }
+  }
+  return {maxError, 0.0, false};
+}
+// Heap allocations when a delay line is released and the same size is
+// asked for again, as deleting and re-adding an effect does.
+DspKernelMeasurement measureDelayPoolReuse() {
+  auto &pool = TDelayLinePool::get();
+  { TStereoDelay warm; warm.prepare(kKernelSampleRate); }
+  const auto before = pool.getStats().allocationCount;
+  for (int round = 0; round < 8; ++round) {
+    TStereoDelay delay;
+    delay.prepare(kKernelSampleRate);
+  }
+  return {(double)(pool.getStats().allocationCount - before), 0.0, false};
+}
+// Largest free pool, as a fraction of its cap, while one line is resized
+// through every size up to the cap again and again.
+DspKernelMeasurement measureDelayPoolResize() {
+  auto &pool = TDelayLinePool::get();
+  std::size_t largestPooled = pool.getStats().pooledSampleCount;
+  TDelayLinePool::Lease lease;
+  for (int round = 0; round < 4; ++round) {
+    for (int samples = 1 << 12;
+         samples <= static_cast<int>(TDelayLinePool::kMaxPooledSamples);
+         samples <<= 1) {
+      lease = pool.acquire(samples);
+      largestPooled = juce::jmax(largestPooled, pool.getStats().pooledSampleCount);
+    }
+  }
+  return {(double)largestPooled / (double)TDelayLinePool::kMaxPooledSamples, 0.0,
+          false};
+}
+// Nanoseconds per stereo frame for the delay and the reverb.
+template <typename Effect>
+DspKernelMeasurement measureDelayEffectThroughput(int iterationCount) {
+  std::vector<float> input(static_cast<std::size_t>(kKernelBlockSize));
+  for (int index = 0; index < kKernelBlockSize; ++index)
+    input[static_cast<std::size_t>(index)] = std::sin(0.3f * index);
+  std::vector<float> left(static_cast<std::size_t>(kKernelBlockSize));
+  std::vector<float> right(static_cast<std::size_t>(kKernelBlockSize));
+  Effect effect;
+  effect.prepare(kKernelSampleRate);
+  typename Effect::Block block;
+  block.inputs = {input.data(), input.data()};
+  block.outputs = {left.data(), right.data()};
+  block.numSamples = kKernelBlockSize;
+  const int blockCount = 512 * juce::jmax(1, iterationCount);
+  const auto start = juce::Time::getHighResolutionTicks();
+  for (int blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+    effect.render(block);
+    kernelSink = kernelSink + left[0];
+  }
+  const double seconds = juce::Time::highResolutionTicksToSeconds(
+      juce::Time::getHighResolutionTicks() - start);
+  return {seconds * 1.0e9 / ((double)blockCount * kKernelBlockSize), 0.0, false};
+}
+// A FLAC file three heads long, so two thirds of it stream. FLAC cannot be
+// memory-mapped, which keeps the file off the mapped path.
+juce::File writeStreamedSampleFile() {
+  const auto file = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                        .getChildFile("teul-kernel-streamed-sample.flac");
+  juce::ignoreUnused(file.deleteFile());
+  const int frameCount = 3 * TSampleSource::kHeadFrames;
+  juce::AudioBuffer<float> buffer(2, frameCount);
+  for (int frame = 0; frame < frameCount; ++frame) {
+    buffer.setSample(0, frame, 0.5f * std::sin(0.013f * frame));
+    buffer.setSample(1, frame, 0.5f * std::sin(0.0071f * frame));
+  }
+  auto output = file.createOutputStream();
+  if (output == nullptr)
+    return {};
+  juce::FlacAudioFormat flacFormat;
+  auto *rawStream = output.release();
+  std::unique_ptr<juce::AudioFormatWriter> writer(
+      flacFormat.createWriterFor(rawStream, kKernelSampleRate, 2, 24, {}, 0));
+  if (writer == nullptr) {
+    delete rawStream;
+    return {};
+  }
+  if (!writer->writeFromAudioSampleBuffer(buffer, 0, frameCount))
+    return {};
+  return file;
+}
+struct StreamedPlayback {
+  bool streamed = false;
+  juce::AudioBuffer<float> rendered;
+  std::uint64_t underruns = 0;
+};
+// Plays the file the way a Sampler voice does: resident frames first, then
+// the voice's stream, with a short read counted as an underrun. Paced
+// playback sleeps half a block between blocks; unpaced playback waits for
+// the read-ahead instead, so the rendered audio is complete.
+StreamedPlayback playStreamedSample(const juce::File &file, bool paced) {
+  StreamedPlayback playback;
+  auto &streamer = TSampleStreamer::get();
+  const auto source = streamer.openSource(file);
+  if (source == nullptr ||
+      source->getStorage() != TSampleSource::Storage::Streamed) {
+    return playback;
+  }
+  playback.streamed = true;
+  const auto length = static_cast<int>(source->getLengthInFrames());
+  playback.rendered.setSize(2, length);
+  playback.rendered.clear();
+  TSampleStream stream;
+  streamer.registerStream(stream, *source);
+  stream.start(source->getResidentFrames());
+  const auto underrunsBefore = streamer.getStats().diskUnderrunCount;
+  const int pauseMilliseconds =
+      juce::roundToInt(500.0 * kKernelBlockSize / kKernelSampleRate);
+  for (int start = 0; start < length; start += kKernelBlockSize) {
+    const int wanted = juce::jmin(kKernelBlockSize, length - start);
+    auto *left = playback.rendered.getWritePointer(0, start);
+    auto *right = playback.rendered.getWritePointer(1, start);
+    int fetched = source->readResident(start, left, right, wanted);
+    for (int attempt = 0; fetched < wanted; ++attempt) {
+      fetched += stream.read(start + fetched, left + fetched, right + fetched,
+                             wanted - fetched);
+      if (paced || attempt == 1000)
+        break;
+      if (fetched < wanted)
+        juce::Thread::sleep(1);
+    }
+    if (fetched < wanted)
+      streamer.noteUnderrun();
+    if (paced)
+      juce::Thread::sleep(pauseMilliseconds);
+  }
+  playback.underruns = streamer.getStats().diskUnderrunCount - underrunsBefore;
+  stream.stop();
+  streamer.unregisterStream(stream);
+  return playback;
+}
+// Largest difference between streamed playback and a straight decode of
+// the same file; not finite when the file did not stream.
+DspKernelMeasurement measureStreamedPlaybackError() {
+  const auto file = writeStreamedSampleFile();
+  const auto playback = playStreamedSample(file, false);
+  double maxError = std::numeric_limits<double>::infinity();
+  if (playback.streamed) {
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    const int length = playback.rendered.getNumSamples();
+    juce::AudioBuffer<float> decoded(2, length);
+    if (reader != nullptr && reader->read(&decoded, 0, length, 0, true, true)) {
+      maxError = 0.0;
+      for (int channel = 0; channel < 2; ++channel) {
+        for (int frame = 0; frame < length; ++frame) {
+          maxError = juce::jmax(
+              maxError, (double)std::abs(playback.rendered.getSample(channel, frame) -
+                                         decoded.getSample(channel, frame)));
+        }
+      }
+    }
+  }
+  juce::ignoreUnused(file.deleteFile());
+  return {maxError, 0.0, false};
+}
+// Underruns counted while the same file plays at twice real time; not
+// finite when the file did not stream.
+DspKernelMeasurement measureStreamedUnderruns() {
+  const auto file = writeStreamedSampleFile();
+  const auto playback = playStreamedSample(file, true);
+  juce::ignoreUnused(file.deleteFile());
+  return {playback.streamed ? (double)playback.underruns
+                            : std::numeric_limits<double>::infinity(),
+          0.0, false};
+}
+// Streams a two-voice Sampler registers beyond its two voices; not finite
+// when the file did not stream.
+DspKernelMeasurement measureSamplerStreamRegistration() {
+  const auto registry = makeDefaultNodeRegistry();
+  const auto *desc = registry->descriptorFor("Teul.Source.Sampler");
+  if (desc == nullptr || !desc->instanceFactory)
+    return {std::numeric_limits<double>::infinity(), 0.0, false};
+  const auto file = writeStreamedSampleFile();
+  auto &streamer = TSampleStreamer::get();
+  const int before = streamer.getStats().registeredStreamCount;
+  auto sampler = desc->instanceFactory();
+  sampler->setVoiceCount(2);
+  sampler->setParameterText(0, file.getFullPathName());
+  const int registered = streamer.getStats().registeredStreamCount - before;
+  sampler.reset();
+  juce::ignoreUnused(file.deleteFile());
+  return {registered > 0 ? (double)std::abs(registered - 2)
+                         : std::numeric_limits<double>::infinity(),
+          0.0, false};
+}
+// Nanoseconds per sample for a chain of eight math ops as one fused tape;
+// the reference runs one tape per op through block buffers, as unfused
+// nodes do.
+DspKernelMeasurement measureExpressionChainThroughput(int iterationCount) {
+  constexpr TExpressionOp chain[] = {
+      TExpressionOp::Add,      TExpressionOp::Multiply, TExpressionOp::Subtract,
+      TExpressionOp::Clamp,    TExpressionOp::ValueMap, TExpressionOp::Divide,
+      TExpressionOp::Add,      TExpressionOp::Multiply};
+  constexpr int chainLength = static_cast<int>(std::size(chain));
+  const std::array<float, TExpressionNodeInstance::kMaxParameters> parameters{
+      {-0.5f, 0.5f, -1.0f, 1.0f}};
+  std::vector<float> x(static_cast<std::size_t>(kKernelBlockSize));
+  std::vector<float> y(static_cast<std::size_t>(kKernelBlockSize));
+  for (int index = 0; index < kKernelBlockSize; ++index) {
+    x[static_cast<std::size_t>(index)] = std::sin(0.05f * index);
+    y[static_cast<std::size_t>(index)] = 1.5f + std::sin(0.3f * index);
+  }
+  const TExpressionTape::Input inputs[] = {{x.data(), 0.0f}, {y.data(), 0.0f}};
+
+  TExpressionTape fused;
+  int result = fused.addInput();
+  const int yRegister = fused.addInput();
+  for (const auto op : chain) {
+    const int other =
+        op == TExpressionOp::Subtract || op == TExpressionOp::Add ? 0 : yRegister;
+    result = fused.addInstruction(op, {{result, other}}, parameters.data());
+  }
+
+  std::vector<TExpressionTape> separate(static_cast<std::size_t>(chainLength));
+  for (int index = 0; index < chainLength; ++index) {
+    auto &tape = separate[static_cast<std::size_t>(index)];
+    tape.addInput();
+    tape.addInput();
+    tape.addInstruction(chain[index], {{0, 1}}, parameters.data());
+  }
+
+  std::vector<std::vector<float>> buffers(
+      static_cast<std::size_t>(chainLength),
+      std::vector<float>(static_cast<std::size_t>(kKernelBlockSize)));
+  const int blockCount = 2048 * juce::jmax(1, iterationCount);
+  const auto fusedStart = juce::Time::getHighResolutionTicks();
+  for (int blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+    fused.run(inputs, buffers[0].data(), kKernelBlockSize);
+    kernelSink = kernelSink + buffers[0][0];
+  }
+  const double fusedSeconds = juce::Time::highResolutionTicksToSeconds(
+      juce::Time::getHighResolutionTicks() - fusedStart);
+
+  const auto separateStart = juce::Time::getHighResolutionTicks();
+  for (int blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+    const float *previous = x.data();
+    for (int index = 0; index < chainLength; ++index) {
+      const auto op = chain[index];
+      const float *other =
+          op == TExpressionOp::Subtract || op == TExpressionOp::Add ? x.data() : y.data();
+      const TExpressionTape::Input operands[] = {{previous, 0.0f}, {other, 0.0f}};
+      auto &output = buffers[static_cast<std::size_t>(index)];
+      separate[static_cast<std::size_t>(index)].run(operands, output.data(),
+                                                    kKernelBlockSize);
+      previous = output.data();
+    }
+    kernelSink = kernelSink + previous[0];
+  }
+  const double separateSeconds = juce::Time::highResolutionTicksToSeconds(
+      juce::Time::getHighResolutionTicks() - separateStart);
+  const double samples = (double)blockCount * kKernelBlockSize;
+  return {fusedSeconds * 1.0e9 / samples, separateSeconds * 1.0e9 / samples, true};
+}
+// Throughput ceilings are loose enough for the Debug build the headless
+// workflow runs; the reference column is the comparison that matters.
+std::vector<DspKernelCaseSpec> makeDspKernelCases() {
+  std::vector<DspKernelCaseSpec> cases;
+  cases.push_back({"fast-exp2", "maxRelativeError", 1.0e-6,
+                   [](int) { return measureExp2Error(); }});
+  cases.push_back({"oscillator-sine", "maxAbsoluteError", 5.0e-6,
+                   [](int) { return measureSineError(); }});
+  cases.push_back({"oscillator-saw-7k", "aliasDecibels", -60.0, [](int) {
+                     return measureOscillatorAlias(TOscillatorWaveform::Saw, 1201);
+                   }});
+  cases.push_back({"oscillator-square-3k5", "aliasDecibels", -60.0, [](int) {
+                     return measureOscillatorAlias(TOscillatorWaveform::Square, 601);
+                   }});
+  cases.push_back({"oscillator-triangle-7k", "aliasDecibels", -60.0, [](int) {
+                     return measureOscillatorAlias(TOscillatorWaveform::Triangle, 1201);
+                   }});
+  cases.push_back({"lfo-control-rate", "maxAbsoluteError", 1.0e-3,
+                   [](int) { return measureControlRateError(); }});
+  cases.push_back({"oscillator-mono", "nanosecondsPerSample", 250.0,
+                   [](int iterations) {
+                     return measureOscillatorThroughput(1, false, iterations);
+                   }});
+  cases.push_back({"oscillator-8-voice-pitch-cv", "nanosecondsPerSample", 250.0,
+                   [](int iterations) {
+                     return measureOscillatorThroughput(TOscillatorBank::kLanes, true,
+                                                        iterations);
+                   }});
+  cases.push_back({"svf-lowpass-response", "maxDecibelError", 0.05,
+                   [](int) { return measureFilterResponseError(); }});
+  cases.push_back({"svf-static-settings", "coefficientUpdates", 0.5,
+                   [](int) { return measureFilterStaticUpdates(); }});
+  cases.push_back({"svf-stereo", "nanosecondsPerSample", 250.0,
+                   [](int iterations) {
+                     return measureFilterThroughput(1, false, iterations);
+                   }});
+  cases.push_back({"svf-8-voice-freq-cv", "nanosecondsPerSample", 250.0,
+                   [](int iterations) {
+                     return measureFilterThroughput(TStateVariableFilter::kMaxVoices,
+                                                    true, iterations);
+                   }});
+  cases.push_back({"delay-fractional-read", "maxAbsoluteError", 5.0e-3,
+                   [](int) { return measureDelayInterpolationError(); }});
+  cases.push_back({"delay-pool-reuse", "heapAllocations", 0.5,
+                   [](int) { return measureDelayPoolReuse(); }});
+  cases.push_back({"delay-pool-resize", "pooledFractionOfCap", 1.0,
+                   [](int) { return measureDelayPoolResize(); }});
+  cases.push_back({"delay-stereo", "nanosecondsPerSample", 250.0,
+                   [](int iterations) {
+                     return measureDelayEffectThroughput<TStereoDelay>(iterations);
+                   }});
+  cases.push_back({"fdn-reverb", "nanosecondsPerSample", 500.0,
+                   [](int iterations) {
+                     return measureDelayEffectThroughput<TFeedbackDelayNetwork>(
+                         iterations);
+                   }});
+  cases.push_back({"sampler-streamed-playback", "maxAbsoluteError", 1.0e-6,
+                   [](int) { return measureStreamedPlaybackError(); }});
+  cases.push_back({"sampler-disk-underruns", "diskUnderruns", 0.5,
+                   [](int) { return measureStreamedUnderruns(); }});
+  cases.push_back({"sampler-voice-streams", "extraStreams", 0.5,
+                   [](int) { return measureSamplerStreamRegistration(); }});
+  cases.push_back({"math-fused-chain", "nanosecondsPerSample", 100.0,
+                   [](int iterations) {
+                     return measureExpressionChainThroughput(iterations);
+                   }});
+  return cases;
+}
+juce::String buildDspKernelSuiteSummaryText(
+    const TVerificationDspKernelSuiteReport &report) {
+  juce::String summary;
+  summary << "suiteId=" << report.suiteId << "\r\n";
+  summary << "passed=" << (report.passed ? "true" : "false") << "\r\n";
+  summary << "iterationCount=" << report.iterationCount << "\r\n";
+  summary << "artifactDirectory=" << report.artifactDirectory << "\r\n";
+  summary << "totalCaseCount=" << report.totalCaseCount << "\r\n";
+  summary << "passedCaseCount=" << report.passedCaseCount << "\r\n";
+  summary << "failedCaseCount=" << report.failedCaseCount << "\r\n\r\n";
+  for (const auto &caseReport : report.caseReports) {
+    summary << "case=" << caseReport.kernelId << "/" << caseReport.metricId << "\r\n";
+    summary << "passed=" << (caseReport.passed ? "true" : "false") << "\r\n";
+    summary << "measured=" << juce::String(caseReport.measuredValue, 9) << "\r\n";
+    summary << "threshold=" << juce::String(caseReport.thresholdValue, 9) << "\r\n";
+    if (caseReport.hasReference) {
+      summary << "reference=" << juce::String(caseReport.referenceValue, 9)
+              << "\r\n";
+    }
+    if (caseReport.failureReason.isNotEmpty())
+      summary << "failureReason=" << caseReport.failureReason << "\r\n";
+    summary << "\r\n";
+  }
+  return summary;
+}
+juce::var makeDspKernelSuiteArtifactBundle(
+    const juce::File &artifactDirectory,
+    const TVerificationDspKernelSuiteReport &report) {
+  juce::Array<juce::var> files;
+  files.add(makeArtifactFileEntry("dspKernelSummary",
+                                  artifactDirectory,
+                                  artifactDirectory.getChildFile("dsp-kernel-summary.txt")));
+  juce::Array<juce::var> cases;
+  for (const auto &caseReport : report.caseReports) {
+    auto *entry = new juce::DynamicObject();
+    entry->setProperty("kernelId", caseReport.kernelId);
+    entry->setProperty("metricId", caseReport.metricId);
+    entry->setProperty("passed", caseReport.passed);
+    entry->setProperty("measured", caseReport.measuredValue);
+    entry->setProperty("threshold", caseReport.thresholdValue);
+    if (caseReport.hasReference)
+      entry->setProperty("reference", caseReport.referenceValue);
+    if (caseReport.failureReason.isNotEmpty())
+      entry->setProperty("failureReason", caseReport.failureReason);
+    cases.add(juce::var(entry));
+  }
+  auto *root = new juce::DynamicObject();
+  root->setProperty("kind", "teul-verification-artifact-bundle");
+  root->setProperty("scope", "dsp-kernel-suite");
+  root->setProperty("suiteId", report.suiteId);
+  root->setProperty("passed", report.passed);
+  root->setProperty("iterationCount", report.iterationCount);
+  root->setProperty("artifactDirectory", artifactDirectory.getFullPathName());
+  root->setProperty("totalCaseCount", report.totalCaseCount);
+  root->setProperty("passedCaseCount", report.passedCaseCount);
+  root->setProperty("failedCaseCount", report.failedCaseCount);
+  root->setProperty("files", juce::var(files));
+  root->setProperty("cases", juce::var(cases));
+  return juce::var(root);
+}
+void finalizeDspKernelSuiteArtifacts(const juce::File &artifactDirectory,
+                                     const TVerificationDspKernelSuiteReport &report) {
+  juce::ignoreUnused(artifactDirectory.createDirectory());
+  writeTextArtifact(artifactDirectory.getChildFile("dsp-kernel-summary.txt"),
+                    buildDspKernelSuiteSummaryText(report));
+  writeJsonArtifact(artifactDirectory.getChildFile("artifact-bundle.json"),
+                    makeDspKernelSuiteArtifactBundle(artifactDirectory, report));
+}
+juce::File makeDspKernelSuiteArtifactDirectory(const juce::String &suiteId) {
+  return juce::File::getCurrentWorkingDirectory()
+      .getChildFile("Builds")
+      .getChildFile("TeulVerification")
+      .getChildFile("DspKernels")
+      .getChildFile(sanitizePathFragment(suiteId));
+}
+} // namespace
+bool runDspKernelGate(TVerificationDspKernelSuiteReport &reportOut,
+                      int iterationCount) {
+  reportOut = {};
+  reportOut.suiteId = "dsp-kernel-primary";
+  reportOut.iterationCount = juce::jmax(1, iterationCount);
+  const auto suiteArtifactDirectory =
+      makeDspKernelSuiteArtifactDirectory(reportOut.suiteId);
+  reportOut.artifactDirectory = suiteArtifactDirectory.getFullPathName();
+  juce::ignoreUnused(suiteArtifactDirectory.deleteRecursively());
+  juce::ignoreUnused(suiteArtifactDirectory.createDirectory());
+  struct ArtifactScope {
+    juce::File directory;
+    TVerificationDspKernelSuiteReport &report;
+    ~ArtifactScope() { finalizeDspKernelSuiteArtifacts(directory, report); }
+  } artifactScope{suiteArtifactDirectory, reportOut};
+  for (const auto &caseSpec : makeDspKernelCases()) {
+    TVerificationDspKernelCaseReport caseReport;
+    caseReport.kernelId = caseSpec.kernelId;
+    caseReport.metricId = caseSpec.metricId;
+    caseReport.thresholdValue = caseSpec.threshold;
+    const auto measurement = caseSpec.measure(reportOut.iterationCount);
+    caseReport.measuredValue = measurement.value;
+    caseReport.referenceValue = measurement.reference;
+    caseReport.hasReference = measurement.hasReference;
+    if (!std::isfinite(measurement.value)) {
+      caseReport.failureReason = caseSpec.metricId + " is not finite.";
+    } else if (measurement.value > caseSpec.threshold) {
+      caseReport.failureReason = caseSpec.metricId + " exceeded baseline (" +
+                                 juce::String(measurement.value, 9) + " > " +
+                                 juce::String(caseSpec.threshold, 9) + ")";
+    }
+    caseReport.passed = caseReport.failureReason.isEmpty();
+    ++reportOut.totalCaseCount;
+    if (caseReport.passed)
+      ++reportOut.passedCaseCount;
+    else
+      ++reportOut.failedCaseCount;
+    reportOut.caseReports.push_back(caseReport);
+  }
+  reportOut.passed =
+      reportOut.totalCaseCount > 0 && reportOut.failedCaseCount == 0;
+  return reportOut.passed;
+}
+} // namespace Teul
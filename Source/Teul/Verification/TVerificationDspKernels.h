@@ -0,0 +1,31 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+namespace Teul {
+// Every metric is lower-is-better: errors, alias levels in dB and
+// nanoseconds per rendered sample. referenceValue holds the same metric for
+// the straightforward per-sample implementation the kernel replaces, when
+// there is one.
+struct TVerificationDspKernelCaseReport {
+  juce::String kernelId;
+  juce::String metricId;
+  bool passed = false;
+  double measuredValue = 0.0;
+  double thresholdValue = 0.0;
+  double referenceValue = 0.0;
+  bool hasReference = false;
+  juce::String failureReason;
+};
+struct TVerificationDspKernelSuiteReport {
+  juce::String suiteId;
+  bool passed = false;
+  int totalCaseCount = 0;
+  int passedCaseCount = 0;
+  int failedCaseCount = 0;
+  int iterationCount = 0;
+  juce::String artifactDirectory;
+  std::vector<TVerificationDspKernelCaseReport> caseReports;
+};
+bool runDspKernelGate(TVerificationDspKernelSuiteReport &reportOut,
+                      int iterationCount = 8);
+} // namespace Teul
@@ -1,4 +1,5 @@
 #include "Teul/Verification/TVerificationFixtures.h"
+#include <cmath>
 namespace Teul {
 namespace {
 int inferPortChannelIndex(juce::StringRef portName) {
@@ -87,6 +88,42 @@ bool appendStereoOutConnections(TGraphDocument &document,
                                      outputNodeId, "R In");
   return leftOk && rightOk;
 }
+bool addRailInputConnection(TGraphDocument &document,
+                            const juce::String &endpointId,
+                            const juce::String &railPortId,
+                            NodeId toNodeId,
+                            juce::StringRef toPortName) {
+  const auto *toNode = document.findNode(toNodeId);
+  if (toNode == nullptr)
+    return false;
+  const auto *toPort = findPortByName(*toNode, toPortName);
+  if (toPort == nullptr)
+    return false;
+  TConnection connection;
+  connection.connectionId = document.allocConnectionId();
+  connection.from = TEndpoint::makeRailPort(endpointId, railPortId);
+  connection.to = TEndpoint::makeNodePort(toNodeId, toPort->portId);
+  document.connections.push_back(connection);
+  return true;
+}
+bool addRailOutputConnection(TGraphDocument &document,
+                             NodeId fromNodeId,
+                             juce::StringRef fromPortName,
+                             const juce::String &endpointId,
+                             const juce::String &railPortId) {
+  const auto *fromNode = document.findNode(fromNodeId);
+  if (fromNode == nullptr)
+    return false;
+  const auto *fromPort = findPortByName(*fromNode, fromPortName);
+  if (fromPort == nullptr)
+    return false;
+  TConnection connection;
+  connection.connectionId = document.allocConnectionId();
+  connection.from = TEndpoint::makeNodePort(fromNodeId, fromPort->portId);
+  connection.to = TEndpoint::makeRailPort(endpointId, railPortId);
+  document.connections.push_back(connection);
+  return true;
+}
 } // namespace
 TGraphDocument makeVerificationGraphG1TonePath(const TNodeRegistry &registry) {
   TGraphDocument document = makeBaseDocument("G1 Tone Path");
@@ -137,9 +174,8 @@ TGraphDocument makeVerificationGraphG2FilterSweep(const TNodeRegistry &registry)
   document.nodes.push_back(std::move(osc));
   document.nodes.push_back(std::move(filter));
   document.nodes.push_back(std::move(out));
-  addConnection(document, oscId, "Out", filterId, "In");
-  addConnection(document, filterId, "Out", outId, "L In");
-  addConnection(document, filterId, "Out", outId, "R In");
+  addConnection(document, oscId, "Out", filterId, "L In");
+  appendStereoOutConnections(document, filterId, "L Out", "L Out", outId);
   return document;
 }
 TGraphDocument makeVerificationGraphG3StereoMotion(const TNodeRegistry &registry) {
@@ -248,6 +284,194 @@ TGraphDocument makeVerificationGraphG5TimeTail(const TNodeRegistry &registry) {
   addConnection(document, delayId, "Out", outId, "R In");
   return document;
 }
+TGraphDocument makeVerificationGraphG6WideFanout(const TNodeRegistry &registry) {
+  TGraphDocument document = makeBaseDocument("G6 Wide Fanout");
+  const auto *oscDesc = requireDescriptor(registry, "Teul.Source.Oscillator");
+  const auto *panDesc = requireDescriptor(registry, "Teul.Mixer.StereoPanner");
+  const auto *busDesc = requireDescriptor(registry, "Teul.Mixer.StereoMixer4");
+  const auto *outDesc = requireDescriptor(registry, "Teul.Routing.AudioOut");
+  if (oscDesc == nullptr || panDesc == nullptr || busDesc == nullptr ||
+      outDesc == nullptr) {
+    return document;
+  }
+  constexpr int voiceCount = 32;
+  auto connectToBus = [&document](NodeId sourceId, NodeId busId, int slot) {
+    const juce::String slotSuffix(slot + 1);
+    addConnection(document, sourceId, "L Out", busId, "L In " + slotSuffix);
+    addConnection(document, sourceId, "R Out", busId, "R In " + slotSuffix);
+  };
+  auto makeBusLayer = [&](const std::vector<NodeId> &sources, int layer) {
+    std::vector<NodeId> buses;
+    const float x = 560.0f + 240.0f * static_cast<float>(layer);
+    for (std::size_t index = 0; index < sources.size(); ++index) {
+      if (index % 4 == 0) {
+        auto bus = makeNodeFromDescriptor(*busDesc, document, x,
+                                          40.0f + 120.0f * static_cast<float>(buses.size()),
+                                          "Bus " + juce::String(layer + 1) + "." +
+                                              juce::String(buses.size() + 1));
+        for (int slot = 1; slot <= 4; ++slot)
+          bus.params["gain" + juce::String(slot)] = 0.5f;
+        buses.push_back(bus.nodeId);
+        document.nodes.push_back(std::move(bus));
+      }
+      connectToBus(sources[index], buses.back(), static_cast<int>(index % 4));
+    }
+    return buses;
+  };
+  std::vector<NodeId> voices;
+  for (int voice = 0; voice < voiceCount; ++voice) {
+    const float y = 40.0f + 60.0f * static_cast<float>(voice);
+    auto osc = makeNodeFromDescriptor(*oscDesc, document, 80.0f, y,
+                                      "Voice " + juce::String(voice + 1));
+    osc.params["waveform"] = voice % 4;
+    osc.params["frequency"] = 110.0f * std::pow(2.0f, static_cast<float>(voice) / 12.0f);
+    osc.params["gain"] = 0.2f;
+    auto pan = makeNodeFromDescriptor(*panDesc, document, 320.0f, y,
+                                      "Pan " + juce::String(voice + 1));
+    pan.params["pan"] = -1.0f + 2.0f * static_cast<float>(voice) /
+                                    static_cast<float>(voiceCount - 1);
+    const auto oscId = osc.nodeId;
+    const auto panId = pan.nodeId;
+    document.nodes.push_back(std::move(osc));
+    document.nodes.push_back(std::move(pan));
+    addConnection(document, oscId, "Out", panId, "In");
+    voices.push_back(panId);
+  }
+  int layer = 0;
+  auto buses = makeBusLayer(voices, layer);
+  while (buses.size() > 1)
+    buses = makeBusLayer(buses, ++layer);
+  auto out = makeNodeFromDescriptor(*outDesc, document,
+                                    800.0f + 240.0f * static_cast<float>(layer),
+                                    120.0f, "Main Out");
+  out.params["volume"] = 0.9f;
+  const auto outId = out.nodeId;
+  document.nodes.push_back(std::move(out));
+  appendStereoOutConnections(document, buses.front(), "L Out", "R Out", outId);
+  return document;
+}
+TGraphDocument makeVerificationGraphG7PolyRail(const TNodeRegistry &registry) {
+  TGraphDocument document = makeBaseDocument("G7 Poly Rail");
+  const auto *midiToCvDesc = requireDescriptor(registry, "Teul.Midi.MidiToCV");
+  const auto *adsrDesc = requireDescriptor(registry, "Teul.Mod.ADSR");
+  const auto *oscDesc = requireDescriptor(registry, "Teul.Source.Oscillator");
+  const auto *vcaDesc = requireDescriptor(registry, "Teul.Mixer.VCA");
+  if (midiToCvDesc == nullptr || adsrDesc == nullptr || oscDesc == nullptr ||
+      vcaDesc == nullptr) {
+    return document;
+  }
+  auto midiToCv = makeNodeFromDescriptor(*midiToCvDesc, document, 80.0f, 80.0f,
+                                         "Voices");
+  midiToCv.params["voices"] = 4;
+  auto adsr = makeNodeFromDescriptor(*adsrDesc, document, 320.0f, 180.0f, "Env");
+  adsr.params["attack"] = 8.0f;
+  adsr.params["decay"] = 90.0f;
+  adsr.params["sustain"] = 0.5f;
+  adsr.params["release"] = 180.0f;
+  auto osc = makeNodeFromDescriptor(*oscDesc, document, 320.0f, 40.0f, "Voice");
+  osc.params["waveform"] = 2;
+  osc.params["frequency"] = 16.3516f;
+  osc.params["gain"] = 0.3f;
+  auto vca = makeNodeFromDescriptor(*vcaDesc, document, 560.0f, 100.0f, "Amp");
+  vca.params["gain"] = 0.8f;
+  const auto midiToCvId = midiToCv.nodeId;
+  const auto adsrId = adsr.nodeId;
+  const auto oscId = osc.nodeId;
+  const auto vcaId = vca.nodeId;
+  document.nodes.push_back(std::move(midiToCv));
+  document.nodes.push_back(std::move(adsr));
+  document.nodes.push_back(std::move(osc));
+  document.nodes.push_back(std::move(vca));
+  addRailInputConnection(document, "midi-in-main", "midi-in-port", midiToCvId,
+                         "MIDI In");
+  addConnection(document, midiToCvId, "V/Oct", oscId, "V/Oct");
+  addConnection(document, midiToCvId, "Gate", adsrId, "Gate");
+  addConnection(document, oscId, "Out", vcaId, "L In");
+  addConnection(document, adsrId, "Env", vcaId, "CV");
+  addRailOutputConnection(document, vcaId, "L Out", "audio-out-main", "audio-out-l");
+  addRailOutputConnection(document, vcaId, "L Out", "audio-out-main", "audio-out-r");
+  return document;
+}
+TGraphDocument makeVerificationGraphG8MathFusion(const TNodeRegistry &registry) {
+  TGraphDocument document = makeBaseDocument("G8 Math Fusion");
+  const auto *lfoDesc = requireDescriptor(registry, "Teul.Source.LFO");
+  const auto *addDesc = requireDescriptor(registry, "Teul.Math.Add");
+  const auto *subtractDesc = requireDescriptor(registry, "Teul.Math.Subtract");
+  const auto *multiplyDesc = requireDescriptor(registry, "Teul.Math.Multiply");
+  const auto *divideDesc = requireDescriptor(registry, "Teul.Math.Divide");
+  const auto *clampDesc = requireDescriptor(registry, "Teul.Math.Clamp");
+  const auto *mapDesc = requireDescriptor(registry, "Teul.Math.ValueMap");
+  const auto *oscDesc = requireDescriptor(registry, "Teul.Source.Oscillator");
+  const auto *vcaDesc = requireDescriptor(registry, "Teul.Mixer.VCA");
+  const auto *outDesc = requireDescriptor(registry, "Teul.Routing.AudioOut");
+  if (lfoDesc == nullptr || addDesc == nullptr || subtractDesc == nullptr ||
+      multiplyDesc == nullptr || divideDesc == nullptr || clampDesc == nullptr ||
+      mapDesc == nullptr || oscDesc == nullptr || vcaDesc == nullptr ||
+      outDesc == nullptr) {
+    return document;
+  }
+  auto lfoA = makeNodeFromDescriptor(*lfoDesc, document, 60.0f, 60.0f, "Mod A");
+  lfoA.params["rate"] = 3.0f;
+  auto lfoB = makeNodeFromDescriptor(*lfoDesc, document, 60.0f, 180.0f, "Mod B");
+  lfoB.params["waveform"] = 1;
+  lfoB.params["rate"] = 0.7f;
+  auto sum = makeNodeFromDescriptor(*addDesc, document, 260.0f, 60.0f, "Sum");
+  auto diff = makeNodeFromDescriptor(*subtractDesc, document, 260.0f, 180.0f, "Diff");
+  auto product = makeNodeFromDescriptor(*multiplyDesc, document, 440.0f, 120.0f,
+                                        "Product");
+  auto ratio = makeNodeFromDescriptor(*divideDesc, document, 620.0f, 120.0f, "Ratio");
+  auto limit = makeNodeFromDescriptor(*clampDesc, document, 800.0f, 120.0f, "Limit");
+  limit.params["min"] = -0.5f;
+  limit.params["max"] = 0.5f;
+  auto depth = makeNodeFromDescriptor(*mapDesc, document, 980.0f, 120.0f, "Depth");
+  depth.params["inMin"] = -0.5f;
+  depth.params["inMax"] = 0.5f;
+  depth.params["outMin"] = 0.0f;
+  depth.params["outMax"] = 1.0f;
+  auto osc = makeNodeFromDescriptor(*oscDesc, document, 980.0f, 0.0f, "Carrier");
+  osc.params["waveform"] = 0;
+  osc.params["frequency"] = 196.0f;
+  osc.params["gain"] = 0.5f;
+  auto vca = makeNodeFromDescriptor(*vcaDesc, document, 1160.0f, 60.0f, "Amp");
+  auto out = makeNodeFromDescriptor(*outDesc, document, 1340.0f, 60.0f, "Main Out");
+  out.params["volume"] = 0.9f;
+  const auto lfoAId = lfoA.nodeId;
+  const auto lfoBId = lfoB.nodeId;
+  const auto sumId = sum.nodeId;
+  const auto diffId = diff.nodeId;
+  const auto productId = product.nodeId;
+  const auto ratioId = ratio.nodeId;
+  const auto limitId = limit.nodeId;
+  const auto depthId = depth.nodeId;
+  const auto oscId = osc.nodeId;
+  const auto vcaId = vca.nodeId;
+  const auto outId = out.nodeId;
+  document.nodes.push_back(std::move(lfoA));
+  document.nodes.push_back(std::move(lfoB));
+  document.nodes.push_back(std::move(sum));
+  document.nodes.push_back(std::move(diff));
+  document.nodes.push_back(std::move(product));
+  document.nodes.push_back(std::move(ratio));
+  document.nodes.push_back(std::move(limit));
+  document.nodes.push_back(std::move(depth));
+  document.nodes.push_back(std::move(osc));
+  document.nodes.push_back(std::move(vca));
+  document.nodes.push_back(std::move(out));
+  addConnection(document, lfoAId, "Out", sumId, "A");
+  addConnection(document, lfoBId, "Out", sumId, "B");
+  addConnection(document, lfoAId, "Out", diffId, "A");
+  addConnection(document, lfoBId, "Out", diffId, "B");
+  addConnection(document, sumId, "A+B", productId, "A");
+  addConnection(document, diffId, "A-B", productId, "B");
+  addConnection(document, productId, "A*B", ratioId, "A");
+  addConnection(document, sumId, "A+B", ratioId, "B");
+  addConnection(document, ratioId, "A/B", limitId, "In");
+  addConnection(document, limitId, "Out", depthId, "In");
+  addConnection(document, oscId, "Out", vcaId, "L In");
+  addConnection(document, depthId, "Out", vcaId, "CV");
+  appendStereoOutConnections(document, vcaId, "L Out", "L Out", outId);
+  return document;
+}
 std::vector<TVerificationGraphFixture>
 makeRepresentativeVerificationGraphSet(const TNodeRegistry &registry) {
   std::vector<TVerificationGraphFixture> fixtures;
@@ -258,4 +482,17 @@ makeRepresentativeVerificationGraphSet(const TNodeRegistry &registry) {
   fixtures.push_back({"G5", "Time Tail", makeVerificationGraphG5TimeTail(registry)});
   return fixtures;
 }
+std::vector<TVerificationGraphFixture>
+makeBenchmarkVerificationGraphSet(const TNodeRegistry &registry) {
+  auto fixtures = makeRepresentativeVerificationGraphSet(registry);
+  fixtures.push_back({"G6", "Wide Fanout", makeVerificationGraphG6WideFanout(registry)});
+  return fixtures;
+}
+std::vector<TVerificationGraphFixture>
+makeCompiledParityVerificationGraphSet(const TNodeRegistry &registry) {
+  auto fixtures = makeRepresentativeVerificationGraphSet(registry);
+  fixtures.push_back({"G7", "Poly Rail", makeVerificationGraphG7PolyRail(registry)});
+  fixtures.push_back({"G8", "Math Fusion", makeVerificationGraphG8MathFusion(registry)});
+  return fixtures;
+}
 } // namespace Teul
\ No newline at end of file
@@ -13,6 +13,13 @@ TGraphDocument makeVerificationGraphG2FilterSweep(const TNodeRegistry &registry)
 TGraphDocument makeVerificationGraphG3StereoMotion(const TNodeRegistry &registry);
 TGraphDocument makeVerificationGraphG4MidiVoice(const TNodeRegistry &registry);
 TGraphDocument makeVerificationGraphG5TimeTail(const TNodeRegistry &registry);
+TGraphDocument makeVerificationGraphG6WideFanout(const TNodeRegistry &registry);
+TGraphDocument makeVerificationGraphG7PolyRail(const TNodeRegistry &registry);
+TGraphDocument makeVerificationGraphG8MathFusion(const TNodeRegistry &registry);
 std::vector<TVerificationGraphFixture>
 makeRepresentativeVerificationGraphSet(const TNodeRegistry &registry);
+std::vector<TVerificationGraphFixture>
+makeBenchmarkVerificationGraphSet(const TNodeRegistry &registry);
+std::vector<TVerificationGraphFixture>
+makeCompiledParityVerificationGraphSet(const TNodeRegistry &registry);
 } // namespace Teul
\ No newline at end of file
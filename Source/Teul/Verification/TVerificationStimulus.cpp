@@ -94,6 +94,65 @@ TVerificationStimulusSpec makeMidiPhraseStimulus() {
       {sampleOffsetForSeconds(1.65), juce::MidiMessage::noteOff(1, 67)});
   return stimulus;
 }
+TVerificationStimulusSpec makeMidiChordStimulus() {
+  TVerificationStimulusSpec stimulus;
+  stimulus.stimulusId = "S6";
+  stimulus.displayName = "MIDI Chords";
+  stimulus.kind = TVerificationStimulusKind::MidiChords;
+  const double sampleRate = 48000.0;
+  auto sampleOffsetForSeconds = [sampleRate](double seconds) {
+    return juce::roundToInt(seconds * sampleRate);
+  };
+  auto addChord = [&](std::initializer_list<int> notes, double onSeconds,
+                      double offSeconds, double strumSeconds) {
+    double noteOnSeconds = onSeconds;
+    for (const int note : notes) {
+      stimulus.midiEvents.push_back(
+          {sampleOffsetForSeconds(noteOnSeconds),
+           juce::MidiMessage::noteOn(1, note, (juce::uint8)100)});
+      stimulus.midiEvents.push_back(
+          {sampleOffsetForSeconds(offSeconds), juce::MidiMessage::noteOff(1, note)});
+      noteOnSeconds += strumSeconds;
+    }
+  };
+  addChord({48, 52, 55, 59}, 0.01, 0.9, 0.013);
+  addChord({50, 53, 57, 60, 64}, 0.7, 1.6, 0.021);
+  return stimulus;
+}
+TVerificationStimulusSpec makeSampleAccurateStepStimulus(const juce::String &nodeLabel,
+                                                         const juce::String &paramKey,
+                                                         float startValue,
+                                                         float endValue,
+                                                         double stepIntervalSeconds) {
+  TVerificationStimulusSpec stimulus;
+  stimulus.stimulusId = "S5";
+  stimulus.displayName = "Sample-Accurate Step";
+  stimulus.kind = TVerificationStimulusKind::SampleAccurateStep;
+  stimulus.automationLanes.push_back(
+      {nodeLabel, paramKey, TVerificationAutomationMode::Step, startValue,
+       endValue, stepIntervalSeconds, true});
+  return stimulus;
+}
+std::vector<TVerificationParamChange>
+makeAutomationChangesForBlock(const TVerificationAutomationLane &lane,
+                              int blockStart,
+                              int blockSamples,
+                              int totalSamples,
+                              double sampleRate) {
+  std::vector<TVerificationParamChange> changes;
+  changes.push_back(
+      {0, valueForLaneAtSample(lane, blockStart, totalSamples, sampleRate)});
+  if (!lane.sampleAccurate || lane.mode != TVerificationAutomationMode::Step)
+    return changes;
+  const int stepIntervalSamples = juce::jmax(
+      1, juce::roundToInt(juce::jmax(0.001, lane.stepIntervalSeconds) * sampleRate));
+  int stepStart = (blockStart / stepIntervalSamples + 1) * stepIntervalSamples;
+  for (; stepStart < blockStart + blockSamples; stepStart += stepIntervalSamples) {
+    changes.push_back({stepStart - blockStart,
+                       valueForLaneAtSample(lane, stepStart, totalSamples, sampleRate)});
+  }
+  return changes;
+}
 bool renderGraphWithStimulus(const TNodeRegistry &registry,
                              const TGraphDocument &document,
                              const TVerificationRenderProfile &profile,
@@ -122,6 +181,8 @@ bool renderGraphWithStimulus(const TNodeRegistry &registry,
     return a.sampleOffset < b.sampleOffset;
   });
   TGraphRuntime runtime(&registry);
+  if (profile.workerThreadCount >= 0)
+    runtime.setWorkerThreadCount(profile.workerThreadCount);
   if (!runtime.buildGraph(document)) {
     writeError(errorMessageOut, "Failed to build verification graph.");
     return false;
@@ -138,13 +199,16 @@ bool renderGraphWithStimulus(const TNodeRegistry &registry,
   resultOut.audioBuffer.clear();
   resultOut.renderedBlockCount = 0;
   std::size_t midiEventIndex = 0;
+  const auto renderStartTicks = juce::Time::getHighResolutionTicks();
   for (int blockStart = 0; blockStart < totalSamples; blockStart += profile.blockSize) {
     const int blockSamples = juce::jmin(profile.blockSize, totalSamples - blockStart);
     for (const auto &resolvedLane : resolvedLanes) {
-      const float value = valueForLaneAtSample(resolvedLane.second, blockStart,
-                                               totalSamples, profile.sampleRate);
-      runtime.queueParameterChange(resolvedLane.first, resolvedLane.second.paramKey,
-                                   value);
+      for (const auto &change : makeAutomationChangesForBlock(
+               resolvedLane.second, blockStart, blockSamples, totalSamples,
+               profile.sampleRate)) {
+        runtime.queueParameterChange(resolvedLane.first, resolvedLane.second.paramKey,
+                                     change.value, change.sampleOffset);
+      }
     }
     juce::AudioBuffer<float> blockBuffer(profile.outputChannels, blockSamples);
     juce::MidiBuffer midiBuffer;
@@ -163,7 +227,12 @@ bool renderGraphWithStimulus(const TNodeRegistry &registry,
     }
     ++resultOut.renderedBlockCount;
   }
+  resultOut.renderMilliseconds = juce::Time::highResolutionTicksToSeconds(
+                                     juce::Time::getHighResolutionTicks() -
+                                     renderStartTicks) *
+                                 1000.0;
   resultOut.runtimeStats = runtime.getRuntimeStats();
+  resultOut.blockLatency = runtime.getBlockLatencyReport();
   return true;
 }
 } // namespace Teul
\ No newline at end of file
@@ -7,6 +7,8 @@ enum class TVerificationStimulusKind {
   StepAutomation,
   SweepAutomation,
   MidiPhrase,
+  SampleAccurateStep,
+  MidiChords,
 };
 enum class TVerificationAutomationMode {
   Step,
@@ -18,6 +20,7 @@ struct TVerificationRenderProfile {
   int blockSize = 128;
   int outputChannels = 2;
   double durationSeconds = 2.0;
+  int workerThreadCount = -1;
 };
 struct TVerificationAutomationLane {
   juce::String nodeLabel;
@@ -26,6 +29,13 @@ struct TVerificationAutomationLane {
   float startValue = 0.0f;
   float endValue = 0.0f;
   double stepIntervalSeconds = 0.25;
+  // Step lanes only: changes land on their own sample instead of the next
+  // block start, so the renderers split the block there.
+  bool sampleAccurate = false;
+};
+struct TVerificationParamChange {
+  int sampleOffset = 0;
+  float value = 0.0f;
 };
 struct TVerificationMidiEvent {
   int sampleOffset = 0;
@@ -45,7 +55,9 @@ struct TVerificationRenderResult {
   juce::AudioBuffer<float> audioBuffer;
   int totalSamples = 0;
   int renderedBlockCount = 0;
+  double renderMilliseconds = 0.0;
   TGraphRuntime::RuntimeStats runtimeStats;
+  TGraphRuntime::BlockLatencyReport blockLatency;
 };
 TVerificationRenderProfile makePrimaryVerificationRenderProfile();
 TVerificationRenderProfile makeSecondaryVerificationRenderProfile();
@@ -61,6 +73,22 @@ TVerificationStimulusSpec makeSweepAutomationStimulus(const juce::String &nodeLa
                                                       float startValue,
                                                       float endValue);
 TVerificationStimulusSpec makeMidiPhraseStimulus();
+// Overlapping chords for polyphonic graphs; the second has one note more
+// than four voices hold, so a voice is stolen.
+TVerificationStimulusSpec makeMidiChordStimulus();
+TVerificationStimulusSpec makeSampleAccurateStepStimulus(const juce::String &nodeLabel,
+                                                         const juce::String &paramKey,
+                                                         float startValue,
+                                                         float endValue,
+                                                         double stepIntervalSeconds);
+// The changes a lane makes in one block, offsets relative to blockStart. The
+// first is always the value at blockStart.
+std::vector<TVerificationParamChange>
+makeAutomationChangesForBlock(const TVerificationAutomationLane &lane,
+                              int blockStart,
+                              int blockSamples,
+                              int totalSamples,
+                              double sampleRate);
 bool renderGraphWithStimulus(const TNodeRegistry &registry,
                              const TGraphDocument &document,
                              const TVerificationRenderProfile &profile,
@@ -1,5 +1,9 @@
 #include "Teul/Verification/TVerificationStress.h"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <functional>
+#include <thread>
 namespace Teul {
 namespace {
 juce::String sanitizePathFragment(const juce::String &text) {
@@ -51,6 +55,17 @@ TGraphRuntime::RuntimeStats maxRuntimeStats(const TGraphRuntime::RuntimeStats &l
   result.activeNodeCount = juce::jmax(lhs.activeNodeCount, rhs.activeNodeCount);
   result.allocatedPortChannels =
       juce::jmax(lhs.allocatedPortChannels, rhs.allocatedPortChannels);
+  result.naivePortChannels =
+      juce::jmax(lhs.naivePortChannels, rhs.naivePortChannels);
+  result.aliasedInputCount =
+      juce::jmax(lhs.aliasedInputCount, rhs.aliasedInputCount);
+  result.summedInputCount =
+      juce::jmax(lhs.summedInputCount, rhs.summedInputCount);
+  result.fusedNodeCount = juce::jmax(lhs.fusedNodeCount, rhs.fusedNodeCount);
+  result.lastSkippedNodeCount =
+      juce::jmax(lhs.lastSkippedNodeCount, rhs.lastSkippedNodeCount);
+  result.meteredPortCount =
+      juce::jmax(lhs.meteredPortCount, rhs.meteredPortCount);
   result.largestBlockSeen = juce::jmax(lhs.largestBlockSeen, rhs.largestBlockSeen);
   result.largestOutputChannelCountSeen = juce::jmax(
       lhs.largestOutputChannelCountSeen, rhs.largestOutputChannelCountSeen);
@@ -64,8 +79,30 @@ TGraphRuntime::RuntimeStats maxRuntimeStats(const TGraphRuntime::RuntimeStats &l
   result.paramChangeCount = juce::jmax(lhs.paramChangeCount, rhs.paramChangeCount);
   result.droppedParamChangeCount =
       juce::jmax(lhs.droppedParamChangeCount, rhs.droppedParamChangeCount);
-  result.droppedParamNotificationCount = juce::jmax(
-      lhs.droppedParamNotificationCount, rhs.droppedParamNotificationCount);
+  result.coalescedParamChangeCount =
+      juce::jmax(lhs.coalescedParamChangeCount, rhs.coalescedParamChangeCount);
+  result.droppedMidiEventCount =
+      juce::jmax(lhs.droppedMidiEventCount, rhs.droppedMidiEventCount);
+  result.overBudgetBlockCount =
+      juce::jmax(lhs.overBudgetBlockCount, rhs.overBudgetBlockCount);
+  result.shedEventCount = juce::jmax(lhs.shedEventCount, rhs.shedEventCount);
+  result.restoreEventCount =
+      juce::jmax(lhs.restoreEventCount, rhs.restoreEventCount);
+  result.shedNodeCount = juce::jmax(lhs.shedNodeCount, rhs.shedNodeCount);
+  result.activeVoiceCount =
+      juce::jmax(lhs.activeVoiceCount, rhs.activeVoiceCount);
+  result.voiceStealCount = juce::jmax(lhs.voiceStealCount, rhs.voiceStealCount);
+  result.activeStreamCount =
+      juce::jmax(lhs.activeStreamCount, rhs.activeStreamCount);
+  result.diskUnderrunCount =
+      juce::jmax(lhs.diskUnderrunCount, rhs.diskUnderrunCount);
+  result.skippedNodeCount =
+      juce::jmax(lhs.skippedNodeCount, rhs.skippedNodeCount);
+  result.splitBlockCount = juce::jmax(lhs.splitBlockCount, rhs.splitBlockCount);
+  result.chunkedBlockCount =
+      juce::jmax(lhs.chunkedBlockCount, rhs.chunkedBlockCount);
+  result.lastSubBlockCount =
+      juce::jmax(lhs.lastSubBlockCount, rhs.lastSubBlockCount);
   result.activeGeneration = juce::jmax(lhs.activeGeneration, rhs.activeGeneration);
   result.pendingGeneration = juce::jmax(lhs.pendingGeneration, rhs.pendingGeneration);
   result.rebuildPending = lhs.rebuildPending || rhs.rebuildPending;
@@ -74,16 +111,106 @@ TGraphRuntime::RuntimeStats maxRuntimeStats(const TGraphRuntime::RuntimeStats &l
   result.xrunDetected = lhs.xrunDetected || rhs.xrunDetected;
   result.mutedFallbackActive = lhs.mutedFallbackActive || rhs.mutedFallbackActive;
   result.cpuLoadPercent = juce::jmax(lhs.cpuLoadPercent, rhs.cpuLoadPercent);
+  result.blockLoadP50 = juce::jmax(lhs.blockLoadP50, rhs.blockLoadP50);
+  result.blockLoadP99 = juce::jmax(lhs.blockLoadP99, rhs.blockLoadP99);
+  result.blockLoadP999 = juce::jmax(lhs.blockLoadP999, rhs.blockLoadP999);
+  result.blockLoadMax = juce::jmax(lhs.blockLoadMax, rhs.blockLoadMax);
+  result.smoothedBlockLoad =
+      juce::jmax(lhs.smoothedBlockLoad, rhs.smoothedBlockLoad);
   result.lastBuildMilliseconds =
       juce::jmax(lhs.lastBuildMilliseconds, rhs.lastBuildMilliseconds);
   result.maxBuildMilliseconds =
       juce::jmax(lhs.maxBuildMilliseconds, rhs.maxBuildMilliseconds);
+  result.lastBuildReusedNodeCount =
+      juce::jmax(lhs.lastBuildReusedNodeCount, rhs.lastBuildReusedNodeCount);
+  result.lastBuildCreatedNodeCount =
+      juce::jmax(lhs.lastBuildCreatedNodeCount, rhs.lastBuildCreatedNodeCount);
+  result.lastBuildDestroyedNodeCount =
+      juce::jmax(lhs.lastBuildDestroyedNodeCount, rhs.lastBuildDestroyedNodeCount);
   result.lastProcessMilliseconds =
       juce::jmax(lhs.lastProcessMilliseconds, rhs.lastProcessMilliseconds);
   result.maxProcessMilliseconds =
       juce::jmax(lhs.maxProcessMilliseconds, rhs.maxProcessMilliseconds);
+  result.maxCommitBlockMilliseconds =
+      juce::jmax(lhs.maxCommitBlockMilliseconds, rhs.maxCommitBlockMilliseconds);
+  result.deferredFreesPending =
+      juce::jmax(lhs.deferredFreesPending, rhs.deferredFreesPending);
+  result.workerCount = juce::jmax(lhs.workerCount, rhs.workerCount);
+  result.parallelBlockCount =
+      juce::jmax(lhs.parallelBlockCount, rhs.parallelBlockCount);
+  for (std::size_t index = 0; index < result.workerBusyMilliseconds.size(); ++index) {
+    result.workerBusyMilliseconds[index] = juce::jmax(
+        lhs.workerBusyMilliseconds[index], rhs.workerBusyMilliseconds[index]);
+  }
   return result;
 }
+// Every runtime uses the same bucket edges, so iterations merge exactly.
+void mergeBlockLoadHistogram(std::vector<TBlockLatencyMonitor::Bucket> &target,
+                             const std::vector<TBlockLatencyMonitor::Bucket> &source) {
+  for (const auto &bucket : source) {
+    auto it = std::lower_bound(target.begin(), target.end(), bucket.upperLoad,
+                               [](const TBlockLatencyMonitor::Bucket &lhs, float load) {
+                                 return lhs.upperLoad < load;
+                               });
+    if (it != target.end() && it->upperLoad == bucket.upperLoad)
+      it->count += bucket.count;
+    else
+      target.insert(it, bucket);
+  }
+}
+void appendRecentXruns(std::vector<TBlockLatencyMonitor::XrunRecord> &target,
+                       const std::vector<TBlockLatencyMonitor::XrunRecord> &source) {
+  target.insert(target.end(), source.begin(), source.end());
+  if (target.size() > static_cast<std::size_t>(TBlockLatencyMonitor::kMaxXruns)) {
+    target.erase(target.begin(),
+                 target.end() - TBlockLatencyMonitor::kMaxXruns);
+  }
+}
+juce::var makeBlockLatencyArtifact(const TVerificationStressCaseReport &report) {
+  juce::Array<juce::var> histogram;
+  for (const auto &bucket : report.blockLoadHistogram) {
+    auto *entry = new juce::DynamicObject();
+    entry->setProperty("upperLoad", bucket.upperLoad);
+    entry->setProperty("count", static_cast<juce::int64>(bucket.count));
+    histogram.add(juce::var(entry));
+  }
+  juce::Array<juce::var> xruns;
+  for (const auto &record : report.recentXruns) {
+    juce::Array<juce::var> topNodes;
+    for (const auto &node : record.topNodes) {
+      if (node.nodeId == kInvalidNodeId)
+        continue;
+      auto *nodeEntry = new juce::DynamicObject();
+      nodeEntry->setProperty("nodeId", static_cast<juce::int64>(node.nodeId));
+      nodeEntry->setProperty("micros", node.micros);
+      topNodes.add(juce::var(nodeEntry));
+    }
+    auto *entry = new juce::DynamicObject();
+    entry->setProperty("blockIndex", static_cast<juce::int64>(record.blockIndex));
+    entry->setProperty("timeMillis", record.timeMillis);
+    entry->setProperty("generation", static_cast<juce::int64>(record.generation));
+    entry->setProperty("elapsedMicros", record.elapsedMicros);
+    entry->setProperty("budgetMicros", record.budgetMicros);
+    entry->setProperty("numSamples", record.numSamples);
+    entry->setProperty("paramChanges", record.paramChanges);
+    entry->setProperty("rebuildCommitted", record.rebuildCommitted);
+    entry->setProperty("paramBurst", record.paramBurst);
+    entry->setProperty("topNodes", juce::var(topNodes));
+    xruns.add(juce::var(entry));
+  }
+  auto *root = new juce::DynamicObject();
+  root->setProperty("kind", "teul-block-latency");
+  root->setProperty("graphId", report.graphId);
+  root->setProperty("overBudgetBlockCount",
+                    static_cast<juce::int64>(report.worstRuntimeStats.overBudgetBlockCount));
+  root->setProperty("worstBlockLoadP50", report.worstRuntimeStats.blockLoadP50);
+  root->setProperty("worstBlockLoadP99", report.worstRuntimeStats.blockLoadP99);
+  root->setProperty("worstBlockLoadP999", report.worstRuntimeStats.blockLoadP999);
+  root->setProperty("worstBlockLoadMax", report.worstRuntimeStats.blockLoadMax);
+  root->setProperty("histogram", juce::var(histogram));
+  root->setProperty("recentXruns", juce::var(xruns));
+  return juce::var(root);
+}
 juce::String buildStressCaseSummaryText(const TVerificationStressCaseReport &report) {
   juce::String summary;
   summary << "graphId=" << report.graphId << "\r\n";
@@ -101,6 +228,16 @@ juce::String buildStressCaseSummaryText(const TVerificationStressCaseReport &rep
           << "\r\n";
   summary << "xrunDetected="
           << (report.worstRuntimeStats.xrunDetected ? "true" : "false") << "\r\n";
+  summary << "overBudgetBlockCount="
+          << juce::String(static_cast<juce::int64>(
+                 report.worstRuntimeStats.overBudgetBlockCount))
+          << "\r\n";
+  summary << "worstBlockLoadP99="
+          << juce::String(report.worstRuntimeStats.blockLoadP99, 6) << "\r\n";
+  summary << "worstBlockLoadMax="
+          << juce::String(report.worstRuntimeStats.blockLoadMax, 6) << "\r\n";
+  summary << "recordedXrunCount=" << static_cast<int>(report.recentXruns.size())
+          << "\r\n";
   summary << "clipDetected="
           << (report.worstRuntimeStats.clipDetected ? "true" : "false") << "\r\n";
   summary << "denormalDetected="
@@ -119,6 +256,9 @@ juce::var makeStressCaseArtifactBundle(const juce::File &artifactDirectory,
   files.add(makeArtifactFileEntry("stressCaseSummary",
                                   artifactDirectory,
                                   artifactDirectory.getChildFile("case-summary.txt")));
+  files.add(makeArtifactFileEntry("blockLatency",
+                                  artifactDirectory,
+                                  artifactDirectory.getChildFile("block-latency.json")));
   auto *root = new juce::DynamicObject();
   root->setProperty("kind", "teul-verification-artifact-bundle");
   root->setProperty("scope", "stress-case");
@@ -134,6 +274,8 @@ juce::var makeStressCaseArtifactBundle(const juce::File &artifactDirectory,
   root->setProperty("worstMaxProcessMilliseconds",
                     report.worstRuntimeStats.maxProcessMilliseconds);
   root->setProperty("xrunDetected", report.worstRuntimeStats.xrunDetected);
+  root->setProperty("worstBlockLoadP99", report.worstRuntimeStats.blockLoadP99);
+  root->setProperty("worstBlockLoadMax", report.worstRuntimeStats.blockLoadMax);
   root->setProperty("clipDetected", report.worstRuntimeStats.clipDetected);
   root->setProperty("denormalDetected", report.worstRuntimeStats.denormalDetected);
   root->setProperty("mutedFallbackActive",
@@ -148,6 +290,8 @@ void finalizeStressCaseArtifacts(const juce::File &artifactDirectory,
   juce::ignoreUnused(artifactDirectory.createDirectory());
   writeTextArtifact(artifactDirectory.getChildFile("case-summary.txt"),
                     buildStressCaseSummaryText(report));
+  writeJsonArtifact(artifactDirectory.getChildFile("block-latency.json"),
+                    makeBlockLatencyArtifact(report));
   writeJsonArtifact(artifactDirectory.getChildFile("artifact-bundle.json"),
                     makeStressCaseArtifactBundle(artifactDirectory, report));
 }
@@ -238,12 +382,10 @@ juce::File makeStressSuiteArtifactDirectory(const juce::String &suiteId) {
       .getChildFile(sanitizePathFragment(suiteId));
 }
 juce::File makeStressCaseArtifactDirectory(const juce::File &suiteDirectory,
-                                           const TVerificationGraphFixture &fixture,
-                                           const TVerificationRenderProfile &profile,
-                                           const TVerificationStimulusSpec &stimulus) {
-  return suiteDirectory.getChildFile(sanitizePathFragment(fixture.fixtureId) + "_" +
-                                     sanitizePathFragment(stimulus.stimulusId) + "_" +
-                                     sanitizePathFragment(profile.profileId));
+                                           const TVerificationStressCaseReport &report) {
+  return suiteDirectory.getChildFile(sanitizePathFragment(report.graphId) + "_" +
+                                     sanitizePathFragment(report.stimulusId) + "_" +
+                                     sanitizePathFragment(report.profileId));
 }
 const TVerificationGraphFixture *findFixtureById(
     const std::vector<TVerificationGraphFixture> &fixtures,
@@ -254,6 +396,177 @@ const TVerificationGraphFixture *findFixtureById(
   }
   return nullptr;
 }
+using StressContractCheck = std::function<juce::String(
+    const TNodeRegistry &, const TGraphDocument &, int, TVerificationStressCaseReport &)>;
+struct StressContractSpec {
+  juce::String fixtureId;
+  juce::String checkId;
+  StressContractCheck check;
+};
+NodeId findNodeIdByLabel(const TGraphDocument &document, const juce::String &label) {
+  for (const auto &node : document.nodes) {
+    if (node.label.equalsIgnoreCase(label))
+      return node.nodeId;
+  }
+  return kInvalidNodeId;
+}
+// The document with one node swapped for a copy under a fresh id, so the
+// copy's parameters are new to the runtime and may take retired cells.
+TGraphDocument replaceNodeWithCopy(const TGraphDocument &document, NodeId nodeId,
+                                   NodeId &copyIdOut) {
+  TGraphDocument replaced = document;
+  copyIdOut = replaced.allocNodeId();
+  for (auto &node : replaced.nodes) {
+    if (node.nodeId != nodeId)
+      continue;
+    node.nodeId = copyIdOut;
+    for (auto &port : node.ports)
+      port.ownerNodeId = copyIdOut;
+  }
+  for (auto &connection : replaced.connections) {
+    if (connection.from.nodeId == nodeId)
+      connection.from.nodeId = copyIdOut;
+    if (connection.to.nodeId == nodeId)
+      connection.to.nodeId = copyIdOut;
+  }
+  return replaced;
+}
+// Another thread keeps queueing a sentinel for the probe node's gain while
+// the graph is rebuilt without and with that node. None of the copies that
+// stand in for it may ever read the sentinel.
+juce::String checkParamRoutesAcrossRebuilds(const TNodeRegistry &registry,
+                                            const TGraphDocument &document,
+                                            int iterationCount,
+                                            TVerificationStressCaseReport &report) {
+  constexpr float sentinel = 3.0f;
+  constexpr int rebuildsPerIteration = 16;
+  const auto profile = makePrimaryVerificationRenderProfile();
+  const NodeId probeId = findNodeIdByLabel(document, "Tone");
+  const auto *probe = document.findNode(probeId);
+  if (probe == nullptr)
+    return "Parameter route check needs the Tone node.";
+
+  TGraphRuntime runtime(&registry);
+  if (!runtime.buildGraph(document))
+    return "Failed to build the parameter route check graph.";
+  runtime.setCurrentChannelLayout(0, profile.outputChannels);
+  runtime.prepareToPlay(profile.sampleRate, profile.blockSize);
+
+  std::atomic<bool> stopProducer{false};
+  std::thread producer([&] {
+    while (!stopProducer.load(std::memory_order_relaxed))
+      runtime.queueParameterChange(probeId, "gain", sentinel);
+  });
+
+  juce::String failureReason;
+  juce::AudioBuffer<float> block(profile.outputChannels, profile.blockSize);
+  juce::MidiBuffer midi;
+  const int rebuildCount = iterationCount * rebuildsPerIteration;
+  for (int rebuild = 0; rebuild < rebuildCount && failureReason.isEmpty(); ++rebuild) {
+    NodeId copyId = kInvalidNodeId;
+    const bool withProbe = rebuild % 2 == 1;
+    if (!runtime.buildGraph(withProbe ? document
+                                      : replaceNodeWithCopy(document, probeId, copyId))) {
+      failureReason = "Parameter route check failed to rebuild.";
+      break;
+    }
+    for (int blockIndex = 0; blockIndex < 2; ++blockIndex) {
+      block.clear();
+      runtime.processBlock(block, midi);
+      ++report.totalRenderedBlocks;
+      report.totalRenderedSamples += profile.blockSize;
+    }
+    if (withProbe)
+      continue;
+    for (const auto &[paramKey, value] : probe->params) {
+      const auto rendered = runtime.getParam(makeTeulParamId(copyId, paramKey));
+      if (!rendered.isVoid() && static_cast<float>(rendered) == sentinel &&
+          static_cast<float>(value) != sentinel) {
+        failureReason = "A change queued for the probe's gain reached " + paramKey +
+                        " of its replacement at rebuild " + juce::String(rebuild) + ".";
+        break;
+      }
+    }
+  }
+
+  stopProducer.store(true, std::memory_order_relaxed);
+  producer.join();
+  report.worstRuntimeStats = runtime.getRuntimeStats();
+  return failureReason;
+}
+// Meters the source's output in two runtimes, one of which has its pan
+// moved in the middle of every block. The splits leave the source untouched,
+// so both must publish the same reading, once per device block.
+juce::String checkMetersAcrossSplitBlocks(const TNodeRegistry &registry,
+                                          const TGraphDocument &document,
+                                          int iterationCount,
+                                          TVerificationStressCaseReport &report) {
+  constexpr int blocksPerIteration = 64;
+  const auto profile = makePrimaryVerificationRenderProfile();
+  const auto *source = document.findNode(findNodeIdByLabel(document, "Source"));
+  const NodeId panId = findNodeIdByLabel(document, "Stereo Pan");
+  PortId meteredPort = kInvalidPortId;
+  if (source != nullptr) {
+    for (const auto &port : source->ports) {
+      if (port.direction == TPortDirection::Output)
+        meteredPort = port.portId;
+    }
+  }
+  if (meteredPort == kInvalidPortId || panId == kInvalidNodeId)
+    return "Meter check needs the Source and Stereo Pan nodes.";
+
+  TGraphRuntime wholeRuntime(&registry);
+  TGraphRuntime splitRuntime(&registry);
+  for (auto *runtime : {&wholeRuntime, &splitRuntime}) {
+    if (!runtime->buildGraph(document))
+      return "Failed to build the meter check graph.";
+    runtime->setCurrentChannelLayout(0, profile.outputChannels);
+    runtime->prepareToPlay(profile.sampleRate, profile.blockSize);
+  }
+  const int wholeSlot = wholeRuntime.subscribePortMeter(meteredPort);
+  const int splitSlot = splitRuntime.subscribePortMeter(meteredPort);
+
+  juce::AudioBuffer<float> block(profile.outputChannels, profile.blockSize);
+  juce::MidiBuffer midi;
+  TPortMeterBank::Reading previous;
+  splitRuntime.readPortMeter(splitSlot, previous);
+  const int blockCount = iterationCount * blocksPerIteration;
+  for (int blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+    const float pan = blockIndex % 2 == 0 ? -0.5f : 0.5f;
+    splitRuntime.queueParameterChange(panId, "pan", pan, profile.blockSize / 2);
+    for (auto *runtime : {&wholeRuntime, &splitRuntime}) {
+      block.clear();
+      runtime->processBlock(block, midi);
+    }
+    ++report.totalRenderedBlocks;
+    report.totalRenderedSamples += profile.blockSize;
+
+    TPortMeterBank::Reading whole;
+    TPortMeterBank::Reading split;
+    if (!wholeRuntime.readPortMeter(wholeSlot, whole) ||
+        !splitRuntime.readPortMeter(splitSlot, split)) {
+      return "Meter slot could not be read at block " + juce::String(blockIndex) + ".";
+    }
+    if (splitRuntime.getRuntimeStats().lastSubBlockCount < 2)
+      return "Meter check block " + juce::String(blockIndex) + " was not split.";
+    if (split.version != previous.version + 1) {
+      return "A split block advanced the meter version by " +
+             juce::String(static_cast<int>(split.version - previous.version)) +
+             " at block " + juce::String(blockIndex) + ".";
+    }
+    if (std::abs(split.peak - whole.peak) > 1.0e-4f ||
+        std::abs(split.rms - whole.rms) > 1.0e-4f) {
+      return "A split block metered peak " + juce::String(split.peak, 6) + " rms " +
+             juce::String(split.rms, 6) + " instead of " + juce::String(whole.peak, 6) +
+             " and " + juce::String(whole.rms, 6) + " at block " +
+             juce::String(blockIndex) + ".";
+    }
+    previous = split;
+  }
+
+  report.worstRuntimeStats = splitRuntime.getRuntimeStats();
+  return {};
+}
 } // namespace
 bool runRepresentativeStressSoakSuite(const TNodeRegistry &registry,
                                       TVerificationStressSuiteReport &reportOut,
@@ -304,8 +617,8 @@ bool runRepresentativeStressSoakSuite(const TNodeRegistry &registry,
     if (fixture == nullptr) {
       caseReport.failureReason = "Representative stress fixture was not found.";
     } else {
-      const auto caseArtifactDirectory = makeStressCaseArtifactDirectory(
-          suiteArtifactDirectory, *fixture, caseSpec.profile, caseSpec.stimulus);
+      const auto caseArtifactDirectory =
+          makeStressCaseArtifactDirectory(suiteArtifactDirectory, caseReport);
       caseReport.artifactDirectory = caseArtifactDirectory.getFullPathName();
       juce::ignoreUnused(caseArtifactDirectory.deleteRecursively());
       juce::ignoreUnused(caseArtifactDirectory.createDirectory());
@@ -358,6 +671,10 @@ bool runRepresentativeStressSoakSuite(const TNodeRegistry &registry,
                 ? renderResult.runtimeStats
                 : maxRuntimeStats(caseReport.worstRuntimeStats,
                                   renderResult.runtimeStats);
+        mergeBlockLoadHistogram(caseReport.blockLoadHistogram,
+                                renderResult.blockLatency.histogram);
+        appendRecentXruns(caseReport.recentXruns,
+                          renderResult.blockLatency.recentXruns);
       }
       caseReport.passed = caseReport.failureReason.isEmpty();
       finalizeStressCaseArtifacts(caseArtifactDirectory, caseReport);
@@ -369,6 +686,36 @@ bool runRepresentativeStressSoakSuite(const TNodeRegistry &registry,
       ++reportOut.failedCaseCount;
     reportOut.caseReports.push_back(caseReport);
   }
+  const std::vector<StressContractSpec> contractSpecs = {
+      {"G1", "param-route-rebuild-race", checkParamRoutesAcrossRebuilds},
+      {"G3", "meter-split-block", checkMetersAcrossSplitBlocks},
+  };
+  for (const auto &contractSpec : contractSpecs) {
+    TVerificationStressCaseReport caseReport;
+    caseReport.graphId = contractSpec.fixtureId;
+    caseReport.stimulusId = contractSpec.checkId;
+    caseReport.profileId = makePrimaryVerificationRenderProfile().profileId;
+    caseReport.iterationCount = reportOut.iterationCount;
+    const auto *fixture = findFixtureById(fixtures, contractSpec.fixtureId);
+    if (fixture == nullptr) {
+      caseReport.failureReason = "Stress contract fixture was not found.";
+    } else {
+      const auto caseArtifactDirectory =
+          makeStressCaseArtifactDirectory(suiteArtifactDirectory, caseReport);
+      caseReport.artifactDirectory = caseArtifactDirectory.getFullPathName();
+      juce::ignoreUnused(caseArtifactDirectory.deleteRecursively());
+      caseReport.failureReason = contractSpec.check(
+          registry, fixture->document, reportOut.iterationCount, caseReport);
+      caseReport.passed = caseReport.failureReason.isEmpty();
+      finalizeStressCaseArtifacts(caseArtifactDirectory, caseReport);
+    }
+    ++reportOut.totalCaseCount;
+    if (caseReport.passed)
+      ++reportOut.passedCaseCount;
+    else
+      ++reportOut.failedCaseCount;
+    reportOut.caseReports.push_back(caseReport);
+  }
   reportOut.passed =
       reportOut.totalCaseCount > 0 && reportOut.failedCaseCount == 0;
   return reportOut.passed;
@@ -13,6 +13,8 @@ struct TVerificationStressCaseReport {
   juce::String artifactDirectory;
   juce::String failureReason;
   TGraphRuntime::RuntimeStats worstRuntimeStats;
+  std::vector<TBlockLatencyMonitor::Bucket> blockLoadHistogram;
+  std::vector<TBlockLatencyMonitor::XrunRecord> recentXruns;
 };
 struct TVerificationStressSuiteReport {
   juce::String suiteId;